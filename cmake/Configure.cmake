@@ -115,6 +115,10 @@ if(NOT SW_BUILD)
   if(ENABLE_ZLIB AND ZLIB_FOUND)
     set(HAVE_LIBZ 1)
   endif()
+
+  if(ENABLE_LIBDEFLATE AND LIBDEFLATE_FOUND)
+    set(HAVE_LIBDEFLATE 1)
+  endif()
 endif()
 
 file(APPEND ${AUTOCONFIG_SRC} "
@@ -141,6 +145,9 @@ file(APPEND ${AUTOCONFIG_SRC} "
 
 /* Define to 1 if you have zlib. */
 #cmakedefine HAVE_LIBZ 1
+
+/* Define to 1 if you have libdeflate. */
+#cmakedefine HAVE_LIBDEFLATE 1
 ")
 
 ########################################
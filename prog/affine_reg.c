@@ -28,6 +28,8 @@
  * affine_reg.c
  *
  *   Tests affine transforms, including invertability and large distortions.
+ *   Also compares the line-incremental interpolation with pointwise
+ *   float interpolation.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -38,6 +40,7 @@
 
 static void MakePtas(l_int32 i, PTA **pptas, PTA **pptad);
 static l_int32 RenderHashedBoxa(PIX *pixt, BOXA *boxa, l_int32 i);
+static PIX *AffinePointwise(PIX *pixs, l_float32 *vc, l_uint32 val);
 
 
     /* Sample values.
@@ -65,6 +68,9 @@ static const l_float32  SCALEX = 0.83;
 static const l_float32  SCALEY = 0.78;
 static const l_float32  ROTATION = 0.11;   /* radian */
 
+    /* Translation by (-0.3, -0.5), as a transform from dest to src */
+static l_float32  SubpixelShift[] = {1.0, 0.0, 0.3, 0.0, 1.0, 0.5};
+
 #define   ADDED_BORDER_PIXELS       1000
 #define   ALL     1
 
@@ -381,6 +387,51 @@ L_REGPARAMS  *rp;
     lept_free(matdinv);
 #endif
 
+#if ALL
+        /* Compare line-incremental with pointwise interpolation.  The
+         * last case is a translation by a fraction of a pixel, which
+         * takes the bottom dest line from the last src line. */
+    lept_stderr("Compare incremental with pointwise interpolation\n");
+    pixc = pixRead("test24.jpg");
+    pixcs = pixScale(pixc, 0.5, 0.5);
+    pixg = pixConvertRGBToLuminance(pixcs);
+    MakePtas(1, &ptas, &ptad);
+    getAffineXformCoeffs(ptad, ptas, &mat1);
+    pix1 = pixAffineGray(pixg, mat1, 255);
+    pix2 = AffinePointwise(pixg, mat1, 255);
+    regTestComparePix(rp, pix1, pix2);  /* 53 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixAffineColor(pixcs, mat1, 0xffffff00);
+    pix2 = AffinePointwise(pixcs, mat1, 0xffffff00);
+    regTestComparePix(rp, pix1, pix2);  /* 54 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixSetSpp(pixcs, 4);
+    pixSetRGBComponent(pixcs, pixg, L_ALPHA_CHANNEL);
+    pix1 = pixAffineColor(pixcs, mat1, 0xffffff00);
+    pix2 = AffinePointwise(pixcs, mat1, 0xffffff00);
+    regTestComparePix(rp, pix1, pix2);  /* 55 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixAffineGray(pixg, SubpixelShift, 255);
+    pix2 = AffinePointwise(pixg, SubpixelShift, 255);
+    regTestComparePix(rp, pix1, pix2);  /* 56 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixAffineColor(pixcs, SubpixelShift, 0xffffff00);
+    pix2 = AffinePointwise(pixcs, SubpixelShift, 0xffffff00);
+    regTestComparePix(rp, pix1, pix2);  /* 57 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixc);
+    pixDestroy(&pixcs);
+    pixDestroy(&pixg);
+    ptaDestroy(&ptas);
+    ptaDestroy(&ptad);
+    lept_free(mat1);
+#endif
+
     return regTestCleanup(rp);
 }
 
@@ -423,3 +474,51 @@ BOX     *box;
 }
 
 
+    /* Pointwise transform, used to check the line-incremental one.
+     * The src location is found in double precision and truncated
+     * to 1/16 pixel, as in the line-incremental version. */
+static PIX *
+AffinePointwise(PIX        *pixs,
+                l_float32  *vc,
+                l_uint32    val)
+{
+l_int32    i, j, w, h, d, wpls, gval;
+l_uint32   cval;
+l_uint32  *datas;
+l_float32  x, y;
+l_float64  xd, yd;
+PIX       *pix1, *pix2, *pixd;
+
+    pixGetDimensions(pixs, &w, &h, &d);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    pixd = pixCreateTemplate(pixs);
+    for (i = 0; i < h; i++) {
+        for (j = 0; j < w; j++) {
+            xd = (l_float64)vc[0] * j + (l_float64)vc[1] * i + vc[2];
+            yd = (l_float64)vc[3] * j + (l_float64)vc[4] * i + vc[5];
+            x = y = -1.0;  /* outside the src */
+            if (xd >= 0.0 && yd >= 0.0 && xd < w && yd < h) {
+                x = (l_int32)(16.0 * xd) / 16.0;
+                y = (l_int32)(16.0 * yd) / 16.0;
+            }
+            if (d == 8) {
+                linearInterpolatePixelGray(datas, wpls, w, h, x, y, val, &gval);
+                pixSetPixel(pixd, j, i, gval);
+            } else {
+                linearInterpolatePixelColor(datas, wpls, w, h, x, y, val,
+                                            &cval);
+                pixSetPixel(pixd, j, i, cval);
+            }
+        }
+    }
+
+    if (d == 32 && pixGetSpp(pixs) == 4) {
+        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
+        pix2 = AffinePointwise(pix1, vc, 255);
+        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    return pixd;
+}
@@ -33,7 +33,8 @@
  *  Some things to note:
  *
  *  (1) This compares results for these operations:
- *         - rasterop brick (non-separable, separable)
+ *         - rasterop brick (non-separable, separable); for large
+ *           bricks, such as 51 x 41, these use running ops
  *         - dwa brick (separable), as implemented in morphdwa.c
  *         - dwa brick separable, but using lower-level non-separable
  *           autogen'd code.
@@ -77,8 +78,8 @@ TestAll(L_REGPARAMS  *rp,
 {
 char        *selnameh, *selnamev;
 l_int32      ok, same, w, h, i, bordercolor, extraborder;
-l_int32      width[3] = {21, 1, 21};
-l_int32      height[3] = {1, 7, 7};
+l_int32      width[4] = {21, 1, 21, 51};
+l_int32      height[4] = {1, 7, 7, 41};
 PIX         *pixref, *pix0, *pix1, *pix2, *pix3, *pix4;
 SEL         *sel;
 SELA        *sela;
@@ -96,7 +97,7 @@ SELA        *sela;
 
         /* Note that with the choice of width and height, there is
          * no situation where they are both 1 (a no-op).  */
-    for (i = 0; i < 3; i++) {
+    for (i = 0; i < 4; i++) {
         w = width[i];
         h = height[i];
         sel = selCreateBrick(h, w, h / 2, w / 2, SEL_HIT);
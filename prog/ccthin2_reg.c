@@ -30,6 +30,8 @@
  *   Tests:
  *   - The examples in pixThinConnectedBySet()
  *   - Use of thinning and thickening in stroke width normalization
+ *   - Thinning with 3x3 Sels, which is done with neighborhood masks,
+ *     gives the same result as with equivalent Sels that use HMTs
  */
 
 #ifdef HAVE_CONFIG_H
@@ -41,13 +43,14 @@
 int main(int    argc,
          char **argv)
 {
-l_int32       i;
+l_int32       i, j, k, n, index, type;
 BOX          *box;
 PIX          *pixs, *pix1, *pix2;
 PIXA         *pixa1, *pixa2, *pixa3, *pixa4, *pixa5;
 PIXAA        *paa;
 L_REGPARAMS  *rp;
-SELA         *sela;
+SEL          *sel1, *sel2;
+SELA         *sela, *sela2;
 
 #if !defined(HAVE_LIBPNG)
     L_ERROR("This test requires libpng to run.\n", "ccthin_reg");
@@ -186,6 +189,37 @@ SELA         *sela;
     pixaDestroy(&pixa5);
     pixDestroy(&pix1);
 
+        /* Pad the 3x3 Sels with a row of don't-care, so that thinning
+         * uses HMTs, and compare with thinning by neighborhood masks */
+    pix1 = pixRead("feyn.tif");
+    box = boxCreate(683, 799, 970, 479);
+    pixs = pixClipRectangle(pix1, box, NULL);
+    pixDestroy(&pix1);
+    boxDestroy(&box);
+    for (i = 0; i < 2; i++) {
+        index = (i == 0) ? 1 : 11;
+        type = (i == 0) ? L_THIN_FG : L_THIN_BG;
+        sela = selaMakeThinSets(index, 0);
+        n = selaGetCount(sela);
+        sela2 = selaCreate(n);
+        for (k = 0; k < n; k++) {
+            sel1 = selaGetSel(sela, k);
+            sel2 = selCreate(4, 3, selGetName(sel1));
+            selSetOrigin(sel2, 1, 1);
+            for (j = 0; j < 9; j++)
+                sel2->data[j / 3][j % 3] = sel1->data[j / 3][j % 3];
+            selaAddSel(sela2, sel2, NULL, L_INSERT);
+        }
+        pix1 = pixThinConnectedBySet(pixs, type, sela, 5);
+        pix2 = pixThinConnectedBySet(pixs, type, sela2, 5);
+        regTestComparePix(rp, pix1, pix2);  /* 19, 20 */
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        selaDestroy(&sela);
+        selaDestroy(&sela2);
+    }
+    pixDestroy(&pixs);
+
     return regTestCleanup(rp);
 }
 
@@ -38,11 +38,17 @@
 
 static const l_int32  SIZE = 7;
 
+static PIX *ColorMorphByComponent(PIX *pixs, l_int32 type, l_int32 hsize,
+                                  l_int32 vsize);
+
 int main(int    argc,
          char **argv)
 {
 char          buf[256];
-PIX          *pixs, *pix1, *pix2;
+l_int32       i;
+l_int32       types[4] = {L_MORPH_DILATE, L_MORPH_ERODE,
+                          L_MORPH_OPEN, L_MORPH_CLOSE};
+PIX          *pixs, *pix1, *pix2, *pix3;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
 
@@ -84,6 +90,26 @@ L_REGPARAMS  *rp;
     pixaAddPix(pixa, pix1, L_INSERT);
     pixDestroy(&pix2);
 
+        /* Compare with the operations on separate components */
+    for (i = 0; i < 4; i++) {
+        pix1 = pixColorMorph(pixs, types[i], 9, 3);
+        pix2 = ColorMorphByComponent(pixs, types[i], 9, 3);
+        regTestComparePix(rp, pix1, pix2);  /* 8 - 11 */
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+
+        /* Composite sequence */
+    pix1 = pixColorMorphSequence(pixs, "c5.5 + o3.3 + d3.1", 0, 0);
+    pix2 = pixColorMorph(pixs, L_MORPH_CLOSE, 5, 5);
+    pix3 = pixColorMorph(pix2, L_MORPH_OPEN, 3, 3);
+    pixDestroy(&pix2);
+    pix2 = ColorMorphByComponent(pix3, L_MORPH_DILATE, 3, 1);
+    regTestComparePix(rp, pix1, pix2);  /* 12 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
     if (rp->display) {
         lept_mkdir("lept/cmorph");
         lept_stderr("Writing to: /tmp/lept/cmorph/colormorph.pdf\n");
@@ -99,3 +125,34 @@ L_REGPARAMS  *rp;
     pixDestroy(&pixs);
     return regTestCleanup(rp);
 }
+
+
+    /* Split into components, do the grayscale operation on each,
+     * and recombine */
+static PIX *
+ColorMorphByComponent(PIX     *pixs,
+                      l_int32  type,
+                      l_int32  hsize,
+                      l_int32  vsize)
+{
+l_int32  i;
+l_int32  comps[3] = {COLOR_RED, COLOR_GREEN, COLOR_BLUE};
+PIX     *pix1, *pixc[3], *pixd;
+
+    for (i = 0; i < 3; i++) {
+        pix1 = pixGetRGBComponent(pixs, comps[i]);
+        if (type == L_MORPH_DILATE)
+            pixc[i] = pixDilateGray(pix1, hsize, vsize);
+        else if (type == L_MORPH_ERODE)
+            pixc[i] = pixErodeGray(pix1, hsize, vsize);
+        else if (type == L_MORPH_OPEN)
+            pixc[i] = pixOpenGray(pix1, hsize, vsize);
+        else  /* type == L_MORPH_CLOSE */
+            pixc[i] = pixCloseGray(pix1, hsize, vsize);
+        pixDestroy(&pix1);
+    }
+    pixd = pixCreateRGBImage(pixc[0], pixc[1], pixc[2]);
+    for (i = 0; i < 3; i++)
+        pixDestroy(&pixc[i]);
+    return pixd;
+}
@@ -42,15 +42,17 @@
 l_int32 main(int    argc,
              char **argv)
 {
-l_int32       i, n;
+l_int32       i, n, w, h, same;
 l_float32     a, b, c;
-L_DEWARP     *dew1, *dew2;
-L_DEWARPA    *dewa1, *dewa2;
+L_DEWARP     *dew1, *dew2, *dew3;
+L_DEWARPA    *dewa1, *dewa2, *dewa3, *dewa4;
+L_REMAP      *remap;
 DPIX         *dpix1, *dpix2, *dpix3;
 FPIX         *fpix1, *fpix2, *fpix3;
 NUMA         *nax, *nafit;
 PIX          *pixs, *pixn, *pixg, *pixd, *pixb, *pix1, *pixt1, *pixt2;
 PIX          *pixs2, *pixn2, *pixg2, *pixb2;
+PIXAC        *pixac;
 PTA          *pta, *ptad;
 PTAA         *ptaa1, *ptaa2;
 L_REGPARAMS  *rp;
@@ -201,6 +203,87 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix1);
     pixDestroy(&pixt1);
 
+        /* Precompute the page 7 disparity as a remap, and compare
+         * with applying the disparity directly */
+    pixg = pixConvertRGBToGray(pixs, 0.5, 0.3, 0.2);
+    dewarpaApplyDisparity(dewa1, 7, pixg, 255, 0, 0, &pixd, NULL);
+    pixGetDimensions(pixg, &w, &h, NULL);
+    remap = remapCreateFromDewarp(dew1, w, h, 0, 0, 1);
+    dewarpMinimize(dew1);
+    pix1 = pixRemap(pixg, remap, L_SAMPLED, L_BRING_IN_WHITE);
+    regTestCompareSimilarPix(rp, pixd, pix1, 20, 0.01, 0);  /* 21 */
+    pixDestroy(&pix1);
+    pix1 = pixRemap(pixg, remap, L_INTERPOLATED, L_BRING_IN_WHITE);
+    regTestWritePixAndCheck(rp, pix1, IFF_JFIF_JPEG);  /* 22 */
+    pixDisplayWithTitle(pix1, 800, 800, "page 7 remapped", rp->display);
+    pixDestroy(&pix1);
+    pixDestroy(&pixd);
+    remapDestroy(&remap);
+
+        /* Build the models for a set of pages.  Page 3 has too few
+         * lines, so it uses the page 7 model. */
+    pixac = pixacompCreateWithInit(8, 0, NULL, IFF_TIFF_G4);
+    pixacompReplacePix(pixac, 3, pixb2, IFF_TIFF_G4);
+    pixacompReplacePix(pixac, 7, pixb, IFF_TIFF_G4);
+    dewa3 = dewarpaCreate(8, 30, 1, 15, 30);
+    dewarpaUseBothArrays(dewa3, 1);
+    dewarpaBuildModels(dewa3, pixac, 0);
+    dewarpaApplyDisparity(dewa1, 7, pixb, 200, 0, 0, &pixd, NULL);
+    dewarpaApplyDisparity(dewa3, 7, pixb, 200, 0, 0, &pix1, NULL);
+    regTestComparePix(rp, pixd, pix1);  /* 23 */
+    pixDestroy(&pixd);
+    pixDestroy(&pix1);
+
+        /* Serialize the models, and use them as a cache; the page
+         * 7 model is not rebuilt */
+    dewarpaWrite("/tmp/lept/regout/dewarp.24.dewa", dewa3);
+    dewa4 = dewarpaRead("/tmp/lept/regout/dewarp.24.dewa");
+    dew3 = dewarpaGetDewarp(dewa4, 7);
+    dewarpaBuildModels(dewa4, pixac, 0);
+    same = (dewarpaGetDewarp(dewa4, 7) == dew3);
+    regTestCompareValues(rp, 1, same, 0);  /* 24 */
+    dewarpaDestroy(&dewa3);
+    dewarpaDestroy(&dewa4);
+    pixacompDestroy(&pixac);
+
+        /* With reuse, a model is not built for page 7, because
+         * page 5 has a valid model */
+    pixac = pixacompCreateWithInit(8, 0, NULL, IFF_TIFF_G4);
+    pixacompReplacePix(pixac, 5, pixb, IFF_TIFF_G4);
+    pixacompReplacePix(pixac, 7, pixb, IFF_TIFF_G4);
+    dewa3 = dewarpaCreate(8, 30, 1, 15, 30);
+    dewarpaUseBothArrays(dewa3, 1);
+    dewarpaBuildModels(dewa3, pixac, 2);
+    dew3 = dewarpaGetDewarp(dewa3, 7);
+    same = (dew3 && dew3->hasref == 1 && dew3->refpage == 5);
+    regTestCompareValues(rp, 1, same, 0);  /* 25 */
+    dewarpaDestroy(&dewa3);
+    pixacompDestroy(&pixac);
+
+        /* Apply the page 7 model to the image at 2x resolution */
+    dewarpaApplyDisparity(dewa1, 7, pixg, 255, 0, 0, &pixd, NULL);
+    pix1 = pixScale(pixg, 2.0, 2.0);
+    dewarpaSetRedfactor(dewa1, 2);
+    dewarpaApplyDisparity(dewa1, 7, pix1, 255, 0, 0, &pixt1, NULL);
+    pixt2 = pixScaleAreaMap2(pixt1);
+    regTestCompareSimilarPix(rp, pixd, pixt2, 40, 0.005, 0);  /* 26 */
+    pixDisplayWithTitle(pixt1, 1000, 800, "page 7 dewarped at 2x",
+                        rp->display);
+    pixDestroy(&pixt1);
+    pixDestroy(&pixt2);
+
+        /* Generating the disparity a row at a time gives the same
+         * result as using the full res disparity arrays */
+    dewarpaApplyDisparity(dewa1, 7, pix1, 255, 40, 30, &pixt1, NULL);
+    dewarpPopulateFullRes(dew1, pix1, 40, 30);
+    dewarpaApplyDisparity(dewa1, 7, pix1, 255, 40, 30, &pixt2, NULL);
+    regTestComparePix(rp, pixt1, pixt2);  /* 27 */
+    pixDestroy(&pix1);
+    pixDestroy(&pixt1);
+    pixDestroy(&pixt2);
+    pixDestroy(&pixd);
+    pixDestroy(&pixg);
+
     dewarpaDestroy(&dewa1);
     dewarpaDestroy(&dewa2);
     pixDestroy(&pixs);
@@ -34,6 +34,11 @@
  *    automatically generated dwa results.
  *
  *    Results must be identical for all operations.
+ *
+ *    Also tests that hmt, dilation and erosion with Sels that are
+ *    done with runs of hits and misses (see selPlanCreate()) give
+ *    the same result as the element by element rasterops, and that
+ *    the hmt pattern search gives the same result as the rasterop hmt.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -42,14 +47,20 @@
 
 #include "allheaders.h"
 
+static SEL *MakeRunSel(l_int32 type);
+static PIX *MorphByElements(PIX *pixs, SEL *sel, l_int32 type);
+
 int main(int    argc,
          char **argv)
 {
-l_int32       i, nsels, same1, same2;
+l_int32       i, nsels, same1, same2, count;
 char         *selname;
+BOX          *box;
 PIX          *pixs, *pixref, *pix1, *pix2, *pix3, *pix4;
 SEL          *sel;
 SELA         *sela;
+PTA          *pta;
+L_SELPLAN    *plan;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -84,7 +95,129 @@ L_REGPARAMS  *rp;
         pixDestroy(&pix4);
     }
 
+        /* Sels with long runs are done with one rasterop for each run.
+         * Compare with the results of doing one rasterop for each
+         * element.  The first Sel has its origin inside; the others
+         * have it outside, below and to the right, and above and
+         * to the left. */
+    pix2 = pixClipRectangle(pixs, box = boxCreate(0, 0, 1000, 1000), NULL);
+    pix1 = pixDilateBrick(NULL, pix2, 15, 1);  /* to match the hmt Sels */
+    boxDestroy(&box);
+    pixDestroy(&pix2);
+    for (i = 0; i < 3; i++) {
+        sel = MakeRunSel(i);
+        plan = selPlanCreate(sel);
+        regTestCompareValues(rp, 1,  /* 20, 26, 32 */
+                             plan->hitcost + plan->misscost <
+                             plan->nhits + plan->nmisses, 0);
+        selPlanDestroy(&plan);
+        pix2 = pixHMT(NULL, pix1, sel);
+        pix3 = MorphByElements(pix1, sel, L_MORPH_HMT);
+        regTestComparePix(rp, pix2, pix3);  /* 21, 27, 33 */
+        pixCountPixels(pix2, &count, NULL);
+        regTestCompareValues(rp, 1, count > 0, 0);  /* 22, 28, 34 */
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        pix2 = pixDilate(NULL, pix1, sel);
+        pix3 = MorphByElements(pix1, sel, L_MORPH_DILATE);
+        regTestComparePix(rp, pix2, pix3);  /* 23, 29, 35 */
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        pix2 = pixErode(NULL, pix1, sel);
+        pix3 = MorphByElements(pix1, sel, L_MORPH_ERODE);
+        regTestComparePix(rp, pix2, pix3);  /* 24, 30, 36 */
+        pixCountPixels(pix2, &count, NULL);
+        regTestCompareValues(rp, 1, count > 0, 0);  /* 25, 31, 37 */
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        selDestroy(&sel);
+    }
+    pixDestroy(&pix1);
+
+        /* Search for the hmt patterns, and compare with the rasterop
+         * hmt.  There is one location for each matched pixel. */
+    for (i = 0; i < nsels; i++) {
+        sel = selaGetSel(sela, i);
+        pix1 = pixHMT(NULL, pixs, sel);
+        pix2 = pixHMTSearch(pixs, sel, &pta);
+        regTestComparePix(rp, pix1, pix2);  /* 38, 40, ... 56 */
+        pixCountPixels(pix1, &count, NULL);
+        regTestCompareValues(rp, count, ptaGetCount(pta), 0);  /* 39, ... */
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        ptaDestroy(&pta);
+    }
+
     pixDestroy(&pixs);
     selaDestroy(&sela);
     return regTestCleanup(rp);
 }
+
+
+    /* Make a Sel with long runs of hits and misses.  For type 0, the
+     * origin is inside the Sel; for types 1 and 2, it is outside. */
+static SEL *
+MakeRunSel(l_int32  type)
+{
+l_int32  j;
+SEL     *sel;
+
+    sel = selCreate(5, 40, "hline");
+    if (type == 0)
+        selSetOrigin(sel, 2, 20);
+    else if (type == 1)
+        selSetOrigin(sel, 8, 46);
+    else
+        selSetOrigin(sel, -10, -50);
+    for (j = 0; j < 40; j++) {
+        selSetElement(sel, 0, j, SEL_MISS);
+        if (j < 10 || j >= 30)
+            selSetElement(sel, 3, j, SEL_HIT);
+        selSetElement(sel, 4, j, SEL_HIT);
+    }
+    selSetElement(sel, 1, 5, SEL_MISS);
+    return sel;
+}
+
+
+    /* Do the operation with one Sel for each element, each of which
+     * has the origin of %sel.  A Sel with one element is done with a
+     * single rasterop, and not with runs.  For erosion and hmt, the
+     * results are ANDed, and for dilation, they are ORed. */
+static PIX *
+MorphByElements(PIX     *pixs,
+                SEL     *sel,
+                l_int32  type)
+{
+l_int32  i, j, sy, sx, cy, cx, val;
+PIX     *pix1, *pixd;
+SEL     *sel1;
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    pixd = NULL;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            selGetElement(sel, i, j, &val);
+            if (val == SEL_DONT_CARE) continue;
+            if (val == SEL_MISS && type != L_MORPH_HMT) continue;
+            sel1 = selCreate(sy, sx, NULL);
+            selSetOrigin(sel1, cy, cx);
+            selSetElement(sel1, i, j, val);
+            if (type == L_MORPH_HMT)
+                pix1 = pixHMT(NULL, pixs, sel1);
+            else if (type == L_MORPH_DILATE)
+                pix1 = pixDilate(NULL, pixs, sel1);
+            else
+                pix1 = pixErode(NULL, pixs, sel1);
+            if (!pixd)
+                pixd = pixClone(pix1);
+            else if (type == L_MORPH_DILATE)
+                pixOr(pixd, pixd, pix1);
+            else
+                pixAnd(pixd, pixd, pix1);
+            pixDestroy(&pix1);
+            selDestroy(&sel1);
+        }
+    }
+    return pixd;
+}
@@ -0,0 +1,119 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*
+ * flatetest.c
+ *
+ *   Benchmark for the flate (zlib) compression used in memory, in pdf
+ *   and in PostScript.  For each image, the raster data is compressed
+ *   and decompressed with zlibCompress() and zlibUncompress(), and the
+ *   image is written to a flate-encoded pdf in memory.
+ *
+ *   The backend (zlib, or libdeflate if leptonica was built with it)
+ *   is shown in the list of library versions.  To compare the two,
+ *   build with and without libdeflate and run this on the same images.
+ *
+ *   Syntax:  flatetest [niters]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <string.h>
+#include "allheaders.h"
+
+static const char *image_files[] = {"rabi.png", "dreyfus8.png",
+                                    "weasel8.240c.png", "test8.jpg",
+                                    "marge.jpg"};
+
+int main(int    argc,
+         char **argv)
+{
+char       *versions;
+l_uint8    *data, *datacomp, *datadecomp, *datapdf;
+l_int32     i, j, nfiles, niters, same;
+size_t      nbytes, ncomp, ndecomp, npdf;
+l_float32   tcomp, tdecomp, tpdf, mbytes;
+PIX        *pix;
+
+    if (argc != 1 && argc != 2)
+        return ERROR_INT(" Syntax:  flatetest [niters]", __func__, 1);
+    niters = (argc == 2) ? atoi(argv[1]) : 10;
+    if (niters < 1) niters = 1;
+    setLeptDebugOK(1);
+
+    versions = getImagelibVersions();
+    lept_stderr("%s\n\n", versions);
+    lept_free(versions);
+
+    nfiles = sizeof(image_files) / sizeof(char *);
+    for (i = 0; i < nfiles; i++) {
+        if ((pix = pixRead(image_files[i])) == NULL) {
+            L_ERROR("can't read %s\n", __func__, image_files[i]);
+            continue;
+        }
+        pixGetRasterData(pix, &data, &nbytes);
+        mbytes = (l_float32)niters * nbytes / 1000000.;
+
+            /* In-memory compression and decompression */
+        startTimer();
+        for (j = 0; j < niters; j++) {
+            datacomp = zlibCompress(data, nbytes, &ncomp);
+            if (j < niters - 1) lept_free(datacomp);
+        }
+        tcomp = stopTimer();
+        startTimer();
+        for (j = 0; j < niters; j++) {
+            datadecomp = zlibUncompress(datacomp, ncomp, &ndecomp);
+            if (j < niters - 1) lept_free(datadecomp);
+        }
+        tdecomp = stopTimer();
+        same = (datadecomp && ndecomp == nbytes &&
+                !memcmp(data, datadecomp, nbytes));
+
+            /* Flate-encoded pdf in memory */
+        startTimer();
+        for (j = 0; j < niters; j++) {
+            pixConvertToPdfData(pix, L_FLATE_ENCODE, 0, &datapdf, &npdf,
+                                0, 0, 300, NULL, NULL, 0);
+            lept_free(datapdf);
+        }
+        tpdf = stopTimer();
+
+        lept_stderr("%s: %zu bytes, ratio %5.2f, %s\n", image_files[i],
+                    nbytes, (l_float32)nbytes / (l_float32)ncomp,
+                    (same) ? "data is the same" : "ERROR: data differs");
+        lept_stderr("   compress: %7.1f MB/sec   uncompress: %7.1f MB/sec   "
+                    "pdf: %7.4f sec/page\n", mbytes / tcomp,
+                    mbytes / tdecomp, tpdf / niters);
+        lept_free(datacomp);
+        lept_free(datadecomp);
+        lept_free(data);
+        pixDestroy(&pix);
+    }
+    return 0;
+}
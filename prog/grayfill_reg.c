@@ -27,7 +27,8 @@
 /*
  * grayfill_reg.c
  *
- *   Regression test for gray filling operations
+ *   Regression test for gray filling operations, and for the
+ *   max-tree filters that give the same results
  */
 
 #ifdef HAVE_CONFIG_H
@@ -43,10 +44,11 @@ int main(int    argc,
          char **argv)
 {
 l_int32       i, j;
-PIX          *pixm, *pixmi, *pixs1, *pixs1_8, *pix1;
+PIX          *pixm, *pixmi, *pixs1, *pixs1_8, *pix1, *pix2;
 PIX          *pixs2, *pixs2_8, *pixs3, *pixs3_8;
 PIX          *pixb1, *pixb2, *pixb3, *pixmin;
 PIXA         *pixa;
+L_MAXTREE    *tree;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -158,6 +160,90 @@ L_REGPARAMS  *rp;
     pixDestroy(&pixs1);
     pixDestroy(&pixs2);
 
+        /* Compare max-tree filters with gray seedfills */
+    pixs1 = pixRead("test8.jpg");
+    for (i = 0; i < 2; i++) {
+        pix1 = pixHMax(pixs1, 40, 4 + 4 * i);
+        pix2 = pixCopy(NULL, pixs1);
+        pixAddConstantGray(pix2, -40);
+        pixSeedfillGray(pix2, pixs1, 4 + 4 * i);
+        regTestComparePix(rp, pix1, pix2);  /* 35, 37 */
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        pix1 = pixHMin(pixs1, 40, 4 + 4 * i);
+        pix2 = pixInvert(NULL, pixs1);
+        pixs2 = pixCopy(NULL, pix2);
+        pixAddConstantGray(pixs2, -40);
+        pixSeedfillGray(pixs2, pix2, 4 + 4 * i);
+        pixInvert(pixs2, pixs2);
+        regTestComparePix(rp, pix1, pixs2);  /* 36, 38 */
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        pixDestroy(&pixs2);
+    }
+
+        /* Compare area opening of a binary image with component
+         * selection by area */
+    pixb1 = pixThresholdToBinary(pixs1, 100);
+    pixs2 = pixConvert1To8(NULL, pixb1, 0, 255);
+    pix1 = pixAreaOpen(pixs2, 30, 8);
+    pixb2 = pixSelectByArea(pixb1, 30, 8, L_SELECT_IF_GTE, NULL);
+    pix2 = pixConvert1To8(NULL, pixb2, 0, 255);
+    regTestComparePix(rp, pix1, pix2);  /* 39 */
+    pixDestroy(&pixb1);
+    pixDestroy(&pixb2);
+    pixDestroy(&pixs2);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Area closing, and filtering by bounding box and extinction
+         * values on a min-tree */
+    pixa = pixaCreate(0);
+    pixaAddPix(pixa, pixs1, L_COPY);
+    pix1 = pixAreaClose(pixs1, 50, 8);
+    regTestWritePixAndCheck(rp, pix1, IFF_PNG);  /* 40 */
+    pixaAddPix(pixa, pix1, L_INSERT);
+    tree = maxtreeCreate(pixs1, L_MIN_TREE, 8);
+    pix1 = maxtreeFilter(tree, L_MT_BBOX_WIDTH, 12);
+    regTestWritePixAndCheck(rp, pix1, IFF_PNG);  /* 41 */
+    pixaAddPix(pixa, pix1, L_INSERT);
+    pix1 = maxtreeExtinctionFilter(tree, L_MT_CONTRAST, 10);
+    regTestWritePixAndCheck(rp, pix1, IFF_PNG);  /* 42 */
+    pixaAddPix(pixa, pix1, L_INSERT);
+    pix1 = pixaDisplayTiledInColumns(pixa, 4, 1.0, 15, 2);
+    pixDisplayWithTitle(pix1, 100, 600, "max-tree filters", rp->display);
+    pixDestroy(&pix1);
+    pixaDestroy(&pixa);
+    maxtreeDestroy(&tree);
+
+        /* Max-tree filters on 16 bpp.  The conversion multiplies each
+         * level by 257, and with the height also multiplied by 257,
+         * the results are those at 8 bpp, converted in the same way. */
+    pixs2 = pixConvert8To16(pixs1, 8);
+    pix1 = pixHMax(pixs2, 40 * 257, 8);
+    pix2 = pixHMax(pixs1, 40, 8);
+    pixs3 = pixConvert8To16(pix2, 8);
+    regTestComparePix(rp, pix1, pixs3);  /* 43 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs3);
+    pix1 = pixHMin(pixs2, 40 * 257, 4);
+    pix2 = pixHMin(pixs1, 40, 4);
+    pixs3 = pixConvert8To16(pix2, 8);
+    regTestComparePix(rp, pix1, pixs3);  /* 44 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs3);
+    pix1 = pixAreaClose(pixs2, 50, 8);
+    pix2 = pixAreaClose(pixs1, 50, 8);
+    pixs3 = pixConvert8To16(pix2, 8);
+    regTestComparePix(rp, pix1, pixs3);  /* 45 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs3);
+    pixDestroy(&pixs2);
+    pixDestroy(&pixs1);
+
     pixDestroy(&pixm);
     pixDestroy(&pixmi);
     pixDestroy(&pixmin);
@@ -46,6 +46,13 @@
  *
  *      (6) Playing around: extract the feynman diagrams from
  *          the stamp, using the tophat.
+ *
+ *      (7) Tests grayscale morphology on 16 bpp images, which must
+ *          give the same result as on 8 bpp.
+ *
+ *      (8) Tests granulometry, comparing the size distribution with
+ *          the result of separate openings, for 8 and 1 bpp, and
+ *          area granulometry for 8 bpp.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -57,15 +64,20 @@
 #define     WSIZE              7
 #define     HSIZE              7
 
+static l_float32 SumPixelValues(PIX *pix);
+
 int main(int    argc,
          char **argv)
 {
 char          seq[512];
-l_int32       w, h;
+l_int32       i, w, h, size, count;
+l_float32     val;
+BOX          *box;
 PIX          *pixs, *pix1, *pix2, *pix3, *pix4, *pix5;
 PIXA         *pixa;
 PIXACC       *pacc;
 PIXCMAP      *cmap;
+NUMA         *na;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -328,5 +340,103 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix1);
     pixDestroy(&pixs);
 
+    /* =========================================================== */
+
+    /* -------------- Erosion and closing at 16 bpp --------------- */
+    pixs = pixRead("aneurisms8.jpg");
+    pix1 = pixConvert8To16(pixs, 8);
+    pix2 = pixErodeGray(pix1, 9, 15);
+    pix3 = pixConvert16To8(pix2, L_MS_BYTE);
+    pix4 = pixErodeGray(pixs, 9, 15);
+    regTestComparePix(rp, pix3, pix4);  /* 43 */
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    pix2 = pixCloseGray(pix1, 21, 5);
+    pix3 = pixConvert16To8(pix2, L_MS_BYTE);
+    pix4 = pixCloseGray(pixs, 21, 5);
+    regTestComparePix(rp, pix3, pix4);  /* 44 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    pixDestroy(&pixs);
+
+    /* =========================================================== */
+
+    /* ----------------------- Granulometry ----------------------- */
+        /* A black border keeps the gray Sels within the image */
+    pixs = pixRead("aneurisms8.jpg");
+    pixGranulometry(pixs, L_BOTH_DIRECTIONS, 11, NULL, &na);
+    pix1 = pixAddBorder(pixs, 12, 0);
+    for (i = 0; i < 2; i++) {
+        size = (i == 0) ? 3 : 11;
+        pix2 = pixOpenGray(pix1, size, size);
+        numaGetFValue(na, size, &val);
+        regTestCompareValues(rp, SumPixelValues(pix2), val,
+                             0.00001 * val);  /* 45, 46 */
+        pixDestroy(&pix2);
+    }
+    numaDestroy(&na);
+    pixDestroy(&pix1);
+    pixDestroy(&pixs);
+
+    pixs = pixRead("feyn-fract.tif");
+    pixGranulometry(pixs, L_HORIZ, 20, NULL, &na);
+    pix1 = pixOpenBrick(NULL, pixs, 15, 1);
+    pixCountPixels(pix1, &count, NULL);
+    numaGetFValue(na, 15, &val);
+    regTestCompareValues(rp, count, val, 0.0);  /* 47 */
+    pixDestroy(&pix1);
+    numaDestroy(&na);
+    pixGranulometry(pixs, L_BOTH_DIRECTIONS, 6, NULL, &na);
+    pix1 = pixOpenBrick(NULL, pixs, 4, 4);
+    pixCountPixels(pix1, &count, NULL);
+    numaGetFValue(na, 4, &val);
+    regTestCompareValues(rp, count, val, 0.0);  /* 48 */
+    pixDestroy(&pix1);
+    numaDestroy(&na);
+    pixDestroy(&pixs);
+
+        /* Area granulometry of a grayscale image */
+    pixs = pixRead("aneurisms8.jpg");
+    pixAreaGranulometry(pixs, 8, 100, NULL, &na);
+    pix1 = pixAreaOpen(pixs, 60, 8);
+    numaGetFValue(na, 60, &val);
+    regTestCompareValues(rp, SumPixelValues(pix1), val,
+                         0.00001 * val);  /* 49 */
+    pixDestroy(&pix1);
+    numaDestroy(&na);
+
+        /* The root is kept by area openings larger than the image */
+    pix2 = pixClipRectangle(pixs, box = boxCreate(100, 100, 6, 6), NULL);
+    boxDestroy(&box);
+    pixAreaGranulometry(pix2, 8, 50, NULL, &na);
+    pix1 = pixAreaOpen(pix2, 40, 8);
+    numaGetFValue(na, 40, &val);
+    regTestCompareValues(rp, SumPixelValues(pix1), val, 0.0);  /* 50 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    numaDestroy(&na);
+    pixDestroy(&pixs);
+
     return regTestCleanup(rp);
 }
+
+
+static l_float32
+SumPixelValues(PIX  *pix)
+{
+l_int32    i;
+l_float32  val;
+l_float64  sum;
+NUMA      *na;
+
+    na = pixGetGrayHistogram(pix, 1);
+    for (i = 0, sum = 0.0; i < 256; i++) {
+        numaGetFValue(na, i, &val);
+        sum += (l_float64)i * val;
+    }
+    numaDestroy(&na);
+    return (l_float32)sum;
+}
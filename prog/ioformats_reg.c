@@ -51,7 +51,9 @@
  *
  *    Section 7. Miscellaneous additional tests
  *
- *    Section 8. Test header reading
+ *    Section 8. Test header reading, including batch reading with a cache
+ *
+ *    Section 9. Test push decoding, with the data supplied in small chunks
  *
  *    This test requires the following external I/O libraries
  *        libjpeg, libtiff, libpng, libz
@@ -90,7 +92,10 @@ static l_int32 testcomp_mem(PIX *pixs, PIX **ppixt, l_int32 index,
 static l_int32 test_writemem(PIX *pixs, l_int32 format, char *psfile);
 static PIX *make_24_bpp_pix(PIX *pixs);
 static l_int32 get_header_data(const char *filename, l_int32 true_format);
+static l_int32 get_batch_header_data(SARRAY *sa);
 static const char *get_tiff_compression_name(l_int32 format);
+static l_int32 test_push_decode(const char *filename, size_t chunksize,
+                                l_int32 minbands);
 
 LEPT_DLL extern const char *ImageFileFormatExtensions[];
 
@@ -104,9 +109,11 @@ l_int32       i, d, n, success, failure, same;
 l_int32       w, h, bps, spp, iscmap, res;
 size_t        size, nbytes;
 PIX          *pix1, *pix2, *pix3, *pix4, *pix5, *pix6, *pix8, *pix16, *pix32;
+BOX          *box;
 PIX          *pix, *pixt, *pixd;
 PIXA         *pixa;
 PIXCMAP      *cmap;
+SARRAY       *sa;
 L_REGPARAMS  *rp;
 
 #if  !HAVE_LIBJPEG
@@ -707,12 +714,76 @@ part6:
     lept_rmfile(tempname);
     lept_free(tempname);
 
+        /* Batch header reading, with and without the cache */
+    sa = sarrayCreate(0);
+    sarrayAddString(sa, BMP_FILE, L_COPY);
+    sarrayAddString(sa, FILE_1BPP, L_COPY);
+    sarrayAddString(sa, FILE_4BPP_C, L_COPY);
+    sarrayAddString(sa, FILE_8BPP_3, L_COPY);
+    sarrayAddString(sa, FILE_16BPP, L_COPY);
+    sarrayAddString(sa, FILE_32BPP_ALPHA, L_COPY);
+    sarrayAddString(sa, "weasel2.4c.bmp", L_COPY);
+        /* The colormap of a 1 bpp bmp is removed when it is read */
+    pix1 = pixRead(FILE_1BPP);
+    pix2 = pixClipRectangle(pix1, box = boxCreate(0, 0, 200, 100), NULL);
+    boxDestroy(&box);
+    cmap = pixcmapCreate(1);
+    pixcmapAddColor(cmap, 255, 255, 0);
+    pixcmapAddColor(cmap, 0, 0, 255);
+    pixSetColormap(pix2, cmap);
+    pixWrite("/tmp/lept/regout/cmap1color.bmp", pix2, IFF_BMP);
+    cmap = pixcmapCreate(1);
+    pixcmapAddColor(cmap, 200, 200, 200);
+    pixcmapAddColor(cmap, 50, 50, 50);
+    pixSetColormap(pix2, cmap);
+    pixWrite("/tmp/lept/regout/cmap1gray.bmp", pix2, IFF_BMP);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    sarrayAddString(sa, "/tmp/lept/regout/cmap1color.bmp", L_COPY);
+    sarrayAddString(sa, "/tmp/lept/regout/cmap1gray.bmp", L_COPY);
+    if (get_batch_header_data(sa)) success = FALSE;
+    sarrayDestroy(&sa);
+
     if (success)
         lept_stderr( "\n  ******* Success on reading headers *******\n\n");
     else
         lept_stderr( "\n  ******* Failure on reading headers *******\n\n");
     if (!success) failure = TRUE;
 
+    /* ------------------ Part 9: Push decoding ------------------ */
+    success = TRUE;
+        /* Rows are decoded as the data arrives */
+    if (test_push_decode(FILE_2BPP_C, 100, 2)) success = FALSE;
+    if (test_push_decode(FILE_8BPP_1, 1000, 2)) success = FALSE;
+    if (test_push_decode(FILE_8BPP_2, 1000, 2)) success = FALSE;
+    if (test_push_decode(FILE_8BPP_3, 500, 2)) success = FALSE;
+    if (test_push_decode(FILE_32BPP, 1000, 2)) success = FALSE;
+    if (test_push_decode(FILE_32BPP_ALPHA, 100, 2)) success = FALSE;
+    if (test_push_decode(FILE_1BIT_ALPHA, 50, 2)) success = FALSE;
+    if (test_push_decode(FILE_CMAP_ALPHA, 50, 2)) success = FALSE;
+    if (test_push_decode(FILE_GRAY_ALPHA, 100, 2)) success = FALSE;
+#if  HAVE_LIBWEBP
+    pix = pixRead(FILE_32BPP);
+    tempname = l_makeTempFilename();
+    pixWrite(tempname, pix, IFF_WEBP);
+    if (test_push_decode(tempname, 1000, 2)) success = FALSE;
+    lept_rmfile(tempname);
+    lept_free(tempname);
+    pixDestroy(&pix);
+#endif  /* HAVE_LIBWEBP */
+        /* Tiff strips are decoded as they arrive if the directory is
+         * at the front.  This file has 16 strips after the directory. */
+    if (test_push_decode("karen8-strips.tif", 5000, 16)) success = FALSE;
+        /* Decoded only when all the data has arrived */
+    if (test_push_decode(FILE_1BPP, 1000, 0)) success = FALSE;
+    if (test_push_decode(FILE_16BPP, 1000, 0)) success = FALSE;
+    if (test_push_decode(BMP_FILE, 1000, 0)) success = FALSE;
+    if (success)
+        lept_stderr("\n  ******* Success on push decoding *******\n\n");
+    else
+        lept_stderr("\n  ******* Failure on push decoding *******\n\n");
+    if (!success) failure = TRUE;
+
 #if  !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF
 finish:
 #endif  /* !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF */
@@ -975,6 +1046,67 @@ size_t      size1, size2;
 }
 
 
+    /* Compare batch header data with the pix that are read from the
+     * files; returns 1 on error */
+static l_int32
+get_batch_header_data(SARRAY  *sa)
+{
+const char  *cachefile = "/tmp/lept/regout/headercache.txt";
+char        *fname;
+l_int32      i, j, n, format, w, h, d, bps, spp, iscmap, ival, bad;
+l_int32      ret = 0;
+NUMA        *naf, *naw, *nah, *nabps, *naspp, *nacmap;
+PIX         *pix;
+
+    lept_rmfile(cachefile);
+    n = sarrayGetCount(sa);
+    for (j = 0; j < 2; j++) {  /* the second pass reads from the cache */
+        pixReadHeadersSA(sa, cachefile, &naf, &naw, &nah, &nabps, &naspp,
+                         NULL, NULL, &nacmap);
+        for (i = 0; i < n; i++) {
+            fname = sarrayGetString(sa, i, L_NOCOPY);
+            findFileFormat(fname, &format);
+            if ((pix = pixRead(fname)) == NULL) {
+                lept_stderr("Error: can't read %s\n", fname);
+                ret = 1;
+                continue;
+            }
+            pixGetDimensions(pix, &w, &h, &d);
+            spp = pixGetSpp(pix);
+            bps = (d == 32) ? 8 : d;
+            iscmap = (pixGetColormap(pix) != NULL) ? 1 : 0;
+            pixDestroy(&pix);
+            numaGetIValue(naf, i, &ival);
+            bad = (ival != format);
+            numaGetIValue(naw, i, &ival);
+            bad |= (ival != w);
+            numaGetIValue(nah, i, &ival);
+            bad |= (ival != h);
+            numaGetIValue(nabps, i, &ival);
+            bad |= (ival != bps);
+            numaGetIValue(naspp, i, &ival);
+            bad |= (ival != spp);
+            numaGetIValue(nacmap, i, &ival);
+            bad |= (ival != iscmap);
+            if (bad) {
+                lept_stderr("Error: header data differs from pix: %s\n",
+                            fname);
+                ret = 1;
+            }
+        }
+        numaDestroy(&naf);
+        numaDestroy(&naw);
+        numaDestroy(&nah);
+        numaDestroy(&nabps);
+        numaDestroy(&naspp);
+        numaDestroy(&nacmap);
+    }
+    if (ret)
+        lept_stderr("Error: inconsistent batch header data\n");
+    return ret;
+}
+
+
 static const char *
 get_tiff_compression_name(l_int32  format)
 {
@@ -999,3 +1131,92 @@ get_tiff_compression_name(l_int32  format)
         lept_stderr("format %d: not tiff\n", format);
     return tiff_compression_name;
 }
+
+
+    /* Feeds the file to a push decoder in chunks.  Returns 1 on error,
+     * or if fewer than %minbands bands are delivered before the
+     * decoder is told that all the data has arrived. */
+static l_int32
+test_push_decode(const char  *filename,
+                 size_t       chunksize,
+                 l_int32      minbands)
+{
+l_uint8    *data;
+l_int32     i, y, nextrow, nbands, nearly, same, ret;
+size_t      size, offset, n;
+BOX        *box;
+L_PUSHDEC  *pd;
+PIX        *pix1, *pix2, *pix3, *pixb;
+PIXA       *pixa;
+
+    data = l_binaryRead(filename, &size);
+    pix1 = pixRead(filename);
+    if (!data || !pix1) {
+        lept_stderr("Error: failure to read %s\n", filename);
+        lept_free(data);
+        pixDestroy(&pix1);
+        return 1;
+    }
+
+        /* Feed the data in chunks, collecting the bands as they appear */
+    ret = 0;
+    nextrow = 0;
+    pixa = pixaCreate(0);
+    pd = pushdecCreate(IFF_UNKNOWN);
+    for (offset = 0; offset < size; offset += chunksize) {
+        n = L_MIN(chunksize, size - offset);
+        if (pushdecFeed(pd, data + offset, n)) {
+            ret = 1;
+            break;
+        }
+        while ((pixb = pushdecGetBand(pd, &y)) != NULL) {
+            if (y != nextrow) ret = 1;
+            nextrow += pixGetHeight(pixb);
+            pixaAddPix(pixa, pixb, L_INSERT);
+        }
+    }
+    nearly = pixaGetCount(pixa);  /* bands delivered before the end */
+    if (pushdecFinish(pd)) ret = 1;
+    while ((pixb = pushdecGetBand(pd, &y)) != NULL) {
+        if (y != nextrow) ret = 1;
+        nextrow += pixGetHeight(pixb);
+        pixaAddPix(pixa, pixb, L_INSERT);
+    }
+    pix2 = pushdecGetPix(pd);
+    pushdecDestroy(&pd);
+
+        /* The image must be the same as with pixRead(), and each band
+         * must match its part of the image, unless the band still has
+         * a 1 bpp colormap that is removed at the end. */
+    nbands = pixaGetCount(pixa);
+    same = 0;
+    if (pix2) pixEqualWithAlpha(pix1, pix2, 1, &same);
+    if (!same || nextrow != pixGetHeight(pix1) || nearly < minbands)
+        ret = 1;
+    for (i = 0, y = 0; i < nbands && pix2; i++) {
+        pixb = pixaGetPix(pixa, i, L_CLONE);
+        if (pixGetDepth(pixb) == pixGetDepth(pix2)) {
+            box = boxCreate(0, y, pixGetWidth(pix2), pixGetHeight(pixb));
+            pix3 = pixClipRectangle(pix2, box, NULL);
+            pixSetSpp(pix3, pixGetSpp(pix2));
+            pixEqualWithAlpha(pixb, pix3, 1, &same);
+            if (!same) ret = 1;
+            boxDestroy(&box);
+            pixDestroy(&pix3);
+        }
+        y += pixGetHeight(pixb);
+        pixDestroy(&pixb);
+    }
+    if (ret)
+        lept_stderr("Error: push decoding of %s, nbands = %d (%d early)\n",
+                    filename, nbands, nearly);
+    else
+        lept_stderr("Push decoding of %s: %d bands (%d early)\n", filename,
+                    nbands, nearly);
+
+    pixaDestroy(&pixa);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    lept_free(data);
+    return ret;
+}
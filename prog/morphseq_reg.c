@@ -29,6 +29,9 @@
  *
  *    Simple regression test for binary morph sequence (interpreter),
  *    showing display mode and rejection of invalid sequence components.
+ *    Also checks that a compiled sequence gives the same result as
+ *    the interpreter, for each of the four brick methods and for
+ *    both boundary conditions.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -42,19 +45,26 @@
 #define  SEQUENCE3    "e3.3 + d3.3 + tw5.5"
 #define  SEQUENCE4    "O3.3 + C3.3"
 #define  SEQUENCE5    "O5.5 + C5.5"
+#define  SEQUENCE6    "e3.3 + d3.3 + d5.1 + e5.1 + C9.2 + E2.3"
+#define  SEQUENCE7    "e8.1 + d8.1"
+#define  SEQUENCE8    "b32 + d1.8 + e1.8 + e5.5 + d5.5"
 #define  BAD_SEQUENCE  "O1.+D8 + E2.4 + e.4 + r25 + R + R.5 + X + x5 + y7.3"
 
 #define  DISPLAY_SEPARATION   0   /* use 250 to get images displayed */
 
+static void TestPlans(L_REGPARAMS *rp, PIX *pixs, l_int32 symmetric);
+
+
 int main(int    argc,
          char **argv)
 {
-PIX  *pixs, *pixg, *pixc, *pixd;
+BOX          *box;
+PIX          *pixs, *pixg, *pixc, *pixd, *pix1;
+L_REGPARAMS  *rp;
 
-    if (argc != 1)
-        return ERROR_INT(" Syntax:  morphseq_reg", __func__, 1);
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
 
-    setLeptDebugOK(1);
     lept_mkdir("lept");
     pixs = pixRead("feyn.tif");
 
@@ -86,6 +96,19 @@ PIX  *pixs, *pixg, *pixc, *pixd;
     pixWrite("/tmp/lept/morphseq4.png", pixd, IFF_PNG);
     pixDestroy(&pixd);
 
+        /* Compiled sequences, with both boundary conditions.  Clip so
+         * that there is foreground at the edge of the image, where
+         * the boundary conditions matter. */
+    pixd = pixRead("feyn-fract.tif");
+    box = boxCreate(7, 3, 203, 180);
+    pix1 = pixClipRectangle(pixd, box, NULL);
+    boxDestroy(&box);
+    pixDestroy(&pixd);
+    TestPlans(rp, pix1, FALSE);
+    TestPlans(rp, pix1, TRUE);
+    resetMorphBoundaryCondition(ASYMMETRIC_MORPH_BC);
+    pixDestroy(&pix1);
+
         /* 8 bpp */
     pixg = pixScaleToGray(pixs, 0.25);
     pixd = pixGrayMorphSequence(pixg, SEQUENCE3, -5, 150);
@@ -116,5 +139,47 @@ PIX  *pixs, *pixg, *pixc, *pixd;
 
     pixDestroy(&pixg);
     pixDestroy(&pixs);
-    return 0;
+    return regTestCleanup(rp);
+}
+
+
+    /* Compares each compiled sequence with the interpreter for the
+     * same method.  Each plan is applied twice, to check that reusing
+     * its scratch image does not change the result. */
+static void
+TestPlans(L_REGPARAMS  *rp,
+          PIX          *pixs,
+          l_int32       symmetric)
+{
+const char   *sequence[4] = {SEQUENCE1, SEQUENCE6, SEQUENCE7, SEQUENCE8};
+l_int32       i, method;
+L_MORPHPLAN  *plan;
+PIX          *pixd, *pix1, *pix2;
+
+    if (symmetric)
+        resetMorphBoundaryCondition(SYMMETRIC_MORPH_BC);
+    else
+        resetMorphBoundaryCondition(ASYMMETRIC_MORPH_BC);
+
+    for (method = L_MORPH_SEQ_ROP; method <= L_MORPH_SEQ_COMP_DWA; method++) {
+        for (i = 0; i < 4; i++) {
+            if (method == L_MORPH_SEQ_ROP)
+                pixd = pixMorphSequence(pixs, sequence[i], 0);
+            else if (method == L_MORPH_SEQ_COMP_ROP)
+                pixd = pixMorphCompSequence(pixs, sequence[i], 0);
+            else if (method == L_MORPH_SEQ_DWA)
+                pixd = pixMorphSequenceDwa(pixs, sequence[i], 0);
+            else  /* L_MORPH_SEQ_COMP_DWA */
+                pixd = pixMorphCompSequenceDwa(pixs, sequence[i], 0);
+            plan = morphPlanCreate(sequence[i], method);
+            pix1 = pixApplyMorphPlan(pixs, plan);
+            pix2 = pixApplyMorphPlan(pixs, plan);
+            regTestComparePix(rp, pixd, pix1);
+            regTestComparePix(rp, pixd, pix2);
+            pixDestroy(&pixd);
+            pixDestroy(&pix1);
+            pixDestroy(&pix2);
+            morphPlanDestroy(&plan);
+        }
+    }
 }
@@ -29,12 +29,14 @@
  *
  *    Tests the fast (uncompressed) serialization of pix to a string
  *    in memory and the deserialization back to a pix.
+ *    Also tests the page-aligned mpix container for pix, pixa and fpix.
  */
 
 #ifdef HAVE_CONFIG_H
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
     /* Use this set */
@@ -57,12 +59,16 @@ int main(int    argc,
 {
 char          buf[256];
 size_t        size;
-l_int32       i, w, h;
+l_int32       i, w, h, wpl, same;
 l_int32       format, bps, spp, iscmap, format2, w2, h2, bps2, spp2, iscmap2;
 l_uint8      *data;
 l_uint32     *data32, *data32r;
 BOX          *box;
+BOXA         *boxa1, *boxa2;
+FPIX         *fpixs, *fpixd;
+L_MPIX       *mp;
 PIX          *pixs, *pixt, *pixt2, *pixd;
+PIXA         *pixa1, *pixa2;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -124,6 +130,69 @@ L_REGPARAMS  *rp;
         lept_free(data);
     }
 
+            /* Test mpix containers with a single pix.  The raster
+             * view must be identical to the pix data. */
+    for (i = 0; i < nfiles; i++) {
+        pixs = pixRead(filename[i]);
+        pixSetText(pixs, filename[i]);
+        pixWriteMpix("/tmp/lept/regout/pixs.mpix", pixs);
+        mp = mpixOpen("/tmp/lept/regout/pixs.mpix");
+        pixd = mpixGetPix(mp, 0);
+        regTestComparePix(rp, pixs, pixd);  /* 3 * nfiles + 2 * i */
+        pixGetDimensions(pixs, &w, &h, NULL);
+        data32 = (l_uint32 *)mpixGetRaster(mp, 0, &wpl);
+        same = (wpl == pixGetWpl(pixs)) &&
+               !memcmp(data32, pixGetData(pixs), 4 * wpl * h);
+        same = same && !strcmp(mpixGetText(mp, 0), filename[i]);
+        regTestCompareValues(rp, 1, same, 0);  /* 3 * nfiles + 2 * i + 1 */
+        mpixClose(&mp);
+        pixDestroy(&pixs);
+        pixDestroy(&pixd);
+    }
+
+            /* Test mpix containers with pixa and boxes */
+    pixa1 = pixaCreate(nfiles);
+    for (i = 0; i < nfiles; i++) {
+        pixs = pixRead(filename[i]);
+        pixGetDimensions(pixs, &w, &h, NULL);
+        pixaAddPix(pixa1, pixs, L_INSERT);
+        pixaAddBox(pixa1, boxCreate(i, 2 * i, w, h), L_INSERT);
+    }
+    pixaWriteMpix("/tmp/lept/regout/pixa.mpix", pixa1);
+    mp = mpixOpen("/tmp/lept/regout/pixa.mpix");
+    pixa2 = mpixGetPixa(mp);
+    regTestCompareValues(rp, nfiles, mpixGetCount(mp), 0);  /* 5 * nfiles */
+    for (i = 0; i < nfiles; i++) {
+        pixs = pixaGetPix(pixa1, i, L_CLONE);
+        pixd = pixaGetPix(pixa2, i, L_CLONE);
+        regTestComparePix(rp, pixs, pixd);  /* 5 * nfiles + 1 + i */
+        pixDestroy(&pixs);
+        pixDestroy(&pixd);
+    }
+    boxa1 = pixaGetBoxa(pixa1, L_CLONE);
+    boxa2 = pixaGetBoxa(pixa2, L_CLONE);
+    boxaEqual(boxa1, boxa2, 0, NULL, &same);
+    regTestCompareValues(rp, 1, same, 0);  /* 6 * nfiles + 1 */
+    mpixClose(&mp);
+    boxaDestroy(&boxa1);
+    boxaDestroy(&boxa2);
+    pixaDestroy(&pixa1);
+    pixaDestroy(&pixa2);
+
+            /* Test mpix container with fpix */
+    pixs = pixRead("karen8.jpg");
+    fpixs = pixConvertToFPix(pixs, 1);
+    fpixWriteMpix("/tmp/lept/regout/fpix.mpix", fpixs);
+    mp = mpixOpen("/tmp/lept/regout/fpix.mpix");
+    fpixd = mpixGetFPix(mp, 0);
+    pixd = fpixConvertToPix(fpixd, 8, L_CLIP_TO_ZERO, 0);
+    regTestComparePix(rp, pixs, pixd);  /* 6 * nfiles + 2 */
+    mpixClose(&mp);
+    fpixDestroy(&fpixs);
+    fpixDestroy(&fpixd);
+    pixDestroy(&pixs);
+    pixDestroy(&pixd);
+
 #if 0
         /* Do timing */
     for (i = 0; i < nfiles; i++) {
@@ -70,6 +70,7 @@
 
 static l_int32 test_file_png(const char *fname, const char *dirout);
 static l_int32 test_mem_png(const char *fname);
+static l_int32 test_preset_png(const char *fname);
 static l_int32 get_header_data(const char *filename);
 static l_int32 test_1bpp_trans(L_REGPARAMS *rp);
 static l_int32 test_1bpp_color(L_REGPARAMS *rp);
@@ -222,6 +223,22 @@ L_REGPARAMS  *rp;
     }
     if (!success) failure = TRUE;
 
+    /* ------------ Part 5: Test lossless r/w with presets ------------ */
+    success = TRUE;
+    if (test_preset_png(FILE_1BPP)) success = FALSE;
+    if (test_preset_png(FILE_4BPP)) success = FALSE;
+    if (test_preset_png(FILE_8BPP)) success = FALSE;
+    if (test_preset_png(FILE_8BPP_C)) success = FALSE;
+    if (test_preset_png(FILE_16BPP)) success = FALSE;
+    if (test_preset_png(FILE_32BPP)) success = FALSE;
+    if (test_preset_png(FILE_32BPP_ALPHA)) success = FALSE;
+    if (success) {
+        lept_stderr("\n  ******* Success on png presets *******\n\n");
+    } else {
+        lept_stderr("\n  ******* Failure on png presets *******\n\n");
+    }
+    if (!success) failure = TRUE;
+
     if (!failure) {
         lept_stderr("  ******* Success on all tests *******\n\n");
     } else {
@@ -299,6 +316,47 @@ PIX      *pixd = NULL;
     return (!same);
 }
 
+    /* Preset r/w test for each preset.  Returns 1 on error */
+static l_int32
+test_preset_png(const char  *fname)
+{
+l_uint8  *data;
+l_int32   i, same, ret;
+size_t    size;
+PIX      *pixs, *pix1, *pixd;
+
+    if ((pixs = pixRead(fname)) == NULL) {
+        lept_stderr("Failure to read %s\n", fname);
+        return 1;
+    }
+
+    ret = 0;
+    for (i = L_PNG_DEFAULT_PRESET; i <= L_PNG_SMALL_PRESET; i++) {
+        pix1 = pixCopy(NULL, pixs);
+        pixSetPngPreset(pix1, i);
+        data = NULL;
+        pixd = NULL;
+        if (pixWriteMemPng(&data, &size, pix1, 0.0) == 0)
+            pixd = pixReadMemPng(data, size);
+        same = FALSE;
+        if (pixd) {
+            if (pixGetSpp(pixs) == 4)
+                pixEqualWithAlpha(pixs, pixd, 1, &same);
+            else
+                pixEqual(pixs, pixd, &same);
+        }
+        if (!same) {
+            lept_stderr("Preset %d write/read fail for file %s\n", i, fname);
+            ret = 1;
+        }
+        pixDestroy(&pix1);
+        pixDestroy(&pixd);
+        lept_free(data);
+    }
+    pixDestroy(&pixs);
+    return ret;
+}
+
     /* Retrieve header data from file and from array in memory */
 static l_int32
 get_header_data(const char  *filename)
@@ -36,6 +36,7 @@
 #include "allheaders.h"
 
 static void MakePtas(l_int32 i, PTA **pptas, PTA **pptad);
+static PIX *ProjectivePointwise(PIX *pixs, l_float32 *vc, l_uint32 val);
 
     /* Sample values.
      *    1-3: invertability tests
@@ -60,6 +61,12 @@ static const l_int32  yp3[] = { 200,  300,  250,  325,   83};
 static const l_int32  xp4[] = {1250, 1200,  240, 1250,  412};
 static const l_int32  yp4[] = { 300,  300,  250,  350,   83};
 
+    /* Translation by (-10, -5), as a transform from dest to src */
+static l_float32  Translate[] = {1.0, 0.0, 10.0, 0.0, 1.0, 5.0};
+
+    /* Translation by (-0.3, -0.5), as a projective transform */
+static l_float32  SubpixelShift[] = {1.0, 0.0, 0.3, 0.0, 1.0, 0.5, 0.0, 0.0};
+
 #define   ADDED_BORDER_PIXELS       250
 #define   ALL     1
 
@@ -67,10 +74,12 @@ static const l_int32  yp4[] = { 300,  300,  250,  350,   83};
 int main(int    argc,
          char **argv)
 {
-l_int32       i;
+l_int32       i, w, h, count;
+l_float32    *vc;
 PIX          *pixs, *pixsc, *pixb, *pixg, *pixc, *pixcs, *pix1, *pix2, *pixd;
 PIXA         *pixa;
 PTA          *ptas, *ptad;
+L_REMAP      *remap1, *remap2, *remap3;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -209,6 +218,91 @@ L_REGPARAMS  *rp;
     ptaDestroy(&ptad);
 #endif
 
+#if ALL
+        /* Compare line-incremental with pointwise interpolation.  The
+         * last case is a translation by a fraction of a pixel, which
+         * takes the bottom dest line from the last src line. */
+    lept_stderr("Compare incremental with pointwise interpolation\n");
+    pixc = pixRead("test24.jpg");
+    pixcs = pixScale(pixc, 0.5, 0.5);
+    pixg = pixConvertRGBToLuminance(pixcs);
+    MakePtas(3, &ptas, &ptad);
+    getProjectiveXformCoeffs(ptad, ptas, &vc);
+    pix1 = pixProjectiveGray(pixg, vc, 255);
+    pix2 = ProjectivePointwise(pixg, vc, 255);
+    regTestComparePix(rp, pix1, pix2);  /* 34 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixProjectiveColor(pixcs, vc, 0xffffff00);
+    pix2 = ProjectivePointwise(pixcs, vc, 0xffffff00);
+    regTestComparePix(rp, pix1, pix2);  /* 35 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixProjectiveGray(pixg, SubpixelShift, 255);
+    pix2 = ProjectivePointwise(pixg, SubpixelShift, 255);
+    regTestComparePix(rp, pix1, pix2);  /* 36 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pix1 = pixProjectiveColor(pixcs, SubpixelShift, 0xffffff00);
+    pix2 = ProjectivePointwise(pixcs, SubpixelShift, 0xffffff00);
+    regTestComparePix(rp, pix1, pix2);  /* 37 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixc);
+    pixDestroy(&pixcs);
+    pixDestroy(&pixg);
+    ptaDestroy(&ptas);
+    ptaDestroy(&ptad);
+    lept_free(vc);
+#endif
+
+#if ALL
+        /* Test precomputed remaps */
+    lept_stderr("Test remaps\n");
+    pixc = pixRead("test24.jpg");
+    pixcs = pixScale(pixc, 0.5, 0.5);
+    pixGetDimensions(pixcs, &w, &h, NULL);
+    MakePtas(3, &ptas, &ptad);
+    getProjectiveXformCoeffs(ptad, ptas, &vc);
+    remap1 = remapCreateProjective(vc, w, h, w, h);
+    pix1 = pixProjectiveColor(pixcs, vc, 0xffffff00);
+    pix2 = pixRemap(pixcs, remap1, L_INTERPOLATED, L_BRING_IN_WHITE);
+    regTestCompareSimilarPix(rp, pix1, pix2, 2, 0.01, 0);  /* 38 */
+    pixDestroy(&pix1);
+
+        /* Compose with a translation, and compare with two steps */
+    remap2 = remapCreateAffine(Translate, w, h, w, h);
+    remap3 = remapCompose(remap1, remap2);
+    pix1 = pixRemap(pixcs, remap3, L_INTERPOLATED, L_BRING_IN_WHITE);
+    pixd = pixRemap(pix2, remap2, L_INTERPOLATED, L_BRING_IN_WHITE);
+    regTestCompareSimilarPix(rp, pix1, pixd, 2, 0.01, 0);  /* 39 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixd);
+
+        /* Sampling on 1 bpp */
+    pix1 = pixScale(pixs, 0.5, 0.5);
+    remapDestroy(&remap1);
+    pixGetDimensions(pix1, &w, &h, NULL);
+    remap1 = remapCreateProjective(vc, w, h, w, h);
+    pix2 = pixProjectiveSampled(pix1, vc, L_BRING_IN_WHITE);
+    pixd = pixRemap(pix1, remap1, L_SAMPLED, L_BRING_IN_WHITE);
+    pixXor(pixd, pixd, pix2);
+    pixCountPixels(pixd, &count, NULL);
+    regTestCompareValues(rp, 0.0, (l_float32)count / (w * h), 0.002);  /* 40 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixd);
+    pixDestroy(&pixc);
+    pixDestroy(&pixcs);
+    ptaDestroy(&ptas);
+    ptaDestroy(&ptad);
+    lept_free(vc);
+    remapDestroy(&remap1);
+    remapDestroy(&remap2);
+    remapDestroy(&remap3);
+#endif
+
     pixDestroy(&pixs);
     return regTestCleanup(rp);
 }
@@ -232,3 +326,53 @@ MakePtas(l_int32  i,
     return;
 }
 
+
+    /* Pointwise transform, used to check the line-incremental one.
+     * The src location is found in double precision and truncated
+     * to 1/16 pixel, as in the line-incremental version. */
+static PIX *
+ProjectivePointwise(PIX        *pixs,
+                    l_float32  *vc,
+                    l_uint32    val)
+{
+l_int32    i, j, w, h, d, wpls, gval;
+l_uint32   cval;
+l_uint32  *datas;
+l_float32  x, y;
+l_float64  xd, yd, denom;
+PIX       *pix1, *pix2, *pixd;
+
+    pixGetDimensions(pixs, &w, &h, &d);
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    pixd = pixCreateTemplate(pixs);
+    for (i = 0; i < h; i++) {
+        for (j = 0; j < w; j++) {
+            denom = (l_float64)vc[6] * j + (l_float64)vc[7] * i + 1.0;
+            xd = ((l_float64)vc[0] * j + (l_float64)vc[1] * i + vc[2]) / denom;
+            yd = ((l_float64)vc[3] * j + (l_float64)vc[4] * i + vc[5]) / denom;
+            x = y = -1.0;  /* outside the src */
+            if (xd >= 0.0 && yd >= 0.0 && xd < w && yd < h) {
+                x = (l_int32)(16.0 * xd) / 16.0;
+                y = (l_int32)(16.0 * yd) / 16.0;
+            }
+            if (d == 8) {
+                linearInterpolatePixelGray(datas, wpls, w, h, x, y, val, &gval);
+                pixSetPixel(pixd, j, i, gval);
+            } else {
+                linearInterpolatePixelColor(datas, wpls, w, h, x, y, val,
+                                            &cval);
+                pixSetPixel(pixd, j, i, cval);
+            }
+        }
+    }
+
+    if (d == 32 && pixGetSpp(pixs) == 4) {
+        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
+        pix2 = ProjectivePointwise(pix1, vc, 255);
+        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    return pixd;
+}
@@ -44,7 +44,7 @@ void RotateOrthTest(PIX *pix, L_REGPARAMS *rp);
 int main(int    argc,
          char **argv)
 {
-PIX          *pixs;
+PIX          *pixs, *pixt;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -62,6 +62,12 @@ L_REGPARAMS  *rp;
     pixs = pixRead(GRAYSCALE_IMAGE);
     RotateOrthTest(pixs, rp);
     pixDestroy(&pixs);
+    lept_stderr("\nTest 16 bpp image:\n");
+    pixt = pixRead(GRAYSCALE_IMAGE);
+    pixs = pixConvert8To16(pixt, 8);
+    RotateOrthTest(pixs, rp);
+    pixDestroy(&pixt);
+    pixDestroy(&pixs);
     lept_stderr("\nTest colormap image:\n");
     pixs = pixRead(COLORMAP_IMAGE);
     RotateOrthTest(pixs, rp);
@@ -99,6 +105,14 @@ PIX      *pixt, *pixd;
          pixCountPixels(pixd, &count, NULL);
          lept_stderr("Failure for four 90-degree rots; count = %d\n", count);
     }
+    pixDestroy(&pixd);
+
+	/* Test that cw rotation is the 180 degree rotation of ccw rotation */
+    pixt = pixRotate90(pixs, 1);
+    pixd = pixRotate90(pixs, -1);
+    pixRotate180(pixd, pixd);
+    regTestComparePix(rp, pixt, pixd);
+    pixDestroy(&pixt);
     pixDestroy(&pixd);
 
 	/* Test 2 successive 180 degree rotations */
@@ -56,6 +56,8 @@ static const l_float32  FACTOR[5] = {2.3f, 1.5f, 1.1f, 0.6f, 0.3f};
 static void AddScaledImages(PIXA *pixa, const char *fname, l_int32 width);
 static void PixaSaveDisplay(PIXA *pixa, L_REGPARAMS *rp);
 static void TestSmoothScaling(const char *fname, L_REGPARAMS *rp);
+static void TestFilterScaling(const char *fname, L_REGPARAMS *rp);
+static void TestScaleToGrayArea(const char *fname, L_REGPARAMS *rp);
 
 int main(int    argc,
          char **argv)
@@ -239,6 +241,12 @@ L_REGPARAMS  *rp;
 
         /* Test 32 bpp low-pass filtered smooth scaling */
     TestSmoothScaling("test24.jpg", rp);  /* 49 */
+
+        /* Test separable resampling with filter kernels */
+    TestFilterScaling("test24.jpg", rp);  /* 50 - 54 */
+
+        /* Test arbitrary scale-to-gray with area reduction */
+    TestScaleToGrayArea(image[0], rp);  /* 55 - 57 */
     return regTestCleanup(rp);
 }
 
@@ -305,3 +313,101 @@ PIXA      *pixa;
     pixDestroy(&pix2);
 }
 
+static void
+TestFilterScaling(const char *fname, L_REGPARAMS *rp)
+{
+l_int32  i, w, h;
+BOX     *box;
+PIX     *pixs, *pixg, *pix1, *pix2, *pix3, *pix4;
+PIXA    *pixa;
+
+    pixs = pixRead(fname);
+    pixg = pixConvertRGBToLuminance(pixs);
+
+        /* The area filter closely matches area mapping for reduction,
+         * except at the image boundary, where the edge pixels are
+         * weighted differently */
+    pix1 = pixScaleWithFilter(pixs, 0.37, 0.37, L_RESAMPLE_AREA);
+    pix2 = pixScaleAreaMap(pixs, 0.37, 0.37);
+    pix3 = pixRemoveBorder(pix1, 1);
+    pix4 = pixRemoveBorder(pix2, 1);
+    regTestCompareSimilarPix(rp, pix3, pix4, 4, 0.005, 0);  /* 50 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+
+        /* Interpolating kernels give the identity at unit scale */
+    pix1 = pixScaleWithFilter(pixg, 1.0, 1.0, L_RESAMPLE_LANCZOS3);
+    regTestComparePix(rp, pixg, pix1);  /* 51 */
+    pixDestroy(&pix1);
+
+        /* Alpha is filtered along with the color */
+    pix1 = pixCopy(NULL, pixs);
+    pixSetSpp(pix1, 4);
+    pixSetComponentArbitrary(pix1, L_ALPHA_CHANNEL, 128);
+    pix2 = pixScaleToSizeWithFilter(pix1, 517, 203, L_RESAMPLE_MITCHELL);
+    pixGetDimensions(pix2, &w, &h, NULL);
+    regTestCompareValues(rp, 4, pixGetSpp(pix2), 0);  /* 52 */
+    pix3 = pixGetRGBComponent(pix2, L_ALPHA_CHANNEL);
+    pixDestroy(&pix1);
+    pix1 = pixCreate(w, h, 8);
+    pixSetAllArbitrary(pix1, 128);
+    regTestComparePix(rp, pix1, pix3);  /* 53 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
+        /* Each kernel for reduction and expansion */
+    pixa = pixaCreate(8);
+    box = boxCreate(250, 150, 100, 80);
+    pix1 = pixClipRectangle(pixg, box, NULL);
+    for (i = L_RESAMPLE_AREA; i <= L_RESAMPLE_LANCZOS3; i++) {
+        pix2 = pixScaleWithFilter(pixs, 0.23, 0.23, i);
+        pixaAddPix(pixa, pix2, L_INSERT);
+        pix2 = pixScaleWithFilter(pix1, 3.1, 2.7, i);
+        pixaAddPix(pixa, pix2, L_INSERT);
+    }
+    pix2 = pixaDisplayTiledInColumns(pixa, 2, 1.0, 10, 2);
+    regTestWritePixAndCheck(rp, pix2, IFF_JFIF_JPEG);  /* 54 */
+    pixDisplayWithTitle(pix2, 0, 600, NULL, rp->display);
+    pixaDestroy(&pixa);
+    boxDestroy(&box);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixg);
+    pixDestroy(&pixs);
+}
+
+static void
+TestScaleToGrayArea(const char *fname, L_REGPARAMS *rp)
+{
+l_int32  w, h;
+BOX     *box;
+PIX     *pixs, *pix1, *pix2, *pix3;
+
+    pixs = pixRead(fname);
+    pixGetDimensions(pixs, &w, &h, NULL);
+
+        /* An exact integer reduction is just the scale-to-gray */
+    box = boxCreate(0, 0, w & 0xfffffff0, h & 0xfffffff0);
+    pix1 = pixClipRectangle(pixs, box, NULL);
+    pix2 = pixScaleToGrayArea(pix1, 0.125, 0.125);
+    pix3 = pixScaleToGray8(pix1);
+    regTestComparePix(rp, pix2, pix3);  /* 55 */
+    boxDestroy(&box);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
+        /* Otherwise, it is close to an area map of the full image */
+    pix1 = pixScaleToGrayArea(pixs, 0.2, 0.15);
+    pixGetDimensions(pix1, &w, &h, NULL);
+    pix2 = pixScaleToSizeWithFilter(pixs, w, h, L_RESAMPLE_AREA);
+    regTestCompareSimilarPix(rp, pix1, pix2, 40, 0.005, 0);  /* 56 */
+    regTestWritePixAndCheck(rp, pix1, IFF_PNG);  /* 57 */
+    pixDisplayWithTitle(pix1, 0, 900, NULL, rp->display);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs);
+}
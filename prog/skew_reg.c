@@ -57,10 +57,12 @@ static const l_int32  BORDER = 150;
 int main(int    argc,
          char **argv)
 {
-l_int32       w, h, wd, hd;
-l_float32     deg2rad, angle, conf;
-PIX          *pixs, *pixb1, *pixb2, *pixr, *pixf, *pixd, *pixc;
+l_int32       i, w, h, wd, hd, pivot, same;
+l_float32     deg2rad, degtorad, angle, conf, sum, angle2, conf2;
+NUMA         *na1, *na2, *na3;
+PIX          *pixs, *pixb1, *pixb2, *pixr, *pixf, *pixd, *pixc, *pix1, *pix2;
 PIXA         *pixa;
+PIXPYRAMID   *pyr;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -124,6 +126,53 @@ L_REGPARAMS  *rp;
     pixDisplayWithTitle(pixd, 100, 100, NULL, rp->display);
     pixDestroy(&pixd);
 
+        /* The sweep and search score sheared images from their row sums,
+         * without making the images.  Verify that the scores are the
+         * same as found from the sheared images. */
+    degtorad = 3.1415926535f / 180.f;  /* as in skew.c */
+    na1 = numaCreate(0);
+    for (i = -6; i <= 6; i++)
+        numaAddNumber(na1, 1.7 * i);
+    pix1 = pixCreateTemplate(pixb1);
+    for (pivot = L_SHEAR_ABOUT_CORNER; pivot <= L_SHEAR_ABOUT_CENTER;
+         pivot++) {
+        na2 = pixFindShearedDifferentialSquareSums(pixb1, na1, pivot);
+        na3 = numaCreate(0);
+        for (i = 0; i < numaGetCount(na1); i++) {
+            numaGetFValue(na1, i, &angle);
+            if (pivot == L_SHEAR_ABOUT_CORNER)
+                pixVShearCorner(pix1, pixb1, degtorad * angle,
+                                L_BRING_IN_WHITE);
+            else
+                pixVShearCenter(pix1, pixb1, degtorad * angle,
+                                L_BRING_IN_WHITE);
+            pixFindDifferentialSquareSum(pix1, &sum);
+            numaAddNumber(na3, sum);
+        }
+        numaSimilar(na2, na3, 0.0, &same);
+        regTestCompareValues(rp, 1, same, 0);  /* 7, 8 */
+        numaDestroy(&na2);
+        numaDestroy(&na3);
+    }
+    numaDestroy(&na1);
+    pixDestroy(&pix1);
+
+        /* Reductions taken from a pyramid are the same as those made
+         * directly, and the skew found from the pyramid is the same. */
+    pyr = pixPyramidCreate(pixs);
+    pix1 = pixPyramidGetBinary(pyr, 2, 2, 0, 0);
+    regTestComparePix(rp, pixb1, pix1);  /* 9 */
+    pixDestroy(&pix1);
+    pixFindSkew(pixs, &angle, &conf);
+    pixPyramidFindSkew(pyr, &angle2, &conf2);
+    regTestCompareValues(rp, angle, angle2, 0.0);  /* 10 */
+    pix1 = pixPyramidGetArea(pyr, 1);
+    pix2 = pixScaleToGray2(pixs);
+    regTestComparePix(rp, pix1, pix2);  /* 11 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixPyramidDestroy(&pyr);
+
     pixDestroy(&pixs);
     pixDestroy(&pixb1);
     pixDestroy(&pixb2);
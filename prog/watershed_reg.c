@@ -36,6 +36,7 @@
 #include "allheaders.h"
 
 void DoWatershed(L_REGPARAMS *rp, PIX *pixs);
+void DoWatershedMarkers(L_REGPARAMS *rp, PIX *pixs);
 
 int main(int    argc,
          char **argv)
@@ -66,6 +67,8 @@ L_REGPARAMS  *rp;
     }
     DoWatershed(rp, pix1);  /* 0 - 11 */
     DoWatershed(rp, pix2);  /* 12 - 23 */
+    DoWatershedMarkers(rp, pix1);  /* 24 - 26 */
+    DoWatershedMarkers(rp, pix2);  /* 27 - 29 */
     pixDestroy(&pix1);
     pixDestroy(&pix2);
     return regTestCleanup(rp);
@@ -155,3 +158,55 @@ PTA       *pta;
     ptaDestroy(&pta);
 }
 
+
+void
+DoWatershedMarkers(L_REGPARAMS  *rp,
+                   PIX          *pixs)
+{
+l_int32    i, w, h, nseeds, nlabels, count;
+l_uint32   redval, greenval;
+NUMA      *na;
+PIX       *pix1, *pix2, *pix3, *pix4, *pix5;
+PTA       *pta;
+
+        /* Seeds, as for DoWatershed() */
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixLocalExtrema(pixs, 0, 0, &pix1, NULL);
+    pixSetOrClearBorder(pix1, 2, 2, 2, 2, PIX_CLR);
+    pixSelectMinInConnComp(pixs, pix1, &pta, NULL);
+    pix2 = pixGenerateFromPta(pta, w, h);
+    pixCountConnComp(pix2, 8, &nseeds);
+
+        /* Every pixel is in the basin of one of the seeds */
+    startTimer();
+    pix3 = pixWatershedMarkers(pixs, pix2, 8, L_WSHED_LABELS);
+    lept_stderr("Time for marker wshed: %7.3f\n", stopTimer());
+    pix4 = pixConvert32To8(pix3, L_LS_TWO_BYTES, L_LS_BYTE);
+    na = pixGetGrayHistogram(pix4, 1);
+    numaGetIValue(na, 0, &count);
+    regTestCompareValues(rp, 0, count, 0.0);  /* 0 */
+    for (i = 1, nlabels = 0; i < 256; i++) {
+        numaGetIValue(na, i, &count);
+        if (count > 0) nlabels++;
+    }
+    regTestCompareValues(rp, nseeds, nlabels, 0.0);  /* 1 */
+    numaDestroy(&na);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+
+        /* The lines separate the basins */
+    pix3 = pixWatershedMarkers(pixs, pix2, 8, L_WSHED_BORDERS);
+    regTestWritePixAndCheck(rp, pix3, IFF_PNG);  /* 2 */
+    composeRGBPixel(255, 0, 0, &redval);
+    composeRGBPixel(0, 255, 0, &greenval);
+    pix5 = pixConvertTo32(pixs);
+    pixPaintThroughMask(pix5, pix3, 0, 0, redval);
+    pixPaintThroughMask(pix5, pix2, 0, 0, greenval);
+    pixDisplayWithTitle(pix5, 100, 600, NULL, rp->display);
+
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix5);
+    ptaDestroy(&pta);
+}
@@ -57,6 +57,11 @@
  *           l_int32     linearInterpolatePixelGray()
  *           l_int32     linearInterpolatePixelColor()
  *
+ *      Incremental line interpolation helpers
+ *           l_int32     affineLinePositions()
+ *           l_int32     linearInterpolateLineGray()
+ *           l_int32     linearInterpolateLineColor()
+ *
  *      Gauss-jordan linear equation solver
  *           l_int32     gaussjordan()
  *
@@ -583,11 +588,10 @@ pixAffineColor(PIX        *pixs,
                l_float32  *vc,
                l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
-l_uint32   val;
+l_int32    i, w, h, d, wpls, wpld, withalpha;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
-PIX       *pix1, *pix2, *pixd;
+PIX       *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -600,31 +604,38 @@ PIX       *pix1, *pix2, *pixd;
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
     pixd = pixCreateTemplate(pixs);
-    pixSetAllArbitrary(pixd, colorval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
+
+        /* If rgba, the alpha component is transformed with the others,
+         * and opaque alpha is brought in from outside */
+    withalpha = (pixGetSpp(pixs) == 4);
+    if (withalpha)
+        pixSetAllArbitrary(pixd, (colorval & 0xffffff00) | 0xff);
+    else
+        pixSetAllArbitrary(pixd, colorval);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines, stepping the src location
+         * incrementally along each line */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            affineXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
-                                        &val);
-            *(lined + j) = val;
-        }
-    }
-
-        /* If rgba, transform the pixs alpha channel and insert in pixd */
-    if (pixGetSpp(pixs) == 4) {
-        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
-        pix2 = pixAffineGray(pix1, vc, 255);  /* bring in opaque */
-        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
-        pixDestroy(&pix1);
-        pixDestroy(&pix2);
+        affineLinePositions((l_float64)vc[1] * i + vc[2],
+                            (l_float64)vc[4] * i + vc[5],
+                            vc[0], vc[3], w, h, w, xpa, ypa);
+        linearInterpolateLineColor(datas, wpls, w, h, xpa, ypa, w,
+                                   withalpha, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -683,9 +694,9 @@ pixAffineGray(PIX        *pixs,
               l_float32  *vc,
               l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, w, h, wpls, wpld;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
 PIX       *pixd;
 
     if (!pixs)
@@ -702,18 +713,27 @@ PIX       *pixd;
     pixSetAllArbitrary(pixd, grayval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines, stepping the src location
+         * incrementally along each line */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            affineXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
-            SET_DATA_BYTE(lined, j, val);
-        }
+        affineLinePositions((l_float64)vc[1] * i + vc[2],
+                            (l_float64)vc[4] * i + vc[5],
+                            vc[0], vc[3], w, h, w, xpa, ypa);
+        linearInterpolateLineGray(datas, wpls, w, h, xpa, ypa, w, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -1147,6 +1167,9 @@ affineXformPt(l_float32  *vc,
  *      (1) This is a standard linear interpolation function.  It is
  *          equivalent to area weighting on each component, and
  *          avoids "jaggies" when rendering sharp edges.
+ *      (2) For a location on the last line of the image, that line is
+ *          also used in place of the line below it.  (This once used
+ *          the first line of the image instead.)
  * </pre>
  */
 l_ok
@@ -1162,7 +1185,7 @@ linearInterpolatePixelColor(l_uint32  *datas,
 l_int32    valid, xpm, ypm, xp, xp2, yp, xf, yf;
 l_int32    rval, gval, bval;
 l_uint32   word00, word01, word10, word11;
-l_uint32  *lines;
+l_uint32  *lines, *lines2;
 
     if (!pval)
         return ERROR_INT("&val not defined", __func__, 1);
@@ -1182,7 +1205,6 @@ l_uint32  *lines;
     xp = xpm >> 4;
     xp2 = xp + 1 < w ? xp + 1 : xp;
     yp = ypm >> 4;
-    if (yp + 1 >= h) wpls = 0;
     xf = xpm & 0x0f;
     yf = ypm & 0x0f;
 
@@ -1191,12 +1213,14 @@ l_uint32  *lines;
         lept_stderr("xp = %d, yp = %d, xf = %d, yf = %d\n", xp, yp, xf, yf);
 #endif  /* DEBUG */
 
-        /* Do area weighting (eqiv. to linear interpolation) */
+        /* Do area weighting (eqiv. to linear interpolation).
+         * On the last src line, use it again for the line below. */
     lines = datas + yp * wpls;
+    lines2 = (yp + 1 < h) ? lines + wpls : lines;
     word00 = *(lines + xp);
     word10 = *(lines + xp2);
-    word01 = *(lines + wpls + xp);
-    word11 = *(lines + wpls + xp2);
+    word01 = *(lines2 + xp);
+    word11 = *(lines2 + xp2);
     rval = ((16 - xf) * (16 - yf) * ((word00 >> L_RED_SHIFT) & 0xff) +
         xf * (16 - yf) * ((word10 >> L_RED_SHIFT) & 0xff) +
         (16 - xf) * yf * ((word01 >> L_RED_SHIFT) & 0xff) +
@@ -1231,6 +1255,9 @@ l_uint32  *lines;
  *      (1) This is a standard linear interpolation function.  It is
  *          equivalent to area weighting on each component, and
  *          avoids "jaggies" when rendering sharp edges.
+ *      (2) For a location on the last line of the image, that line is
+ *          also used in place of the line below it.  (This once used
+ *          the first line of the image instead.)
  * </pre>
  */
 l_ok
@@ -1244,7 +1271,7 @@ linearInterpolatePixelGray(l_uint32  *datas,
                            l_int32   *pval)
 {
 l_int32    valid, xpm, ypm, xp, xp2, yp, xf, yf, v00, v10, v01, v11;
-l_uint32  *lines;
+l_uint32  *lines, *lines2;
 
     if (!pval)
         return ERROR_INT("&val not defined", __func__, 1);
@@ -1264,7 +1291,6 @@ l_uint32  *lines;
     xp = xpm >> 4;
     xp2 = xp + 1 < w ? xp + 1 : xp;
     yp = ypm >> 4;
-    if (yp + 1 >= h) wpls = 0;
     xf = xpm & 0x0f;
     yf = ypm & 0x0f;
 
@@ -1273,18 +1299,277 @@ l_uint32  *lines;
         lept_stderr("xp = %d, yp = %d, xf = %d, yf = %d\n", xp, yp, xf, yf);
 #endif  /* DEBUG */
 
-        /* Interpolate by area weighting. */
+        /* Interpolate by area weighting.  On the last src line,
+         * use it again for the line below. */
     lines = datas + yp * wpls;
+    lines2 = (yp + 1 < h) ? lines + wpls : lines;
     v00 = (16 - xf) * (16 - yf) * GET_DATA_BYTE(lines, xp);
     v10 = xf * (16 - yf) * GET_DATA_BYTE(lines, xp2);
-    v01 = (16 - xf) * yf * GET_DATA_BYTE(lines + wpls, xp);
-    v11 = xf * yf * GET_DATA_BYTE(lines + wpls, xp2);
+    v01 = (16 - xf) * yf * GET_DATA_BYTE(lines2, xp);
+    v11 = xf * yf * GET_DATA_BYTE(lines2, xp2);
     *pval = (v00 + v01 + v10 + v11) / 256;
     return 0;
 }
 
 
 
+/*-------------------------------------------------------------*
+ *           Incremental line interpolation helpers            *
+ *-------------------------------------------------------------*/
+/*!
+ * \brief   affineLinePositions()
+ *
+ * \param[in]    x0, y0     src location for the first dest pixel on the line
+ * \param[in]    dx, dy     src increments for each dest pixel on the line
+ * \param[in]    w, h       of src image
+ * \param[in]    n          number of dest pixels on the line
+ * \param[in]    xpa, ypa   arrays of size %n for src locations
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Along a line of dest pixels, the src location for affine
+ *          and bilinear transforms changes by a constant increment.
+ *          This generates the src locations, in units of 1/16 pixel,
+ *          for use by linearInterpolateLineGray() and
+ *          linearInterpolateLineColor().
+ *      (2) The span of dest pixels whose src location is inside the
+ *          src image is found up front.  Within the span, the locations
+ *          are accumulated in fixed point with 32 fractional bits,
+ *          which is far more accurate than the 1/16 pixel that is used.
+ *          Dest pixels outside the span are given a location of -1.
+ * </pre>
+ */
+l_ok
+affineLinePositions(l_float64  x0,
+                    l_float64  y0,
+                    l_float64  dx,
+                    l_float64  dy,
+                    l_int32    w,
+                    l_int32    h,
+                    l_int32    n,
+                    l_int32   *xpa,
+                    l_int32   *ypa)
+{
+l_int32    j, jstart, jend;
+l_int64    xs, ys, dxs, dys, x, y;
+l_float64  start, end, fx, fy;
+
+    if (!xpa || !ypa)
+        return ERROR_INT("xpa and ypa not both defined", __func__, 1);
+    if (w < 1 || h < 1 || n < 1)
+        return ERROR_INT("invalid size", __func__, 1);
+
+    for (j = 0; j < n; j++)
+        xpa[j] = ypa[j] = -1;
+
+        /* Coefficients too large to be represented in fixed point
+         * have at most a few dest pixels in the image.  Find them
+         * directly, and skip any NaNs. */
+    if (!(L_ABS(x0) < 1.0e8 && L_ABS(y0) < 1.0e8 &&
+          L_ABS(dx) < 1.0e3 && L_ABS(dy) < 1.0e3)) {
+        for (j = 0; j < n; j++) {
+            fx = x0 + j * dx;
+            fy = y0 + j * dy;
+            if (fx >= 0.0 && fy >= 0.0 && fx < w && fy < h) {
+                xpa[j] = (l_int32)(16.0 * fx);
+                ypa[j] = (l_int32)(16.0 * fy);
+            }
+        }
+        return 0;
+    }
+
+        /* Estimate the span where the src location is inside the image */
+    start = 0.0;
+    end = n - 1;
+    if (dx == 0.0) {
+        if (x0 < 0.0 || x0 >= w) return 0;
+    } else {
+        start = L_MAX(start, L_MIN(-x0 / dx, (w - x0) / dx));
+        end = L_MIN(end, L_MAX(-x0 / dx, (w - x0) / dx));
+    }
+    if (dy == 0.0) {
+        if (y0 < 0.0 || y0 >= h) return 0;
+    } else {
+        start = L_MAX(start, L_MIN(-y0 / dy, (h - y0) / dy));
+        end = L_MIN(end, L_MAX(-y0 / dy, (h - y0) / dy));
+    }
+    if (start > end + 1.0) return 0;
+
+        /* Widen by one and then trim the span exactly, using the same
+         * fixed point arithmetic that generates the locations */
+    xs = (l_int64)floor(x0 * 4294967296.0 + 0.5);
+    ys = (l_int64)floor(y0 * 4294967296.0 + 0.5);
+    dxs = (l_int64)floor(dx * 4294967296.0 + 0.5);
+    dys = (l_int64)floor(dy * 4294967296.0 + 0.5);
+    jstart = L_MAX(0, (l_int32)start - 1);
+    jend = L_MIN(n - 1, (l_int32)end + 1);
+    for (; jstart <= jend; jstart++) {
+        x = xs + jstart * dxs;
+        y = ys + jstart * dys;
+        if (x >= 0 && y >= 0 && (x >> 32) < w && (y >> 32) < h)
+            break;
+    }
+    for (; jend >= jstart; jend--) {
+        x = xs + jend * dxs;
+        y = ys + jend * dys;
+        if (x >= 0 && y >= 0 && (x >> 32) < w && (y >> 32) < h)
+            break;
+    }
+
+        /* Accumulate the locations across the span */
+    x = xs + jstart * dxs;
+    y = ys + jstart * dys;
+    for (j = jstart; j <= jend; j++) {
+        xpa[j] = (l_int32)(x >> 28);
+        ypa[j] = (l_int32)(y >> 28);
+        x += dxs;
+        y += dys;
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   linearInterpolateLineGray()
+ *
+ * \param[in]    datas      ptr to beginning of 8 bpp src image data
+ * \param[in]    wpls       32-bit word/line for this data array
+ * \param[in]    w, h       of src image
+ * \param[in]    xpa, ypa   src locations, in units of 1/16 pixel
+ * \param[in]    n          number of dest pixels
+ * \param[in]    lined      dest line
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For each location, this gives the same result as
+ *          linearInterpolatePixelGray() at (xpa[j] / 16, ypa[j] / 16).
+ *          On the last src line, both interpolate toward that line
+ *          itself.  The pixel function once interpolated toward the
+ *          first src line there, so the warps differ from earlier
+ *          versions in dest pixels that come from the last src line.
+ *      (2) Dest pixels with a negative location are not changed, so
+ *          the dest should be initialized with the value to be brought
+ *          in from outside the src image.
+ *      (3) The locations must otherwise be inside the src image.  They
+ *          are made by affineLinePositions() for affine and bilinear
+ *          transforms and by a similar function for projective transforms.
+ * </pre>
+ */
+l_ok
+linearInterpolateLineGray(l_uint32  *datas,
+                          l_int32    wpls,
+                          l_int32    w,
+                          l_int32    h,
+                          l_int32   *xpa,
+                          l_int32   *ypa,
+                          l_int32    n,
+                          l_uint32  *lined)
+{
+l_int32    j, xp, xp2, yp, xf, yf, v00, v10, v01, v11;
+l_uint32  *lines, *lines2;
+
+    if (!datas || !lined)
+        return ERROR_INT("datas and lined not both defined", __func__, 1);
+    if (!xpa || !ypa)
+        return ERROR_INT("xpa and ypa not both defined", __func__, 1);
+
+    for (j = 0; j < n; j++) {
+        if (xpa[j] < 0 || ypa[j] < 0) continue;
+        xp = xpa[j] >> 4;
+        yp = ypa[j] >> 4;
+        xf = xpa[j] & 0x0f;
+        yf = ypa[j] & 0x0f;
+        xp2 = xp + 1 < w ? xp + 1 : xp;
+        lines = datas + yp * wpls;
+        lines2 = yp + 1 < h ? lines + wpls : lines;
+        v00 = (16 - xf) * (16 - yf) * GET_DATA_BYTE(lines, xp);
+        v10 = xf * (16 - yf) * GET_DATA_BYTE(lines, xp2);
+        v01 = (16 - xf) * yf * GET_DATA_BYTE(lines2, xp);
+        v11 = xf * yf * GET_DATA_BYTE(lines2, xp2);
+        SET_DATA_BYTE(lined, j, (v00 + v01 + v10 + v11) >> 8);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   linearInterpolateLineColor()
+ *
+ * \param[in]    datas      ptr to beginning of 32 bpp src image data
+ * \param[in]    wpls       32-bit word/line for this data array
+ * \param[in]    w, h       of src image
+ * \param[in]    xpa, ypa   src locations, in units of 1/16 pixel
+ * \param[in]    n          number of dest pixels
+ * \param[in]    withalpha  1 to interpolate the alpha component as well;
+ *                          0 to set it to 0
+ * \param[in]    lined      dest line
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For each location, this gives the same result as
+ *          linearInterpolatePixelColor() on each component.  See
+ *          linearInterpolateLineGray() for the treatment of the last
+ *          src line and for the requirements on the locations and
+ *          the dest.
+ *      (2) The area weights sum to 256, so a weighted sum of 8-bit
+ *          values fits in 16 bits.  The 4 components are therefore
+ *          interpolated two at a time, in 16-bit fields of a 32-bit word.
+ * </pre>
+ */
+l_ok
+linearInterpolateLineColor(l_uint32  *datas,
+                           l_int32    wpls,
+                           l_int32    w,
+                           l_int32    h,
+                           l_int32   *xpa,
+                           l_int32   *ypa,
+                           l_int32    n,
+                           l_int32    withalpha,
+                           l_uint32  *lined)
+{
+l_int32    j, xp, xp2, yp, xf, yf;
+l_uint32   w00, w10, w01, w11, word00, word10, word01, word11;
+l_uint32   rb, ga, mask;
+l_uint32  *lines, *lines2;
+
+    if (!datas || !lined)
+        return ERROR_INT("datas and lined not both defined", __func__, 1);
+    if (!xpa || !ypa)
+        return ERROR_INT("xpa and ypa not both defined", __func__, 1);
+
+    mask = (withalpha) ? 0xffffffff : 0xffffff00;
+    for (j = 0; j < n; j++) {
+        if (xpa[j] < 0 || ypa[j] < 0) continue;
+        xp = xpa[j] >> 4;
+        yp = ypa[j] >> 4;
+        xf = xpa[j] & 0x0f;
+        yf = ypa[j] & 0x0f;
+        xp2 = xp + 1 < w ? xp + 1 : xp;
+        lines = datas + yp * wpls;
+        lines2 = yp + 1 < h ? lines + wpls : lines;
+        w00 = (16 - xf) * (16 - yf);
+        w10 = xf * (16 - yf);
+        w01 = (16 - xf) * yf;
+        w11 = xf * yf;
+        word00 = lines[xp];
+        word10 = lines[xp2];
+        word01 = lines2[xp];
+        word11 = lines2[xp2];
+        rb = w00 * ((word00 >> 8) & 0x00ff00ff) +
+             w10 * ((word10 >> 8) & 0x00ff00ff) +
+             w01 * ((word01 >> 8) & 0x00ff00ff) +
+             w11 * ((word11 >> 8) & 0x00ff00ff);
+        ga = w00 * (word00 & 0x00ff00ff) + w10 * (word10 & 0x00ff00ff) +
+             w01 * (word01 & 0x00ff00ff) + w11 * (word11 & 0x00ff00ff);
+        lined[j] = ((rb & 0xff00ff00) | ((ga >> 8) & 0x00ff00ff)) & mask;
+    }
+    return 0;
+}
+
+
 /*-------------------------------------------------------------*
  *               Gauss-jordan linear equation solver           *
  *-------------------------------------------------------------*/
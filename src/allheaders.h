@@ -83,6 +83,9 @@ LEPT_DLL extern l_ok affineXformSampledPt ( l_float32 *vc, l_int32 x, l_int32 y,
 LEPT_DLL extern l_ok affineXformPt ( l_float32 *vc, l_int32 x, l_int32 y, l_float32 *pxp, l_float32 *pyp );
 LEPT_DLL extern l_ok linearInterpolatePixelColor ( l_uint32 *datas, l_int32 wpls, l_int32 w, l_int32 h, l_float32 x, l_float32 y, l_uint32 colorval, l_uint32 *pval );
 LEPT_DLL extern l_ok linearInterpolatePixelGray ( l_uint32 *datas, l_int32 wpls, l_int32 w, l_int32 h, l_float32 x, l_float32 y, l_int32 grayval, l_int32 *pval );
+LEPT_DLL extern l_ok affineLinePositions ( l_float64 x0, l_float64 y0, l_float64 dx, l_float64 dy, l_int32 w, l_int32 h, l_int32 n, l_int32 *xpa, l_int32 *ypa );
+LEPT_DLL extern l_ok linearInterpolateLineGray ( l_uint32 *datas, l_int32 wpls, l_int32 w, l_int32 h, l_int32 *xpa, l_int32 *ypa, l_int32 n, l_uint32 *lined );
+LEPT_DLL extern l_ok linearInterpolateLineColor ( l_uint32 *datas, l_int32 wpls, l_int32 w, l_int32 h, l_int32 *xpa, l_int32 *ypa, l_int32 n, l_int32 withalpha, l_uint32 *lined );
 LEPT_DLL extern l_int32 gaussjordan ( l_float32 **a, l_float32 *b, l_int32 n );
 LEPT_DLL extern PIX * pixAffineSequential ( PIX *pixs, PTA *ptad, PTA *ptas, l_int32 bw, l_int32 bh );
 LEPT_DLL extern l_float32 * createMatrix2dTranslate ( l_float32 transx, l_float32 transy );
@@ -665,6 +668,7 @@ LEPT_DLL extern l_ok dewarpaSetCurvatures ( L_DEWARPA *dewa, l_int32 max_linecur
 LEPT_DLL extern l_ok dewarpaUseBothArrays ( L_DEWARPA *dewa, l_int32 useboth );
 LEPT_DLL extern l_ok dewarpaSetCheckColumns ( L_DEWARPA *dewa, l_int32 check_columns );
 LEPT_DLL extern l_ok dewarpaSetMaxDistance ( L_DEWARPA *dewa, l_int32 maxdist );
+LEPT_DLL extern l_ok dewarpaSetRedfactor ( L_DEWARPA *dewa, l_int32 redfactor );
 LEPT_DLL extern L_DEWARP * dewarpRead ( const char *filename );
 LEPT_DLL extern L_DEWARP * dewarpReadStream ( FILE *fp );
 LEPT_DLL extern L_DEWARP * dewarpReadMem ( const l_uint8 *data, size_t size );
@@ -697,6 +701,7 @@ LEPT_DLL extern l_ok dewarpaSetValidModels ( L_DEWARPA *dewa, l_int32 notests, l
 LEPT_DLL extern l_ok dewarpaInsertRefModels ( L_DEWARPA *dewa, l_int32 notests, l_int32 debug );
 LEPT_DLL extern l_ok dewarpaStripRefModels ( L_DEWARPA *dewa );
 LEPT_DLL extern l_ok dewarpaRestoreModels ( L_DEWARPA *dewa );
+LEPT_DLL extern l_ok dewarpaBuildModels ( L_DEWARPA *dewa, PIXAC *pixac, l_int32 reusedist );
 LEPT_DLL extern l_ok dewarpaInfo ( FILE *fp, L_DEWARPA *dewa );
 LEPT_DLL extern l_ok dewarpaModelStats ( L_DEWARPA *dewa, l_int32 *pnnone, l_int32 *pnvsuccess, l_int32 *pnvvalid, l_int32 *pnhsuccess, l_int32 *pnhvalid, l_int32 *pnref );
 LEPT_DLL extern l_ok dewarpaShowArrays ( L_DEWARPA *dewa, l_float32 scalefact, l_int32 first, l_int32 last );
@@ -1091,6 +1096,8 @@ LEPT_DLL extern l_ok readHeaderMemJpeg ( const l_uint8 *data, size_t size, l_int
 LEPT_DLL extern l_ok readResolutionMemJpeg ( const l_uint8 *data, size_t size, l_int32 *pxres, l_int32 *pyres );
 LEPT_DLL extern l_ok pixWriteMemJpeg ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 quality, l_int32 progressive );
 LEPT_DLL extern l_ok pixSetChromaSampling ( PIX *pix, l_int32 sampling );
+LEPT_DLL extern l_ok jpegPushDecode ( L_PUSHDEC *pd );
+LEPT_DLL extern void jpegPushCleanup ( L_PUSHDEC *pd );
 LEPT_DLL extern L_KERNEL * kernelCreate ( l_int32 height, l_int32 width );
 LEPT_DLL extern void kernelDestroy ( L_KERNEL **pkel );
 LEPT_DLL extern L_KERNEL * kernelCopy ( L_KERNEL *kels );
@@ -1150,6 +1157,17 @@ LEPT_DLL extern L_ASET_NODE * l_asetGetNext ( L_ASET_NODE *n );
 LEPT_DLL extern L_ASET_NODE * l_asetGetLast ( L_ASET *s );
 LEPT_DLL extern L_ASET_NODE * l_asetGetPrev ( L_ASET_NODE *n );
 LEPT_DLL extern l_int32 l_asetSize ( L_ASET *s );
+LEPT_DLL extern L_MAXTREE * maxtreeCreate ( PIX *pixs, l_int32 type, l_int32 connectivity );
+LEPT_DLL extern void maxtreeDestroy ( L_MAXTREE **ptree );
+LEPT_DLL extern l_ok maxtreeGetNodeAttributes ( L_MAXTREE *tree, l_int32 attribute, NUMA **pnaval, NUMA **pnaheight );
+LEPT_DLL extern PIX * maxtreeFilter ( L_MAXTREE *tree, l_int32 attribute, l_int32 minval );
+LEPT_DLL extern PIX * maxtreeHeightFilter ( L_MAXTREE *tree, l_int32 height );
+LEPT_DLL extern l_ok maxtreeGetExtinctionValues ( L_MAXTREE *tree, l_int32 attribute, NUMA **pnaext, PTA **ppta );
+LEPT_DLL extern PIX * maxtreeExtinctionFilter ( L_MAXTREE *tree, l_int32 attribute, l_int32 nkeep );
+LEPT_DLL extern PIX * pixAreaOpen ( PIX *pixs, l_int32 minarea, l_int32 connectivity );
+LEPT_DLL extern PIX * pixAreaClose ( PIX *pixs, l_int32 minarea, l_int32 connectivity );
+LEPT_DLL extern PIX * pixHMax ( PIX *pixs, l_int32 height, l_int32 connectivity );
+LEPT_DLL extern PIX * pixHMin ( PIX *pixs, l_int32 height, l_int32 connectivity );
 LEPT_DLL extern PIX * generateBinaryMaze ( l_int32 w, l_int32 h, l_int32 xi, l_int32 yi, l_float32 wallps, l_float32 ranis );
 LEPT_DLL extern PTA * pixSearchBinaryMaze ( PIX *pixs, l_int32 xi, l_int32 yi, l_int32 xf, l_int32 yf, PIX **ppixd );
 LEPT_DLL extern PTA * pixSearchGrayMaze ( PIX *pixs, l_int32 xi, l_int32 yi, l_int32 xf, l_int32 yf, PIX **ppixd );
@@ -1161,6 +1179,7 @@ LEPT_DLL extern PIX * pixClose ( PIX *pixd, PIX *pixs, SEL *sel );
 LEPT_DLL extern PIX * pixCloseSafe ( PIX *pixd, PIX *pixs, SEL *sel );
 LEPT_DLL extern PIX * pixOpenGeneralized ( PIX *pixd, PIX *pixs, SEL *sel );
 LEPT_DLL extern PIX * pixCloseGeneralized ( PIX *pixd, PIX *pixs, SEL *sel );
+LEPT_DLL extern PIX * pixHMTSearch ( PIX *pixs, SEL *sel, PTA **ppta );
 LEPT_DLL extern PIX * pixDilateBrick ( PIX *pixd, PIX *pixs, l_int32 hsize, l_int32 vsize );
 LEPT_DLL extern PIX * pixErodeBrick ( PIX *pixd, PIX *pixs, l_int32 hsize, l_int32 vsize );
 LEPT_DLL extern PIX * pixOpenBrick ( PIX *pixd, PIX *pixs, l_int32 hsize, l_int32 vsize );
@@ -1190,6 +1209,8 @@ LEPT_DLL extern PIXA * pixaExtendByMorph ( PIXA *pixas, l_int32 type, l_int32 ni
 LEPT_DLL extern PIXA * pixaExtendByScaling ( PIXA *pixas, NUMA *nasc, l_int32 type, l_int32 include );
 LEPT_DLL extern PIX * pixSeedfillMorph ( PIX *pixs, PIX *pixm, l_int32 maxiters, l_int32 connectivity );
 LEPT_DLL extern NUMA * pixRunHistogramMorph ( PIX *pixs, l_int32 runtype, l_int32 direction, l_int32 maxsize );
+LEPT_DLL extern l_ok pixGranulometry ( PIX *pixs, l_int32 direction, l_int32 maxsize, NUMA **pnaspec, NUMA **pnadist );
+LEPT_DLL extern l_ok pixAreaGranulometry ( PIX *pixs, l_int32 connectivity, l_int32 maxsize, NUMA **pnaspec, NUMA **pnadist );
 LEPT_DLL extern PIX * pixTophat ( PIX *pixs, l_int32 hsize, l_int32 vsize, l_int32 type );
 LEPT_DLL extern PIX * pixHDome ( PIX *pixs, l_int32 height, l_int32 connectivity );
 LEPT_DLL extern PIX * pixFastTophat ( PIX *pixs, l_int32 xsize, l_int32 ysize, l_int32 type );
@@ -1214,8 +1235,26 @@ LEPT_DLL extern PIX * pixMorphCompSequence ( PIX *pixs, const char *sequence, l_
 LEPT_DLL extern PIX * pixMorphSequenceDwa ( PIX *pixs, const char *sequence, l_int32 dispsep );
 LEPT_DLL extern PIX * pixMorphCompSequenceDwa ( PIX *pixs, const char *sequence, l_int32 dispsep );
 LEPT_DLL extern l_int32 morphSequenceVerify ( SARRAY *sa );
+LEPT_DLL extern L_MORPHPLAN * morphPlanCreate ( const char *sequence, l_int32 method );
+LEPT_DLL extern void morphPlanDestroy ( L_MORPHPLAN **pplan );
+LEPT_DLL extern PIX * pixApplyMorphPlan ( PIX *pixs, L_MORPHPLAN *plan );
+LEPT_DLL extern PIXA * pixaApplyMorphPlan ( PIXA *pixas, L_MORPHPLAN *plan );
 LEPT_DLL extern PIX * pixGrayMorphSequence ( PIX *pixs, const char *sequence, l_int32 dispsep, l_int32 dispy );
 LEPT_DLL extern PIX * pixColorMorphSequence ( PIX *pixs, const char *sequence, l_int32 dispsep, l_int32 dispy );
+LEPT_DLL extern l_ok pixWriteMpix ( const char *filename, PIX *pix );
+LEPT_DLL extern l_ok pixaWriteMpix ( const char *filename, PIXA *pixa );
+LEPT_DLL extern l_ok fpixWriteMpix ( const char *filename, FPIX *fpix );
+LEPT_DLL extern L_MPIX * mpixOpen ( const char *filename );
+LEPT_DLL extern void mpixClose ( L_MPIX **pmp );
+LEPT_DLL extern l_int32 mpixGetCount ( L_MPIX *mp );
+LEPT_DLL extern l_int32 mpixGetType ( L_MPIX *mp );
+LEPT_DLL extern l_ok mpixGetImageInfo ( L_MPIX *mp, l_int32 index, l_int32 *pw, l_int32 *ph, l_int32 *pd, l_int32 *pwpl, l_int32 *piscmap );
+LEPT_DLL extern const l_uint32 * mpixGetRaster ( L_MPIX *mp, l_int32 index, l_int32 *pwpl );
+LEPT_DLL extern const char * mpixGetText ( L_MPIX *mp, l_int32 index );
+LEPT_DLL extern BOX * mpixGetBox ( L_MPIX *mp, l_int32 index );
+LEPT_DLL extern PIX * mpixGetPix ( L_MPIX *mp, l_int32 index );
+LEPT_DLL extern PIXA * mpixGetPixa ( L_MPIX *mp );
+LEPT_DLL extern FPIX * mpixGetFPix ( L_MPIX *mp, l_int32 index );
 LEPT_DLL extern NUMA * numaCreate ( l_int32 n );
 LEPT_DLL extern NUMA * numaCreateFromIArray ( l_int32 *iarray, l_int32 size );
 LEPT_DLL extern NUMA * numaCreateFromFArray ( l_float32 *farray, l_int32 size, l_int32 copyflag );
@@ -1373,6 +1412,7 @@ LEPT_DLL extern l_ok numaEvalBestHaarParameters ( NUMA *nas, l_float32 relweight
 LEPT_DLL extern l_ok numaEvalHaarSum ( NUMA *nas, l_float32 width, l_float32 shift, l_float32 relweight, l_float32 *pscore );
 LEPT_DLL extern NUMA * genConstrainedNumaInRange ( l_int32 first, l_int32 last, l_int32 nmax, l_int32 use_pairs );
 LEPT_DLL extern l_ok pixGetRegionsBinary ( PIX *pixs, PIX **ppixhm, PIX **ppixtm, PIX **ppixtb, PIXA *pixadb );
+LEPT_DLL extern l_ok pixPyramidGetRegionsBinary ( PIXPYRAMID *pyr, PIX **ppixhm, PIX **ppixtm, PIX **ppixtb, PIXA *pixadb );
 LEPT_DLL extern PIX * pixGenHalftoneMask ( PIX *pixs, PIX **ppixtext, l_int32 *phtfound, l_int32 debug );
 LEPT_DLL extern PIX * pixGenerateHalftoneMask ( PIX *pixs, PIX **ppixtext, l_int32 *phtfound, PIXA *pixadb );
 LEPT_DLL extern PIX * pixGenTextlineMask ( PIX *pixs, PIX **ppixvws, l_int32 *ptlfound, PIXA *pixadb );
@@ -1385,6 +1425,7 @@ LEPT_DLL extern BOXA * pixSplitComponentWithProfile ( PIX *pixs, l_int32 delta,
 LEPT_DLL extern PIXA * pixExtractTextlines ( PIX *pixs, l_int32 maxw, l_int32 maxh, l_int32 minw, l_int32 minh, l_int32 adjw, l_int32 adjh, PIXA *pixadb );
 LEPT_DLL extern PIXA * pixExtractRawTextlines ( PIX *pixs, l_int32 maxw, l_int32 maxh, l_int32 adjw, l_int32 adjh, PIXA *pixadb );
 LEPT_DLL extern l_ok pixCountTextColumns ( PIX *pixs, l_float32 deltafract, l_float32 peakfract, l_float32 clipfract, l_int32 *pncols, PIXA *pixadb );
+LEPT_DLL extern l_ok pixPyramidCountTextColumns ( PIXPYRAMID *pyr, l_float32 deltafract, l_float32 peakfract, l_float32 clipfract, l_int32 *pncols, PIXA *pixadb );
 LEPT_DLL extern l_ok pixDecideIfText ( PIX *pixs, BOX *box, l_int32 *pistext, PIXA *pixadb );
 LEPT_DLL extern l_ok pixFindThreshFgExtent ( PIX *pixs, l_int32 thresh, l_int32 *ptop, l_int32 *pbot );
 LEPT_DLL extern l_ok pixDecideIfTable ( PIX *pixs, BOX *box, l_int32 orient, l_int32 *pscore, PIXA *pixadb );
@@ -2004,6 +2045,11 @@ LEPT_DLL extern l_ok pixConnCompIncrInit ( PIX *pixs, l_int32 conn, PIX **ppixd,
 LEPT_DLL extern l_int32 pixConnCompIncrAdd ( PIX *pixs, PTAA *ptaa, l_int32 *pncc, l_float32 x, l_float32 y, l_int32 debug );
 LEPT_DLL extern l_ok pixGetSortedNeighborValues ( PIX *pixs, l_int32 x, l_int32 y, l_int32 conn, l_int32 **pneigh, l_int32 *pnvals );
 LEPT_DLL extern PIX * pixLocToColorTransform ( PIX *pixs );
+LEPT_DLL extern PIXPYRAMID * pixPyramidCreate ( PIX *pixs );
+LEPT_DLL extern void pixPyramidDestroy ( PIXPYRAMID **ppyr );
+LEPT_DLL extern PIX * pixPyramidGetSource ( PIXPYRAMID *pyr );
+LEPT_DLL extern PIX * pixPyramidGetBinary ( PIXPYRAMID *pyr, l_int32 level1, l_int32 level2, l_int32 level3, l_int32 level4 );
+LEPT_DLL extern PIX * pixPyramidGetArea ( PIXPYRAMID *pyr, l_int32 nred );
 LEPT_DLL extern PIXTILING * pixTilingCreate ( PIX *pixs, l_int32 nx, l_int32 ny, l_int32 w, l_int32 h, l_int32 xoverlap, l_int32 yoverlap );
 LEPT_DLL extern void pixTilingDestroy ( PIXTILING **ppt );
 LEPT_DLL extern l_ok pixTilingGetCount ( PIXTILING *pt, l_int32 *pnx, l_int32 *pny );
@@ -2021,9 +2067,12 @@ LEPT_DLL extern l_ok fgetPngColormapInfo ( FILE *fp, PIXCMAP **pcmap, l_int32 *p
 LEPT_DLL extern l_ok pixWritePng ( const char *filename, PIX *pix, l_float32 gamma );
 LEPT_DLL extern l_ok pixWriteStreamPng ( FILE *fp, PIX *pix, l_float32 gamma );
 LEPT_DLL extern l_ok pixSetZlibCompression ( PIX *pix, l_int32 compval );
+LEPT_DLL extern l_ok pixSetPngPreset ( PIX *pix, l_int32 preset );
 LEPT_DLL extern void l_pngSetReadStrip16To8 ( l_int32 flag );
 LEPT_DLL extern PIX * pixReadMemPng ( const l_uint8 *filedata, size_t filesize );
 LEPT_DLL extern l_ok pixWriteMemPng ( l_uint8 **pfiledata, size_t *pfilesize, PIX *pix, l_float32 gamma );
+LEPT_DLL extern l_ok pngPushDecode ( L_PUSHDEC *pd );
+LEPT_DLL extern void pngPushCleanup ( L_PUSHDEC *pd );
 LEPT_DLL extern PIX * pixReadStreamPnm ( FILE *fp );
 LEPT_DLL extern l_ok readHeaderPnm ( const char *filename, l_int32 *pw, l_int32 *ph, l_int32 *pd, l_int32 *ptype, l_int32 *pbps, l_int32 *pspp );
 LEPT_DLL extern l_ok freadHeaderPnm ( FILE *fp, l_int32 *pw, l_int32 *ph, l_int32 *pd, l_int32 *ptype, l_int32 *pbps, l_int32 *pspp );
@@ -2046,6 +2095,7 @@ LEPT_DLL extern PIX * pixProjectivePtaWithAlpha ( PIX *pixs, PTA *ptad, PTA *pta
 LEPT_DLL extern l_ok getProjectiveXformCoeffs ( PTA *ptas, PTA *ptad, l_float32 **pvc );
 LEPT_DLL extern l_ok projectiveXformSampledPt ( l_float32 *vc, l_int32 x, l_int32 y, l_int32 *pxp, l_int32 *pyp );
 LEPT_DLL extern l_ok projectiveXformPt ( l_float32 *vc, l_int32 x, l_int32 y, l_float32 *pxp, l_float32 *pyp );
+LEPT_DLL extern l_ok projectiveLinePositions ( l_float32 *vc, l_int32 y, l_int32 w, l_int32 h, l_int32 n, l_int32 *xpa, l_int32 *ypa );
 LEPT_DLL extern l_ok convertFilesToPS ( const char *dirin, const char *substr, l_int32 res, const char *fileout );
 LEPT_DLL extern l_ok sarrayConvertFilesToPS ( SARRAY *sa, l_int32 res, const char *fileout );
 LEPT_DLL extern l_ok convertFilesFittedToPS ( const char *dirin, const char *substr, l_float32 xpts, l_float32 ypts, const char *fileout );
@@ -2191,6 +2241,14 @@ LEPT_DLL extern l_ok ptraaGetSize ( L_PTRAA *paa, l_int32 *psize );
 LEPT_DLL extern l_ok ptraaInsertPtra ( L_PTRAA *paa, l_int32 index, L_PTRA *pa );
 LEPT_DLL extern L_PTRA * ptraaGetPtra ( L_PTRAA *paa, l_int32 index, l_int32 accessflag );
 LEPT_DLL extern L_PTRA * ptraaFlattenToPtra ( L_PTRAA *paa );
+LEPT_DLL extern L_PUSHDEC * pushdecCreate ( l_int32 format );
+LEPT_DLL extern void pushdecDestroy ( L_PUSHDEC **ppd );
+LEPT_DLL extern l_ok pushdecFeed ( L_PUSHDEC *pd, const l_uint8 *data, size_t nbytes );
+LEPT_DLL extern l_ok pushdecFinish ( L_PUSHDEC *pd );
+LEPT_DLL extern l_int32 pushdecGetStatus ( L_PUSHDEC *pd );
+LEPT_DLL extern l_ok pushdecGetInfo ( L_PUSHDEC *pd, l_int32 *pw, l_int32 *ph, l_int32 *pdepth, l_int32 *pnrows );
+LEPT_DLL extern PIX * pushdecGetBand ( L_PUSHDEC *pd, l_int32 *py );
+LEPT_DLL extern PIX * pushdecGetPix ( L_PUSHDEC *pd );
 LEPT_DLL extern l_ok pixQuadtreeMean ( PIX *pixs, l_int32 nlevels, PIX *pix_ma, FPIXA **pfpixa );
 LEPT_DLL extern l_ok pixQuadtreeVariance ( PIX *pixs, l_int32 nlevels, PIX *pix_ma, DPIX *dpix_msa, FPIXA **pfpixa_v, FPIXA **pfpixa_rv );
 LEPT_DLL extern l_ok pixMeanInRectangle ( PIX *pixs, BOX *box, PIX *pixma, l_float32 *pval );
@@ -2240,6 +2298,8 @@ LEPT_DLL extern PIX * pixReadWithHint ( const char *filename, l_int32 hint );
 LEPT_DLL extern PIX * pixReadIndexed ( SARRAY *sa, l_int32 index );
 LEPT_DLL extern PIX * pixReadStream ( FILE *fp, l_int32 hint );
 LEPT_DLL extern l_ok pixReadHeader ( const char *filename, l_int32 *pformat, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
+LEPT_DLL extern l_ok pixReadHeaderFull ( const char *filename, l_int32 *pformat, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *pres, l_int32 *pnpages, l_int32 *piscmap );
+LEPT_DLL extern l_ok pixReadHeadersSA ( SARRAY *sa, const char *cachefile, NUMA **pnaformat, NUMA **pnaw, NUMA **pnah, NUMA **pnabps, NUMA **pnaspp, NUMA **pnares, NUMA **pnapages, NUMA **pnacmap );
 LEPT_DLL extern l_ok findFileFormat ( const char *filename, l_int32 *pformat );
 LEPT_DLL extern l_ok findFileFormatStream ( FILE *fp, l_int32 *pformat );
 LEPT_DLL extern l_ok findFileFormatBuffer ( const l_uint8 *buf, l_int32 *pformat );
@@ -2321,6 +2381,16 @@ LEPT_DLL extern l_ok regTestCompareFiles ( L_REGPARAMS *rp, l_int32 index1, l_in
 LEPT_DLL extern l_ok regTestWritePixAndCheck ( L_REGPARAMS *rp, PIX *pix, l_int32 format );
 LEPT_DLL extern l_ok regTestWriteDataAndCheck ( L_REGPARAMS *rp, void *data, size_t nbytes, const char *ext );
 LEPT_DLL extern char * regTestGenLocalFilename ( L_REGPARAMS *rp, l_int32 index, l_int32 format );
+LEPT_DLL extern L_REMAP * remapCreate ( FPIX *fpixx, FPIX *fpixy, l_int32 ws, l_int32 hs );
+LEPT_DLL extern void remapDestroy ( L_REMAP **premap );
+LEPT_DLL extern L_REMAP * remapCreateAffine ( l_float32 *vc, l_int32 w, l_int32 h, l_int32 ws, l_int32 hs );
+LEPT_DLL extern L_REMAP * remapCreateBilinear ( l_float32 *vc, l_int32 w, l_int32 h, l_int32 ws, l_int32 hs );
+LEPT_DLL extern L_REMAP * remapCreateProjective ( l_float32 *vc, l_int32 w, l_int32 h, l_int32 ws, l_int32 hs );
+LEPT_DLL extern L_REMAP * remapCreateFromDewarp ( L_DEWARP *dew, l_int32 w, l_int32 h, l_int32 x, l_int32 y, l_int32 usehoriz );
+LEPT_DLL extern L_REMAP * remapCompose ( L_REMAP *remap1, L_REMAP *remap2 );
+LEPT_DLL extern l_ok remapGetDimensions ( L_REMAP *remap, l_int32 *pw, l_int32 *ph, l_int32 *pws, l_int32 *phs );
+LEPT_DLL extern l_ok remapGetMaps ( L_REMAP *remap, FPIX **pfpixx, FPIX **pfpixy );
+LEPT_DLL extern PIX * pixRemap ( PIX *pixs, L_REMAP *remap, l_int32 type, l_int32 incolor );
 LEPT_DLL extern l_ok l_pdfRenderFile ( const char *filename, l_int32 res, SARRAY **psaout );
 LEPT_DLL extern l_ok l_pdfRenderFiles ( const char *dir, SARRAY *sain, l_int32 res, SARRAY **psaout );
 LEPT_DLL extern l_ok l_pdfRenderUnscaledFile ( const char *filename, SARRAY **psaout );
@@ -2355,6 +2425,7 @@ LEPT_DLL extern PIX * pixFlipTB ( PIX *pixd, PIX *pixs );
 LEPT_DLL extern PIX * pixRotateShear ( PIX *pixs, l_int32 xcen, l_int32 ycen, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern PIX * pixRotate2Shear ( PIX *pixs, l_int32 xcen, l_int32 ycen, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern PIX * pixRotate3Shear ( PIX *pixs, l_int32 xcen, l_int32 ycen, l_float32 angle, l_int32 incolor );
+LEPT_DLL extern PIX * pixRotate3ShearLI ( PIX *pixs, l_int32 xcen, l_int32 ycen, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern l_ok pixRotateShearIP ( PIX *pixs, l_int32 xcen, l_int32 ycen, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern PIX * pixRotateShearCenter ( PIX *pixs, l_float32 angle, l_int32 incolor );
 LEPT_DLL extern l_ok pixRotateShearCenterIP ( PIX *pixs, l_float32 angle, l_int32 incolor );
@@ -2446,10 +2517,13 @@ LEPT_DLL extern PIX * pixScaleRGBToGray2 ( PIX *pixs, l_float32 rwt, l_float32 g
 LEPT_DLL extern PIX * pixScaleAreaMap ( PIX *pix, l_float32 scalex, l_float32 scaley );
 LEPT_DLL extern PIX * pixScaleAreaMap2 ( PIX *pix );
 LEPT_DLL extern PIX * pixScaleAreaMapToSize ( PIX *pixs, l_int32 wd, l_int32 hd );
+LEPT_DLL extern PIX * pixScaleWithFilter ( PIX *pixs, l_float32 scalex, l_float32 scaley, l_int32 filtertype );
+LEPT_DLL extern PIX * pixScaleToSizeWithFilter ( PIX *pixs, l_int32 wd, l_int32 hd, l_int32 filtertype );
 LEPT_DLL extern PIX * pixScaleBinary ( PIX *pixs, l_float32 scalex, l_float32 scaley );
 LEPT_DLL extern PIX * pixScaleBinaryWithShift ( PIX *pixs, l_float32 scalex, l_float32 scaley, l_float32 shiftx, l_float32 shifty );
 LEPT_DLL extern PIX * pixScaleToGray ( PIX *pixs, l_float32 scalefactor );
 LEPT_DLL extern PIX * pixScaleToGrayFast ( PIX *pixs, l_float32 scalefactor );
+LEPT_DLL extern PIX * pixScaleToGrayArea ( PIX *pixs, l_float32 scalex, l_float32 scaley );
 LEPT_DLL extern PIX * pixScaleToGray2 ( PIX *pixs );
 LEPT_DLL extern PIX * pixScaleToGray3 ( PIX *pixs );
 LEPT_DLL extern PIX * pixScaleToGray4 ( PIX *pixs );
@@ -2509,6 +2583,8 @@ LEPT_DLL extern char * selaGetCombName ( SELA *sela, l_int32 size, l_int32 direc
 LEPT_DLL extern l_ok getCompositeParameters ( l_int32 size, l_int32 *psize1, l_int32 *psize2, char **pnameh1, char **pnameh2, char **pnamev1, char **pnamev2 );
 LEPT_DLL extern SARRAY * selaGetSelnames ( SELA *sela );
 LEPT_DLL extern l_ok selFindMaxTranslations ( SEL *sel, l_int32 *pxp, l_int32 *pyp, l_int32 *pxn, l_int32 *pyn );
+LEPT_DLL extern L_SELPLAN * selPlanCreate ( SEL *sel );
+LEPT_DLL extern void selPlanDestroy ( L_SELPLAN **pplan );
 LEPT_DLL extern SEL * selRotateOrth ( SEL *sel, l_int32 quads );
 LEPT_DLL extern SELA * selaRead ( const char *fname );
 LEPT_DLL extern SELA * selaReadStream ( FILE *fp );
@@ -2566,8 +2642,10 @@ LEPT_DLL extern l_ok pixFindSkewSweep ( PIX *pixs, l_float32 *pangle, l_int32 re
 LEPT_DLL extern l_ok pixFindSkewSweepAndSearch ( PIX *pixs, l_float32 *pangle, l_float32 *pconf, l_int32 redsweep, l_int32 redsearch, l_float32 sweeprange, l_float32 sweepdelta, l_float32 minbsdelta );
 LEPT_DLL extern l_ok pixFindSkewSweepAndSearchScore ( PIX *pixs, l_float32 *pangle, l_float32 *pconf, l_float32 *pendscore, l_int32 redsweep, l_int32 redsearch, l_float32 sweepcenter, l_float32 sweeprange, l_float32 sweepdelta, l_float32 minbsdelta );
 LEPT_DLL extern l_ok pixFindSkewSweepAndSearchScorePivot ( PIX *pixs, l_float32 *pangle, l_float32 *pconf, l_float32 *pendscore, l_int32 redsweep, l_int32 redsearch, l_float32 sweepcenter, l_float32 sweeprange, l_float32 sweepdelta, l_float32 minbsdelta, l_int32 pivot );
+LEPT_DLL extern l_ok pixPyramidFindSkew ( PIXPYRAMID *pyr, l_float32 *pangle, l_float32 *pconf );
 LEPT_DLL extern l_int32 pixFindSkewOrthogonalRange ( PIX *pixs, l_float32 *pangle, l_float32 *pconf, l_int32 redsweep, l_int32 redsearch, l_float32 sweeprange, l_float32 sweepdelta, l_float32 minbsdelta, l_float32 confprior );
 LEPT_DLL extern l_ok pixFindDifferentialSquareSum ( PIX *pixs, l_float32 *psum );
+LEPT_DLL extern NUMA * pixFindShearedDifferentialSquareSums ( PIX *pixs, NUMA *naangle, l_int32 pivot );
 LEPT_DLL extern l_ok pixFindNormalizedSquareSum ( PIX *pixs, l_float32 *phratio, l_float32 *pvratio, l_float32 *pfract );
 LEPT_DLL extern PIX * pixReadStreamSpix ( FILE *fp );
 LEPT_DLL extern l_ok readHeaderSpix ( const char *filename, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
@@ -2640,6 +2718,8 @@ LEPT_DLL extern PIXA * pixaReadMemMultipageTiff ( const l_uint8 *data, size_t si
 LEPT_DLL extern l_ok pixaWriteMemMultipageTiff ( l_uint8 **pdata, size_t *psize, PIXA *pixa );
 LEPT_DLL extern l_ok pixWriteMemTiff ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 comptype );
 LEPT_DLL extern l_ok pixWriteMemTiffCustom ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 comptype, NUMA *natags, SARRAY *savals, SARRAY *satypes, NUMA *nasizes );
+LEPT_DLL extern l_ok tiffPushDecode ( L_PUSHDEC *pd );
+LEPT_DLL extern void tiffPushCleanup ( L_PUSHDEC *pd );
 LEPT_DLL extern l_int32 setMsgSeverity ( l_int32 newsev );
 LEPT_DLL extern l_int32 returnErrorInt ( const char *msg, const char *procname, l_int32 ival );
 LEPT_DLL extern l_float32 returnErrorFloat ( const char *msg, const char *procname, l_float32 fval );
@@ -2756,6 +2836,7 @@ LEPT_DLL extern l_ok wshedApply ( L_WSHED *wshed );
 LEPT_DLL extern l_ok wshedBasins ( L_WSHED *wshed, PIXA **ppixa, NUMA **pnalevels );
 LEPT_DLL extern PIX * wshedRenderFill ( L_WSHED *wshed );
 LEPT_DLL extern PIX * wshedRenderColors ( L_WSHED *wshed );
+LEPT_DLL extern PIX * pixWatershedMarkers ( PIX *pixs, PIX *pixm, l_int32 connectivity, l_int32 outformat );
 LEPT_DLL extern l_ok pixaWriteWebPAnim ( const char *filename, PIXA *pixa, l_int32 loopcount, l_int32 duration, l_int32 quality, l_int32 lossless );
 LEPT_DLL extern l_ok pixaWriteStreamWebPAnim ( FILE *fp, PIXA *pixa, l_int32 loopcount, l_int32 duration, l_int32 quality, l_int32 lossless );
 LEPT_DLL extern l_ok pixaWriteMemWebPAnim ( l_uint8 **pencdata, size_t *pencsize, PIXA *pixa, l_int32 loopcount, l_int32 duration, l_int32 quality, l_int32 lossless );
@@ -2766,6 +2847,8 @@ LEPT_DLL extern l_ok readHeaderMemWebP ( const l_uint8 *data, size_t size, l_int
 LEPT_DLL extern l_ok pixWriteWebP ( const char *filename, PIX *pixs, l_int32 quality, l_int32 lossless );
 LEPT_DLL extern l_ok pixWriteStreamWebP ( FILE *fp, PIX *pixs, l_int32 quality, l_int32 lossless );
 LEPT_DLL extern l_ok pixWriteMemWebP ( l_uint8 **pencdata, size_t *pencsize, PIX *pixs, l_int32 quality, l_int32 lossless );
+LEPT_DLL extern l_ok webpPushDecode ( L_PUSHDEC *pd );
+LEPT_DLL extern void webpPushCleanup ( L_PUSHDEC *pd );
 LEPT_DLL extern l_int32 l_jpegSetQuality ( l_int32 new_quality );
 LEPT_DLL extern void setLeptDebugOK ( l_int32 allow );
 LEPT_DLL extern l_ok pixaWriteFiles ( const char *rootname, PIXA *pixa, l_int32 format );
@@ -2789,6 +2872,7 @@ LEPT_DLL extern void changeFormatForMissingLib ( l_int32 *pformat );
 LEPT_DLL extern l_ok pixDisplayWrite ( PIX *pixs, l_int32 reduction );
 LEPT_DLL extern l_uint8 * zlibCompress ( const l_uint8 *datain, size_t nin, size_t *pnout );
 LEPT_DLL extern l_uint8 * zlibUncompress ( const l_uint8 *datain, size_t nin, size_t *pnout );
+LEPT_DLL extern size_t zlibCompressBound ( size_t nin );
 
 #ifdef __cplusplus
 }
@@ -446,11 +446,10 @@ pixBilinearColor(PIX        *pixs,
                  l_float32  *vc,
                  l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
-l_uint32   val;
+l_int32    i, w, h, d, wpls, wpld, withalpha;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
-PIX       *pix1, *pix2, *pixd;
+PIX       *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -463,31 +462,40 @@ PIX       *pix1, *pix2, *pixd;
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
     pixd = pixCreateTemplate(pixs);
-    pixSetAllArbitrary(pixd, colorval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
+
+        /* If rgba, the alpha component is transformed with the others,
+         * and opaque alpha is brought in from outside */
+    withalpha = (pixGetSpp(pixs) == 4);
+    if (withalpha)
+        pixSetAllArbitrary(pixd, (colorval & 0xffffff00) | 0xff);
+    else
+        pixSetAllArbitrary(pixd, colorval);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines.  Along each line, the
+         * bilinear transform is affine, so the src location is
+         * stepped incrementally. */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            bilinearXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
-                                        &val);
-            *(lined + j) = val;
-        }
-    }
-
-        /* If rgba, transform the pixs alpha channel and insert in pixd */
-    if (pixGetSpp(pixs) == 4) {
-        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
-        pix2 = pixBilinearGray(pix1, vc, 255);  /* bring in opaque */
-        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
-        pixDestroy(&pix1);
-        pixDestroy(&pix2);
+        affineLinePositions((l_float64)vc[1] * i + vc[3],
+                            (l_float64)vc[5] * i + vc[7],
+                            (l_float64)vc[0] + vc[2] * i,
+                            (l_float64)vc[4] + vc[6] * i, w, h, w, xpa, ypa);
+        linearInterpolateLineColor(datas, wpls, w, h, xpa, ypa, w,
+                                   withalpha, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -545,9 +553,9 @@ pixBilinearGray(PIX        *pixs,
                 l_float32  *vc,
                 l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, w, h, wpls, wpld;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
 PIX       *pixd;
 
     if (!pixs)
@@ -564,18 +572,29 @@ PIX       *pixd;
     pixSetAllArbitrary(pixd, grayval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines.  Along each line, the
+         * bilinear transform is affine, so the src location is
+         * stepped incrementally. */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            bilinearXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
-            SET_DATA_BYTE(lined, j, val);
-        }
+        affineLinePositions((l_float64)vc[1] * i + vc[3],
+                            (l_float64)vc[5] * i + vc[7],
+                            (l_float64)vc[0] + vc[2] * i,
+                            (l_float64)vc[4] + vc[6] * i, w, h, w, xpa, ypa);
+        linearInterpolateLineGray(datas, wpls, w, h, xpa, ypa, w, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -32,6 +32,12 @@
  *     PIX    *pixThinConnected()
  *     PIX    *pixThinConnectedBySet()
  *     SELA   *selaMakeThinSets()
+ *
+ *     Static helpers for thinning
+ *        static l_int32    thinMakeMasks()
+ *        static l_int32    thinByMasks()
+ *        static l_int32    thinPassLow()
+ *        static l_int32    thinByHMT()
  * </pre>
  */
 
@@ -39,8 +45,18 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
+static l_int32 thinMakeMasks(SELA *sela, l_int32 **pmasks);
+static l_int32 thinByMasks(PIX *pixd, const l_int32 *masks, l_int32 nsels,
+                           l_int32 maxiters);
+static l_int32 thinPassLow(l_uint32 *data, l_int32 h, l_int32 wpl,
+                           const l_int32 *masks, l_int32 nsels,
+                           l_uint32 *bufs, l_int32 *lastpass,
+                           l_int32 pass);
+static l_int32 thinByHMT(PIX *pixd, SELA *sela, l_int32 maxiters);
+
     /* ------------------------------------------------------------
      * The sels used here (and their rotated counterparts) are the
      * useful 3x3 Sels for thinning.   They are defined in sel2.c,
@@ -214,6 +230,16 @@ SELA  *sela;
  *          operate directly on the source (pixd) to produce the result
  *          (in this case, with four sequential thinning operations, one
  *          from each of four directions).
+ *      (4) When all the Sels are 3x3 with the origin at the center and
+ *          at least one hit, which is true for all the sets made by
+ *          selaMakeThinSets(), the HMTs are not done with rasterops.
+ *          Instead, the rotated Sels are converted to masks on the
+ *          3x3 neighborhood, and the union of the HMTs for each
+ *          direction is computed for 32 pixels at a time, in a single
+ *          pass over the image.  Rows where nothing nearby has changed
+ *          in the previous four passes are skipped, because they
+ *          cannot change again.  The result is identical to that
+ *          found with pixHMT().
  * </pre>
  */
 PIX *
@@ -222,11 +248,9 @@ pixThinConnectedBySet(PIX     *pixs,
                       SELA    *sela,
                       l_int32  maxiters)
 {
-l_int32  i, j, r, nsels, same;
-PIXA    *pixahmt;
-PIX    **pixhmt;  /* array owned by pixahmt; do not destroy! */
-PIX     *pix1, *pix2, *pixd;
-SEL     *sel, *selr;
+l_int32   ret;
+l_int32  *masks;
+PIX      *pix1, *pix2, *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -238,19 +262,6 @@ SEL     *sel, *selr;
         return (PIX *)ERROR_PTR("sela not defined", __func__, NULL);
     if (maxiters == 0) maxiters = 10000;
 
-        /* Set up array of temp pix to hold hmts */
-    nsels = selaGetCount(sela);
-    pixahmt = pixaCreate(nsels);
-    for (i = 0; i < nsels; i++) {
-        pix1 = pixCreateTemplate(pixs);
-        pixaAddPix(pixahmt, pix1, L_INSERT);
-    }
-    pixhmt = pixaGetPixArray(pixahmt);
-    if (!pixhmt) {
-        pixaDestroy(&pixahmt);
-        return (PIX *)ERROR_PTR("pixhmt array not made", __func__, NULL);
-    }
-
         /* Set up initial image for fg thinning */
     if (type == L_THIN_FG)
         pixd = pixCopy(NULL, pixs);
@@ -258,25 +269,19 @@ SEL     *sel, *selr;
         pixd = pixInvert(NULL, pixs);
 
         /* Thin the fg, with up to maxiters iterations */
-    for (i = 0; i < maxiters; i++) {
-        pix1 = pixCopy(NULL, pixd);  /* test for completion */
-        for (r = 0; r < 4; r++) {  /* over 90 degree rotations of Sels */
-            for (j = 0; j < nsels; j++) {  /* over individual sels in sela */
-                sel = selaGetSel(sela, j);  /* not a copy */
-                selr = selRotateOrth(sel, r);
-                pixHMT(pixhmt[j], pixd, selr);
-                selDestroy(&selr);
-                if (j > 0)
-                    pixOr(pixhmt[0], pixhmt[0], pixhmt[j]);  /* accum result */
-            }
-            pixSubtract(pixd, pixd, pixhmt[0]);  /* remove result */
-        }
-        pixEqual(pixd, pix1, &same);
-        pixDestroy(&pix1);
-        if (same) {
-/*            L_INFO("%d iterations to completion\n", __func__, i); */
-            break;
-        }
+    if (thinMakeMasks(sela, &masks)) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("masks not made", __func__, NULL);
+    }
+    if (masks) {
+        ret = thinByMasks(pixd, masks, selaGetCount(sela), maxiters);
+        LEPT_FREE(masks);
+    } else {
+        ret = thinByHMT(pixd, sela, maxiters);
+    }
+    if (ret) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("thinning failed", __func__, NULL);
     }
 
         /* This is a bit tricky. If we're thickening the foreground, then
@@ -301,7 +306,6 @@ SEL     *sel, *selr;
         pixDestroy(&pix2);
     }
 
-    pixaDestroy(&pixahmt);
     return pixd;
 }
 
@@ -466,3 +470,312 @@ SELA  *sela1, *sela2, *sela3;
     selaDestroy(&sela1);
     return sela2;
 }
+
+
+/*----------------------------------------------------------------*
+ *                  Static helpers for thinning                   *
+ *----------------------------------------------------------------*/
+/*!
+ * \brief   thinMakeMasks()
+ *
+ * \param[in]   sela     of Sels for parallel composite HMTs
+ * \param[out]  pmasks   masks, or NULL if the Sels can't be used
+ *                        with thinByMasks()
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each Sel must be 3x3 with the origin at the center, and
+ *          have at least one hit.
+ *      (2) For each of the four rotations r and each Sel j, the hits
+ *          and misses are stored as a pair of 9-bit masks, at
+ *          masks[2 * (r * nsels + j)].  Bit (3 * i + j) of a mask
+ *          represents sel->data[i][j].
+ * </pre>
+ */
+static l_int32
+thinMakeMasks(SELA      *sela,
+              l_int32  **pmasks)
+{
+l_int32   i, j, k, r, nsels, sx, sy, cx, cy, hits, misses;
+l_int32  *masks;
+SEL      *sel, *selr;
+
+    *pmasks = NULL;
+    nsels = selaGetCount(sela);
+    if (nsels == 0)
+        return 0;
+    for (k = 0; k < nsels; k++) {
+        sel = selaGetSel(sela, k);
+        selGetParameters(sel, &sy, &sx, &cy, &cx);
+        if (sy != 3 || sx != 3 || cy != 1 || cx != 1)
+            return 0;
+    }
+
+    if ((masks = (l_int32 *)LEPT_CALLOC(8 * nsels, sizeof(l_int32))) == NULL)
+        return ERROR_INT("masks not made", __func__, 1);
+    for (r = 0; r < 4; r++) {
+        for (k = 0; k < nsels; k++) {
+            sel = selaGetSel(sela, k);  /* not a copy */
+            if ((selr = selRotateOrth(sel, r)) == NULL) {
+                LEPT_FREE(masks);
+                return ERROR_INT("selr not made", __func__, 1);
+            }
+            hits = misses = 0;
+            for (i = 0; i < 3; i++) {
+                for (j = 0; j < 3; j++) {
+                    if (selr->data[i][j] == SEL_HIT)
+                        hits |= 1 << (3 * i + j);
+                    else if (selr->data[i][j] == SEL_MISS)
+                        misses |= 1 << (3 * i + j);
+                }
+            }
+            selDestroy(&selr);
+            if (hits == 0) {
+                LEPT_FREE(masks);
+                return 0;
+            }
+            masks[2 * (r * nsels + k)] = hits;
+            masks[2 * (r * nsels + k) + 1] = misses;
+        }
+    }
+
+    *pmasks = masks;
+    return 0;
+}
+
+
+/*!
+ * \brief   thinByMasks()
+ *
+ * \param[in]   pixd       1 bpp; thinned in place
+ * \param[in]   masks      from thinMakeMasks()
+ * \param[in]   nsels      number of Sels in each direction
+ * \param[in]   maxiters   max number of iters allowed
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each iteration makes four passes, one for each rotation
+ *          of the Sels.  The pass on which each row last changed is
+ *          saved, and a row is only processed if it or one of its
+ *          neighbors has changed within the previous four passes.
+ *          Otherwise the input to the 3x3 neighborhoods on the row is
+ *          the same as it was for the same rotation in the previous
+ *          iteration, which removed nothing from the row.
+ *      (2) As with the rasterop HMTs, pixels outside the image are
+ *          treated as background.
+ *      (3) Thinning is complete when an iteration changes nothing.
+ * </pre>
+ */
+static l_int32
+thinByMasks(PIX            *pixd,
+            const l_int32  *masks,
+            l_int32         nsels,
+            l_int32         maxiters)
+{
+l_int32    i, r, h, wpl, pass, change;
+l_int32   *lastpass;
+l_uint32  *data, *bufs;
+
+    pixGetDimensions(pixd, NULL, &h, NULL);
+    wpl = pixGetWpl(pixd);
+    data = pixGetData(pixd);
+    pixSetPadBits(pixd, 0);
+    bufs = (l_uint32 *)LEPT_CALLOC(2 * wpl, sizeof(l_uint32));
+    lastpass = (l_int32 *)LEPT_CALLOC(h, sizeof(l_int32));
+    if (!bufs || !lastpass) {
+        LEPT_FREE(bufs);
+        LEPT_FREE(lastpass);
+        return ERROR_INT("bufs and lastpass not made", __func__, 1);
+    }
+    for (i = 0; i < h; i++)  /* every row is processed on the first pass */
+        lastpass[i] = -1;
+
+    for (i = 0, pass = 0; i < maxiters; i++) {
+        change = FALSE;
+        for (r = 0; r < 4; r++, pass++) {
+            if (thinPassLow(data, h, wpl, masks + 2 * r * nsels, nsels,
+                            bufs, lastpass, pass))
+                change = TRUE;
+        }
+        if (!change) {
+/*            L_INFO("%d iterations to completion\n", __func__, i); */
+            break;
+        }
+    }
+
+    LEPT_FREE(bufs);
+    LEPT_FREE(lastpass);
+    return 0;
+}
+
+
+/*!
+ * \brief   thinPassLow()
+ *
+ * \param[in]   data       of 1 bpp image, with pad bits cleared
+ * \param[in]   h          height of image
+ * \param[in]   wpl        words per line
+ * \param[in]   masks      hits and misses for the Sels in one direction
+ * \param[in]   nsels      number of Sels
+ * \param[in]   bufs       2 * wpl words, for saving input rows
+ * \param[in]   lastpass   pass on which each row last changed; updated
+ * \param[in]   pass       index of this pass
+ * \return  1 if any pixel was removed; 0 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) This removes the union of the HMTs of the Sels from the
+ *          image.  All HMTs are computed on the input to the pass, so
+ *          the input of each row is saved before the row is changed,
+ *          to be used as the upper neighbor of the next row.
+ *      (2) For each word, the 9 neighbors of each of the 32 pixels are
+ *          shifted into alignment with the pixel, so that an HMT is
+ *          the AND of the hits and the inverted misses.
+ * </pre>
+ */
+static l_int32
+thinPassLow(l_uint32       *data,
+            l_int32         h,
+            l_int32         wpl,
+            const l_int32  *masks,
+            l_int32         nsels,
+            l_uint32       *bufs,
+            l_int32        *lastpass,
+            l_int32         pass)
+{
+l_int32    i, j, k, m, last, bit, hits, misses, change, rowchange, cur;
+l_uint32   word, rem, match;
+l_uint32   nbrs[9];
+l_uint32  *line, *lines[3];
+const l_uint32  *lineprev;
+
+    change = FALSE;
+    lineprev = NULL;
+    cur = 0;
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        last = lastpass[i];
+        if (i > 0) last = L_MAX(last, lastpass[i - 1]);
+        if (i < h - 1) last = L_MAX(last, lastpass[i + 1]);
+        if (last < pass - 4) {  /* nothing nearby changed; skip the row */
+            lineprev = line;
+            continue;
+        }
+
+            /* Save the input row, and compute on saved input rows */
+        memcpy(bufs + cur * wpl, line, 4 * wpl);
+        lines[0] = (l_uint32 *)lineprev;
+        lines[1] = bufs + cur * wpl;
+        lines[2] = (i < h - 1) ? line + wpl : NULL;
+        rowchange = FALSE;
+        for (j = 0; j < wpl; j++) {
+            if ((word = lines[1][j]) == 0)
+                continue;
+            for (k = 0; k < 3; k++) {
+                if (!lines[k]) {
+                    nbrs[3 * k] = nbrs[3 * k + 1] = nbrs[3 * k + 2] = 0;
+                    continue;
+                }
+                nbrs[3 * k + 1] = lines[k][j];
+                nbrs[3 * k] = lines[k][j] >> 1;
+                if (j > 0)
+                    nbrs[3 * k] |= lines[k][j - 1] << 31;
+                nbrs[3 * k + 2] = lines[k][j] << 1;
+                if (j < wpl - 1)
+                    nbrs[3 * k + 2] |= lines[k][j + 1] >> 31;
+            }
+
+            rem = 0;
+            for (m = 0; m < nsels; m++) {
+                hits = masks[2 * m];
+                misses = masks[2 * m + 1];
+                match = word;  /* only fg pixels can be removed */
+                for (bit = 0; bit < 9 && match; bit++) {
+                    if (hits & (1 << bit))
+                        match &= nbrs[bit];
+                    else if (misses & (1 << bit))
+                        match &= ~nbrs[bit];
+                }
+                rem |= match;
+            }
+            if (word & rem) {
+                line[j] = word & ~rem;
+                rowchange = TRUE;
+            }
+        }
+
+        if (rowchange) {
+            lastpass[i] = pass;
+            change = TRUE;
+        }
+        lineprev = bufs + cur * wpl;
+        cur = 1 - cur;
+    }
+
+    return change;
+}
+
+
+/*!
+ * \brief   thinByHMT()
+ *
+ * \param[in]   pixd       1 bpp; thinned in place
+ * \param[in]   sela       of Sels for parallel composite HMTs
+ * \param[in]   maxiters   max number of iters allowed
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is used for Sels that are not handled by thinByMasks().
+ * </pre>
+ */
+static l_int32
+thinByHMT(PIX     *pixd,
+          SELA    *sela,
+          l_int32  maxiters)
+{
+l_int32  i, j, r, nsels, same;
+PIXA    *pixahmt;
+PIX    **pixhmt;  /* array owned by pixahmt; do not destroy! */
+PIX     *pix1;
+SEL     *sel, *selr;
+
+        /* Set up array of temp pix to hold hmts */
+    nsels = selaGetCount(sela);
+    pixahmt = pixaCreate(nsels);
+    for (i = 0; i < nsels; i++) {
+        pix1 = pixCreateTemplate(pixd);
+        pixaAddPix(pixahmt, pix1, L_INSERT);
+    }
+    pixhmt = pixaGetPixArray(pixahmt);
+    if (!pixhmt) {
+        pixaDestroy(&pixahmt);
+        return ERROR_INT("pixhmt array not made", __func__, 1);
+    }
+
+    for (i = 0; i < maxiters; i++) {
+        pix1 = pixCopy(NULL, pixd);  /* test for completion */
+        for (r = 0; r < 4; r++) {  /* over 90 degree rotations of Sels */
+            for (j = 0; j < nsels; j++) {  /* over individual sels in sela */
+                sel = selaGetSel(sela, j);  /* not a copy */
+                selr = selRotateOrth(sel, r);
+                pixHMT(pixhmt[j], pixd, selr);
+                selDestroy(&selr);
+                if (j > 0)
+                    pixOr(pixhmt[0], pixhmt[0], pixhmt[j]);  /* accum result */
+            }
+            pixSubtract(pixd, pixd, pixhmt[0]);  /* remove result */
+        }
+        pixEqual(pixd, pix1, &same);
+        pixDestroy(&pix1);
+        if (same) {
+/*            L_INFO("%d iterations to completion\n", __func__, i); */
+            break;
+        }
+    }
+
+    pixaDestroy(&pixahmt);
+    return 0;
+}
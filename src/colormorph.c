@@ -34,7 +34,10 @@
  *
  *      Method: Algorithm by van Herk and Gil and Werman, 1992
  *              Apply grayscale morphological operations separately
- *              to each component.
+ *              to each component.  This is done directly on the
+ *              packed 32 bpp pixels, with the components processed
+ *              together as separate bytes, so the image is not split
+ *              into components and recombined.
  * </pre>
  */
 
@@ -59,10 +62,16 @@
  *
  * <pre>
  * Notes:
- *      (1) This does the morph operation on each component separately,
- *          and recombines the result.
+ *      (1) This does the morph operation on each component separately.
+ *          The grayscale operations work on each byte of a 32 bpp pixel
+ *          independently, so there is no need to split the image into
+ *          components and recombine the results.
  *      (2) Sel is a brick with all elements being hits.
  *      (3) If hsize = vsize = 1, just returns a copy.
+ *      (4) As before, the alpha byte of pixd is 0 and pixd has spp = 3,
+ *          whatever is in the alpha byte of pixs.  The gray operations
+ *          also change that byte, so it is cleared even when pixs
+ *          has spp = 3.
  * </pre>
  */
 PIX *
@@ -71,7 +80,7 @@ pixColorMorph(PIX     *pixs,
               l_int32  hsize,
               l_int32  vsize)
 {
-PIX  *pixr, *pixg, *pixb, *pixrm, *pixgm, *pixbm, *pixd;
+PIX  *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -94,33 +103,18 @@ PIX  *pixr, *pixg, *pixb, *pixrm, *pixgm, *pixbm, *pixd;
     if (hsize == 1 && vsize == 1)
         return pixCopy(NULL, pixs);
 
-    pixr = pixGetRGBComponent(pixs, COLOR_RED);
-    pixg = pixGetRGBComponent(pixs, COLOR_GREEN);
-    pixb = pixGetRGBComponent(pixs, COLOR_BLUE);
-    if (type == L_MORPH_DILATE) {
-        pixrm = pixDilateGray(pixr, hsize, vsize);
-        pixgm = pixDilateGray(pixg, hsize, vsize);
-        pixbm = pixDilateGray(pixb, hsize, vsize);
-    } else if (type == L_MORPH_ERODE) {
-        pixrm = pixErodeGray(pixr, hsize, vsize);
-        pixgm = pixErodeGray(pixg, hsize, vsize);
-        pixbm = pixErodeGray(pixb, hsize, vsize);
-    } else if (type == L_MORPH_OPEN) {
-        pixrm = pixOpenGray(pixr, hsize, vsize);
-        pixgm = pixOpenGray(pixg, hsize, vsize);
-        pixbm = pixOpenGray(pixb, hsize, vsize);
-    } else {   /* type == L_MORPH_CLOSE */
-        pixrm = pixCloseGray(pixr, hsize, vsize);
-        pixgm = pixCloseGray(pixg, hsize, vsize);
-        pixbm = pixCloseGray(pixb, hsize, vsize);
-    }
-    pixd = pixCreateRGBImage(pixrm, pixgm, pixbm);
-    pixDestroy(&pixr);
-    pixDestroy(&pixrm);
-    pixDestroy(&pixg);
-    pixDestroy(&pixgm);
-    pixDestroy(&pixb);
-    pixDestroy(&pixbm);
+    if (type == L_MORPH_DILATE)
+        pixd = pixDilateGray(pixs, hsize, vsize);
+    else if (type == L_MORPH_ERODE)
+        pixd = pixErodeGray(pixs, hsize, vsize);
+    else if (type == L_MORPH_OPEN)
+        pixd = pixOpenGray(pixs, hsize, vsize);
+    else  /* type == L_MORPH_CLOSE */
+        pixd = pixCloseGray(pixs, hsize, vsize);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
 
+    pixSetComponentArbitrary(pixd, L_ALPHA_CHANNEL, 0);
+    pixSetSpp(pixd, 3);
     return pixd;
 }
@@ -51,6 +51,7 @@
  *          l_int32            dewarpaUseBothArrays()
  *          l_int32            dewarpaSetCheckColumns()
  *          l_int32            dewarpaSetMaxDistance()
+ *          l_int32            dewarpaSetRedfactor()
  *
  *      Dewarp serialized I/O
  *          L_DEWARP          *dewarpRead()
@@ -423,6 +424,7 @@ static const l_int32     InitialPtrArraySize = 20;   /* n'import quoi */
 static const l_int32     MaxPtrArraySize = 10000;
 static const l_int32     DefaultArraySampling = 30;
 static const l_int32     MinArraySampling = 8;
+static const l_int32     MaxRedfactor = 4;
 static const l_int32     DefaultMinLines = 15;
 static const l_int32     MinMinLines = 4;
 static const l_int32     DefaultMaxRefDist = 16;
@@ -498,7 +500,8 @@ dewarpCreateRef(l_int32  pageno,
 {
 L_DEWARP  *dew;
 
-    dew = (L_DEWARP *)LEPT_CALLOC(1, sizeof(L_DEWARP));
+    if ((dew = (L_DEWARP *)LEPT_CALLOC(1, sizeof(L_DEWARP))) == NULL)
+        return (L_DEWARP *)ERROR_PTR("dew not made", __func__, NULL);
     dew->pageno = pageno;
     dew->hasref = 1;
     dew->refpage = refpage;
@@ -546,7 +549,8 @@ L_DEWARP  *dew;
  *
  * \param[in]   nptrs       number of dewarp page ptrs; typ. the number of pages
  * \param[in]   sampling    use 0 for default value; the minimum allowed is 8
- * \param[in]   redfactor   of input images: 1 is full res; 2 is 2x reduced
+ * \param[in]   redfactor   of input images: 1 is full res; 2 is 2x reduced;
+ *                          up to 4 is allowed
  * \param[in]   minlines    minimum number of lines to accept; use 0 for default
  * \param[in]   maxdist     for locating reference disparity; use -1 for default
  * \return  dewa or NULL on error
@@ -560,7 +564,9 @@ L_DEWARP  *dew;
  *          factor that is half the sampling you want on the full resolution
  *          images.
  *      (3) Use %redfactor = 1 for full resolution; 2 for 2x reduction.
- *          All input images must be at one of these two resolutions.
+ *          All input images must be at the same resolution.  The
+ *          disparity is applied to images that are larger by %redfactor
+ *          than the images used to build the models.
  *      (4) %minlines is the minimum number of nearly full-length lines
  *          required to generate a vertical disparity array.  The default
  *          number is 15.  Use a smaller number to accept a questionable
@@ -585,8 +591,8 @@ L_DEWARPA  *dewa;
         nptrs = InitialPtrArraySize;
     if (nptrs > MaxPtrArraySize)
         return (L_DEWARPA *)ERROR_PTR("too many pages", __func__, NULL);
-    if (redfactor != 1 && redfactor != 2)
-        return (L_DEWARPA *)ERROR_PTR("redfactor not in {1,2}",
+    if (redfactor < 1 || redfactor > MaxRedfactor)
+        return (L_DEWARPA *)ERROR_PTR("redfactor not in [1 ... 4]",
                                       __func__, NULL);
     if (sampling == 0) {
          sampling = DefaultArraySampling;
@@ -657,6 +663,9 @@ L_DEWARPA  *dewa;
  *          The direct models are only made for pages with images in
  *          the pixacomp; the ref models are made for pages of the
  *          same parity within %maxdist of the nearest direct model.
+ *      (7) This builds a model for every page.  To build fewer models
+ *          and reuse them on nearby pages, or to add pages to an
+ *          existing dewa, use dewarpaBuildModels().
  * </pre>
  */
 L_DEWARPA *
@@ -666,10 +675,8 @@ dewarpaCreateFromPixacomp(PIXAC   *pixac,
                           l_int32  minlines,
                           l_int32  maxdist)
 {
-l_int32     i, nptrs, pageno;
-L_DEWARP   *dew;
+l_int32     nptrs;
 L_DEWARPA  *dewa;
-PIX        *pixt;
 
     if (!pixac)
         return (L_DEWARPA *)ERROR_PTR("pixac not defined", __func__, NULL);
@@ -679,35 +686,10 @@ PIX        *pixt;
                               sampling, 1, minlines, maxdist)) == NULL)
         return (L_DEWARPA *)ERROR_PTR("dewa not made", __func__, NULL);
     dewarpaUseBothArrays(dewa, useboth);
-
-    for (i = 0; i < nptrs; i++) {
-        pageno = pixacompGetOffset(pixac) + i;  /* index into pixacomp */
-        pixt = pixacompGetPix(pixac, pageno);
-        if (pixt && (pixGetWidth(pixt) > 1)) {
-            dew = dewarpCreate(pixt, pageno);
-            pixDestroy(&pixt);
-            if (!dew) {
-                ERROR_INT("unable to make dew!", __func__, 1);
-                continue;
-            }
-
-               /* Insert into dewa for this page */
-            dewarpaInsertDewarp(dewa, dew);
-
-               /* Build disparity arrays for this page */
-            dewarpBuildPageModel(dew, NULL);
-            if (!dew->vsuccess) {  /* will need to use model from nearby page */
-                dewarpaDestroyDewarp(dewa, pageno);
-                L_ERROR("unable to build model for page %d\n", __func__, i);
-                continue;
-            }
-                /* Remove all extraneous data */
-            dewarpMinimize(dew);
-        }
-        pixDestroy(&pixt);
+    if (dewarpaBuildModels(dewa, pixac, 0)) {
+        dewarpaDestroy(&dewa);
+        return (L_DEWARPA *)ERROR_PTR("models not built", __func__, NULL);
     }
-    dewarpaInsertRefModels(dewa, 0, 0);
-
     return dewa;
 }
 
@@ -1094,6 +1076,56 @@ dewarpaSetMaxDistance(L_DEWARPA  *dewa,
 }
 
 
+/*!
+ * \brief   dewarpaSetRedfactor()
+ *
+ * \param[in]    dewa
+ * \param[in]    redfactor   of model images relative to the images to
+ *                           be dewarped; 1 to 4
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The page models hold sampled disparity arrays, in units
+ *          of the pixels of the images on which they were built.
+ *          This sets the scale at which they are applied, so that
+ *          models can be used at a different resolution without
+ *          rebuilding them.  For example, models built on 300 ppi
+ *          images, or read back from a serialized dewa, can be applied
+ *          to 600 ppi images with %redfactor = 2.
+ *      (2) This removes the full resolution disparity arrays of all
+ *          the models; they are remade at the new scale when needed.
+ * </pre>
+ */
+l_ok
+dewarpaSetRedfactor(L_DEWARPA  *dewa,
+                    l_int32     redfactor)
+{
+l_int32    i;
+L_DEWARP  *dew;
+
+    if (!dewa)
+        return ERROR_INT("dewa not defined", __func__, 1);
+    if (redfactor < 1 || redfactor > MaxRedfactor)
+        return ERROR_INT("redfactor not in [1 ... 4]", __func__, 1);
+
+    dewa->redfactor = redfactor;
+    for (i = 0; i <= dewa->maxpage; i++) {
+        if ((dew = dewa->dewarp[i]) != NULL) {
+            dew->redfactor = redfactor;
+            fpixDestroy(&dew->fullvdispar);
+            fpixDestroy(&dew->fullhdispar);
+        }
+        if ((dew = dewa->dewarpcache[i]) != NULL) {
+            dew->redfactor = redfactor;
+            fpixDestroy(&dew->fullvdispar);
+            fpixDestroy(&dew->fullhdispar);
+        }
+    }
+    return 0;
+}
+
+
 /*----------------------------------------------------------------------*
  *                       Dewarp serialized I/O                          *
  *----------------------------------------------------------------------*/
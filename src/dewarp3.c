@@ -36,6 +36,12 @@
  *          static PIX        *pixApplyVertDisparity()
  *          static PIX        *pixApplyHorizDisparity()
  *
+ *      Full res disparity, generated a row at a time
+ *          static DISPROWS   *disparityRowsCreate()
+ *          static void        disparityRowsDestroy()
+ *          static l_float32  *disparityRowsGet()
+ *          static void        disparityRowsExpand()
+ *
  *      Apply disparity array to boxa
  *          l_int32            dewarpaApplyDisparityBoxa()
  *          static BOXA       *boxaApplyDisparity()
@@ -58,11 +64,38 @@
 #include <math.h>
 #include "allheaders.h"
 
+    /* Generates the rows of a full resolution disparity array from
+     * the sampled array, without making the full array. */
+struct DisparityRows
+{
+    FPIX       *fpixs;      /* sampled disparity, multiplied by redfactor  */
+    FPIX       *fpixfull;   /* full res disparity, if it is already made   */
+    l_int32     factor;     /* expansion factor: sampling * redfactor      */
+    l_int32     wf;         /* width of expanded array, without border     */
+    l_int32     hf;         /* height of expanded array, without border    */
+    l_int32     left;       /* slope border added on the left              */
+    l_int32     top;        /* slope border added on the top               */
+    l_int32     w;          /* number of values in each row                */
+    l_float32  *fract;      /* interpolation fractions                     */
+    l_float32  *exprow;     /* expanded row, without border                */
+    l_float32  *toprows;    /* first 2 rows of the expanded array          */
+    l_float32  *botrows;    /* last 2 rows of the expanded array           */
+    l_float32  *row;        /* output row                                  */
+};
+typedef struct DisparityRows  DISPROWS;
+
 static l_int32 dewarpaApplyInit(L_DEWARPA *dewa, l_int32 pageno, PIX *pixs,
-                                l_int32 x, l_int32 y, L_DEWARP **pdew,
-                                const char *debugfile);
-static PIX *pixApplyVertDisparity(L_DEWARP *dew, PIX *pixs, l_int32 grayin);
-static PIX * pixApplyHorizDisparity(L_DEWARP *dew, PIX *pixs, l_int32 grayin);
+                                L_DEWARP **pdew, const char *debugfile);
+static PIX *pixApplyVertDisparity(L_DEWARP *dew, PIX *pixs, l_int32 x,
+                                  l_int32 y, l_int32 grayin);
+static PIX * pixApplyHorizDisparity(L_DEWARP *dew, PIX *pixs, l_int32 x,
+                                    l_int32 y, l_int32 grayin);
+static DISPROWS *disparityRowsCreate(L_DEWARP *dew, FPIX *fpixsamp,
+                                     FPIX *fpixfull, PIX *pixs,
+                                     l_int32 x, l_int32 y);
+static void disparityRowsDestroy(DISPROWS **pdr);
+static l_float32 *disparityRowsGet(DISPROWS *dr, l_int32 i);
+static void disparityRowsExpand(DISPROWS *dr, l_int32 r, l_float32 *rowd);
 static BOXA *boxaApplyDisparity(L_DEWARP *dew, BOXA *boxa, l_int32 direction,
                                 l_int32 mapdir);
 
@@ -91,25 +124,25 @@ static BOXA *boxaApplyDisparity(L_DEWARP *dew, BOXA *boxa, l_int32 direction,
  *      (3) If the models and ref models have not been validated, this
  *          will do so by calling dewarpaInsertRefModels().
  *      (4) This works with both stripped and full resolution page models.
- *          If the full res disparity array(s) are missing, they are remade.
+ *          If the full res disparity array(s) are missing, they are not
+ *          made.  Instead, each row of full res disparity is interpolated
+ *          from the sampled array as it is needed.  This gives the same
+ *          result, and the memory used for the disparity is a few rows
+ *          rather than two float arrays the size of the page.
  *      (5) The caller must handle errors that are returned because there
  *          are no valid models or ref models for the page -- typically
  *          by using the input pixs.
  *      (6) If there is no model for %pageno, this will use the model for
  *          'refpage' and put the result in the dew for %pageno.
- *      (7) This populates the full resolution disparity arrays if
- *          necessary.  If x and/or y are positive, they are used,
- *          in conjunction with pixs, to determine the required
- *          slope-based extension of the full resolution disparity
- *          arrays in each direction.  When (x,y) == (0,0), all
- *          extension is to the right and down.  Nonzero values of (x,y)
- *          are useful for dewarping when pixs is deliberately undercropped.
- *      (8) Important: when applying disparity to a number of images,
- *          after calling this function and saving the resulting pixd,
- *          you should call dewarpMinimize(dew) on the dew for %pageno.
- *          This will remove pixs and pixd (or their clones) stored in dew,
- *          as well as the full resolution disparity arrays.  Together,
- *          these hold approximately 16 bytes for each pixel in pixs.
+ *      (7) If x and/or y are positive, they are used, in conjunction
+ *          with pixs, to determine the required slope-based extension
+ *          of the full resolution disparity in each direction.
+ *          When (x,y) == (0,0), all extension is to the right and down.
+ *          Nonzero values of (x,y) are useful for dewarping when pixs
+ *          is deliberately undercropped.
+ *      (8) This calls dewarpMinimize() on the dew that is used, which
+ *          removes the model image and any full resolution disparity
+ *          arrays made by dewarpPopulateFullRes().
  * </pre>
  */
 l_ok
@@ -135,12 +168,12 @@ PIX       *pixv, *pixh;
         grayin = 255;
     }
 
-        /* Find the appropriate dew to use and fully populate its array(s) */
-    if (dewarpaApplyInit(dewa, pageno, pixs, x, y, &dew, debugfile))
+        /* Find the appropriate dew to use */
+    if (dewarpaApplyInit(dewa, pageno, pixs, &dew, debugfile))
         return ERROR_INT("no model available", __func__, 1);
 
         /* Correct for vertical disparity and save the result */
-    if ((pixv = pixApplyVertDisparity(dew, pixs, grayin)) == NULL) {
+    if ((pixv = pixApplyVertDisparity(dew, pixs, x, y, grayin)) == NULL) {
         dewarpMinimize(dew);
         return ERROR_INT("pixv not made", __func__, 1);
     }
@@ -159,7 +192,8 @@ PIX       *pixv, *pixh;
         if (dew->hvalid == FALSE) {
             L_INFO("invalid horiz model for page %d\n", __func__, pageno);
         } else {
-            if ((pixh = pixApplyHorizDisparity(dew, pixv, grayin)) != NULL) {
+            pixh = pixApplyHorizDisparity(dew, pixv, x, y, grayin);
+            if (pixh != NULL) {
                 pixDestroy(ppixd);
                 *ppixd = pixh;
                 if (debugfile) {
@@ -181,7 +215,7 @@ PIX       *pixv, *pixh;
         lept_stderr("pdf file: %s\n", debugfile);
     }
 
-        /* Get rid of the large full res disparity arrays */
+        /* Get rid of the model image and any full res disparity arrays */
     dewarpMinimize(dew);
 
     return 0;
@@ -194,7 +228,6 @@ PIX       *pixv, *pixh;
  * \param[in]    dewa
  * \param[in]    pageno      of page model to be used; may be a ref model
  * \param[in]    pixs        image to be modified; can be 1, 8 or 32 bpp
- * \param[in]    x, y        origin for generation of disparity arrays
  * \param[out]   pdew        dewarp to be used for this page
  * \param[in]    debugfile   use NULL to skip writing this
  * \return  0 if OK, 1 on error no models or ref models available
@@ -214,8 +247,6 @@ static l_int32
 dewarpaApplyInit(L_DEWARPA   *dewa,
                  l_int32      pageno,
                  PIX         *pixs,
-                 l_int32      x,
-                 l_int32      y,
                  L_DEWARP   **pdew,
                  const char  *debugfile)
 {
@@ -233,8 +264,6 @@ PIX       *pix1;
         return ERROR_INT("invalid pageno", __func__, 1);
     if (!pixs)
         return ERROR_INT("pixs not defined", __func__, 1);
-    if (x < 0) x = 0;
-    if (y < 0) y = 0;
     debug = (debugfile) ? 1 : 0;
 
         /* Make sure all models are valid and all refmodels have
@@ -275,10 +304,6 @@ PIX       *pix1;
         }
     }
 
-        /* Generate the full res disparity arrays if they don't exist
-         * (e.g., if they've been minimized or read from file), or if
-         * they are too small for the current image.  */
-    dewarpPopulateFullRes(dew2, pixs, x, y);
     return 0;
 }
 
@@ -288,6 +313,7 @@ PIX       *pix1;
  *
  * \param[in]    dew
  * \param[in]    pixs     1, 8 or 32 bpp
+ * \param[in]    x, y     origin for generation of disparity arrays
  * \param[in]    grayin   gray value, from 0 to 255, for pixels brought in;
  *                        use -1 to use pixels on the boundary of pixs
  * \return  pixd   modified to remove vertical disparity, or NULL on error
@@ -300,18 +326,22 @@ PIX       *pix1;
  *      (2) Specify gray color for pixels brought in from the outside:
  *          0 is black, 255 is white.  Use -1 to select pixels from the
  *          boundary of the source image.
+ *      (3) The full res vertical disparity is used if it exists and is
+ *          large enough; otherwise, it is generated a row at a time.
  * </pre>
  */
 static PIX *
 pixApplyVertDisparity(L_DEWARP  *dew,
                       PIX       *pixs,
+                      l_int32    x,
+                      l_int32    y,
                       l_int32    grayin)
 {
-l_int32     i, j, w, h, d, fw, fh, wpld, wplf, isrc, val8;
+l_int32     i, j, w, h, d, wpld, isrc, val8;
 l_uint32   *datad, *lined;
-l_float32  *dataf, *linef;
+l_float32  *linef;
 void      **lineptrs;
-FPIX       *fpix;
+DISPROWS   *dr;
 PIX        *pixd;
 
     if (!dew)
@@ -321,13 +351,10 @@ PIX        *pixd;
     pixGetDimensions(pixs, &w, &h, &d);
     if (d != 1 && d != 8 && d != 32)
         return (PIX *)ERROR_PTR("pix not 1, 8 or 32 bpp", __func__, NULL);
-    if ((fpix = dew->fullvdispar) == NULL)
-        return (PIX *)ERROR_PTR("fullvdispar not defined", __func__, NULL);
-    fpixGetDimensions(fpix, &fw, &fh);
-    if (fw < w || fh < h) {
-        lept_stderr("fw = %d, w = %d, fh = %d, h = %d\n", fw, w, fh, h);
-        return (PIX *)ERROR_PTR("invalid fpix size", __func__, NULL);
-    }
+    if ((dr = disparityRowsCreate(dew, dew->sampvdispar, dew->fullvdispar,
+                                  pixs, x, y)) == NULL)
+        return (PIX *)ERROR_PTR("vert disparity not available",
+                                __func__, NULL);
 
         /* Two choices for requested pixels outside pixs: (1) use pixels'
          * from the boundary of pixs; use white or light gray pixels. */
@@ -335,14 +362,12 @@ PIX        *pixd;
     if (grayin >= 0)
         pixSetAllGray(pixd, grayin);
     datad = pixGetData(pixd);
-    dataf = fpixGetData(fpix);
     wpld = pixGetWpl(pixd);
-    wplf = fpixGetWpl(fpix);
     if (d == 1) {
         lineptrs = pixGetLinePtrs(pixs, NULL);
         for (i = 0; i < h; i++) {
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 isrc = (l_int32)(i - linef[j] + 0.5);
                 if (grayin < 0)  /* use value at boundary if outside */
@@ -357,7 +382,7 @@ PIX        *pixd;
         lineptrs = pixGetLinePtrs(pixs, NULL);
         for (i = 0; i < h; i++) {
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 isrc = (l_int32)(i - linef[j] + 0.5);
                 if (grayin < 0)
@@ -372,7 +397,7 @@ PIX        *pixd;
         lineptrs = pixGetLinePtrs(pixs, NULL);
         for (i = 0; i < h; i++) {
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 isrc = (l_int32)(i - linef[j] + 0.5);
                 if (grayin < 0)
@@ -384,6 +409,7 @@ PIX        *pixd;
     }
 
     LEPT_FREE(lineptrs);
+    disparityRowsDestroy(&dr);
     return pixd;
 }
 
@@ -393,6 +419,7 @@ PIX        *pixd;
  *
  * \param[in]    dew
  * \param[in]    pixs     1, 8 or 32 bpp
+ * \param[in]    x, y     origin for generation of disparity arrays
  * \param[in]    grayin   gray value, from 0 to 255, for pixels brought in;
  *                        use -1 to use pixels on the boundary of pixs
  * \return  pixd   modified to remove horizontal disparity if possible,
@@ -408,17 +435,21 @@ PIX        *pixd;
  *      (3) The input pixs has already been corrected for vertical disparity.
  *          If the horizontal disparity array doesn't exist, this returns
  *          a clone of %pixs.
+ *      (4) The full res horizontal disparity is used if it exists and is
+ *          large enough; otherwise, it is generated a row at a time.
  * </pre>
  */
 static PIX *
 pixApplyHorizDisparity(L_DEWARP  *dew,
                        PIX       *pixs,
+                       l_int32    x,
+                       l_int32    y,
                        l_int32    grayin)
 {
-l_int32     i, j, w, h, d, fw, fh, wpls, wpld, wplf, jsrc, val8;
+l_int32     i, j, w, h, d, wpls, wpld, jsrc, val8;
 l_uint32   *datas, *lines, *datad, *lined;
-l_float32  *dataf, *linef;
-FPIX       *fpix;
+l_float32  *linef;
+DISPROWS   *dr;
 PIX        *pixd;
 
     if (!dew)
@@ -428,13 +459,12 @@ PIX        *pixd;
     pixGetDimensions(pixs, &w, &h, &d);
     if (d != 1 && d != 8 && d != 32)
         return (PIX *)ERROR_PTR("pix not 1, 8 or 32 bpp", __func__, NULL);
-    if ((fpix = dew->fullhdispar) == NULL)
-        return (PIX *)ERROR_PTR("fullhdispar not defined", __func__, NULL);
-    fpixGetDimensions(fpix, &fw, &fh);
-    if (fw < w || fh < h) {
-        lept_stderr("fw = %d, w = %d, fh = %d, h = %d\n", fw, w, fh, h);
-        return (PIX *)ERROR_PTR("invalid fpix size", __func__, NULL);
-    }
+    if (!dew->samphdispar)
+        return (PIX *)ERROR_PTR("horiz disparity not defined", __func__, NULL);
+    if ((dr = disparityRowsCreate(dew, dew->samphdispar, dew->fullhdispar,
+                                  pixs, x, y)) == NULL)
+        return (PIX *)ERROR_PTR("horiz disparity not available",
+                                __func__, NULL);
 
         /* Two choices for requested pixels outside pixs: (1) use pixels'
          * from the boundary of pixs; use white or light gray pixels. */
@@ -443,15 +473,13 @@ PIX        *pixd;
         pixSetAllGray(pixd, grayin);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
-    dataf = fpixGetData(fpix);
     wpls = pixGetWpl(pixs);
     wpld = pixGetWpl(pixd);
-    wplf = fpixGetWpl(fpix);
     if (d == 1) {
         for (i = 0; i < h; i++) {
             lines = datas + i * wpls;
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 jsrc = (l_int32)(j - linef[j] + 0.5);
                 if (grayin < 0)  /* use value at boundary if outside */
@@ -466,7 +494,7 @@ PIX        *pixd;
         for (i = 0; i < h; i++) {
             lines = datas + i * wpls;
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 jsrc = (l_int32)(j - linef[j] + 0.5);
                 if (grayin < 0)
@@ -481,7 +509,7 @@ PIX        *pixd;
         for (i = 0; i < h; i++) {
             lines = datas + i * wpls;
             lined = datad + i * wpld;
-            linef = dataf + i * wplf;
+            linef = disparityRowsGet(dr, i);
             for (j = 0; j < w; j++) {
                 jsrc = (l_int32)(j - linef[j] + 0.5);
                 if (grayin < 0)
@@ -492,10 +520,285 @@ PIX        *pixd;
         }
     }
 
+    disparityRowsDestroy(&dr);
     return pixd;
 }
 
 
+/*----------------------------------------------------------------------*
+ *           Full res disparity, generated a row at a time              *
+ *----------------------------------------------------------------------*/
+/*!
+ * \brief   disparityRowsCreate()
+ *
+ * \param[in]    dew
+ * \param[in]    fpixsamp   sampled disparity array
+ * \param[in]    fpixfull   [optional] full res disparity array
+ * \param[in]    pixs       image to which the disparity is to be applied
+ * \param[in]    x, y       origin for generation of disparity arrays
+ * \return  dr, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is used to get the rows of the full res disparity array
+ *          that dewarpPopulateFullRes() would make for %pixs, without
+ *          ever making that array.  Only a few rows are stored.
+ *          The values are identical to those in the full array:
+ *          the rows are interpolated as in fpixScaleByInteger(), and
+ *          the slope border is added as in fpixAddSlopeBorder().
+ *      (2) If %fpixfull exists and is large enough for %pixs, its rows
+ *          are returned instead, as they would have been used before.
+ * </pre>
+ */
+static DISPROWS *
+disparityRowsCreate(L_DEWARP  *dew,
+                    FPIX      *fpixsamp,
+                    FPIX      *fpixfull,
+                    PIX       *pixs,
+                    l_int32    x,
+                    l_int32    y)
+{
+l_int32    i, w, h, ws, hs, fw, fh, redfactor, deltaw, deltah;
+DISPROWS  *dr;
+
+    if (!dew)
+        return (DISPROWS *)ERROR_PTR("dew not defined", __func__, NULL);
+    if (!fpixsamp)
+        return (DISPROWS *)ERROR_PTR("fpixsamp not defined", __func__, NULL);
+    if (!pixs)
+        return (DISPROWS *)ERROR_PTR("pixs not defined", __func__, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if ((dr = (DISPROWS *)LEPT_CALLOC(1, sizeof(DISPROWS))) == NULL)
+        return (DISPROWS *)ERROR_PTR("dr not made", __func__, NULL);
+    dr->w = w;
+    if (fpixfull) {
+        fpixGetDimensions(fpixfull, &fw, &fh);
+        if (fw >= w && fh >= h) {
+            dr->fpixfull = fpixfull;  /* not owned */
+            return dr;
+        }
+    }
+
+    fpixGetDimensions(fpixsamp, &ws, &hs);
+    if (ws < 2 || hs < 2) {
+        LEPT_FREE(dr);
+        return (DISPROWS *)ERROR_PTR("fpixsamp too small", __func__, NULL);
+    }
+    redfactor = dew->redfactor;
+    if ((dr->fpixs = fpixCopy(fpixsamp)) == NULL) {
+        disparityRowsDestroy(&dr);
+        return (DISPROWS *)ERROR_PTR("fpixs not made", __func__, NULL);
+    }
+    if (redfactor > 1)
+        fpixAddMultConstant(dr->fpixs, 0.0, (l_float32)redfactor);
+    dr->factor = dew->sampling * redfactor;
+    dr->wf = dr->factor * (ws - 1) + 1;
+    dr->hf = dr->factor * (hs - 1) + 1;
+
+        /* Use the same slope border as dewarpPopulateFullRes() */
+    deltaw = w - redfactor * dew->sampling * (dew->nx - 1) + 2;
+    deltah = h - redfactor * dew->sampling * (dew->ny - 1) + 2;
+    deltaw = L_MAX(0, deltaw);
+    deltah = L_MAX(0, deltah);
+    if (deltaw > 0 || deltah > 0) {
+        dr->left = L_MAX(0, x);
+        dr->top = L_MAX(0, y);
+    }
+
+    dr->fract = (l_float32 *)LEPT_CALLOC(dr->factor, sizeof(l_float32));
+    dr->exprow = (l_float32 *)LEPT_CALLOC(dr->wf, sizeof(l_float32));
+    dr->row = (l_float32 *)LEPT_CALLOC(w, sizeof(l_float32));
+    if (!dr->fract || !dr->exprow || !dr->row) {
+        disparityRowsDestroy(&dr);
+        return (DISPROWS *)ERROR_PTR("row arrays not made", __func__, NULL);
+    }
+    for (i = 0; i < dr->factor; i++)
+        dr->fract[i] = i / (l_float32)dr->factor;
+
+        /* Save the rows used for extending at top and bottom */
+    if (dr->top > 0) {
+        dr->toprows = (l_float32 *)LEPT_CALLOC(2 * w, sizeof(l_float32));
+        if (!dr->toprows) {
+            disparityRowsDestroy(&dr);
+            return (DISPROWS *)ERROR_PTR("toprows not made", __func__, NULL);
+        }
+        disparityRowsExpand(dr, 0, dr->toprows);
+        disparityRowsExpand(dr, 1, dr->toprows + w);
+    }
+    if (dr->top + dr->hf < h) {
+        dr->botrows = (l_float32 *)LEPT_CALLOC(2 * w, sizeof(l_float32));
+        if (!dr->botrows) {
+            disparityRowsDestroy(&dr);
+            return (DISPROWS *)ERROR_PTR("botrows not made", __func__, NULL);
+        }
+        disparityRowsExpand(dr, dr->hf - 2, dr->botrows);
+        disparityRowsExpand(dr, dr->hf - 1, dr->botrows + w);
+    }
+    return dr;
+}
+
+
+/*!
+ * \brief   disparityRowsDestroy()
+ *
+ * \param[in,out]   pdr    will be set to null before returning
+ * \return  void
+ */
+static void
+disparityRowsDestroy(DISPROWS  **pdr)
+{
+DISPROWS  *dr;
+
+    if (pdr == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((dr = *pdr) == NULL)
+        return;
+
+    fpixDestroy(&dr->fpixs);
+    LEPT_FREE(dr->fract);
+    LEPT_FREE(dr->exprow);
+    LEPT_FREE(dr->toprows);
+    LEPT_FREE(dr->botrows);
+    LEPT_FREE(dr->row);
+    LEPT_FREE(dr);
+    *pdr = NULL;
+}
+
+
+/*!
+ * \brief   disparityRowsGet()
+ *
+ * \param[in]    dr
+ * \param[in]    i     row of the full res disparity array
+ * \return  array of w disparity values for row %i
+ *
+ * <pre>
+ * Notes:
+ *      (1) The returned array is owned by %dr, and is overwritten
+ *          on the next call.
+ * </pre>
+ */
+static l_float32 *
+disparityRowsGet(DISPROWS  *dr,
+                 l_int32    i)
+{
+l_int32     j, w, top, hf;
+l_float32   val1, val2, del;
+l_float32  *row, *line1, *line2;
+
+    if (dr->fpixfull)
+        return fpixGetData(dr->fpixfull) + i * fpixGetWpl(dr->fpixfull);
+
+    w = dr->w;
+    top = dr->top;
+    hf = dr->hf;
+    row = dr->row;
+    if (i < top) {  /* extend up from the first 2 rows */
+        line1 = dr->toprows;
+        line2 = dr->toprows + w;
+        for (j = 0; j < w; j++) {
+            val1 = line1[j];
+            val2 = line2[j];
+            del = val1 - val2;
+            row[j] = val1 + del * (top - i);
+        }
+    } else if (i < top + hf) {
+        disparityRowsExpand(dr, i - top, row);
+    } else {  /* extend down from the last 2 rows */
+        line1 = dr->botrows + w;
+        line2 = dr->botrows;
+        for (j = 0; j < w; j++) {
+            val1 = line1[j];
+            val2 = line2[j];
+            del = val1 - val2;
+            row[j] = val1 + del * (i - top - hf + 1);
+        }
+    }
+    return row;
+}
+
+
+/*!
+ * \brief   disparityRowsExpand()
+ *
+ * \param[in]    dr
+ * \param[in]    r       row of the expanded array, without border
+ * \param[out]   rowd    w values, including the left and right border
+ * \return  void
+ */
+static void
+disparityRowsExpand(DISPROWS   *dr,
+                    l_int32     r,
+                    l_float32  *rowd)
+{
+l_int32     i, j, k, m, ws, hs, wpls, factor, wf, w, left, jend;
+l_float32   val0, val1, val2, val3, fk, del;
+l_float32  *lines, *fract, *exprow;
+
+    fpixGetDimensions(dr->fpixs, &ws, &hs);
+    wpls = fpixGetWpl(dr->fpixs);
+    factor = dr->factor;
+    fract = dr->fract;
+    exprow = dr->exprow;
+    wf = dr->wf;
+    i = r / factor;
+    k = r % factor;
+    lines = fpixGetData(dr->fpixs) + i * wpls;
+
+        /* Interpolate between sampled rows i and i + 1.  The arithmetic
+         * is written exactly as in fpixScaleByInteger(), including the
+         * products that are done in single precision. */
+    if (i < hs - 1) {
+        fk = fract[k];
+        for (j = 0; j < ws - 1; j++) {
+            val0 = lines[j];
+            val1 = lines[j + 1];
+            val2 = lines[wpls + j];
+            val3 = lines[wpls + j + 1];
+            for (m = 0; m < factor; m++) {
+                exprow[j * factor + m] =
+                        val0 * (1.0 - fract[m]) * (1.0 - fk) +
+                        val1 * fract[m] * (1.0 - fk) +
+                        val2 * (1.0 - fract[m]) * fk +
+                        val3 * fract[m] * fk;
+            }
+        }
+        val0 = lines[ws - 1];
+        val1 = lines[wpls + ws - 1];
+        exprow[wf - 1] = val0 * (1.0 - fk) + val1 * fk;
+    } else {  /* bottom row */
+        for (j = 0; j < ws - 1; j++) {
+            val0 = lines[j];
+            val1 = lines[j + 1];
+            for (m = 0; m < factor; m++)
+                exprow[j * factor + m] = val0 * (1.0 - fract[m]) +
+                                         val1 * fract[m];
+        }
+        exprow[wf - 1] = lines[ws - 1];
+    }
+
+        /* Copy out, with slope extension to the left and right */
+    w = dr->w;
+    left = dr->left;
+    jend = L_MIN(w, left + wf);
+    val1 = exprow[0];
+    val2 = exprow[1];
+    del = val1 - val2;
+    for (j = 0; j < left && j < w; j++)
+        rowd[j] = val1 + del * (left - j);
+    for (j = left; j < jend; j++)
+        rowd[j] = exprow[j - left];
+    val1 = exprow[wf - 1];
+    val2 = exprow[wf - 2];
+    del = val1 - val2;
+    for (j = jend; j < w; j++)
+        rowd[j] = val1 + del * (j - left - wf + 1);
+}
+
+
 /*----------------------------------------------------------------------*
  *                 Apply warping disparity array to boxa                *
  *----------------------------------------------------------------------*/
@@ -550,8 +853,9 @@ PIX       *pixv, *pixh;
     *pboxad = boxaCopy(boxas, L_CLONE);
 
         /* Find the appropriate dew to use and fully populate its array(s) */
-    if (dewarpaApplyInit(dewa, pageno, pixs, x, y, &dew, debugfile))
+    if (dewarpaApplyInit(dewa, pageno, pixs, &dew, debugfile))
         return ERROR_INT("no model available", __func__, 1);
+    dewarpPopulateFullRes(dew, pixs, x, y);
 
         /* Correct for vertical disparity and save the result */
     if ((boxav = boxaApplyDisparity(dew, boxas, L_VERT, mapdir)) == NULL) {
@@ -573,7 +877,7 @@ PIX       *pixv, *pixh;
         pixRenderBoxaArb(pix1, boxas, 2, 255, 0, 0);
         pixWriteDebug("/tmp/lept/dewboxa/01.png", pix1, IFF_PNG);
         pixDestroy(&pix1);
-        pixv = pixApplyVertDisparity(dew, pixs, 255);
+        pixv = pixApplyVertDisparity(dew, pixs, x, y, 255);
         pix1 = pixConvertTo32(pixv);
         pixRenderBoxaArb(pix1, boxav, 2, 0, 255, 0);
         pixWriteDebug("/tmp/lept/dewboxa/02.png", pix1, IFF_PNG);
@@ -593,7 +897,7 @@ PIX       *pixv, *pixh;
                 *pboxad = boxah;
                 if (debug_out) {
                     PIX  *pix1;
-                    pixh = pixApplyHorizDisparity(dew, pixv, 255);
+                    pixh = pixApplyHorizDisparity(dew, pixv, x, y, 255);
                     pix1 = pixConvertTo32(pixh);
                     pixRenderBoxaArb(pix1, boxah, 2, 0, 0, 255);
                     pixWriteDebug("/tmp/lept/dewboxa/03.png", pix1, IFF_PNG);
@@ -755,6 +1059,9 @@ L_DEWARP  *dewt;
  *      (2) If pixs is not given, the size of the arrays is determined
  *          by the original image from which the sampled version was
  *          generated.  Any values of (x,y) are ignored.
+ *          If the model was built on an image reduced by redfactor,
+ *          the arrays are expanded by redfactor and the disparity
+ *          values are multiplied by it, to fit the unreduced image.
  *      (3) If pixs is given, the full resolution disparity arrays must
  *          be large enough to accommodate it.
  *          (a) If the arrays do not exist, the value of (x,y) determines
@@ -789,35 +1096,35 @@ FPIX       *fpixt1, *fpixt2;
     if (pix)
         pixGetDimensions(pix, &width, &height, NULL);
     else {
-        width = dew->w;
-        height = dew->h;
+        width = dew->redfactor * dew->w;
+        height = dew->redfactor * dew->h;
     }
 
         /* Destroy the existing arrays if they are too small */
     if (dew->fullvdispar) {
         fpixGetDimensions(dew->fullvdispar, &fw, &fh);
-        if (width > fw || height > fw)
+        if (width > fw || height > fh)
             fpixDestroy(&dew->fullvdispar);
     }
     if (dew->fullhdispar) {
         fpixGetDimensions(dew->fullhdispar, &fw, &fh);
-        if (width > fw || height > fw)
+        if (width > fw || height > fh)
             fpixDestroy(&dew->fullhdispar);
     }
 
         /* Find the required width and height expansion deltas */
-    deltaw = width - dew->sampling * (dew->nx - 1) + 2;
-    deltah = height - dew->sampling * (dew->ny - 1) + 2;
     redfactor = dew->redfactor;
-    deltaw = redfactor * L_MAX(0, deltaw);
-    deltah = redfactor * L_MAX(0, deltah);
+    deltaw = width - redfactor * dew->sampling * (dew->nx - 1) + 2;
+    deltah = height - redfactor * dew->sampling * (dew->ny - 1) + 2;
+    deltaw = L_MAX(0, deltaw);
+    deltah = L_MAX(0, deltah);
 
         /* Generate the full res vertical array if it doesn't exist,
          * extending it as required to make it big enough.  Use x,y
          * to determine the amounts on each side. */
     if (!dew->fullvdispar) {
         fpixt1 = fpixCopy(dew->sampvdispar);
-        if (redfactor == 2)
+        if (redfactor > 1)
             fpixAddMultConstant(fpixt1, 0.0, (l_float32)redfactor);
         fpixt2 = fpixScaleByInteger(fpixt1, dew->sampling * redfactor);
         fpixDestroy(&fpixt1);
@@ -836,7 +1143,7 @@ FPIX       *fpixt1, *fpixt2;
          * not if required to skip running horizontal disparity. */
     if (!dew->fullhdispar && dew->samphdispar && !dew->skip_horiz) {
         fpixt1 = fpixCopy(dew->samphdispar);
-        if (redfactor == 2)
+        if (redfactor > 1)
             fpixAddMultConstant(fpixt1, 0.0, (l_float32)redfactor);
         fpixt2 = fpixScaleByInteger(fpixt1, dew->sampling * redfactor);
         fpixDestroy(&fpixt1);
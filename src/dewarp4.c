@@ -43,6 +43,8 @@
  *          l_int32            dewarpaInsertRefModels()
  *          l_int32            dewarpaStripRefModels()
  *          l_int32            dewarpaRestoreModels()
+ *          l_int32            dewarpaBuildModels()
+ *          static l_int32     dewarpaHasReusableModel()
  *
  *      Dewarp debugging output
  *          l_int32            dewarpaInfo()
@@ -63,6 +65,7 @@
 
 static l_int32 dewarpaTestForValidModel(L_DEWARPA *dewa, L_DEWARP *dew,
                                         l_int32 notests);
+static l_int32 dewarpaHasReusableModel(L_DEWARPA *dewa, l_int32 pageno);
 
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_INVALID_MODELS      0   /* set this to 1 for debugging */
@@ -641,6 +644,155 @@ L_DEWARP  *dew;
 }
 
 
+/*!
+ * \brief   dewarpaBuildModels()
+ *
+ * \param[in]    dewa
+ * \param[in]    pixac       1 bpp page images, with 1x1x1 placeholders
+ * \param[in]    reusedist   max distance to a page on the same side
+ *                           whose model is used instead of building one;
+ *                           use 0 to build a model for every page
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This builds page models for the images in %pixac, and
+ *          then inserts the ref models.  The page number of each image
+ *          is its index in %pixac, which includes the pixacomp offset.
+ *          Placeholder images are skipped.
+ *      (2) Pages that already have a model in %dewa are not rebuilt.
+ *          A dewa of minimized models is small: it holds only the
+ *          sampled disparity arrays.  So a dewa that was serialized
+ *          with dewarpaWrite() can serve as a cache of page models.
+ *          Read it back with dewarpaRead(), and this only builds
+ *          models for new pages.  To apply the cached models to images
+ *          at another resolution, use dewarpaSetRedfactor().
+ *      (3) Facing pages are warped differently, but a page is usually
+ *          warped like nearby pages on the same side of the book.
+ *          If %reusedist > 0, the pages are taken in order, and a page
+ *          is skipped if a page of the same parity within %reusedist
+ *          already has a valid model.  The skipped page then gets
+ *          a ref model.  For example, with %reusedist = 2, a model is
+ *          built on every other page of each side.  %reusedist is
+ *          limited to the maxdist of %dewa, beyond which ref models
+ *          are not used.
+ *      (4) Models that fail to build are removed; those pages also
+ *          get ref models if possible.  Each model is minimized after
+ *          it is built, so memory does not grow with the number of pages.
+ * </pre>
+ */
+l_ok
+dewarpaBuildModels(L_DEWARPA  *dewa,
+                   PIXAC      *pixac,
+                   l_int32     reusedist)
+{
+l_int32    i, k, n, pageno, refpage;
+L_DEWARP  *dew;
+PIX       *pix;
+
+    if (!dewa)
+        return ERROR_INT("dewa not defined", __func__, 1);
+    if (!pixac)
+        return ERROR_INT("pixac not defined", __func__, 1);
+    if (reusedist > dewa->maxdist) {
+        L_WARNING("reusedist = %d > maxdist; reducing to %d\n", __func__,
+                  reusedist, dewa->maxdist);
+        reusedist = dewa->maxdist;
+    }
+
+        /* Put all existing page models back in the main array */
+    if (dewarpaRestoreModels(dewa))
+        return ERROR_INT("models not restored", __func__, 1);
+
+    n = pixacompGetCount(pixac);
+    for (i = 0; i < n; i++) {
+        pageno = pixacompGetOffset(pixac) + i;
+        if (pageno <= dewa->maxpage && dewa->dewarp[pageno])
+            continue;  /* already has a model */
+
+            /* Use a valid model on a nearby page of the same parity.
+             * The ref is inserted here so that this page is included
+             * when the ref models are inserted below. */
+        refpage = -1;
+        for (k = 2; k <= reusedist && refpage < 0; k += 2) {
+            if (dewarpaHasReusableModel(dewa, pageno - k))
+                refpage = pageno - k;
+            else if (dewarpaHasReusableModel(dewa, pageno + k))
+                refpage = pageno + k;
+        }
+        if (refpage >= 0) {
+            if ((dew = dewarpCreateRef(pageno, refpage)) == NULL)
+                return ERROR_INT("ref dew not made", __func__, 1);
+            if (dewarpaInsertDewarp(dewa, dew)) {
+                dewarpDestroy(&dew);
+                return ERROR_INT("ref dew not inserted", __func__, 1);
+            }
+            continue;
+        }
+
+        pix = pixacompGetPix(pixac, pageno);
+        if (!pix || pixGetWidth(pix) <= 1) {  /* placeholder */
+            pixDestroy(&pix);
+            continue;
+        }
+        dew = dewarpCreate(pix, pageno);
+        pixDestroy(&pix);
+        if (!dew) {
+            L_ERROR("unable to make dew for page %d\n", __func__, pageno);
+            continue;
+        }
+
+            /* Insert into dewa and build disparity arrays for this page */
+        if (dewarpaInsertDewarp(dewa, dew)) {
+            dewarpDestroy(&dew);
+            return ERROR_INT("dew not inserted", __func__, 1);
+        }
+        dewarpBuildPageModel(dew, NULL);
+        if (!dew->vsuccess) {  /* will need to use model from nearby page */
+            dewarpaDestroyDewarp(dewa, pageno);
+            L_ERROR("unable to build model for page %d\n", __func__, pageno);
+            continue;
+        }
+        dewarpMinimize(dew);  /* remove all extraneous data */
+    }
+
+    if (dewarpaInsertRefModels(dewa, 0, 0))
+        return ERROR_INT("ref models not inserted", __func__, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   dewarpaHasReusableModel()
+ *
+ * \param[in]    dewa
+ * \param[in]    pageno
+ * \return  1 if the page has a valid model that can be used as a ref
+ *              model by other pages, 0 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) If useboth is set, the model must have a valid horizontal
+ *          disparity array as well.
+ * </pre>
+ */
+static l_int32
+dewarpaHasReusableModel(L_DEWARPA  *dewa,
+                        l_int32     pageno)
+{
+L_DEWARP  *dew;
+
+    if (pageno < 0 || pageno > dewa->maxpage)
+        return 0;
+    if ((dew = dewa->dewarp[pageno]) == NULL || dew->hasref)
+        return 0;
+    dewarpaTestForValidModel(dewa, dew, 0);
+    if (!dew->vvalid)
+        return 0;
+    return (dewa->useboth) ? dew->hvalid : 1;
+}
+
+
 /*----------------------------------------------------------------------*
  *                      Dewarp debugging output                         *
  *----------------------------------------------------------------------*/
@@ -126,6 +126,9 @@ typedef uintptr_t l_uintptr_t;
   #if !defined(HAVE_LIBZ)
   #define  HAVE_LIBZ          1
   #endif
+  #if !defined(HAVE_LIBDEFLATE)
+  #define  HAVE_LIBDEFLATE    0
+  #endif
   #if !defined(HAVE_LIBGIF)
   #define  HAVE_LIBGIF        0
   #endif
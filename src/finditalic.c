@@ -141,7 +141,7 @@ SEL     *sel_ital1, *sel_ital2, *sel_ital3;
          * The noise removal close/open is important to exclude
          * situations where a small slanted line accidentally
          * matches sel_ital1. */
-    pixsd = pixHMT(NULL, pixs, sel_ital1);
+    pixsd = pixHMTSearch(pixs, sel_ital1, NULL);
     pixClose(pixsd, pixsd, sel_ital3);
     pixOpen(pixsd, pixsd, sel_ital3);
 
@@ -417,7 +417,8 @@ PIX       *pix1;
  *          biased signal.  It may be advisable to run a table detector
  *          first (e.g., pixDecideIfTable()), and not run the orientation
  *          detector if it is a table.
- *      (9) Uses rasterop implementation of HMT.
+ *      (9) Uses pixHMTSearch(), which only evaluates the full HMT Sels
+ *          at candidate locations.
  * </pre>
  */
 l_ok
@@ -633,8 +634,8 @@ SEL       *sel1, *sel2, *sel3, *sel4;
         /* Find the ascenders and optionally filter with pixm.
          * For an explanation of the procedure used for counting the result
          * of the HMT, see comments at the beginning of this function. */
-    pix1 = pixHMT(NULL, pix0, sel1);
-    pix2 = pixHMT(NULL, pix0, sel2);
+    pix1 = pixHMTSearch(pix0, sel1, NULL);
+    pix2 = pixHMTSearch(pix0, sel2, NULL);
     pixOr(pix1, pix1, pix2);
     if (pixm)
         pixAnd(pix1, pix1, pixm);
@@ -646,8 +647,8 @@ SEL       *sel1, *sel2, *sel3, *sel4;
     pixDestroy(&pix3);
 
         /* Find the ascenders and optionally filter with pixm. */
-    pix1 = pixHMT(NULL, pix0, sel3);
-    pix2 = pixHMT(NULL, pix0, sel4);
+    pix1 = pixHMTSearch(pix0, sel3, NULL);
+    pix2 = pixHMTSearch(pix0, sel4, NULL);
     pixOr(pix1, pix1, pix2);
     if (pixm)
         pixAnd(pix1, pix1, pixm);
@@ -765,7 +766,7 @@ SEL       *sel1, *sel2;
     pixDestroy(&pix3);
 
         /* Filter the right-facing characters. */
-    pix1 = pixHMT(NULL, pix0, sel1);
+    pix1 = pixHMTSearch(pix0, sel1, NULL);
     pix3 = pixReduceRankBinaryCascade(pix1, 1, 1, 0, 0);
     pixCountPixels(pix3, &count1, NULL);
     pixDebugFlipDetect("/tmp/lept/orient/right.png", pixs, pix1, debug);
@@ -773,7 +774,7 @@ SEL       *sel1, *sel2;
     pixDestroy(&pix3);
 
         /* Filter the left-facing characters. */
-    pix2 = pixHMT(NULL, pix0, sel2);
+    pix2 = pixHMTSearch(pix0, sel2, NULL);
     pix3 = pixReduceRankBinaryCascade(pix2, 1, 1, 0, 0);
     pixCountPixels(pix3, &count2, NULL);
     pixDebugFlipDetect("/tmp/lept/orient/left.png", pixs, pix2, debug);
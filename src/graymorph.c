@@ -48,6 +48,10 @@
  *      Low-level grayscale morphological operations
  *            static void    dilateGrayLow()
  *            static void    erodeGrayLow()
+ *            static void    grayMorphLow()
+ *            static void    grayExtremeLineLow()
+ *            static void    grayRunningExtremaLow()
+ *            static l_uint32 byteGEMask()
  *
  *
  *      Method: Algorithm by van Herk and Gil and Werman, 1992
@@ -58,6 +62,17 @@
  *      or closing, or for a square SE, as expected, and is independent
  *      of the size of the SE.
  *
+ *      The vertical operations work on entire rows at a time, so the
+ *      image is accessed in raster order and the inner loops can be
+ *      vectorized by the compiler.  This is several times faster than
+ *      going down each column.  The horizontal operations unpack each
+ *      line into arrays of pixels in order.
+ *
+ *      The general functions take 8, 16 or 32 bpp images.  For 32 bpp,
+ *      each byte of the pixel is a separate channel, and the packed
+ *      pixels are processed directly, with all channels of each
+ *      pixel handled together.  This is used for color morphology.
+ *
  *      A faster implementation can be made directly for brick Sels
  *      of maximum size 3.  We unroll the computation for sets of 8 bytes.
  *      It needs to be called explicitly; the general functions do not
@@ -123,6 +138,7 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
     /* Special static operations for 3x1, 1x3 and 3x3 structuring elements */
@@ -132,14 +148,22 @@ static PIX *pixDilateGray3h(PIX *pixs);
 static PIX *pixDilateGray3v(PIX *pixs);
 
     /*  Low-level gray morphological operations */
-static void dilateGrayLow(l_uint32 *datad, l_int32 w, l_int32 h,
+static void dilateGrayLow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 d,
                           l_int32 wpld, l_uint32 *datas, l_int32 wpls,
-                          l_int32 size, l_int32 direction, l_uint8 *buffer,
-                          l_uint8 *maxarray);
-static void erodeGrayLow(l_uint32 *datad, l_int32 w, l_int32 h,
+                          l_int32 size, l_int32 direction);
+static void erodeGrayLow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 d,
+                         l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                         l_int32 size, l_int32 direction);
+static void grayMorphLow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 d,
                          l_int32 wpld, l_uint32 *datas, l_int32 wpls,
-                         l_int32 size, l_int32 direction, l_uint8 *buffer,
-                         l_uint8 *minarray);
+                         l_int32 size, l_int32 direction, l_int32 type);
+static void grayExtremeLineLow(void *lined, const void *line1,
+                               const void *line2, l_int32 n, l_int32 d,
+                               l_int32 type);
+static void grayRunningExtremaLow(void *fwd, void *bwd, const void *line,
+                                  l_int32 w, l_int32 size, l_int32 d,
+                                  l_int32 type);
+static l_uint32 byteGEMask(l_uint32 val1, l_uint32 val2);
 
 /*-----------------------------------------------------------------*
  *           Top-level grayscale morphological operations          *
@@ -147,7 +171,7 @@ static void erodeGrayLow(l_uint32 *datad, l_int32 w, l_int32 h,
 /*!
  * \brief   pixErodeGray()
  *
- * \param[in]    pixs
+ * \param[in]    pixs   8, 16 or 32 bpp
  * \param[in]    hsize  of Sel; must be odd; origin implicitly in center
  * \param[in]    vsize  ditto
  * \return  pixd
@@ -156,6 +180,8 @@ static void erodeGrayLow(l_uint32 *datad, l_int32 w, l_int32 h,
  * Notes:
  *      (1) Sel is a brick with all elements being hits
  *      (2) If hsize = vsize = 1, just returns a copy.
+ *      (3) For 32 bpp, the operation is done on each byte (component)
+ *          independently, including the alpha byte.
  * </pre>
  */
 PIX *
@@ -163,16 +189,17 @@ pixErodeGray(PIX     *pixs,
              l_int32  hsize,
              l_int32  vsize)
 {
-l_uint8   *buffer, *minarray;
-l_int32    w, h, wplb, wplt;
-l_int32    leftpix, rightpix, toppix, bottompix, maxsize;
+l_int32    w, h, d, wplb, wplt;
+l_int32    leftpix, rightpix, toppix, bottompix;
+l_uint32   maxval;
 l_uint32  *datab, *datat;
 PIX       *pixb, *pixt, *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
-    if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs not 8 bpp", __func__, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8, 16 or 32 bpp", __func__, NULL);
     if (hsize < 1 || vsize < 1)
         return (PIX *)ERROR_PTR("hsize or vsize < 1", __func__, NULL);
     if ((hsize & 1) == 0 ) {
@@ -185,7 +212,6 @@ PIX       *pixb, *pixt, *pixd;
     }
 
     pixb = pixt = pixd = NULL;
-    buffer = minarray = NULL;
 
     if (hsize == 1 && vsize == 1)
         return pixCopy(NULL, pixs);
@@ -207,7 +233,9 @@ PIX       *pixb, *pixt, *pixd;
         bottompix = (3 * vsize + 1) / 2;
     }
 
-    pixb = pixAddBorderGeneral(pixs, leftpix, rightpix, toppix, bottompix, 255);
+    maxval = (d == 8) ? 0xff : ((d == 16) ? 0xffff : 0xffffffff);
+    pixb = pixAddBorderGeneral(pixs, leftpix, rightpix, toppix, bottompix,
+                               maxval);
     pixt = pixCreateTemplate(pixb);
     if (!pixb || !pixt) {
         L_ERROR("pixb and pixt not made\n", __func__);
@@ -220,27 +248,15 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
-    maxsize = L_MAX(hsize, vsize);
-    minarray = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
-    if (!buffer || !minarray) {
-        L_ERROR("buffer and minarray not made\n", __func__);
-        goto cleanup;
-    }
-
     if (vsize == 1) {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, minarray);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
     } else if (hsize == 1) {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, vsize, L_VERT,
-                     buffer, minarray);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, vsize, L_VERT);
     } else {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, minarray);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                     buffer, minarray);
+        erodeGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
         pixDestroy(&pixt);
         pixt = pixClone(pixb);
     }
@@ -250,8 +266,6 @@ PIX       *pixb, *pixt, *pixd;
         L_ERROR("pixd not made\n", __func__);
 
 cleanup:
-    LEPT_FREE(buffer);
-    LEPT_FREE(minarray);
     pixDestroy(&pixb);
     pixDestroy(&pixt);
     return pixd;
@@ -261,7 +275,7 @@ cleanup:
 /*!
  * \brief   pixDilateGray()
  *
- * \param[in]    pixs
+ * \param[in]    pixs   8, 16 or 32 bpp
  * \param[in]    hsize  of Sel; must be odd; origin implicitly in center
  * \param[in]    vsize  ditto
  * \return  pixd
@@ -270,6 +284,8 @@ cleanup:
  * Notes:
  *      (1) Sel is a brick with all elements being hits
  *      (2) If hsize = vsize = 1, just returns a copy.
+ *      (3) For 32 bpp, the operation is done on each byte (component)
+ *          independently, including the alpha byte.
  * </pre>
  */
 PIX *
@@ -277,16 +293,16 @@ pixDilateGray(PIX     *pixs,
               l_int32  hsize,
               l_int32  vsize)
 {
-l_uint8   *buffer, *maxarray;
-l_int32    w, h, wplb, wplt;
-l_int32    leftpix, rightpix, toppix, bottompix, maxsize;
+l_int32    w, h, d, wplb, wplt;
+l_int32    leftpix, rightpix, toppix, bottompix;
 l_uint32  *datab, *datat;
 PIX       *pixb, *pixt, *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
-    if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs not 8 bpp", __func__, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8, 16 or 32 bpp", __func__, NULL);
     if (hsize < 1 || vsize < 1)
         return (PIX *)ERROR_PTR("hsize or vsize < 1", __func__, NULL);
     if ((hsize & 1) == 0 ) {
@@ -299,7 +315,6 @@ PIX       *pixb, *pixt, *pixd;
     }
 
     pixb = pixt = pixd = NULL;
-    buffer = maxarray = NULL;
 
     if (hsize == 1 && vsize == 1)
         return pixCopy(NULL, pixs);
@@ -334,27 +349,15 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
-    maxsize = L_MAX(hsize, vsize);
-    maxarray = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
-    if (!buffer || !maxarray) {
-        L_ERROR("buffer and maxarray not made\n", __func__);
-        goto cleanup;
-    }
-
     if (vsize == 1) {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                      buffer, maxarray);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
     } else if (hsize == 1) {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, vsize, L_VERT,
-                      buffer, maxarray);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, vsize, L_VERT);
     } else {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                      buffer, maxarray);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                      buffer, maxarray);
+        dilateGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
         pixDestroy(&pixt);
         pixt = pixClone(pixb);
     }
@@ -364,8 +367,6 @@ PIX       *pixb, *pixt, *pixd;
         L_ERROR("pixd not made\n", __func__);
 
 cleanup:
-    LEPT_FREE(buffer);
-    LEPT_FREE(maxarray);
     pixDestroy(&pixb);
     pixDestroy(&pixt);
     return pixd;
@@ -375,7 +376,7 @@ cleanup:
 /*!
  * \brief   pixOpenGray()
  *
- * \param[in]    pixs
+ * \param[in]    pixs   8, 16 or 32 bpp
  * \param[in]    hsize  of Sel; must be odd; origin implicitly in center
  * \param[in]    vsize  ditto
  * \return  pixd
@@ -384,6 +385,8 @@ cleanup:
  * Notes:
  *      (1) Sel is a brick with all elements being hits
  *      (2) If hsize = vsize = 1, just returns a copy.
+ *      (3) For 32 bpp, the operation is done on each byte (component)
+ *          independently, including the alpha byte.
  * </pre>
  */
 PIX *
@@ -391,17 +394,17 @@ pixOpenGray(PIX     *pixs,
             l_int32  hsize,
             l_int32  vsize)
 {
-l_uint8   *buffer;
-l_uint8   *array;  /* used to find either min or max in interval */
-l_int32    w, h, wplb, wplt;
-l_int32    leftpix, rightpix, toppix, bottompix, maxsize;
+l_int32    w, h, d, wplb, wplt;
+l_int32    leftpix, rightpix, toppix, bottompix;
+l_uint32   maxval;
 l_uint32  *datab, *datat;
 PIX       *pixb, *pixt, *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
-    if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs not 8 bpp", __func__, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8, 16 or 32 bpp", __func__, NULL);
     if (hsize < 1 || vsize < 1)
         return (PIX *)ERROR_PTR("hsize or vsize < 1", __func__, NULL);
     if ((hsize & 1) == 0 ) {
@@ -414,7 +417,6 @@ PIX       *pixb, *pixt, *pixd;
     }
 
     pixb = pixt = pixd = NULL;
-    buffer = array = NULL;
 
     if (hsize == 1 && vsize == 1)
         return pixCopy(NULL, pixs);
@@ -436,7 +438,9 @@ PIX       *pixb, *pixt, *pixd;
         bottompix = (3 * vsize + 1) / 2;
     }
 
-    pixb = pixAddBorderGeneral(pixs, leftpix, rightpix, toppix, bottompix, 255);
+    maxval = (d == 8) ? 0xff : ((d == 16) ? 0xffff : 0xffffffff);
+    pixb = pixAddBorderGeneral(pixs, leftpix, rightpix, toppix, bottompix,
+                               maxval);
     pixt = pixCreateTemplate(pixb);
     if (!pixb || !pixt) {
         L_ERROR("pixb and pixt not made\n", __func__);
@@ -449,44 +453,28 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
-    maxsize = L_MAX(hsize, vsize);
-    array = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
-    if (!buffer || !array) {
-        L_ERROR("buffer and array not made\n", __func__);
-        goto cleanup;
-    }
-
     if (vsize == 1) {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, array);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datab, w, h, wplb, datat, wplt, hsize, L_HORIZ,
-                      buffer, array);
+        dilateGrayLow(datab, w, h, d, wplb, datat, wplt, hsize, L_HORIZ);
     }
     else if (hsize == 1) {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, vsize, L_VERT,
-                     buffer, array);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, vsize, L_VERT);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                      buffer, array);
+        dilateGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
     } else {
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, array);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                     buffer, array);
+        erodeGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
         pixSetOrClearBorder(pixb, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                      buffer, array);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                      buffer, array);
+        dilateGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
     }
 
     pixd = pixRemoveBorderGeneral(pixb, leftpix, rightpix, toppix, bottompix);
@@ -494,8 +482,6 @@ PIX       *pixb, *pixt, *pixd;
         L_ERROR("pixd not made\n", __func__);
 
 cleanup:
-    LEPT_FREE(buffer);
-    LEPT_FREE(array);
     pixDestroy(&pixb);
     pixDestroy(&pixt);
     return pixd;
@@ -505,7 +491,7 @@ cleanup:
 /*!
  * \brief   pixCloseGray()
  *
- * \param[in]    pixs
+ * \param[in]    pixs   8, 16 or 32 bpp
  * \param[in]    hsize  of Sel; must be odd; origin implicitly in center
  * \param[in]    vsize  ditto
  * \return  pixd
@@ -514,6 +500,8 @@ cleanup:
  * Notes:
  *      (1) Sel is a brick with all elements being hits
  *      (2) If hsize = vsize = 1, just returns a copy.
+ *      (3) For 32 bpp, the operation is done on each byte (component)
+ *          independently, including the alpha byte.
  * </pre>
  */
 PIX *
@@ -521,17 +509,16 @@ pixCloseGray(PIX     *pixs,
              l_int32  hsize,
              l_int32  vsize)
 {
-l_uint8   *buffer;
-l_uint8   *array;  /* used to find either min or max in interval */
-l_int32    w, h, wplb, wplt;
-l_int32    leftpix, rightpix, toppix, bottompix, maxsize;
+l_int32    w, h, d, wplb, wplt;
+l_int32    leftpix, rightpix, toppix, bottompix;
 l_uint32  *datab, *datat;
 PIX       *pixb, *pixt, *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
-    if (pixGetDepth(pixs) != 8)
-        return (PIX *)ERROR_PTR("pixs not 8 bpp", __func__, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8, 16 or 32 bpp", __func__, NULL);
     if (hsize < 1 || vsize < 1)
         return (PIX *)ERROR_PTR("hsize or vsize < 1", __func__, NULL);
     if ((hsize & 1) == 0 ) {
@@ -544,7 +531,6 @@ PIX       *pixb, *pixt, *pixd;
     }
 
     pixb = pixt = pixd = NULL;
-    buffer = array = NULL;
 
     if (hsize == 1 && vsize == 1)
         return pixCopy(NULL, pixs);
@@ -579,43 +565,27 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
-    maxsize = L_MAX(hsize, vsize);
-    array = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
-    if (!buffer || !array) {
-        L_ERROR("buffer and array not made\n", __func__);
-        goto cleanup;
-    }
-
     if (vsize == 1) {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, array);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datab, w, h, wplb, datat, wplt, hsize, L_HORIZ,
-                      buffer, array);
+        erodeGrayLow(datab, w, h, d, wplb, datat, wplt, hsize, L_HORIZ);
     } else if (hsize == 1) {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, vsize, L_VERT,
-                     buffer, array);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, vsize, L_VERT);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                      buffer, array);
+        erodeGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
     } else {
-        dilateGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                      buffer, array);
+        dilateGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_CLR);
-        dilateGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                      buffer, array);
+        dilateGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
         pixSetOrClearBorder(pixb, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datat, w, h, wplt, datab, wplb, hsize, L_HORIZ,
-                     buffer, array);
+        erodeGrayLow(datat, w, h, d, wplt, datab, wplb, hsize, L_HORIZ);
         pixSetOrClearBorder(pixt, leftpix, rightpix, toppix, bottompix,
                             PIX_SET);
-        erodeGrayLow(datab, w, h, wplb, datat, wplt, vsize, L_VERT,
-                     buffer, array);
+        erodeGrayLow(datab, w, h, d, wplb, datat, wplt, vsize, L_VERT);
     }
 
     pixd = pixRemoveBorderGeneral(pixb, leftpix, rightpix, toppix, bottompix);
@@ -623,8 +593,6 @@ PIX       *pixb, *pixt, *pixd;
         L_ERROR("pixd not made\n", __func__);
 
 cleanup:
-    LEPT_FREE(buffer);
-    LEPT_FREE(array);
     pixDestroy(&pixb);
     pixDestroy(&pixt);
     return pixd;
@@ -1132,15 +1100,14 @@ PIX  *pixt, *pixb, *pixbd, *pixd;
 /*!
  * \brief   dilateGrayLow()
  *
- * \param[in]    datad       8 bpp dsst image
+ * \param[in]    datad       8, 16 or 32 bpp dest image
  * \param[in]    w, h        dimensions of src and dest
+ * \param[in]    d           depth of src and dest: 8, 16 or 32
  * \param[in]    wpld        words/line of dest
- * \param[in]    datas       8 bpp src image
+ * \param[in]    datas       8, 16 or 32 bpp src image
  * \param[in]    wpls        words/line of src
  * \param[in]    size        full length of SEL; restricted to odd numbers
  * \param[in]    direction   L_HORIZ or L_VERT
- * \param[in]    buffer      holds full line or column of src image pixels
- * \param[in]    maxarray    array of dimension 2*size+1
  * \return  void
  *
  * <pre>
@@ -1154,199 +1121,433 @@ PIX  *pixt, *pixb, *pixbd, *pixd;
  *            and we initialize the src border pixels to 0.
  *            This allows full processing over the actual image; at
  *            the end the border is removed.
- *        (2) Uses algorithm of van Herk, Gil and Werman
+ *        (2) Uses algorithm of van Herk, Gil and Werman.
+ *            See grayMorphLow().
  * </pre>
  */
 static void
 dilateGrayLow(l_uint32  *datad,
               l_int32    w,
               l_int32    h,
+              l_int32    d,
               l_int32    wpld,
               l_uint32  *datas,
               l_int32    wpls,
               l_int32    size,
-              l_int32    direction,
-              l_uint8   *buffer,
-              l_uint8   *maxarray)
+              l_int32    direction)
 {
-l_int32    i, j, k;
-l_int32    hsize, nsteps, startmax, startx, starty;
-l_uint8    maxval;
-l_uint32  *lines, *lined;
-
-    if (direction == L_HORIZ) {
-        hsize = size / 2;
-        nsteps = (w - 2 * hsize) / size;
-        for (i = 0; i < h; i++) {
-            lines = datas + i * wpls;
-            lined = datad + i * wpld;
-
-                /* fill buffer with pixels in byte order */
-            for (j = 0; j < w; j++)
-                buffer[j] = GET_DATA_BYTE(lines, j);
-
-            for (j = 0; j < nsteps; j++) {
-                    /* refill the minarray */
-                startmax = (j + 1) * size - 1;
-                maxarray[size - 1] = buffer[startmax];
-                for (k = 1; k < size; k++) {
-                    maxarray[size - 1 - k] =
-                        L_MAX(maxarray[size - k], buffer[startmax - k]);
-                    maxarray[size - 1 + k] =
-                        L_MAX(maxarray[size + k - 2], buffer[startmax + k]);
-                }
-
-                    /* compute dilation values */
-                startx = hsize + j * size;
-                SET_DATA_BYTE(lined, startx, maxarray[0]);
-                SET_DATA_BYTE(lined, startx + size - 1, maxarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    maxval = L_MAX(maxarray[k], maxarray[k + size - 1]);
-                    SET_DATA_BYTE(lined, startx + k, maxval);
-                }
-            }
-        }
-    } else {  /* direction == L_VERT */
-        hsize = size / 2;
-        nsteps = (h - 2 * hsize) / size;
-        for (j = 0; j < w; j++) {
-                /* fill buffer with pixels in byte order */
-            for (i = 0; i < h; i++) {
-                lines = datas + i * wpls;
-                buffer[i] = GET_DATA_BYTE(lines, j);
-            }
-
-            for (i = 0; i < nsteps; i++) {
-                    /* refill the minarray */
-                startmax = (i + 1) * size - 1;
-                maxarray[size - 1] = buffer[startmax];
-                for (k = 1; k < size; k++) {
-                    maxarray[size - 1 - k] =
-                        L_MAX(maxarray[size - k], buffer[startmax - k]);
-                    maxarray[size - 1 + k] =
-                        L_MAX(maxarray[size + k - 2], buffer[startmax + k]);
-                }
-
-                    /* compute dilation values */
-                starty = hsize + i * size;
-                lined = datad + starty * wpld;
-                SET_DATA_BYTE(lined, j, maxarray[0]);
-                SET_DATA_BYTE(lined + (size - 1) * wpld, j,
-                        maxarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    maxval = L_MAX(maxarray[k], maxarray[k + size - 1]);
-                    SET_DATA_BYTE(lined + wpld * k, j, maxval);
-                }
-            }
-        }
-    }
-
-    return;
+    grayMorphLow(datad, w, h, d, wpld, datas, wpls, size, direction,
+                 L_MORPH_DILATE);
 }
 
 
 /*!
  * \brief   erodeGrayLow()
  *
- * \param[in]    datad       8 bpp dsst image
+ * \param[in]    datad       8, 16 or 32 bpp dest image
  * \param[in]    w, h        dimensions of src and dest
+ * \param[in]    d           depth of src and dest: 8, 16 or 32
  * \param[in]    wpld        words/line of dest
- * \param[in]    datas       8 bpp src image
+ * \param[in]    datas       8, 16 or 32 bpp src image
  * \param[in]    wpls        words/line of src
  * \param[in]    size        full length of SEL; restricted to odd numbers
  * \param[in]    direction   L_HORIZ or L_VERT
- * \param[in]    buffer      holds full line or column of src image pixels
- * \param[in]    minarray    array of dimension 2*size+1
  * \return  void
  *
  * <pre>
  * Notes:
- *        (1) See notes in dilateGrayLow()
+ *        (1) See notes in dilateGrayLow().  The src border pixels
+ *            are initialized to the maximum value.
  * </pre>
  */
 static void
 erodeGrayLow(l_uint32  *datad,
              l_int32    w,
              l_int32    h,
+             l_int32    d,
+             l_int32    wpld,
+             l_uint32  *datas,
+             l_int32    wpls,
+             l_int32    size,
+             l_int32    direction)
+{
+    grayMorphLow(datad, w, h, d, wpld, datas, wpls, size, direction,
+                 L_MORPH_ERODE);
+}
+
+
+/*!
+ * \brief   grayMorphLow()
+ *
+ * \param[in]    datad       8, 16 or 32 bpp dest image
+ * \param[in]    w, h        dimensions of src and dest
+ * \param[in]    d           depth of src and dest: 8, 16 or 32
+ * \param[in]    wpld        words/line of dest
+ * \param[in]    datas       8, 16 or 32 bpp src image
+ * \param[in]    wpls        words/line of src
+ * \param[in]    size        full length of SEL; restricted to odd numbers
+ * \param[in]    direction   L_HORIZ or L_VERT
+ * \param[in]    type        L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *        (1) The line is divided into blocks of %size pixels, starting
+ *            at 0.  In each block we find the running extremum going
+ *            forward from the start of the block, and the running
+ *            extremum going backward from the end of the block.
+ *            Any window of %size pixels covers either one block or
+ *            the end of one block and the start of the next, so the
+ *            result centered at x is the extremum of the backward
+ *            value at x - size/2 and the forward value at x + size/2.
+ *            This is computed for all pixels that are at least size/2
+ *            from the ends of the line.  The others, which are in the
+ *            border, are not used.
+ *        (2) For the horizontal direction, each src line is unpacked
+ *            into an array, and the forward and backward arrays are
+ *            made from it.  For 32 bpp the words are already in pixel
+ *            order, so the src and dest lines are used directly.
+ *        (3) For the vertical direction we work on entire rows at a
+ *            time, so that the image is accessed in raster order and
+ *            the inner loops, in grayExtremeLineLow(), can be vectorized
+ *            by the compiler.  The forward running extrema are
+ *            written directly to the dest rows; the backward running
+ *            extrema need a buffer of only %size rows.  Each dest row
+ *            is written after the forward value stored in it has been
+ *            used for the last time.
+ *        (4) datad and datas must be different.
+ * </pre>
+ */
+static void
+grayMorphLow(l_uint32  *datad,
+             l_int32    w,
+             l_int32    h,
+             l_int32    d,
              l_int32    wpld,
              l_uint32  *datas,
              l_int32    wpls,
              l_int32    size,
              l_int32    direction,
-             l_uint8   *buffer,
-             l_uint8   *minarray)
+             l_int32    type)
 {
-l_int32    i, j, k;
-l_int32    hsize, nsteps, startmin, startx, starty;
-l_uint8    minval;
-l_uint32  *lines, *lined;
+l_int32    i, j, k, hsize, bstart, bend, n, wpl, last;
+l_uint32  *lines, *lined, *linet, *datat;
+l_uint32  *buffer, *fwd, *bwd, *lineout;
 
+    hsize = size / 2;
     if (direction == L_HORIZ) {
-        hsize = size / 2;
-        nsteps = (w - 2 * hsize) / size;
+        wpl = L_MIN(wpls, wpld);
+        if ((buffer = (l_uint32 *)LEPT_CALLOC(4 * wpl, sizeof(l_uint32)))
+            == NULL) {
+            L_ERROR("buffer not made\n", __func__);
+            return;
+        }
+        fwd = buffer + wpl;
+        bwd = buffer + 2 * wpl;
+        lineout = buffer + 3 * wpl;
+        n = w - 2 * hsize;
         for (i = 0; i < h; i++) {
             lines = datas + i * wpls;
             lined = datad + i * wpld;
 
-                /* fill buffer with pixels in byte order */
-            for (j = 0; j < w; j++)
-                buffer[j] = GET_DATA_BYTE(lines, j);
-
-            for (j = 0; j < nsteps; j++) {
-                    /* refill the minarray */
-                startmin = (j + 1) * size - 1;
-                minarray[size - 1] = buffer[startmin];
-                for (k = 1; k < size; k++) {
-                    minarray[size - 1 - k] =
-                        L_MIN(minarray[size - k], buffer[startmin - k]);
-                    minarray[size - 1 + k] =
-                        L_MIN(minarray[size + k - 2], buffer[startmin + k]);
-                }
+                /* 32 bpp pixels are already in order in the line */
+            if (d == 32) {
+                grayRunningExtremaLow(fwd, bwd, lines, w, size, d, type);
+                if (n > 0)
+                    grayExtremeLineLow(lined + hsize, bwd, fwd + 2 * hsize,
+                                       n, d, type);
+                continue;
+            }
 
-                    /* compute erosion values */
-                startx = hsize + j * size;
-                SET_DATA_BYTE(lined, startx, minarray[0]);
-                SET_DATA_BYTE(lined, startx + size - 1, minarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    minval = L_MIN(minarray[k], minarray[k + size - 1]);
-                    SET_DATA_BYTE(lined, startx + k, minval);
-                }
+                /* put the pixels in order in the line buffer */
+            if (d == 8) {
+                lineEndianByteSwap(buffer, lines, wpl);
+            } else {  /* d == 16 */
+                for (j = 0; j < w; j++)
+                    ((l_uint16 *)buffer)[j] = GET_DATA_TWO_BYTES(lines, j);
+            }
+
+            grayRunningExtremaLow(fwd, bwd, buffer, w, size, d, type);
+            if (n <= 0) continue;
+
+                /* the result at j + hsize */
+            if (d == 8) {
+                grayExtremeLineLow((l_uint8 *)lineout + hsize, bwd,
+                                   (l_uint8 *)fwd + 2 * hsize, n, d, type);
+                lineEndianByteSwap(lined, lineout, wpl);
+            } else {  /* d == 16 */
+                grayExtremeLineLow((l_uint16 *)lineout + hsize, bwd,
+                                   (l_uint16 *)fwd + 2 * hsize, n, d, type);
+                for (j = hsize; j < hsize + n; j++)
+                    SET_DATA_TWO_BYTES(lined, j, ((l_uint16 *)lineout)[j]);
             }
         }
+        LEPT_FREE(buffer);
     } else {  /* direction == L_VERT */
-        hsize = size / 2;
-        nsteps = (h - 2 * hsize) / size;
-        for (j = 0; j < w; j++) {
-                /* fill buffer with pixels in byte order */
-            for (i = 0; i < h; i++) {
-                lines = datas + i * wpls;
-                buffer[i] = GET_DATA_BYTE(lines, j);
+        wpl = L_MIN(wpls, wpld);
+        n = (32 / d) * wpl;  /* pixels in a full row */
+        if ((datat = (l_uint32 *)LEPT_CALLOC((size_t)size * wpl,
+                                             sizeof(l_uint32))) == NULL) {
+            L_ERROR("datat not made\n", __func__);
+            return;
+        }
+
+            /* forward running extrema, into the dest */
+        for (i = 0; i < h; i++) {
+            lines = datas + i * wpls;
+            lined = datad + i * wpld;
+            if (i % size == 0)
+                memcpy(lined, lines, 4 * wpl);
+            else
+                grayExtremeLineLow(lined, lined - wpld, lines, n, d, type);
+        }
+
+            /* for each block, the backward running extrema go into datat,
+             * and are combined with the forward values to give the
+             * result at i + hsize for each row i in the block. */
+        last = h - 1 - 2 * hsize;
+        for (bstart = 0; bstart <= last; bstart += size) {
+            bend = L_MIN(bstart + size, h) - 1;
+            linet = datat + (bend - bstart) * wpl;
+            memcpy(linet, datas + bend * wpls, 4 * wpl);
+            for (k = bend - bstart - 1; k >= 0; k--) {
+                linet = datat + k * wpl;
+                grayExtremeLineLow(linet, linet + wpl,
+                                   datas + (bstart + k) * wpls, n, d, type);
             }
+            for (i = bstart; i <= L_MIN(bend, last); i++) {
+                lined = datad + (i + hsize) * wpld;
+                grayExtremeLineLow(lined, datat + (i - bstart) * wpl,
+                                   datad + (i + 2 * hsize) * wpld, n, d,
+                                   type);
+            }
+        }
+        LEPT_FREE(datat);
+    }
+}
 
-            for (i = 0; i < nsteps; i++) {
-                    /* refill the minarray */
-                startmin = (i + 1) * size - 1;
-                minarray[size - 1] = buffer[startmin];
-                for (k = 1; k < size; k++) {
-                    minarray[size - 1 - k] =
-                        L_MIN(minarray[size - k], buffer[startmin - k]);
-                    minarray[size - 1 + k] =
-                        L_MIN(minarray[size + k - 2], buffer[startmin + k]);
-                }
 
-                    /* compute erosion values */
-                starty = hsize + i * size;
-                lined = datad + starty * wpld;
-                SET_DATA_BYTE(lined, j, minarray[0]);
-                SET_DATA_BYTE(lined + (size - 1) * wpld, j,
-                        minarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    minval = L_MIN(minarray[k], minarray[k + size - 1]);
-                    SET_DATA_BYTE(lined + wpld * k, j, minval);
+/*!
+ * \brief   grayExtremeLineLow()
+ *
+ * \param[in]    lined      dest array
+ * \param[in]    line1      first src array
+ * \param[in]    line2      second src array
+ * \param[in]    n          number of pixels
+ * \param[in]    d          8, 16 or 32; the arrays are of l_uint8,
+ *                          l_uint16 or l_uint32
+ * \param[in]    type       L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *        (1) Sets each pixel in %lined to the max (for dilation) or the
+ *            min (for erosion) of the corresponding pixels in %line1
+ *            and %line2.  %lined can be the same as either src.
+ *        (2) The order of pixels within a word does not matter here,
+ *            so image rows can be used directly.
+ *        (3) For 32 bpp, each byte is a separate channel.  The 4 channels
+ *            of a pixel are handled together; see byteGEMask().
+ * </pre>
+ */
+static void
+grayExtremeLineLow(void        *lined,
+                   const void  *line1,
+                   const void  *line2,
+                   l_int32      n,
+                   l_int32      d,
+                   l_int32      type)
+{
+l_int32          j;
+l_uint8         *bd;
+const l_uint8   *b1, *b2;
+l_uint16        *sd;
+const l_uint16  *s1, *s2;
+l_uint32         val1, val2;
+l_uint32        *wd;
+const l_uint32  *w1, *w2;
+
+    if (d == 8) {
+        bd = (l_uint8 *)lined;
+        b1 = (const l_uint8 *)line1;
+        b2 = (const l_uint8 *)line2;
+        if (type == L_MORPH_DILATE) {
+            for (j = 0; j < n; j++)
+                bd[j] = L_MAX(b1[j], b2[j]);
+        } else {
+            for (j = 0; j < n; j++)
+                bd[j] = L_MIN(b1[j], b2[j]);
+        }
+    } else if (d == 32) {
+        wd = (l_uint32 *)lined;
+        w1 = (const l_uint32 *)line1;
+        w2 = (const l_uint32 *)line2;
+        if (type == L_MORPH_DILATE) {
+            for (j = 0; j < n; j++) {
+                val1 = w1[j];
+                val2 = w2[j];
+                wd[j] = val2 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
+            }
+        } else {
+            for (j = 0; j < n; j++) {
+                val1 = w1[j];
+                val2 = w2[j];
+                wd[j] = val1 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
+            }
+        }
+    } else {  /* d == 16 */
+        sd = (l_uint16 *)lined;
+        s1 = (const l_uint16 *)line1;
+        s2 = (const l_uint16 *)line2;
+        if (type == L_MORPH_DILATE) {
+            for (j = 0; j < n; j++)
+                sd[j] = L_MAX(s1[j], s2[j]);
+        } else {
+            for (j = 0; j < n; j++)
+                sd[j] = L_MIN(s1[j], s2[j]);
+        }
+    }
+}
+
+
+/*!
+ * \brief   grayRunningExtremaLow()
+ *
+ * \param[in]    fwd        forward running extrema
+ * \param[in]    bwd        backward running extrema
+ * \param[in]    line       src pixels, in order
+ * \param[in]    w          number of pixels
+ * \param[in]    size       length of the blocks
+ * \param[in]    d          8, 16 or 32; the arrays are of l_uint8,
+ *                          l_uint16 or l_uint32
+ * \param[in]    type       L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *        (1) The pixels are divided into blocks of %size, starting at 0.
+ *            In each block, %fwd gets the max (for dilation) or min
+ *            (for erosion) from the start of the block to each pixel,
+ *            and %bwd gets it from each pixel to the end of the block.
+ *        (2) For 32 bpp, each byte is a separate channel.  The 4 channels
+ *            of a pixel are handled together; see byteGEMask().
+ * </pre>
+ */
+static void
+grayRunningExtremaLow(void        *fwd,
+                      void        *bwd,
+                      const void  *line,
+                      l_int32      w,
+                      l_int32      size,
+                      l_int32      d,
+                      l_int32      type)
+{
+l_int32          j, bstart, bend;
+l_uint8         *bf, *bb;
+const l_uint8   *bs;
+l_uint16        *sf, *sb;
+const l_uint16  *ss;
+l_uint32         val1, val2;
+l_uint32        *wf, *wb;
+const l_uint32  *ws;
+
+    for (bstart = 0; bstart < w; bstart += size) {
+        bend = L_MIN(bstart + size, w) - 1;
+        if (d == 8) {
+            bf = (l_uint8 *)fwd;
+            bb = (l_uint8 *)bwd;
+            bs = (const l_uint8 *)line;
+            bf[bstart] = bs[bstart];
+            bb[bend] = bs[bend];
+            if (type == L_MORPH_DILATE) {
+                for (j = bstart + 1; j <= bend; j++)
+                    bf[j] = L_MAX(bf[j - 1], bs[j]);
+                for (j = bend - 1; j >= bstart; j--)
+                    bb[j] = L_MAX(bb[j + 1], bs[j]);
+            } else {
+                for (j = bstart + 1; j <= bend; j++)
+                    bf[j] = L_MIN(bf[j - 1], bs[j]);
+                for (j = bend - 1; j >= bstart; j--)
+                    bb[j] = L_MIN(bb[j + 1], bs[j]);
+            }
+        } else if (d == 32) {
+            wf = (l_uint32 *)fwd;
+            wb = (l_uint32 *)bwd;
+            ws = (const l_uint32 *)line;
+            wf[bstart] = ws[bstart];
+            wb[bend] = ws[bend];
+            if (type == L_MORPH_DILATE) {
+                for (j = bstart + 1; j <= bend; j++) {
+                    val1 = wf[j - 1];
+                    val2 = ws[j];
+                    wf[j] = val2 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
+                }
+                for (j = bend - 1; j >= bstart; j--) {
+                    val1 = wb[j + 1];
+                    val2 = ws[j];
+                    wb[j] = val2 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
+                }
+            } else {
+                for (j = bstart + 1; j <= bend; j++) {
+                    val1 = wf[j - 1];
+                    val2 = ws[j];
+                    wf[j] = val1 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
+                }
+                for (j = bend - 1; j >= bstart; j--) {
+                    val1 = wb[j + 1];
+                    val2 = ws[j];
+                    wb[j] = val1 ^ ((val1 ^ val2) & byteGEMask(val1, val2));
                 }
             }
+        } else {  /* d == 16 */
+            sf = (l_uint16 *)fwd;
+            sb = (l_uint16 *)bwd;
+            ss = (const l_uint16 *)line;
+            sf[bstart] = ss[bstart];
+            sb[bend] = ss[bend];
+            if (type == L_MORPH_DILATE) {
+                for (j = bstart + 1; j <= bend; j++)
+                    sf[j] = L_MAX(sf[j - 1], ss[j]);
+                for (j = bend - 1; j >= bstart; j--)
+                    sb[j] = L_MAX(sb[j + 1], ss[j]);
+            } else {
+                for (j = bstart + 1; j <= bend; j++)
+                    sf[j] = L_MIN(sf[j - 1], ss[j]);
+                for (j = bend - 1; j >= bstart; j--)
+                    sb[j] = L_MIN(sb[j + 1], ss[j]);
+            }
         }
     }
+}
+
+
+/*!
+ * \brief   byteGEMask()
+ *
+ * \param[in]    val1, val2    32 bpp pixels
+ * \return  mask with 0xff in each byte where the byte of %val1 is
+ *          not less than the byte of %val2, and 0 elsewhere
+ *
+ * <pre>
+ * Notes:
+ *        (1) This compares the 4 bytes (channels) of two pixels at once,
+ *            in a 32-bit register.  The low 7 bits of each byte are
+ *            compared by a subtraction in which the high bit of each
+ *            byte of the minuend is set, so there is no borrow between
+ *            bytes; the high bits are then compared separately.
+ *        (2) With mask = byteGEMask(val1, val2),
+ *              max = val2 ^ ((val1 ^ val2) & mask)
+ *              min = val1 ^ ((val1 ^ val2) & mask)
+ *            for each byte.
+ * </pre>
+ */
+static l_uint32
+byteGEMask(l_uint32  val1,
+           l_uint32  val2)
+{
+l_uint32  diff, ge;
 
-    return;
+    diff = (val1 | 0x80808080) - (val2 & 0x7f7f7f7f);
+    ge = ((val1 & ~val2) | (~(val1 ^ val2) & diff)) & 0x80808080;
+    return (ge << 1) - (ge >> 7);
 }
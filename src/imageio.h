@@ -247,4 +247,45 @@ struct L_Pdf_Data
 };
 typedef struct L_Pdf_Data  L_PDF_DATA;
 
+
+/* ------------------------------------------------------------------------- *
+ *                        Push (incremental) decoding                        *
+ * ------------------------------------------------------------------------- */
+/*
+ *  A push decoder accepts compressed data in chunks as they arrive
+ *  (e.g., from a network download) and decodes as far as the data
+ *  allows.  The decoded image is allocated as soon as the header has
+ *  been read, and completed rows accumulate in it from the top down.
+ *  Bands of newly completed rows can be extracted with pushdecGetBand(),
+ *  so that processing can start before all the data has been received.
+ *
+ *  The entire compressed input is retained in %data, so that formats
+ *  without incremental support can be decoded in one shot at the end.
+ */
+
+/*! Push decoder status */
+enum {
+    L_PUSHDEC_WAITING  = 0,  /*!< no decoded rows yet; needs more data      */
+    L_PUSHDEC_DECODING = 1,  /*!< header has been read; rows are arriving   */
+    L_PUSHDEC_DONE     = 2,  /*!< the complete image has been decoded       */
+    L_PUSHDEC_ERROR    = 3   /*!< decoding failed; no further data accepted */
+};
+
+/*! Push decoder */
+struct L_Push_Decoder
+{
+    l_int32            format;       /*!< input format: IFF_PNG, etc.         */
+    l_uint8           *data;         /*!< compressed data received so far     */
+    size_t             nalloc;       /*!< size of allocated data array        */
+    size_t             nbytes;       /*!< number of bytes received            */
+    size_t             offset;       /*!< bytes already handed to the codec   */
+    l_int32            eof;          /*!< set when no more data will arrive   */
+    l_int32            status;       /*!< L_PUSHDEC_WAITING, etc.             */
+    struct Pix        *pix;          /*!< decoded image; made from the header */
+    l_int32            nrows;        /*!< number of completed rows in pix     */
+    l_int32            nout;         /*!< number of rows returned as bands    */
+    void              *codec;        /*!< codec-specific decoder state        */
+};
+typedef struct L_Push_Decoder  L_PUSHDEC;
+
 #endif  /* LEPTONICA_IMAGEIO_H */
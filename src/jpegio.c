@@ -51,6 +51,11 @@
  *    Setting special flag for chroma sampling on write
  *          l_int32          pixSetChromaSampling()
  *
+ *    Push decoding of jpeg
+ *          static l_int32   jpegPushRun()
+ *          l_int32          jpegPushDecode()
+ *          void             jpegPushCleanup()
+ *
  *    Static system helpers
  *          static void      jpeg_error_catch_all_1()
  *          static void      jpeg_error_catch_all_2()
@@ -1184,6 +1189,328 @@ pixSetChromaSampling(PIX     *pix,
 }
 
 
+/*---------------------------------------------------------------------*
+ *                        Push decoding of jpeg                        *
+ *---------------------------------------------------------------------*/
+    /* Stages of push decoding */
+enum {
+    JPEG_PUSH_HEADER = 0,   /* reading the header                          */
+    JPEG_PUSH_START = 1,    /* starting decompression                      */
+    JPEG_PUSH_SCAN = 2      /* reading scanlines                           */
+};
+
+    /*! State of the suspending jpeg reader used by a push decoder.
+     *  The cinfo struct must be first, so that the source callbacks
+     *  can get the state from it. */
+struct JpegPushState
+{
+    struct jpeg_decompress_struct  cinfo;
+    struct jpeg_error_mgr          jerr;
+    struct jpeg_source_mgr         src;
+    L_PUSHDEC      *pd;        /*!< the push decoder that owns this         */
+    size_t          skip;      /*!< bytes still to be skipped               */
+    l_int32         stage;     /*!< JPEG_PUSH_HEADER, etc.                  */
+    l_int32         eoi;       /*!< 1 if a fake EOI marker was supplied     */
+    l_int32         spp;       /*!< samples/pixel in the decoded rows       */
+    JSAMPROW        rowbuffer; /*!< one decoded row                         */
+};
+typedef struct JpegPushState  JPEGPUSHSTATE;
+
+    /* Inserted when the data ends before the end of the image */
+static const JOCTET  JpegFakeEOI[2] = {0xff, JPEG_EOI};
+
+static void
+jpegPushInitSource(j_decompress_ptr  cinfo)
+{
+}
+
+/*!
+ * \brief   jpegPushFillInput()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Called by libjpeg when it has used all the data in the buffer.
+ *          Until the end of the data has been signalled, this returns
+ *          FALSE, which causes libjpeg to suspend and back up to a
+ *          point from which it can resume when more data is available.
+ *      (2) At the end of the data, a fake EOI marker is supplied and a
+ *          warning is issued, as is done by the libjpeg data sources.
+ * </pre>
+ */
+static boolean
+jpegPushFillInput(j_decompress_ptr  cinfo)
+{
+JPEGPUSHSTATE  *ps;
+
+    ps = (JPEGPUSHSTATE *)cinfo;
+    if (!ps->pd->eof)
+        return FALSE;
+    L_WARNING("premature end of jpeg data\n", __func__);
+    cinfo->err->num_warnings++;
+    ps->src.next_input_byte = JpegFakeEOI;
+    ps->src.bytes_in_buffer = 2;
+    ps->eoi = 1;
+    return TRUE;
+}
+
+static void
+jpegPushSkipInput(j_decompress_ptr  cinfo,
+                  long              num_bytes)
+{
+JPEGPUSHSTATE  *ps;
+
+    if (num_bytes <= 0) return;
+    ps = (JPEGPUSHSTATE *)cinfo;
+    if ((size_t)num_bytes <= ps->src.bytes_in_buffer) {
+        ps->src.next_input_byte += num_bytes;
+        ps->src.bytes_in_buffer -= num_bytes;
+    } else {  /* skip the rest when it arrives */
+        ps->skip = num_bytes - ps->src.bytes_in_buffer;
+        ps->src.next_input_byte += ps->src.bytes_in_buffer;
+        ps->src.bytes_in_buffer = 0;
+    }
+}
+
+static void
+jpegPushTermSource(j_decompress_ptr  cinfo)
+{
+}
+
+
+/*!
+ * \brief   jpegPushConvertRow()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Converts the decoded row in the rowbuffer to row %i of the
+ *          image, as is done in pixReadStreamJpeg().
+ * </pre>
+ */
+static void
+jpegPushConvertRow(JPEGPUSHSTATE  *ps,
+                   l_int32         i)
+{
+l_int32    j, k, w, rval, gval, bval, cyan, magenta, yellow, black;
+l_uint32  *line, *ppixel;
+JSAMPROW   rowbuffer;
+PIX       *pix;
+
+    pix = ps->pd->pix;
+    w = pixGetWidth(pix);
+    line = pixGetData(pix) + i * pixGetWpl(pix);
+    rowbuffer = ps->rowbuffer;
+    if (ps->spp == 3) {
+        for (j = k = 0, ppixel = line; j < w; j++, ppixel++) {
+            SET_DATA_BYTE(ppixel, COLOR_RED, rowbuffer[k++]);
+            SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuffer[k++]);
+            SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuffer[k++]);
+        }
+    } else if (ps->spp == 4) {  /* CMYK or YCCK; see pixReadStreamJpeg() */
+        for (j = k = 0, ppixel = line; j < w; j++, ppixel++) {
+            cyan = rowbuffer[k++];
+            magenta = rowbuffer[k++];
+            yellow = rowbuffer[k++];
+            black = rowbuffer[k++];
+            if (ps->cinfo.saw_Adobe_marker) {
+                rval = (black * cyan) / 255;
+                gval = (black * magenta) / 255;
+                bval = (black * yellow) / 255;
+            } else {
+                rval = black * (255 - cyan) / 255;
+                gval = black * (255 - magenta) / 255;
+                bval = black * (255 - yellow) / 255;
+            }
+            rval = L_MIN(L_MAX(rval, 0), 255);
+            gval = L_MIN(L_MAX(gval, 0), 255);
+            bval = L_MIN(L_MAX(bval, 0), 255);
+            composeRGBPixel(rval, gval, bval, ppixel);
+        }
+    } else {  /* 8 bpp grayscale */
+        for (j = 0; j < w; j++)
+            SET_DATA_BYTE(line, j, rowbuffer[j]);
+    }
+}
+
+
+/*!
+ * \brief   jpegPushRun()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Runs the decoder through as many stages as the data allows.
+ *          Any libjpeg call can suspend for lack of data, in which case
+ *          it is called again when more data has arrived.
+ *      (2) As with pixReadStreamJpeg(), reading is aborted if a
+ *          warning about corrupted data is issued during decoding
+ *          of the scanlines.
+ * </pre>
+ */
+static l_int32
+jpegPushRun(JPEGPUSHSTATE  *ps)
+{
+l_int32                  i, w, h, spp, ycck, cmyk;
+L_PUSHDEC               *pd;
+PIX                     *pix;
+j_decompress_ptr         cinfo;
+
+    pd = ps->pd;
+    cinfo = &ps->cinfo;
+    if (ps->stage == JPEG_PUSH_HEADER) {
+        if (jpeg_read_header(cinfo, TRUE) == JPEG_SUSPENDED)
+            return 0;
+        jpeg_calc_output_dimensions(cinfo);
+        spp = cinfo->out_color_components;
+        w = cinfo->output_width;
+        h = cinfo->output_height;
+        ycck = (cinfo->jpeg_color_space == JCS_YCCK && spp == 4);
+        cmyk = (cinfo->jpeg_color_space == JCS_CMYK && spp == 4);
+        if (spp != 1 && spp != 3 && !ycck && !cmyk)
+            return ERROR_INT("spp must be 1 or 3, or YCCK or CMYK",
+                             __func__, 1);
+        ps->spp = spp;
+        ps->rowbuffer = (JSAMPROW)LEPT_CALLOC(sizeof(JSAMPLE), (size_t)spp * w);
+        pix = pixCreate(w, h, (spp == 1) ? 8 : 32);
+        if (!ps->rowbuffer || !pix) {
+            pixDestroy(&pix);
+            return ERROR_INT("rowbuffer or pix not made", __func__, 1);
+        }
+        pixSetInputFormat(pix, IFF_JFIF_JPEG);
+        if (cinfo->density_unit == 1) {  /* pixels per inch */
+            pixSetXRes(pix, cinfo->X_density);
+            pixSetYRes(pix, cinfo->Y_density);
+        } else if (cinfo->density_unit == 2) {  /* pixels per centimeter */
+            pixSetXRes(pix, (l_int32)((l_float32)cinfo->X_density * 2.54
+                                      + 0.5));
+            pixSetYRes(pix, (l_int32)((l_float32)cinfo->Y_density * 2.54
+                                      + 0.5));
+        }
+        pd->pix = pix;
+        pd->status = L_PUSHDEC_DECODING;
+        ps->stage = JPEG_PUSH_START;
+    }
+
+    if (ps->stage == JPEG_PUSH_START) {
+        if (!jpeg_start_decompress(cinfo))
+            return 0;
+        ps->stage = JPEG_PUSH_SCAN;
+    }
+
+    while (cinfo->output_scanline < cinfo->output_height) {
+        i = cinfo->output_scanline;
+        if (jpeg_read_scanlines(cinfo, &ps->rowbuffer, (JDIMENSION)1) == 0)
+            return 0;
+        if (cinfo->err->num_warnings > 0) {
+            L_ERROR("read error at scanline %d; nwarn = %ld\n",
+                    __func__, i, cinfo->err->num_warnings);
+            return ERROR_INT("bad data", __func__, 1);
+        }
+        jpegPushConvertRow(ps, i);
+        pd->nrows = i + 1;
+    }
+
+        /* The rest of the data is not needed */
+    jpeg_abort_decompress(cinfo);
+    pd->status = L_PUSHDEC_DONE;
+    return 0;
+}
+
+
+/*!
+ * \brief   jpegPushDecode()
+ *
+ * \param[in]    pd    push decoder
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is called by the push decoder (pushdecode.c) whenever
+ *          data arrives.  It uses a suspending data source on the data
+ *          held by the push decoder.  Because that data can be moved
+ *          when it is extended, the position is saved as an offset.
+ *      (2) The result is the same as with pixReadMemJpeg() with
+ *          cmflag = 0, reduction = 1 and hint = 0.
+ *      (3) For a progressive jpeg, libjpeg reads all the scans in
+ *          jpeg_start_decompress(), so all the rows appear at the end.
+ * </pre>
+ */
+l_ok
+jpegPushDecode(L_PUSHDEC  *pd)
+{
+l_int32         ret;
+size_t          n;
+JPEGPUSHSTATE  *ps;
+jmp_buf         jmpbuf;  /* must be local to the function */
+
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+    if (BITS_IN_JSAMPLE != 8)  /* set in jmorecfg.h */
+        return ERROR_INT("BITS_IN_JSAMPLE != 8", __func__, 1);
+
+    if (!pd->codec) {
+        ps = (JPEGPUSHSTATE *)LEPT_CALLOC(1, sizeof(JPEGPUSHSTATE));
+        ps->pd = pd;
+        pd->codec = ps;
+        ps->cinfo.err = jpeg_std_error(&ps->jerr);
+        ps->jerr.error_exit = jpeg_error_catch_all_1;
+        ps->cinfo.client_data = (void *)&jmpbuf;
+        if (setjmp(jmpbuf))
+            return ERROR_INT("jpeg decompressor not made", __func__, 1);
+        jpeg_create_decompress(&ps->cinfo);
+        ps->src.init_source = jpegPushInitSource;
+        ps->src.fill_input_buffer = jpegPushFillInput;
+        ps->src.skip_input_data = jpegPushSkipInput;
+        ps->src.resync_to_restart = jpeg_resync_to_restart;
+        ps->src.term_source = jpegPushTermSource;
+        ps->cinfo.src = &ps->src;
+    }
+    ps = (JPEGPUSHSTATE *)pd->codec;
+
+        /* Finish skipping data that had not arrived */
+    if (ps->skip > 0) {
+        n = L_MIN(ps->skip, pd->nbytes - pd->offset);
+        pd->offset += n;
+        ps->skip -= n;
+        if (ps->skip > 0 && !pd->eof)
+            return 0;
+    }
+
+        /* Point the source at the data not yet consumed */
+    ps->src.next_input_byte = pd->data + pd->offset;
+    ps->src.bytes_in_buffer = pd->nbytes - pd->offset;
+    ps->cinfo.client_data = (void *)&jmpbuf;
+    if (setjmp(jmpbuf))  /* the error handler destroys the cinfo */
+        return ERROR_INT("internal jpeg error", __func__, 1);
+    ret = jpegPushRun(ps);
+
+        /* Save the position for resuming */
+    if (ps->eoi)
+        pd->offset = pd->nbytes;
+    else if (!ret && pd->status != L_PUSHDEC_DONE)
+        pd->offset = ps->src.next_input_byte - pd->data;
+    return ret;
+}
+
+
+/*!
+ * \brief   jpegPushCleanup()
+ *
+ * \param[in]    pd    push decoder
+ * \return  void
+ */
+void
+jpegPushCleanup(L_PUSHDEC  *pd)
+{
+JPEGPUSHSTATE  *ps;
+
+    if (!pd || !pd->codec) return;
+    ps = (JPEGPUSHSTATE *)pd->codec;
+    jpeg_destroy_decompress(&ps->cinfo);
+    LEPT_FREE(ps->rowbuffer);
+    LEPT_FREE(ps);
+    pd->codec = NULL;
+}
+
+
 /*---------------------------------------------------------------------*
  *                        Static system helpers                        *
  *---------------------------------------------------------------------*/
@@ -146,6 +146,21 @@ l_ok pixSetChromaSampling(PIX *pix, l_int32 sampling)
 
 /* ----------------------------------------------------------------------*/
 
+/* ----------------------------------------------------------------------*/
+
+l_ok jpegPushDecode(L_PUSHDEC *pd)
+{
+    return ERROR_INT("function not present", __func__, 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void jpegPushCleanup(L_PUSHDEC *pd)
+{
+    L_ERROR("function not present\n", __func__);
+    return;
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBJPEG */
 /* --------------------------------------------*/
@@ -66,6 +66,10 @@
 #include "zlib.h"
 #endif
 
+#if HAVE_LIBDEFLATE
+#include "libdeflate.h"
+#endif
+
 #if HAVE_LIBWEBP
 #include "webp/encode.h"
 #endif
@@ -93,6 +97,7 @@
  *            libpng 1.6.37
  *            libtiff 4.1.0
  *            zlib 1.2.11
+ *            libdeflate 1.19  (if used for zlibCompress())
  *            libwebp 0.6.1
  *            libopenjp2 2.5.0
  *      (2) The caller must free the memory.
@@ -175,6 +180,13 @@ char    *versionStrP = NULL;
     stringJoinIP(&versionStrP, ZLIB_VERSION);
 #endif  /* HAVE_LIBZ */
 
+#if HAVE_LIBDEFLATE
+    if (!first) stringJoinIP(&versionStrP, " : ");
+    first = FALSE;
+    stringJoinIP(&versionStrP, "libdeflate ");
+    stringJoinIP(&versionStrP, LIBDEFLATE_VERSION_STRING);
+#endif  /* HAVE_LIBDEFLATE */
+
 #if HAVE_LIBWEBP
     {
     l_int32 val;
@@ -0,0 +1,1082 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file maxtree.c
+ * <pre>
+ *
+ *      Max-tree and min-tree
+ *            L_MAXTREE       *maxtreeCreate()
+ *            void             maxtreeDestroy()
+ *            l_ok             maxtreeGetNodeAttributes()
+ *
+ *      Connected filters on the tree
+ *            PIX             *maxtreeFilter()
+ *            PIX             *maxtreeHeightFilter()
+ *            l_ok             maxtreeGetExtinctionValues()
+ *            PIX             *maxtreeExtinctionFilter()
+ *
+ *      Simple interface
+ *            PIX             *pixAreaOpen()
+ *            PIX             *pixAreaClose()
+ *            PIX             *pixHMax()
+ *            PIX             *pixHMin()
+ *
+ *      Static helpers
+ *            static l_int32  *maxtreeSortPixels()
+ *            static l_int32   maxtreeFindRoot()
+ *            static l_int32  *maxtreeGetAttribute()
+ *            static l_int32  *maxtreeGetPeaks()
+ *            static l_int32  *maxtreeGetExtinction()
+ *            static PIX      *maxtreeRenderKept()
+ *            static PIX      *maxtreeRender()
+ *
+ *  The max-tree of a grayscale image has a node for each connected
+ *  component of each thresholded image {p : f(p) >= t}.  The parent
+ *  of a node is the component that contains it at the next lower
+ *  threshold.  The leaves are the regional maxima, and the root is
+ *  the entire image at its minimum level.  The min-tree is the
+ *  max-tree of the inverted image, and its nodes are the components
+ *  of dark regions.
+ *
+ *  The tree is built once, in a time that is nearly linear in the
+ *  number of pixels, by the union-find method:
+ *    (1) Sort the pixels by decreasing value, using a counting sort.
+ *    (2) Visit the pixels in that order.  Each pixel starts a new set,
+ *        and it becomes the parent of the set of each neighbor that
+ *        has already been visited.
+ *    (3) Make every pixel point to the canonical pixel of its parent
+ *        node; i.e., the pixel that represents the node.
+ *
+ *  Many filters that otherwise need a long sequence of seedfills are
+ *  then a single pass over the tree.  These are connected filters:
+ *  they remove some of the nodes, lowering the pixels of each removed
+ *  node to the level of its nearest surviving ancestor, and they
+ *  never move a contour.
+ *    ~ An area opening, pixAreaOpen(), removes the bright parts with
+ *      fewer than a given number of pixels, and an area closing,
+ *      pixAreaClose(), fills in the dark parts.  For example, an area
+ *      closing removes small dark specks from a page image, but it
+ *      does not touch the thin text strokes if they are part of
+ *      larger connected components.
+ *    ~ The same filter with the bounding box width or height, or the
+ *      contrast (the height of the peak above the saddle where it
+ *      merges), is made by maxtreeFilter().
+ *    ~ The h-max and h-min transforms, pixHMax() and pixHMin(),
+ *      lower each peak by h, or flatten it if it is less than h high.
+ *      These are the results of the seedfill in pixHDome().
+ *    ~ The extinction value of a regional maximum is the largest size
+ *      of a node in which it is the dominant maximum.  Filtering by
+ *      extinction values keeps the n most significant maxima.
+ *
+ *  The tree holds 10 bytes for each pixel.  It is built without
+ *  threads; a tree for a very large image can be made from the trees
+ *  of horizontal stripes, but that is not implemented here.
+ *
+ *  Typical usage:
+ *      L_MAXTREE *tree = maxtreeCreate(pixs, L_MIN_TREE, 8);
+ *      PIX *pixd1 = maxtreeFilter(tree, L_MT_AREA, 20);
+ *      PIX *pixd2 = maxtreeHeightFilter(tree, 40);
+ *      maxtreeDestroy(&tree);
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <string.h>
+#include "allheaders.h"
+
+static l_int32 *maxtreeSortPixels(l_uint16 *levels, l_int32 n,
+                                  l_int32 maxval);
+static l_int32 maxtreeFindRoot(l_int32 *zpar, l_int32 p);
+static l_int32 *maxtreeGetAttribute(L_MAXTREE *tree, l_int32 attribute);
+static l_int32 *maxtreeGetPeaks(L_MAXTREE *tree);
+static l_int32 *maxtreeGetExtinction(L_MAXTREE *tree, l_int32 *attr);
+static PIX *maxtreeRenderKept(L_MAXTREE *tree, l_int32 *keep);
+static PIX *maxtreeRender(L_MAXTREE *tree, l_int32 *vals);
+
+    /* Neighbor offsets; the first 4 are for 4-connectivity */
+static const l_int32  Dx[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+static const l_int32  Dy[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+
+    /* A pixel p is the canonical pixel of its node if it is the root,
+     * or if its parent node is at a different level. */
+#define  IS_CANONICAL(tree, p) \
+    ((p) == (tree)->root || \
+     (tree)->levels[(tree)->parent[p]] != (tree)->levels[p])
+
+
+/*------------------------------------------------------------------*
+ *                      Max-tree and min-tree                       *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   maxtreeCreate()
+ *
+ * \param[in]    pixs           8 or 16 bpp; no colormap
+ * \param[in]    type           L_MAX_TREE or L_MIN_TREE
+ * \param[in]    connectivity   4 or 8
+ * \return  tree, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The nodes of a max-tree are the components of bright
+ *          regions, and those of a min-tree are the components of
+ *          dark regions.  All filters on a min-tree act on the dark
+ *          regions and return images in the original polarity.
+ *      (2) The tree does not keep a reference to pixs.
+ * </pre>
+ */
+L_MAXTREE *
+maxtreeCreate(PIX     *pixs,
+              l_int32  type,
+              l_int32  connectivity)
+{
+l_int32     i, j, k, w, h, d, n, wpl, p, q, r, x, y, zp, temp, nnodes;
+l_int32    *sorted, *parent, *zpar, *repr;
+l_uint8    *rank;
+l_uint16   *levels;
+l_uint32   *data, *line;
+L_MAXTREE  *tree;
+
+    if (!pixs)
+        return (L_MAXTREE *)ERROR_PTR("pixs not defined", __func__, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 8 && d != 16)
+        return (L_MAXTREE *)ERROR_PTR("pixs not 8 or 16 bpp", __func__, NULL);
+    if (pixGetColormap(pixs))
+        return (L_MAXTREE *)ERROR_PTR("pixs has colormap", __func__, NULL);
+    if (type != L_MAX_TREE && type != L_MIN_TREE)
+        return (L_MAXTREE *)ERROR_PTR("invalid type", __func__, NULL);
+    if (connectivity != 4 && connectivity != 8)
+        return (L_MAXTREE *)ERROR_PTR("connectivity not 4 or 8",
+                                      __func__, NULL);
+
+    if ((tree = (L_MAXTREE *)LEPT_CALLOC(1, sizeof(L_MAXTREE))) == NULL)
+        return (L_MAXTREE *)ERROR_PTR("tree not made", __func__, NULL);
+    tree->w = w;
+    tree->h = h;
+    tree->depth = d;
+    tree->type = type;
+    tree->connectivity = connectivity;
+    tree->maxval = (d == 8) ? 0xff : 0xffff;
+    n = w * h;
+
+        /* Get the levels, inverted for a min-tree */
+    if ((levels = (l_uint16 *)LEPT_CALLOC(n, sizeof(l_uint16))) == NULL) {
+        maxtreeDestroy(&tree);
+        return (L_MAXTREE *)ERROR_PTR("levels not made", __func__, NULL);
+    }
+    tree->levels = levels;
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    for (i = 0, k = 0; i < h; i++) {
+        line = data + i * wpl;
+        for (j = 0; j < w; j++, k++) {
+            levels[k] = (d == 8) ? GET_DATA_BYTE(line, j)
+                                 : GET_DATA_TWO_BYTES(line, j);
+            if (type == L_MIN_TREE)
+                levels[k] = tree->maxval - levels[k];
+        }
+    }
+
+        /* Union-find, visiting the pixels in decreasing order.  The
+         * sets are merged by rank, to keep the finds short, and repr[]
+         * holds the most recently visited pixel of each set; that is
+         * the pixel with the lowest level.  The pixel being visited
+         * becomes the parent of repr[] of each set that it touches,
+         * so each pixel is visited before its parent.  A pixel has
+         * been visited if parent[] >= 0. */
+    sorted = maxtreeSortPixels(levels, n, tree->maxval);
+    tree->sorted = sorted;
+    parent = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    tree->parent = parent;
+    zpar = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    repr = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    rank = (l_uint8 *)LEPT_CALLOC(n, sizeof(l_uint8));
+    if (!sorted || !parent || !zpar || !repr || !rank) {
+        LEPT_FREE(zpar);
+        LEPT_FREE(repr);
+        LEPT_FREE(rank);
+        maxtreeDestroy(&tree);
+        return (L_MAXTREE *)ERROR_PTR("arrays not made", __func__, NULL);
+    }
+    memset(parent, 0xff, n * sizeof(l_int32));
+    for (k = 0; k < n; k++) {
+        p = sorted[k];
+        parent[p] = p;
+        zpar[p] = p;
+        repr[p] = p;
+        zp = p;
+        y = p / w;
+        x = p - y * w;
+        for (i = 0; i < connectivity; i++) {
+            if (x + Dx[i] < 0 || x + Dx[i] >= w ||
+                y + Dy[i] < 0 || y + Dy[i] >= h)
+                continue;
+            q = p + Dy[i] * w + Dx[i];
+            if (parent[q] < 0)
+                continue;
+            if ((r = maxtreeFindRoot(zpar, q)) == zp)
+                continue;
+            parent[repr[r]] = p;
+            if (rank[zp] < rank[r]) {
+                temp = zp;
+                zp = r;
+                r = temp;
+            } else if (rank[zp] == rank[r]) {
+                rank[zp]++;
+            }
+            zpar[r] = zp;
+            repr[zp] = p;
+        }
+    }
+    LEPT_FREE(zpar);
+    LEPT_FREE(repr);
+    LEPT_FREE(rank);
+    tree->root = sorted[n - 1];
+
+        /* Canonicalize, from the root up */
+    for (k = n - 1, nnodes = 0; k >= 0; k--) {
+        p = sorted[k];
+        q = parent[p];
+        if (levels[parent[q]] == levels[q])
+            parent[p] = parent[q];
+        if (IS_CANONICAL(tree, p))
+            nnodes++;
+    }
+    tree->nnodes = nnodes;
+    return tree;
+}
+
+
+/*!
+ * \brief   maxtreeDestroy()
+ *
+ * \param[in,out]  ptree    will be set to null before returning
+ * \return  void
+ */
+void
+maxtreeDestroy(L_MAXTREE  **ptree)
+{
+L_MAXTREE  *tree;
+
+    if (ptree == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((tree = *ptree) == NULL)
+        return;
+
+    LEPT_FREE(tree->levels);
+    LEPT_FREE(tree->sorted);
+    LEPT_FREE(tree->parent);
+    LEPT_FREE(tree);
+    *ptree = NULL;
+}
+
+
+/*!
+ * \brief   maxtreeGetNodeAttributes()
+ *
+ * \param[in]    tree
+ * \param[in]    attribute   L_MT_AREA, L_MT_CONTRAST, L_MT_BBOX_WIDTH
+ *                           or L_MT_BBOX_HEIGHT
+ * \param[out]   pnaval      [optional] attribute value of each node
+ * \param[out]   pnaheight   [optional] level of each node above
+ *                           the level of its parent
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The nodes are given in decreasing order of level, with
+ *          the root last.  The height of the root is its level.
+ *      (2) For a min-tree, the levels are those of the inverted image.
+ *      (3) The sum of the heights of the nodes that contain a pixel
+ *          is the pixel level.  Consequently, the sum over the nodes
+ *          of (area * height) is the sum of the levels, and the
+ *          area pattern spectrum of a grayscale image is found from
+ *          the areas and heights.  See pixAreaGranulometry().
+ * </pre>
+ */
+l_ok
+maxtreeGetNodeAttributes(L_MAXTREE  *tree,
+                         l_int32     attribute,
+                         NUMA      **pnaval,
+                         NUMA      **pnaheight)
+{
+l_int32   k, n, p, height;
+l_int32  *attr;
+
+    if (pnaval) *pnaval = NULL;
+    if (pnaheight) *pnaheight = NULL;
+    if (!pnaval && !pnaheight)
+        return ERROR_INT("no output requested", __func__, 1);
+    if (!tree)
+        return ERROR_INT("tree not defined", __func__, 1);
+    if ((attr = maxtreeGetAttribute(tree, attribute)) == NULL)
+        return ERROR_INT("attr not made", __func__, 1);
+
+    if (pnaval) *pnaval = numaCreate(tree->nnodes);
+    if (pnaheight) *pnaheight = numaCreate(tree->nnodes);
+    n = tree->w * tree->h;
+    for (k = 0; k < n; k++) {
+        p = tree->sorted[k];
+        if (!IS_CANONICAL(tree, p))
+            continue;
+        if (pnaval)
+            numaAddNumber(*pnaval, attr[p]);
+        if (pnaheight) {
+            height = tree->levels[p];
+            if (p != tree->root)
+                height -= tree->levels[tree->parent[p]];
+            numaAddNumber(*pnaheight, height);
+        }
+    }
+    LEPT_FREE(attr);
+    return 0;
+}
+
+
+/*------------------------------------------------------------------*
+ *                  Connected filters on the tree                   *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   maxtreeFilter()
+ *
+ * \param[in]    tree
+ * \param[in]    attribute   L_MT_AREA, L_MT_CONTRAST, L_MT_BBOX_WIDTH
+ *                           or L_MT_BBOX_HEIGHT
+ * \param[in]    minval      smallest attribute value of a kept node
+ * \return  pixd filtered image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each node with an attribute value less than %minval is
+ *          removed, and its pixels are set to the level of the nearest
+ *          ancestor that is kept.  The root is always kept.
+ *      (2) All four attributes are increasing: the value of a node is
+ *          never larger than that of its parent.  Consequently, this
+ *          is an opening on a max-tree and a closing on a min-tree.
+ *          With L_MT_AREA it is the area opening or area closing.
+ *      (3) With L_MT_CONTRAST it removes the peaks, or fills the
+ *          basins, that are less than %minval deep.  This differs
+ *          from the h-max and h-min transforms of maxtreeHeightFilter(),
+ *          in that the deeper peaks and basins are not changed.
+ *      (4) With L_MT_BBOX_WIDTH or L_MT_BBOX_HEIGHT it removes the
+ *          parts that fit in a vertical or horizontal strip of width
+ *          %minval - 1.
+ * </pre>
+ */
+PIX *
+maxtreeFilter(L_MAXTREE  *tree,
+              l_int32     attribute,
+              l_int32     minval)
+{
+l_int32   k, n, p;
+l_int32  *attr;
+PIX      *pixd;
+
+    if (!tree)
+        return (PIX *)ERROR_PTR("tree not defined", __func__, NULL);
+    if ((attr = maxtreeGetAttribute(tree, attribute)) == NULL)
+        return (PIX *)ERROR_PTR("attr not made", __func__, NULL);
+
+    n = tree->w * tree->h;
+    for (k = 0; k < n; k++) {
+        p = tree->sorted[k];
+        attr[p] = (attr[p] >= minval) ? 1 : 0;
+    }
+    pixd = maxtreeRenderKept(tree, attr);
+    LEPT_FREE(attr);
+    return pixd;
+}
+
+
+/*!
+ * \brief   maxtreeHeightFilter()
+ *
+ * \param[in]    tree
+ * \param[in]    height     amount by which the peaks are lowered; >= 0
+ * \return  pixd filtered image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) On a max-tree this is the h-max transform: the gray
+ *          reconstruction of pixs from the seed (pixs - %height),
+ *          as made by pixSeedfillGray().  Each peak is lowered by
+ *          %height, and the peaks that rise less than %height above
+ *          their highest saddle are flattened to the saddle level.
+ *      (2) On a min-tree this is the h-min transform, that raises
+ *          the bottom of each basin by %height.
+ *      (3) The result at a pixel p is the largest level t <= f(p) for
+ *          which the component of p at threshold t reaches a level of
+ *          at least t + %height.  Going down from a node at level l,
+ *          with parent at level l', the component stays the same for
+ *          all t in (l', l], so the result is found for each node from
+ *          its peak level and the result for its parent.
+ * </pre>
+ */
+PIX *
+maxtreeHeightFilter(L_MAXTREE  *tree,
+                    l_int32     height)
+{
+l_int32   k, n, p, t;
+l_int32  *vals;
+PIX      *pixd;
+
+    if (!tree)
+        return (PIX *)ERROR_PTR("tree not defined", __func__, NULL);
+    if (height < 0)
+        return (PIX *)ERROR_PTR("height < 0", __func__, NULL);
+    if ((vals = maxtreeGetPeaks(tree)) == NULL)
+        return (PIX *)ERROR_PTR("vals not made", __func__, NULL);
+
+        /* Replace the peak level of each node by its output level,
+         * from the root up */
+    n = tree->w * tree->h;
+    for (k = n - 1; k >= 0; k--) {
+        p = tree->sorted[k];
+        if (p == tree->root) {
+            vals[p] = L_MAX(0, L_MIN(tree->levels[p], vals[p] - height));
+        } else if (IS_CANONICAL(tree, p)) {
+            t = L_MIN(tree->levels[p], vals[p] - height);
+            vals[p] = (t > tree->levels[tree->parent[p]]) ? t
+                      : vals[tree->parent[p]];
+        } else {
+            vals[p] = vals[tree->parent[p]];
+        }
+    }
+    pixd = maxtreeRender(tree, vals);
+    LEPT_FREE(vals);
+    return pixd;
+}
+
+
+/*!
+ * \brief   maxtreeGetExtinctionValues()
+ *
+ * \param[in]    tree
+ * \param[in]    attribute   L_MT_AREA, L_MT_CONTRAST, L_MT_BBOX_WIDTH
+ *                           or L_MT_BBOX_HEIGHT
+ * \param[out]   pnaext      extinction value of each regional extremum
+ * \param[out]   ppta        [optional] location of one pixel in each
+ *                           regional extremum
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The regional extrema are the leaves of the tree: the regional
+ *          maxima of a max-tree and the regional minima of a min-tree.
+ *          They are given in decreasing order of level (for a min-tree,
+ *          increasing order of the pixel values).
+ *      (2) Where the branches of several extrema merge, the extremum
+ *          of the branch with the largest attribute value survives,
+ *          and the others become extinct.  The extinction value of an
+ *          extremum is the attribute value of the largest branch that
+ *          it dominates.  The extremum that reaches the root has the
+ *          attribute value of the root.
+ *      (3) With L_MT_CONTRAST the extinction values are the dynamics
+ *          of the extrema: the depth of each basin measured from the
+ *          saddle through which it overflows into a deeper basin.
+ * </pre>
+ */
+l_ok
+maxtreeGetExtinctionValues(L_MAXTREE  *tree,
+                           l_int32     attribute,
+                           NUMA      **pnaext,
+                           PTA       **ppta)
+{
+l_int32   k, n, p;
+l_int32  *attr, *ext;
+
+    if (ppta) *ppta = NULL;
+    if (!pnaext)
+        return ERROR_INT("&naext not defined", __func__, 1);
+    *pnaext = NULL;
+    if (!tree)
+        return ERROR_INT("tree not defined", __func__, 1);
+    if ((attr = maxtreeGetAttribute(tree, attribute)) == NULL)
+        return ERROR_INT("attr not made", __func__, 1);
+
+    if ((ext = maxtreeGetExtinction(tree, attr)) == NULL) {
+        LEPT_FREE(attr);
+        return ERROR_INT("ext not made", __func__, 1);
+    }
+    *pnaext = numaCreate(0);
+    if (ppta) *ppta = ptaCreate(0);
+    n = tree->w * tree->h;
+    for (k = 0; k < n; k++) {
+        p = tree->sorted[k];
+        if (ext[p] < 0)
+            continue;
+        numaAddNumber(*pnaext, ext[p]);
+        if (ppta)
+            ptaAddPt(*ppta, p % tree->w, p / tree->w);
+    }
+    LEPT_FREE(attr);
+    LEPT_FREE(ext);
+    return 0;
+}
+
+
+/*!
+ * \brief   maxtreeExtinctionFilter()
+ *
+ * \param[in]    tree
+ * \param[in]    attribute   L_MT_AREA, L_MT_CONTRAST, L_MT_BBOX_WIDTH
+ *                           or L_MT_BBOX_HEIGHT
+ * \param[in]    nkeep       number of regional extrema to keep; >= 1
+ * \return  pixd filtered image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This keeps the %nkeep regional extrema with the largest
+ *          extinction values, along with all the nodes on the paths
+ *          from them to the root.  All other nodes are removed, as in
+ *          maxtreeFilter().  For example, with a min-tree and
+ *          L_MT_CONTRAST, the result has only the %nkeep deepest
+ *          basins, which can then be used as watershed markers.
+ *      (2) The kept extrema are not changed, so the result differs
+ *          from a filter with a threshold on the attribute, that
+ *          prunes every branch.
+ * </pre>
+ */
+PIX *
+maxtreeExtinctionFilter(L_MAXTREE  *tree,
+                        l_int32     attribute,
+                        l_int32     nkeep)
+{
+l_int32   i, k, n, p, nleaves, index;
+l_int32  *attr, *ext, *leaves;
+NUMA     *naext, *naindex;
+PIX      *pixd;
+
+    if (!tree)
+        return (PIX *)ERROR_PTR("tree not defined", __func__, NULL);
+    if (nkeep < 1)
+        return (PIX *)ERROR_PTR("nkeep < 1", __func__, NULL);
+    if ((attr = maxtreeGetAttribute(tree, attribute)) == NULL)
+        return (PIX *)ERROR_PTR("attr not made", __func__, NULL);
+
+        /* Sort the leaves by decreasing extinction value */
+    ext = maxtreeGetExtinction(tree, attr);
+    n = tree->w * tree->h;
+    leaves = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    if (!ext || !leaves) {
+        LEPT_FREE(attr);
+        LEPT_FREE(ext);
+        LEPT_FREE(leaves);
+        return (PIX *)ERROR_PTR("ext and leaves not made", __func__, NULL);
+    }
+    naext = numaCreate(0);
+    for (k = 0, nleaves = 0; k < n; k++) {
+        p = tree->sorted[k];
+        if (ext[p] < 0)
+            continue;
+        leaves[nleaves++] = p;
+        numaAddNumber(naext, ext[p]);
+    }
+    naindex = numaGetSortIndex(naext, L_SORT_DECREASING);
+
+        /* Keep the first nkeep leaves and their ancestors */
+    memset(attr, 0, n * sizeof(l_int32));
+    attr[tree->root] = 1;
+    for (i = 0; i < L_MIN(nkeep, nleaves); i++) {
+        numaGetIValue(naindex, i, &index);
+        for (p = leaves[index]; attr[p] == 0; p = tree->parent[p])
+            attr[p] = 1;
+    }
+    pixd = maxtreeRenderKept(tree, attr);
+
+    LEPT_FREE(attr);
+    LEPT_FREE(ext);
+    LEPT_FREE(leaves);
+    numaDestroy(&naext);
+    numaDestroy(&naindex);
+    return pixd;
+}
+
+
+/*------------------------------------------------------------------*
+ *                         Simple interface                         *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   pixAreaOpen()
+ *
+ * \param[in]    pixs           8 or 16 bpp; no colormap
+ * \param[in]    minarea        smallest area of a bright region
+ * \param[in]    connectivity   4 or 8
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The area opening removes the bright regions with fewer
+ *          than %minarea pixels, by lowering each one to the level
+ *          of its surroundings.  It is the maximum over all openings
+ *          by connected structuring elements of %minarea pixels.
+ *      (2) It is equivalent to thresholding at each level, removing
+ *          the components of area less than %minarea, and stacking
+ *          the results.  Unlike a brick opening, it preserves thin
+ *          bright lines that belong to large regions.
+ * </pre>
+ */
+PIX *
+pixAreaOpen(PIX     *pixs,
+            l_int32  minarea,
+            l_int32  connectivity)
+{
+L_MAXTREE  *tree;
+PIX        *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if ((tree = maxtreeCreate(pixs, L_MAX_TREE, connectivity)) == NULL)
+        return (PIX *)ERROR_PTR("tree not made", __func__, NULL);
+    pixd = maxtreeFilter(tree, L_MT_AREA, minarea);
+    maxtreeDestroy(&tree);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixAreaClose()
+ *
+ * \param[in]    pixs           8 or 16 bpp; no colormap
+ * \param[in]    minarea        smallest area of a dark region
+ * \param[in]    connectivity   4 or 8
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The area closing fills the dark regions with fewer than
+ *          %minarea pixels to the level of their surroundings.  On a
+ *          scanned page with dark text, this removes small dark specks
+ *          and leaves the text strokes unchanged, if they are part of
+ *          components that are at least %minarea pixels in size.
+ * </pre>
+ */
+PIX *
+pixAreaClose(PIX     *pixs,
+             l_int32  minarea,
+             l_int32  connectivity)
+{
+L_MAXTREE  *tree;
+PIX        *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if ((tree = maxtreeCreate(pixs, L_MIN_TREE, connectivity)) == NULL)
+        return (PIX *)ERROR_PTR("tree not made", __func__, NULL);
+    pixd = maxtreeFilter(tree, L_MT_AREA, minarea);
+    maxtreeDestroy(&tree);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixHMax()
+ *
+ * \param[in]    pixs           8 or 16 bpp; no colormap
+ * \param[in]    height         amount by which the peaks are lowered
+ * \param[in]    connectivity   4 or 8
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the h-max transform.  It gives the same result as
+ *          the seedfill
+ *              pixd = pixCopy(NULL, pixs);
+ *              pixAddConstantGray(pixd, -height);
+ *              pixSeedfillGray(pixd, pixs, connectivity);
+ *          See maxtreeHeightFilter().
+ *      (2) pixs - pixd is the h-dome image of pixHDome().
+ *      (3) For a single transform the seedfill is usually faster.
+ *          Build the tree when several filters are applied to the
+ *          same image.
+ * </pre>
+ */
+PIX *
+pixHMax(PIX     *pixs,
+        l_int32  height,
+        l_int32  connectivity)
+{
+L_MAXTREE  *tree;
+PIX        *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if ((tree = maxtreeCreate(pixs, L_MAX_TREE, connectivity)) == NULL)
+        return (PIX *)ERROR_PTR("tree not made", __func__, NULL);
+    pixd = maxtreeHeightFilter(tree, height);
+    maxtreeDestroy(&tree);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixHMin()
+ *
+ * \param[in]    pixs           8 or 16 bpp; no colormap
+ * \param[in]    height         amount by which the basins are raised
+ * \param[in]    connectivity   4 or 8
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the h-min transform: the dual of pixHMax().  Each
+ *          basin is raised by %height, and the basins that are less
+ *          than %height deep are filled to the level where they
+ *          overflow.  It is the usual way to suppress the shallow
+ *          minima before a watershed.
+ * </pre>
+ */
+PIX *
+pixHMin(PIX     *pixs,
+        l_int32  height,
+        l_int32  connectivity)
+{
+L_MAXTREE  *tree;
+PIX        *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if ((tree = maxtreeCreate(pixs, L_MIN_TREE, connectivity)) == NULL)
+        return (PIX *)ERROR_PTR("tree not made", __func__, NULL);
+    pixd = maxtreeHeightFilter(tree, height);
+    maxtreeDestroy(&tree);
+    return pixd;
+}
+
+
+/*------------------------------------------------------------------*
+ *                          Static helpers                          *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   maxtreeSortPixels()
+ *
+ * \param[in]    levels    array of pixel levels
+ * \param[in]    n         number of pixels
+ * \param[in]    maxval    largest possible level
+ * \return  array of pixel indices, sorted by decreasing level,
+ *          or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a counting sort.  Pixels at the same level are
+ *          in raster order.
+ * </pre>
+ */
+static l_int32 *
+maxtreeSortPixels(l_uint16  *levels,
+                  l_int32    n,
+                  l_int32    maxval)
+{
+l_int32   i, v, sum, count;
+l_int32  *start, *sorted;
+
+    if ((start = (l_int32 *)LEPT_CALLOC(maxval + 1, sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("start not made", __func__, NULL);
+    for (i = 0; i < n; i++)
+        start[levels[i]]++;
+    for (v = maxval, sum = 0; v >= 0; v--) {
+        count = start[v];
+        start[v] = sum;
+        sum += count;
+    }
+    if ((sorted = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32))) == NULL) {
+        LEPT_FREE(start);
+        return (l_int32 *)ERROR_PTR("sorted not made", __func__, NULL);
+    }
+    for (i = 0; i < n; i++)
+        sorted[start[levels[i]]++] = i;
+    LEPT_FREE(start);
+    return sorted;
+}
+
+
+/*!
+ * \brief   maxtreeFindRoot()
+ *
+ * \param[in]    zpar    union-find parents
+ * \param[in]    p       pixel index
+ * \return  root of the set containing p
+ *
+ * <pre>
+ * Notes:
+ *      (1) This halves the path as it goes.
+ * </pre>
+ */
+static l_int32
+maxtreeFindRoot(l_int32  *zpar,
+                l_int32   p)
+{
+    while (zpar[p] != p) {
+        zpar[p] = zpar[zpar[p]];
+        p = zpar[p];
+    }
+    return p;
+}
+
+
+/*!
+ * \brief   maxtreeGetAttribute()
+ *
+ * \param[in]    tree
+ * \param[in]    attribute   L_MT_AREA, L_MT_CONTRAST, L_MT_BBOX_WIDTH
+ *                           or L_MT_BBOX_HEIGHT
+ * \return  array with the attribute of each node at its canonical
+ *          pixel, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Values at non-canonical pixels are meaningless.
+ *      (2) Each attribute is accumulated in one pass over the sorted
+ *          pixels, from the leaves to the root.
+ * </pre>
+ */
+static l_int32 *
+maxtreeGetAttribute(L_MAXTREE  *tree,
+                    l_int32     attribute)
+{
+l_int32   k, n, w, p, q;
+l_int32  *attr, *amin, *amax;
+
+    if (attribute != L_MT_AREA && attribute != L_MT_CONTRAST &&
+        attribute != L_MT_BBOX_WIDTH && attribute != L_MT_BBOX_HEIGHT)
+        return (l_int32 *)ERROR_PTR("invalid attribute", __func__, NULL);
+
+    n = tree->w * tree->h;
+    if (attribute == L_MT_CONTRAST) {
+        if ((attr = maxtreeGetPeaks(tree)) == NULL)
+            return (l_int32 *)ERROR_PTR("peaks not made", __func__, NULL);
+        for (k = 0; k < n; k++) {
+            p = tree->sorted[k];
+            attr[p] -= tree->levels[tree->parent[p]];
+        }
+        return attr;
+    }
+
+    if ((attr = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("attr not made", __func__, NULL);
+    if (attribute == L_MT_AREA) {
+        for (k = 0; k < n; k++)
+            attr[k] = 1;
+        for (k = 0; k < n - 1; k++) {
+            p = tree->sorted[k];
+            attr[tree->parent[p]] += attr[p];
+        }
+        return attr;
+    }
+
+        /* Bounding box width or height */
+    w = tree->w;
+    if ((amin = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32))) == NULL) {
+        LEPT_FREE(attr);
+        return (l_int32 *)ERROR_PTR("amin not made", __func__, NULL);
+    }
+    amax = attr;
+    for (k = 0; k < n; k++)
+        amin[k] = amax[k] = (attribute == L_MT_BBOX_WIDTH) ? k % w : k / w;
+    for (k = 0; k < n - 1; k++) {
+        p = tree->sorted[k];
+        q = tree->parent[p];
+        amin[q] = L_MIN(amin[q], amin[p]);
+        amax[q] = L_MAX(amax[q], amax[p]);
+    }
+    for (k = 0; k < n; k++)
+        attr[k] = amax[k] - amin[k] + 1;
+    LEPT_FREE(amin);
+    return attr;
+}
+
+
+/*!
+ * \brief   maxtreeGetPeaks()
+ *
+ * \param[in]    tree
+ * \return  array with the highest level in each node at its
+ *          canonical pixel, or NULL on error
+ */
+static l_int32 *
+maxtreeGetPeaks(L_MAXTREE  *tree)
+{
+l_int32   k, n, p, q;
+l_int32  *peaks;
+
+    n = tree->w * tree->h;
+    if ((peaks = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("peaks not made", __func__, NULL);
+    for (k = 0; k < n; k++)
+        peaks[k] = tree->levels[k];
+    for (k = 0; k < n - 1; k++) {
+        p = tree->sorted[k];
+        q = tree->parent[p];
+        peaks[q] = L_MAX(peaks[q], peaks[p]);
+    }
+    return peaks;
+}
+
+
+/*!
+ * \brief   maxtreeGetExtinction()
+ *
+ * \param[in]    tree
+ * \param[in]    attr    attribute of each node at its canonical pixel
+ * \return  array with the extinction value of each leaf at its
+ *          canonical pixel, and -1 elsewhere; or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The nodes are visited from the leaves to the root.  For each
+ *          node, best[] is its child with the largest attribute so far,
+ *          and carry[] is the leaf that it passes on to its parent.
+ *          When a child loses to a sibling, the leaf it carries gets
+ *          the attribute of the child as its extinction value.
+ *      (2) Ties are won by the child that is visited first; i.e., the
+ *          one with the higher level.
+ * </pre>
+ */
+static l_int32 *
+maxtreeGetExtinction(L_MAXTREE  *tree,
+                     l_int32    *attr)
+{
+l_int32   k, n, p, q, loser;
+l_int32  *best, *carry, *ext;
+
+    n = tree->w * tree->h;
+    best = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    carry = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    ext = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    if (!best || !carry || !ext) {
+        LEPT_FREE(best);
+        LEPT_FREE(carry);
+        LEPT_FREE(ext);
+        return (l_int32 *)ERROR_PTR("arrays not made", __func__, NULL);
+    }
+    memset(best, 0xff, n * sizeof(l_int32));
+    memset(ext, 0xff, n * sizeof(l_int32));
+    for (k = 0; k < n; k++) {
+        p = tree->sorted[k];
+        if (!IS_CANONICAL(tree, p))
+            continue;
+        carry[p] = (best[p] < 0) ? p : carry[best[p]];
+        if (p == tree->root) {
+            ext[carry[p]] = attr[p];
+            break;
+        }
+        q = tree->parent[p];
+        if (best[q] < 0) {
+            best[q] = p;
+            continue;
+        }
+        if (attr[p] > attr[best[q]]) {
+            loser = best[q];
+            best[q] = p;
+        } else {
+            loser = p;
+        }
+        ext[carry[loser]] = attr[loser];
+    }
+    LEPT_FREE(best);
+    LEPT_FREE(carry);
+    return ext;
+}
+
+
+/*!
+ * \brief   maxtreeRenderKept()
+ *
+ * \param[in]    tree
+ * \param[in]    keep    1 at the canonical pixel of each kept node;
+ *                       overwritten with the output levels
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The pixels of each removed node are set to the level of the
+ *          nearest kept ancestor.  The root is always kept.
+ * </pre>
+ */
+static PIX *
+maxtreeRenderKept(L_MAXTREE  *tree,
+                  l_int32    *keep)
+{
+l_int32  k, n, p;
+
+    n = tree->w * tree->h;
+    for (k = n - 1; k >= 0; k--) {
+        p = tree->sorted[k];
+        if (p == tree->root || (IS_CANONICAL(tree, p) && keep[p]))
+            keep[p] = tree->levels[p];
+        else
+            keep[p] = keep[tree->parent[p]];
+    }
+    return maxtreeRender(tree, keep);
+}
+
+
+/*!
+ * \brief   maxtreeRender()
+ *
+ * \param[in]    tree
+ * \param[in]    vals    output level of each pixel
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For a min-tree, the levels are inverted back to pixel values.
+ * </pre>
+ */
+static PIX *
+maxtreeRender(L_MAXTREE  *tree,
+              l_int32    *vals)
+{
+l_int32    i, j, k, w, h, wpl, val;
+l_uint32  *data, *line;
+PIX       *pixd;
+
+    w = tree->w;
+    h = tree->h;
+    if ((pixd = pixCreate(w, h, tree->depth)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+    data = pixGetData(pixd);
+    wpl = pixGetWpl(pixd);
+    for (i = 0, k = 0; i < h; i++) {
+        line = data + i * wpl;
+        for (j = 0; j < w; j++, k++) {
+            val = vals[k];
+            if (tree->type == L_MIN_TREE)
+                val = tree->maxval - val;
+            if (tree->depth == 8)
+                SET_DATA_BYTE(line, j, val);
+            else
+                SET_DATA_TWO_BYTES(line, j, val);
+        }
+    }
+    return pixd;
+}
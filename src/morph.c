@@ -38,6 +38,9 @@
  *         PIX     *pixOpenGeneralized()
  *         PIX     *pixCloseGeneralized()
  *
+ *     Hit-miss pattern search
+ *         PIX     *pixHMTSearch()
+ *
  *     Binary morphological (raster) ops with brick Sels
  *         PIX     *pixDilateBrick()
  *         PIX     *pixErodeBrick()
@@ -62,6 +65,21 @@
  *         static PIX     *processMorphArgs1()
  *         static PIX     *processMorphArgs2()
  *
+ *     Static helpers for large brick Sels
+ *         static l_int32  selIsLargeBrick()
+ *         static void     brickMorphRunning()
+ *         static void     lineMorphRunning()
+ *         static void     runningOpLow()
+ *         static void     shiftOpLow()
+ *
+ *     Static helpers for Sels decomposed into runs
+ *         static void     morphByRuns()
+ *         static void     morphRunsLow()
+ *
+ *     Static helpers for hit-miss pattern search
+ *         static l_int32  hmtOrderElements()
+ *         static void     hmtSearchLow()
+ *
  *  You are provided with many simple ways to do binary morphology.
  *  In particular, if you are using brick Sels, there are six
  *  convenient methods, all specially tailored for separable operations
@@ -80,14 +98,18 @@
  *      These are separable rasterop implementations.  The Sels are
  *      automatically generated, used, and destroyed at the end.
  *      You can get the result as a new Pix, in-place back into the src Pix,
- *      or written to another existing Pix.
+ *      or written to another existing Pix.  When the brick is at least
+ *      MinRunningSize in either direction, pixDilate() and pixErode()
+ *      use running ORs and ANDs, built up by doubling the run length,
+ *      so the cost grows only with the log of the Sel size.
  *
  *  (2) Brick Sels: pix*CompBrick(), where * = {Dilate, Erode, Open, Close}.
  *      These are separable, 2-way composite, rasterop implementations.
  *      The Sels are automatically generated, used, and destroyed at the end.
  *      You can get the result as a new Pix, in-place back into the src Pix,
- *      or written to another existing Pix.  For large Sels, these are
- *      considerably faster than the corresponding pix*Brick() functions.
+ *      or written to another existing Pix.  For large Sels, these use
+ *      far fewer rasterops than a rasterop for each hit, but the
+ *      pix*Brick() functions now use running ops for large bricks.
  *      N.B.:  The size of the Sels that are actually used are typically
  *      close to, but not exactly equal to, the size input to the function.
  *
@@ -178,10 +200,46 @@ LEPT_DLL l_int32  MORPH_BC = ASYMMETRIC_MORPH_BC;
     /* We accept this cost in extra rasterops for decomposing exactly. */
 static const l_int32  ACCEPTABLE_COST = 5;
 
+    /* Solid brick and line Sels with at least this many elements in
+     * either direction are done with running ops, whose cost grows
+     * only with the log of the Sel size. */
+static const l_int32  MinRunningSize = 7;
+
+    /* Extra cost, in full image passes, of adding and removing the
+     * border when a general Sel is done with runs; see selPlanCreate(). */
+static const l_int32  RunBorderCost = 2;
+
     /* Static helpers for arg processing */
 static PIX * processMorphArgs1(PIX *pixd, PIX *pixs, SEL *sel, PIX **ppixt);
 static PIX * processMorphArgs2(PIX *pixd, PIX *pixs, SEL *sel);
 
+    /* Static helpers for large brick Sels */
+static l_int32 selIsLargeBrick(SEL *sel);
+static void brickMorphRunning(PIX *pixd, PIX *pixs, SEL *sel, l_int32 type);
+static void lineMorphRunning(PIX *pixd, PIX *pixs, l_int32 orient,
+                             l_int32 lo, l_int32 hi, l_int32 type);
+static void runningOpLow(l_uint32 *data, l_int32 h, l_int32 wpl,
+                         l_int32 orient, l_int32 size, l_int32 dir,
+                         l_int32 type);
+static void shiftOpLow(l_uint32 *datad, l_uint32 *datas, l_int32 h,
+                       l_int32 wpl, l_int32 orient, l_int32 shift,
+                       l_int32 type);
+
+    /* Static helpers for Sels decomposed into runs */
+static void morphByRuns(PIX *pixd, PIX *pixs, L_SELPLAN *plan,
+                        l_int32 type);
+static void morphRunsLow(PIX *pixd, PIX *pixs, l_int32 orient,
+                         l_int32 *runs, l_int32 nruns, l_int32 cx,
+                         l_int32 cy, l_int32 type, l_int32 inverted);
+
+    /* Static helpers for hit-miss pattern search */
+static l_int32 hmtOrderElements(SEL *sel, l_int32 **pelems,
+                                l_int32 *pnelem);
+static void hmtSearchLow(l_uint32 *datad, l_int32 w, l_int32 h,
+                         l_int32 wpld, l_uint32 *datab, l_int32 wplb,
+                         l_int32 left, l_int32 top, l_int32 *elems,
+                         l_int32 nelem);
+
 
 /*-----------------------------------------------------------------*
  *    Generic binary morphological ops implemented with rasterop   *
@@ -207,6 +265,11 @@ static PIX * processMorphArgs2(PIX *pixd, PIX *pixs, SEL *sel);
  *          (b) pixDilate(pixs, pixs, ...);
  *          (c) pixDilate(pixd, pixs, ...);
  *      (4) The size of the result is determined by pixs.
+ *      (5) A solid brick or line Sel that is large in either direction
+ *          is done separably with running ORs, rather than with one
+ *          rasterop for each hit.  Other Sels are done with one
+ *          rasterop for each run of hits, when that is estimated to be
+ *          cheaper; see selPlanCreate().  The result is the same.
  * </pre>
  */
 PIX *
@@ -214,12 +277,27 @@ pixDilate(PIX  *pixd,
           PIX  *pixs,
           SEL  *sel)
 {
-l_int32  i, j, w, h, sx, sy, cx, cy, seldata;
-PIX     *pixt;
+l_int32     i, j, w, h, sx, sy, cx, cy, seldata;
+L_SELPLAN  *plan;
+PIX        *pixt;
 
     if ((pixd = processMorphArgs1(pixd, pixs, sel, &pixt)) == NULL)
         return (PIX *)ERROR_PTR("processMorphArgs1 failed", __func__, pixd);
 
+    if (selIsLargeBrick(sel)) {
+        brickMorphRunning(pixd, pixt, sel, L_MORPH_DILATE);
+        pixDestroy(&pixt);
+        return pixd;
+    }
+    plan = selPlanCreate(sel);
+    if (plan && plan->hitcost + RunBorderCost < plan->nhits) {
+        morphByRuns(pixd, pixt, plan, L_MORPH_DILATE);
+        selPlanDestroy(&plan);
+        pixDestroy(&pixt);
+        return pixd;
+    }
+    selPlanDestroy(&plan);
+
     pixGetDimensions(pixs, &w, &h, NULL);
     selGetParameters(sel, &sy, &sx, &cy, &cx);
     pixClearAll(pixd);
@@ -259,6 +337,11 @@ PIX     *pixt;
  *          (b) pixErode(pixs, pixs, ...);
  *          (c) pixErode(pixd, pixs, ...);
  *      (4) The size of the result is determined by pixs.
+ *      (5) A solid brick or line Sel that is large in either direction
+ *          is done separably with running ANDs, rather than with one
+ *          rasterop for each hit.  Other Sels are done with one
+ *          rasterop for each run of hits, when that is estimated to be
+ *          cheaper; see selPlanCreate().  The result is the same.
  * </pre>
  */
 PIX *
@@ -266,25 +349,35 @@ pixErode(PIX  *pixd,
          PIX  *pixs,
          SEL  *sel)
 {
-l_int32  i, j, w, h, sx, sy, cx, cy, seldata;
-l_int32  xp, yp, xn, yn;
-PIX     *pixt;
+l_int32     i, j, w, h, sx, sy, cx, cy, seldata;
+l_int32     xp, yp, xn, yn;
+L_SELPLAN  *plan;
+PIX        *pixt;
 
     if ((pixd = processMorphArgs1(pixd, pixs, sel, &pixt)) == NULL)
         return (PIX *)ERROR_PTR("processMorphArgs1 failed", __func__, pixd);
 
     pixGetDimensions(pixs, &w, &h, NULL);
     selGetParameters(sel, &sy, &sx, &cy, &cx);
-    pixSetAll(pixd);
-    for (i = 0; i < sy; i++) {
-        for (j = 0; j < sx; j++) {
-            seldata = sel->data[i][j];
-            if (seldata == 1) {   /* src & dst */
+    plan = NULL;
+    if (selIsLargeBrick(sel)) {
+        brickMorphRunning(pixd, pixt, sel, L_MORPH_ERODE);
+    } else if ((plan = selPlanCreate(sel)) != NULL &&
+               plan->hitcost + RunBorderCost < plan->nhits) {
+        morphByRuns(pixd, pixt, plan, L_MORPH_ERODE);
+    } else {
+        pixSetAll(pixd);
+        for (i = 0; i < sy; i++) {
+            for (j = 0; j < sx; j++) {
+                seldata = sel->data[i][j];
+                if (seldata == 1) {   /* src & dst */
                     pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC & PIX_DST,
                                 pixt, 0, 0);
+                }
             }
         }
     }
+    selPlanDestroy(&plan);
 
         /* Clear near edges.  We do this for the asymmetric boundary
          * condition convention that implements erosion assuming all
@@ -332,6 +425,9 @@ PIX     *pixt;
  *          (b) pixHMT(pixs, pixs, ...);
  *          (c) pixHMT(pixd, pixs, ...);
  *      (4) The size of the result is determined by pixs.
+ *      (5) When it is estimated to be cheaper, the hits and misses are
+ *          done with one rasterop for each run; see selPlanCreate().
+ *          The result is the same.
  * </pre>
  */
 PIX *
@@ -339,43 +435,51 @@ pixHMT(PIX  *pixd,
        PIX  *pixs,
        SEL  *sel)
 {
-l_int32  i, j, w, h, sx, sy, cx, cy, firstrasterop, seldata;
-l_int32  xp, yp, xn, yn;
-PIX     *pixt;
+l_int32     i, j, w, h, sx, sy, cx, cy, firstrasterop, seldata;
+l_int32     xp, yp, xn, yn;
+L_SELPLAN  *plan;
+PIX        *pixt;
 
     if ((pixd = processMorphArgs1(pixd, pixs, sel, &pixt)) == NULL)
         return (PIX *)ERROR_PTR("processMorphArgs1 failed", __func__, pixd);
 
     pixGetDimensions(pixs, &w, &h, NULL);
     selGetParameters(sel, &sy, &sx, &cy, &cx);
-    firstrasterop = TRUE;
-    for (i = 0; i < sy; i++) {
-        for (j = 0; j < sx; j++) {
-            seldata = sel->data[i][j];
-            if (seldata == 1) {  /* hit */
-                if (firstrasterop == TRUE) {  /* src only */
-                    pixClearAll(pixd);
-                    pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC,
-                                pixt, 0, 0);
-                    firstrasterop = FALSE;
-                } else {   /* src & dst */
-                    pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC & PIX_DST,
-                                pixt, 0, 0);
-                }
-            } else if (seldata == 2) {  /* miss */
-                if (firstrasterop == TRUE) {  /* ~src only */
-                    pixSetAll(pixd);
-                    pixRasterop(pixd, cx - j, cy - i, w, h, PIX_NOT(PIX_SRC),
-                             pixt, 0, 0);
-                    firstrasterop = FALSE;
-                } else {  /* ~src & dst */
-                    pixRasterop(pixd, cx - j, cy - i, w, h,
-                                PIX_NOT(PIX_SRC) & PIX_DST,
-                                pixt, 0, 0);
+    plan = selPlanCreate(sel);
+    if (plan && plan->hitcost + plan->misscost + RunBorderCost <
+                plan->nhits + plan->nmisses) {
+        morphByRuns(pixd, pixt, plan, L_MORPH_HMT);
+    } else {
+        firstrasterop = TRUE;
+        for (i = 0; i < sy; i++) {
+            for (j = 0; j < sx; j++) {
+                seldata = sel->data[i][j];
+                if (seldata == 1) {  /* hit */
+                    if (firstrasterop == TRUE) {  /* src only */
+                        pixClearAll(pixd);
+                        pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC,
+                                    pixt, 0, 0);
+                        firstrasterop = FALSE;
+                    } else {   /* src & dst */
+                        pixRasterop(pixd, cx - j, cy - i, w, h,
+                                    PIX_SRC & PIX_DST, pixt, 0, 0);
+                    }
+                } else if (seldata == 2) {  /* miss */
+                    if (firstrasterop == TRUE) {  /* ~src only */
+                        pixSetAll(pixd);
+                        pixRasterop(pixd, cx - j, cy - i, w, h,
+                                    PIX_NOT(PIX_SRC), pixt, 0, 0);
+                        firstrasterop = FALSE;
+                    } else {  /* ~src & dst */
+                        pixRasterop(pixd, cx - j, cy - i, w, h,
+                                    PIX_NOT(PIX_SRC) & PIX_DST,
+                                    pixt, 0, 0);
+                    }
                 }
             }
         }
     }
+    selPlanDestroy(&plan);
 
         /* Clear near edges */
     selFindMaxTranslations(sel, &xp, &yp, &xn, &yn);
@@ -639,6 +743,105 @@ PIX  *pixt;
 }
 
 
+/*-----------------------------------------------------------------*
+ *                     Hit-miss pattern search                     *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   pixHMTSearch()
+ *
+ * \param[in]    pixs    1 bpp
+ * \param[in]    sel
+ * \param[out]   ppta    [optional] locations of the matches
+ * \return  pixd with the matches, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixd = pixHMT(NULL, pixs, sel),
+ *          and optionally also returns the location of each match.
+ *          It is much faster when the matches are sparse, as they
+ *          are when searching for a pattern of fg pixels, because the
+ *          full Sel is only evaluated at candidate locations.
+ *      (2) Each word of 32 dest pixels is found by ANDing the shifted
+ *          src words for the hits and the inverted shifted src words
+ *          for the misses.  Two hits that are far apart in the Sel are
+ *          tested first, and the remaining elements are only tested
+ *          if some of the 32 pixels are still candidates.  The other
+ *          hits come before the misses, because fg pixels are usually
+ *          the less common.
+ *      (3) As with pixHMT(), the pixels outside the image are OFF: a hit
+ *          outside the image fails, and a miss outside it succeeds.
+ *      (4) If the Sel has no hits, every pixel is a candidate, and
+ *          this uses pixHMT().
+ * </pre>
+ */
+PIX *
+pixHMTSearch(PIX   *pixs,
+             SEL   *sel,
+             PTA  **ppta)
+{
+l_int32    i, j, k, w, h, wpld, nelem, nhits, left, right, top, bot;
+l_int32   *elems;
+l_uint32   word;
+l_uint32  *datad, *lined;
+PIX       *pixb, *pixd;
+PTA       *pta;
+
+    if (ppta) *ppta = NULL;
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs undefined or not 1 bpp", __func__, NULL);
+    if (!sel)
+        return (PIX *)ERROR_PTR("sel not defined", __func__, NULL);
+
+    nhits = hmtOrderElements(sel, &elems, &nelem);
+    if (nhits == 0) {
+        pixd = pixHMT(NULL, pixs, sel);
+    } else {
+            /* Add a border of OFF pixels that covers all the shifts,
+             * with whole words on the left and right sides */
+        left = right = top = bot = 0;
+        for (i = 0; i < nelem; i++) {
+            left = L_MAX(left, -elems[3 * i]);
+            right = L_MAX(right, elems[3 * i]);
+            top = L_MAX(top, -elems[3 * i + 1]);
+            bot = L_MAX(bot, elems[3 * i + 1]);
+        }
+        left = 32 * ((left + 31) / 32);
+        right = 32 * ((right + 31) / 32) + 32;
+        pixb = pixAddBorderGeneral(pixs, left, right, top, bot, 0);
+        pixGetDimensions(pixs, &w, &h, NULL);
+        pixd = pixCreateTemplate(pixs);
+        hmtSearchLow(pixGetData(pixd), w, h, pixGetWpl(pixd),
+                     pixGetData(pixb), pixGetWpl(pixb), left, top,
+                     elems, nelem);
+        pixDestroy(&pixb);
+    }
+    LEPT_FREE(elems);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+
+    if (ppta) {
+        pixGetDimensions(pixd, &w, &h, NULL);
+        datad = pixGetData(pixd);
+        wpld = pixGetWpl(pixd);
+        pta = ptaCreate(0);
+        for (i = 0; i < h; i++) {
+            lined = datad + i * wpld;
+            for (j = 0; j < wpld; j++) {
+                if ((word = lined[j]) == 0)
+                    continue;
+                for (k = 0; k < 32 && 32 * j + k < w; k++) {
+                    if (word & (0x80000000 >> k))
+                        ptaAddPt(pta, 32 * j + k, i);
+                }
+            }
+        }
+        *ppta = pta;
+    }
+
+    return pixd;
+}
+
+
 /*-----------------------------------------------------------------*
  *          Binary morphological (raster) ops with brick Sels      *
  *-----------------------------------------------------------------*/
@@ -1865,3 +2068,610 @@ l_int32  sx, sy;
     pixResizeImageData(pixd, pixs);
     return pixd;
 }
+
+
+/*-----------------------------------------------------------------*
+ *               Static helpers for large brick Sels               *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   selIsLargeBrick()
+ *
+ * \param[in]    sel
+ * \return  1 if %sel is a solid brick of hits, with the origin inside,
+ *              and at least MinRunningSize in either direction; 0 otherwise
+ */
+static l_int32
+selIsLargeBrick(SEL  *sel)
+{
+l_int32  i, j, sx, sy, cx, cy;
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    if (sx < MinRunningSize && sy < MinRunningSize)
+        return 0;
+    if (cx < 0 || cx >= sx || cy < 0 || cy >= sy)
+        return 0;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            if (sel->data[i][j] != SEL_HIT)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*!
+ * \brief   brickMorphRunning()
+ *
+ * \param[in]    pixd    result; same size as pixs, and not equal to it
+ * \param[in]    pixs    1 bpp
+ * \param[in]    sel     solid brick, with origin inside
+ * \param[in]    type    L_MORPH_DILATE, L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as the rasterop loops in
+ *          pixDilate() and pixErode(), except that for erosion the
+ *          asymmetric b.c. is applied by the caller.  Pixels outside
+ *          the image are taken as OFF for dilation and ON for erosion.
+ *      (2) The brick is done separably, horizontally and then
+ *          vertically, each with a running op over the line.
+ *      (3) For dilation, the Sel is reflected about its origin, so that
+ *          pixd(x) is the OR of pixs(x + k), for k in the range
+ *          [cx - sx + 1, cx].  For erosion, pixd(x) is the AND of
+ *          pixs(x + k) for k in [-cx, sx - 1 - cx].
+ * </pre>
+ */
+static void
+brickMorphRunning(PIX     *pixd,
+                  PIX     *pixs,
+                  SEL     *sel,
+                  l_int32  type)
+{
+l_int32  sx, sy, cx, cy, lox, hix, loy, hiy;
+PIX     *pixt;
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    if (type == L_MORPH_DILATE) {
+        lox = cx - sx + 1;
+        hix = cx;
+        loy = cy - sy + 1;
+        hiy = cy;
+    } else {
+        lox = -cx;
+        hix = sx - 1 - cx;
+        loy = -cy;
+        hiy = sy - 1 - cy;
+    }
+
+    if (sy == 1) {
+        lineMorphRunning(pixd, pixs, L_HORIZ, lox, hix, type);
+    } else if (sx == 1) {
+        lineMorphRunning(pixd, pixs, L_VERT, loy, hiy, type);
+    } else {
+        pixt = pixCreateTemplate(pixs);
+        lineMorphRunning(pixt, pixs, L_HORIZ, lox, hix, type);
+        lineMorphRunning(pixd, pixt, L_VERT, loy, hiy, type);
+        pixDestroy(&pixt);
+    }
+    return;
+}
+
+
+/*!
+ * \brief   lineMorphRunning()
+ *
+ * \param[in]    pixd     result; same size as pixs, and not equal to it
+ * \param[in]    pixs     1 bpp
+ * \param[in]    orient   L_HORIZ, L_VERT
+ * \param[in]    lo, hi   range of offsets, with lo <= 0 <= hi
+ * \param[in]    type     L_MORPH_DILATE, L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) pixd(x) = OP pixs(x + k), for k in [lo, hi], where OP is
+ *          OR for dilation and AND for erosion.  Pixels outside the
+ *          image are the identity for OP.
+ *      (2) The offsets are split into [0, hi], which is a running op
+ *          looking forward from x, and [lo, -1], which is a running op
+ *          looking backward from x - 1.  Each is done in place, and
+ *          they are combined with one more shifted op.
+ * </pre>
+ */
+static void
+lineMorphRunning(PIX     *pixd,
+                 PIX     *pixs,
+                 l_int32  orient,
+                 l_int32  lo,
+                 l_int32  hi,
+                 l_int32  type)
+{
+l_int32    h, wpl;
+l_uint32  *datad, *datat;
+PIX       *pixt;
+
+    pixCopy(pixd, pixs);
+    h = pixGetHeight(pixd);
+    wpl = pixGetWpl(pixd);
+    datad = pixGetData(pixd);
+
+        /* The forward running op reads the pad bits at the end of
+         * each line, so they must be the identity for OP. */
+    if (orient == L_HORIZ)
+        pixSetPadBits(pixd, (type == L_MORPH_DILATE) ? 0 : 1);
+    runningOpLow(datad, h, wpl, orient, hi + 1, 1, type);
+
+    if (lo < 0) {
+        pixt = pixCopy(NULL, pixs);
+        datat = pixGetData(pixt);
+        runningOpLow(datat, h, wpl, orient, -lo, -1, type);
+        shiftOpLow(datad, datat, h, wpl, orient, -1, type);
+        pixDestroy(&pixt);
+    }
+    pixSetPadBits(pixd, 0);
+    return;
+}
+
+
+/*!
+ * \brief   runningOpLow()
+ *
+ * \param[in]    data     1 bpp image data, operated on in place
+ * \param[in]    h        height
+ * \param[in]    wpl      words/line
+ * \param[in]    orient   L_HORIZ, L_VERT
+ * \param[in]    size     length of the running op; >= 1
+ * \param[in]    dir      1 for forward, -1 for backward
+ * \param[in]    type     L_MORPH_DILATE, L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Forward: data(x) <-- OP data(x + k), for k in [0, size - 1].
+ *          Backward: data(x) <-- OP data(x - k), for k in [0, size - 1].
+ *      (2) The length is doubled at each step, by combining the result
+ *          with itself shifted by the current length, until it reaches
+ *          p, the largest power of 2 not larger than %size.  A last step
+ *          shifted by (size - p) covers the rest, because two
+ *          overlapping runs of length p span the size.
+ * </pre>
+ */
+static void
+runningOpLow(l_uint32  *data,
+             l_int32    h,
+             l_int32    wpl,
+             l_int32    orient,
+             l_int32    size,
+             l_int32    dir,
+             l_int32    type)
+{
+l_int32  len;
+
+    for (len = 1; 2 * len <= size; len *= 2)
+        shiftOpLow(data, data, h, wpl, orient, dir * len, type);
+    if (size > len)
+        shiftOpLow(data, data, h, wpl, orient, dir * (size - len), type);
+    return;
+}
+
+
+/*!
+ * \brief   shiftOpLow()
+ *
+ * \param[in]    datad    1 bpp dest image data
+ * \param[in]    datas    1 bpp src image data; can be equal to datad
+ * \param[in]    h        height
+ * \param[in]    wpl      words/line of both
+ * \param[in]    orient   L_HORIZ, L_VERT
+ * \param[in]    shift    nonzero offset to the src pixel
+ * \param[in]    type     L_MORPH_DILATE, L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) datad(x) <-- datad(x) OP datas(x + shift), where src pixels
+ *          outside the image are the identity for OP.
+ *      (2) For in-place operation, the words are visited in the
+ *          direction of the shift, so that each src word is read before
+ *          it is written.
+ * </pre>
+ */
+static void
+shiftOpLow(l_uint32  *datad,
+           l_uint32  *datas,
+           l_int32    h,
+           l_int32    wpl,
+           l_int32    orient,
+           l_int32    shift,
+           l_int32    type)
+{
+l_int32    i, j, k, m, nw, nb, nfull;
+l_uint32   ident, v, vn;
+l_uint32  *lined, *lines;
+
+    ident = (type == L_MORPH_DILATE) ? 0 : 0xffffffff;
+    m = L_ABS(shift);
+    if (orient == L_HORIZ) {
+        nw = m >> 5;  /* whole words */
+        nb = m & 31;  /* remaining bits */
+            /* Number of dest words for which both src words are inside */
+        nfull = L_MAX(0, wpl - nw - 1);
+        for (i = 0; i < h; i++) {
+            lined = datad + i * wpl;
+            lines = datas + i * wpl;
+            if (shift > 0) {
+                if (nb == 0) {
+                    if (type == L_MORPH_DILATE) {
+                        for (j = 0; j < wpl - nw; j++)
+                            lined[j] |= lines[j + nw];
+                    } else {
+                        for (j = 0; j < wpl - nw; j++)
+                            lined[j] &= lines[j + nw];
+                    }
+                    j = L_MAX(0, wpl - nw);
+                } else {
+                    if (type == L_MORPH_DILATE) {
+                        for (j = 0; j < nfull; j++)
+                            lined[j] |= (lines[j + nw] << nb) |
+                                        (lines[j + nw + 1] >> (32 - nb));
+                    } else {
+                        for (j = 0; j < nfull; j++)
+                            lined[j] &= (lines[j + nw] << nb) |
+                                        (lines[j + nw + 1] >> (32 - nb));
+                    }
+                    j = nfull;
+                }
+                for (; j < wpl; j++) {  /* src runs off the end */
+                    k = j + nw;
+                    v = (k < wpl) ? lines[k] : ident;
+                    if (nb)
+                        v = (v << nb) | (ident >> (32 - nb));
+                    if (type == L_MORPH_DILATE)
+                        lined[j] |= v;
+                    else
+                        lined[j] &= v;
+                }
+            } else {
+                    /* Visit the words in reverse order, in case
+                     * datad == datas */
+                for (j = wpl - 1; j >= wpl - nfull; j--) {
+                    k = j - nw;
+                    v = (nb) ? (lines[k] >> nb) | (lines[k - 1] << (32 - nb))
+                             : lines[k];
+                    if (type == L_MORPH_DILATE)
+                        lined[j] |= v;
+                    else
+                        lined[j] &= v;
+                }
+                for (; j >= 0; j--) {  /* src runs off the beginning */
+                    k = j - nw;
+                    v = (k >= 0) ? lines[k] : ident;
+                    if (nb) {
+                        vn = (k >= 1) ? lines[k - 1] : ident;
+                        v = (v >> nb) | (vn << (32 - nb));
+                    }
+                    if (type == L_MORPH_DILATE)
+                        lined[j] |= v;
+                    else
+                        lined[j] &= v;
+                }
+            }
+        }
+    } else {  /* L_VERT */
+        if (shift > 0) {
+            for (i = 0; i < h - m; i++) {
+                lined = datad + i * wpl;
+                lines = datas + (i + m) * wpl;
+                if (type == L_MORPH_DILATE) {
+                    for (j = 0; j < wpl; j++)
+                        lined[j] |= lines[j];
+                } else {
+                    for (j = 0; j < wpl; j++)
+                        lined[j] &= lines[j];
+                }
+            }
+        } else {
+            for (i = h - 1; i >= m; i--) {
+                lined = datad + i * wpl;
+                lines = datas + (i - m) * wpl;
+                if (type == L_MORPH_DILATE) {
+                    for (j = 0; j < wpl; j++)
+                        lined[j] |= lines[j];
+                } else {
+                    for (j = 0; j < wpl; j++)
+                        lined[j] &= lines[j];
+                }
+            }
+        }
+    }
+    return;
+}
+
+
+/*-----------------------------------------------------------------*
+ *            Static helpers for Sels decomposed into runs         *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   morphByRuns()
+ *
+ * \param[in]    pixd    result; same size as pixs, and not equal to it
+ * \param[in]    pixs    1 bpp
+ * \param[in]    plan    from selPlanCreate()
+ * \param[in]    type    L_MORPH_DILATE, L_MORPH_ERODE, L_MORPH_HMT
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as the rasterop loops in
+ *          pixDilate(), pixErode() and pixHMT(), except for the clearing
+ *          of pixels near the edges, which is done by the caller.
+ *      (2) Each run is done with one rasterop, so its first pixel
+ *          must be within the image for every pixel of pixd, even when
+ *          the run itself crosses the edge.  We therefore work on
+ *          pixs with an added border of pixels that have the value
+ *          assumed outside the image: OFF for dilation, ON for erosion.
+ *          For hmt, the hits are only used where they are all within
+ *          the image, and misses outside the image are satisfied,
+ *          so the border pixels are OFF.
+ * </pre>
+ */
+static void
+morphByRuns(PIX        *pixd,
+            PIX        *pixs,
+            L_SELPLAN  *plan,
+            l_int32     type)
+{
+l_int32  w, h, left, right, top, bot;
+PIX     *pixsb, *pixdb;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    left = 32 * ((plan->sx + 31) / 32);  /* keep word alignment */
+    right = plan->sx;
+    top = bot = plan->sy;
+    pixsb = pixAddBorderGeneral(pixs, left, right, top, bot,
+                                (type == L_MORPH_ERODE) ? 1 : 0);
+    pixdb = pixCreateTemplate(pixsb);
+
+    if (type == L_MORPH_DILATE) {
+        morphRunsLow(pixdb, pixsb, plan->hitorient, plan->hitruns,
+                     plan->nhitruns, plan->cx, plan->cy, L_MORPH_DILATE, 0);
+    } else {
+        pixSetAll(pixdb);
+        morphRunsLow(pixdb, pixsb, plan->hitorient, plan->hitruns,
+                     plan->nhitruns, plan->cx, plan->cy, L_MORPH_ERODE, 0);
+        if (type == L_MORPH_HMT)
+            morphRunsLow(pixdb, pixsb, plan->missorient, plan->missruns,
+                         plan->nmissruns, plan->cx, plan->cy,
+                         L_MORPH_ERODE, 1);
+    }
+
+    pixRasterop(pixd, 0, 0, w, h, PIX_SRC, pixdb, left, top);
+    pixDestroy(&pixsb);
+    pixDestroy(&pixdb);
+    return;
+}
+
+
+/*!
+ * \brief   morphRunsLow()
+ *
+ * \param[in]    pixd      accumulated result; same size as pixs
+ * \param[in]    pixs      1 bpp
+ * \param[in]    orient    L_HORIZ, L_VERT
+ * \param[in]    runs      (i, j, length) for each run, sorted by length
+ * \param[in]    nruns
+ * \param[in]    cx, cy    sel origin
+ * \param[in]    type      L_MORPH_DILATE, L_MORPH_ERODE
+ * \param[in]    inverted  1 for the misses of an hmt; 0 otherwise
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) For dilation, the run from (i, j) ORs into pixd the pixels
+ *          pixs(x - (j + k - cx)), for k in [0, length - 1].  That is
+ *          the backward running OR, at x - (j - cx).
+ *      (2) For erosion, the run ANDs the pixels pixs(x + (j + k - cx)),
+ *          which is the forward running AND, at x + (j - cx).  For the
+ *          misses, the AND of the inverted pixels is the inverse of
+ *          the forward running OR.
+ *      (3) The running op image for each length is made once and
+ *          used for all runs of that length.
+ * </pre>
+ */
+static void
+morphRunsLow(PIX      *pixd,
+             PIX      *pixs,
+             l_int32   orient,
+             l_int32  *runs,
+             l_int32   nruns,
+             l_int32   cx,
+             l_int32   cy,
+             l_int32   type,
+             l_int32   inverted)
+{
+l_int32  w, h, k, i, j, len, lastlen, runtype, dir, op;
+PIX     *pixr;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    runtype = (type == L_MORPH_ERODE && !inverted) ? L_MORPH_ERODE
+                                                   : L_MORPH_DILATE;
+    dir = (type == L_MORPH_DILATE) ? -1 : 1;
+    if (type == L_MORPH_DILATE)
+        op = PIX_SRC | PIX_DST;
+    else if (!inverted)
+        op = PIX_SRC & PIX_DST;
+    else
+        op = PIX_NOT(PIX_SRC) & PIX_DST;
+
+    pixr = NULL;
+    lastlen = 0;
+    for (k = 0; k < nruns; k++) {
+        i = runs[3 * k];
+        j = runs[3 * k + 1];
+        len = runs[3 * k + 2];
+        if (len != lastlen) {
+            pixDestroy(&pixr);
+            if (len == 1) {
+                pixr = pixClone(pixs);
+            } else {
+                pixr = pixCopy(NULL, pixs);
+                if (orient == L_HORIZ && dir == 1)  /* reads the pad bits */
+                    pixSetPadBits(pixr, (runtype == L_MORPH_ERODE) ? 1 : 0);
+                runningOpLow(pixGetData(pixr), h, pixGetWpl(pixr), orient,
+                             len, dir, runtype);
+            }
+            lastlen = len;
+        }
+        if (type == L_MORPH_DILATE)
+            pixRasterop(pixd, j - cx, i - cy, w, h, op, pixr, 0, 0);
+        else
+            pixRasterop(pixd, cx - j, cy - i, w, h, op, pixr, 0, 0);
+    }
+    pixDestroy(&pixr);
+    return;
+}
+
+
+/*-----------------------------------------------------------------*
+ *           Static helpers for hit-miss pattern search            *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   hmtOrderElements()
+ *
+ * \param[in]    sel
+ * \param[out]   pelems   triples (dx, dy, type) for the hits and misses,
+ *                        in order of testing
+ * \param[out]   pnelem   number of hits and misses
+ * \return  number of hits
+ *
+ * <pre>
+ * Notes:
+ *      (1) The first hit in raster order is tested first, followed
+ *          by the hit that is farthest from it, the rest of the hits,
+ *          and then the misses.  The shift (dx, dy) is from the dest
+ *          pixel to the src pixel for the element.
+ * </pre>
+ */
+static l_int32
+hmtOrderElements(SEL       *sel,
+                 l_int32  **pelems,
+                 l_int32   *pnelem)
+{
+l_int32   i, j, k, sx, sy, cx, cy, n, nhits, maxdist, dist, imax, tmp;
+l_int32  *elems;
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    elems = (l_int32 *)LEPT_CALLOC(3 * sx * sy, sizeof(l_int32));
+    *pelems = elems;
+    n = nhits = 0;
+    for (k = SEL_HIT; k <= SEL_MISS; k++) {
+        for (i = 0; i < sy; i++) {
+            for (j = 0; j < sx; j++) {
+                if (sel->data[i][j] != k) continue;
+                elems[3 * n] = j - cx;
+                elems[3 * n + 1] = i - cy;
+                elems[3 * n + 2] = k;
+                n++;
+            }
+        }
+        if (k == SEL_HIT) nhits = n;
+    }
+    *pnelem = n;
+
+        /* Move the hit farthest from the first one into second place */
+    maxdist = -1;
+    imax = 0;
+    for (i = 1; i < nhits; i++) {
+        dist = L_ABS(elems[3 * i] - elems[0]) +
+               L_ABS(elems[3 * i + 1] - elems[1]);
+        if (dist > maxdist) {
+            maxdist = dist;
+            imax = i;
+        }
+    }
+    if (imax > 1) {
+        for (k = 0; k < 3; k++) {
+            tmp = elems[3 + k];
+            elems[3 + k] = elems[3 * imax + k];
+            elems[3 * imax + k] = tmp;
+        }
+    }
+    return nhits;
+}
+
+
+/*!
+ * \brief   hmtSearchLow()
+ *
+ * \param[in]    datad, w, h, wpld   dest
+ * \param[in]    datab, wplb         src, with an added border of OFF pixels
+ * \param[in]    left, top           size of the border; left is a
+ *                                   multiple of 32
+ * \param[in]    elems               from hmtOrderElements()
+ * \param[in]    nelem               number of hits and misses
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The border must cover all the shifts of the elements, with
+ *          at least one extra word on the right, so that the two src
+ *          words holding the 32 shifted pixels can always be read.
+ *      (2) For each dest word, this stops testing elements as soon as
+ *          none of the 32 pixels can be a match.
+ * </pre>
+ */
+static void
+hmtSearchLow(l_uint32  *datad,
+             l_int32    w,
+             l_int32    h,
+             l_int32    wpld,
+             l_uint32  *datab,
+             l_int32    wplb,
+             l_int32    left,
+             l_int32    top,
+             l_int32   *elems,
+             l_int32    nelem)
+{
+l_int32    i, j, k, shift;
+l_int32   *offset, *shifts;
+l_uint32   word, val, endmask;
+l_uint32  *lined, *lineb, *pword;
+l_uint32  *invert;
+
+        /* For each element, the src word offset from the dest word,
+         * the shift within the word, and the inversion for misses */
+    offset = (l_int32 *)LEPT_CALLOC(nelem, sizeof(l_int32));
+    shifts = (l_int32 *)LEPT_CALLOC(nelem, sizeof(l_int32));
+    invert = (l_uint32 *)LEPT_CALLOC(nelem, sizeof(l_uint32));
+    for (k = 0; k < nelem; k++) {
+        offset[k] = (top + elems[3 * k + 1]) * wplb +
+                    (left + elems[3 * k]) / 32;
+        shifts[k] = elems[3 * k] & 31;
+        invert[k] = (elems[3 * k + 2] == SEL_MISS) ? 0xffffffff : 0;
+    }
+
+    endmask = (w & 31) ? 0xffffffff << (32 - (w & 31)) : 0xffffffff;
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        lineb = datab + i * wplb;
+        for (j = 0; j < wpld; j++) {
+            word = 0xffffffff;
+            for (k = 0; k < nelem && word; k++) {
+                pword = lineb + offset[k] + j;
+                if ((shift = shifts[k]) == 0)
+                    val = pword[0];
+                else
+                    val = (pword[0] << shift) | (pword[1] >> (32 - shift));
+                word &= val ^ invert[k];
+            }
+            lined[j] = word;
+        }
+        lined[wpld - 1] &= endmask;
+    }
+
+    LEPT_FREE(offset);
+    LEPT_FREE(shifts);
+    LEPT_FREE(invert);
+}
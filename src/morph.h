@@ -34,6 +34,9 @@
  *  Contains the following structs:
  *      struct Sel
  *      struct Sela
+ *      struct L_SelPlan
+ *      struct L_MorphPlan
+ *      struct L_MaxTree
  *      struct Kernel
  *
  *  Contains definitions for:
@@ -42,6 +45,8 @@
  *      runlength flags for granulometry
  *      direction flags for grayscale morphology
  *      morphological operation flags
+ *      compiled morph sequence methods
+ *      max-tree types and node attributes
  *      standard border size
  *      grayscale intensity scaling flags
  *      morphological tophat flags
@@ -78,6 +83,68 @@ struct Sela
 };
 typedef struct Sela SELA;
 
+/*! Decomposition of a Sel into runs, for rasterop morphology */
+struct L_SelPlan
+{
+    l_int32       sy;        /*!< sel height                               */
+    l_int32       sx;        /*!< sel width                                */
+    l_int32       cy;        /*!< y location of sel origin                 */
+    l_int32       cx;        /*!< x location of sel origin                 */
+    l_int32       nhits;     /*!< number of hits                           */
+    l_int32       hitorient; /*!< L_HORIZ or L_VERT runs of hits           */
+    l_int32       nhitruns;  /*!< number of runs of hits                   */
+    l_int32      *hitruns;   /*!< (i, j, length) for each run of hits,     */
+                             /*!< starting at (i, j); sorted by length     */
+    l_int32       hitcost;   /*!< estimated cost of the runs, in passes    */
+    l_int32       nmisses;   /*!< number of misses                         */
+    l_int32       missorient; /*!< L_HORIZ or L_VERT runs of misses        */
+    l_int32       nmissruns; /*!< number of runs of misses                 */
+    l_int32      *missruns;  /*!< (i, j, length) for each run of misses    */
+    l_int32       misscost;  /*!< estimated cost of the runs, in passes    */
+};
+typedef struct L_SelPlan L_SELPLAN;
+
+
+/*-------------------------------------------------------------------------*
+ *                  Compiled binary morphological sequence                 *
+ *-------------------------------------------------------------------------*/
+/*! Morph sequence plan: a sequence string, parsed and verified once */
+struct L_MorphPlan
+{
+    l_int32       method;    /*!< L_MORPH_SEQ_ROP, etc.                    */
+    l_int32       nsteps;    /*!< number of steps, after fusing ops        */
+    l_int32      *steps;     /*!< 5 ints for each step: op and its args    */
+    l_int32       border;    /*!< added at the start; removed at the end   */
+    struct Pix   *pixt;      /*!< scratch image kept between calls         */
+};
+typedef struct L_MorphPlan L_MORPHPLAN;
+
+
+/*-------------------------------------------------------------------------*
+ *                       Max-tree (component tree)                         *
+ *-------------------------------------------------------------------------*/
+/*! Max-tree of an 8 or 16 bpp image; the nodes are the connected
+ *  components of all the thresholded images.  Pixels are indexed
+ *  in raster order, and each node is represented by one of its
+ *  pixels at the node level (the canonical pixel).  */
+struct L_MaxTree
+{
+    l_int32       w;         /*!< image width                              */
+    l_int32       h;         /*!< image height                             */
+    l_int32       depth;     /*!< 8 or 16 bpp                              */
+    l_int32       type;      /*!< L_MAX_TREE or L_MIN_TREE                 */
+    l_int32       connectivity; /*!< 4 or 8                                */
+    l_int32       maxval;    /*!< 0xff or 0xffff                           */
+    l_uint16     *levels;    /*!< pixel values; inverted for a min-tree    */
+    l_int32      *sorted;    /*!< pixel indices in decreasing level order; */
+                             /*!< every pixel comes before its parent      */
+    l_int32      *parent;    /*!< canonical pixel of the parent node;      */
+                             /*!< or of its own node if not canonical      */
+    l_int32       root;      /*!< canonical pixel of the root node         */
+    l_int32       nnodes;    /*!< number of nodes in the tree              */
+};
+typedef struct L_MaxTree L_MAXTREE;
+
 
 /*-------------------------------------------------------------------------*
  *                                 Kernel                                  *
@@ -151,6 +218,34 @@ enum {
     L_MORPH_HMT       = 5
 };
 
+/*-------------------------------------------------------------------------*
+ *                  Methods for compiled morph sequences                   *
+ *-------------------------------------------------------------------------*/
+/*! Morph Sequence Method */
+enum {
+    L_MORPH_SEQ_ROP       = 1,   /*!< as in pixMorphSequence()           */
+    L_MORPH_SEQ_COMP_ROP  = 2,   /*!< as in pixMorphCompSequence()       */
+    L_MORPH_SEQ_DWA       = 3,   /*!< as in pixMorphSequenceDwa()        */
+    L_MORPH_SEQ_COMP_DWA  = 4    /*!< as in pixMorphCompSequenceDwa()    */
+};
+
+/*-------------------------------------------------------------------------*
+ *                 Max-tree types and node attributes                      *
+ *-------------------------------------------------------------------------*/
+/*! Max-tree Type */
+enum {
+    L_MAX_TREE  = 1,         /*!< nodes are components of bright regions */
+    L_MIN_TREE  = 2          /*!< nodes are components of dark regions   */
+};
+
+/*! Max-tree Node Attribute */
+enum {
+    L_MT_AREA         = 1,   /*!< number of pixels in the node           */
+    L_MT_CONTRAST     = 2,   /*!< peak level above the parent level      */
+    L_MT_BBOX_WIDTH   = 3,   /*!< width of the node bounding box         */
+    L_MT_BBOX_HEIGHT  = 4    /*!< height of the node bounding box        */
+};
+
 /*-------------------------------------------------------------------------*
  *                    Grayscale intensity scaling flags                    *
  *-------------------------------------------------------------------------*/
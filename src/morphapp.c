@@ -68,8 +68,10 @@
  *      Iterative morphological seed filling (don't use for real work)
  *            PIX       *pixSeedfillMorph()
  *
- *      Granulometry on binary images
+ *      Granulometry
  *            NUMA      *pixRunHistogramMorph()
+ *            l_int32    pixGranulometry()
+ *            l_int32    pixAreaGranulometry()
  *
  *      Composite operations on grayscale images
  *            PIX       *pixTophat()
@@ -80,6 +82,14 @@
  *      Centroid of component
  *            PTA       *pixaCentroids()
  *            l_int32    pixCentroid()
+ *
+ *      Static helpers for granulometry
+ *            static void   granulometryLinear()
+ *            static void   lineSpectrumLow()
+ *            static void   granulometryBrickBinary()
+ *            static void   granulometryBrickGray()
+ *            static void   runningMaxLow()
+ *            static void   granulometryMakeNumas()
  * </pre>
  */
 
@@ -87,11 +97,27 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 #include "array_internal.h"
 
 #define   SWAP(x, y)   {temp = (x); (x) = (y); (y) = temp;}
 
+    /* Static helpers for granulometry */
+static void granulometryLinear(PIX *pixs, l_int32 direction,
+                               l_int32 maxsize, l_float64 *spec);
+static void lineSpectrumLow(l_int32 *vals, l_int32 n, l_int32 *starts,
+                            l_int32 *levels, l_int32 maxsize,
+                            l_float64 *spec);
+static void granulometryBrickBinary(PIX *pixs, l_int32 maxsize,
+                                    l_float64 *spec);
+static void granulometryBrickGray(PIX *pixs, l_int32 maxsize,
+                                  l_float64 *spec);
+static void runningMaxLow(l_uint8 *data, l_int32 w, l_int32 h,
+                          l_int32 orient, l_int32 size);
+static void granulometryMakeNumas(l_float64 *spec, l_int32 maxsize,
+                                  NUMA **pnaspec, NUMA **pnadist);
+
 /*-----------------------------------------------------------------*
  *                   Extraction of boundary pixels                 *
  *-----------------------------------------------------------------*/
@@ -257,6 +283,8 @@ PIXA    *pixas, *pixad;
  *          or exceed a minimum size for the operation to take place.
  *      (4) The input pixa should have a boxa giving the locations
  *          of the pix components.
+ *      (5) The sequence is parsed once, by morphPlanCreate(), and the
+ *          plan is applied to each component.
  * </pre>
  */
 PIXA *
@@ -265,10 +293,11 @@ pixaMorphSequenceByComponent(PIXA        *pixas,
                              l_int32      minw,
                              l_int32      minh)
 {
-l_int32  n, i, w, h, d;
-BOX     *box;
-PIX     *pix1, *pix2;
-PIXA    *pixad;
+l_int32       n, i, w, h, d;
+BOX          *box;
+L_MORPHPLAN  *plan;
+PIX          *pix1, *pix2;
+PIXA         *pixad;
 
     if (!pixas)
         return (PIXA *)ERROR_PTR("pixas not defined", __func__, NULL);
@@ -285,16 +314,25 @@ PIXA    *pixad;
     if (minw <= 0) minw = 1;
     if (minh <= 0) minh = 1;
 
-    if ((pixad = pixaCreate(n)) == NULL)
+        /* Parse the sequence once for all the components */
+    if ((plan = morphPlanCreate(sequence, L_MORPH_SEQ_COMP_ROP)) == NULL)
+        return (PIXA *)ERROR_PTR("plan not made", __func__, NULL);
+
+    if ((pixad = pixaCreate(n)) == NULL) {
+        morphPlanDestroy(&plan);
         return (PIXA *)ERROR_PTR("pixad not made", __func__, NULL);
+    }
     for (i = 0; i < n; i++) {
         pixaGetPixDimensions(pixas, i, &w, &h, NULL);
         if (w >= minw && h >= minh) {
             if ((pix1 = pixaGetPix(pixas, i, L_CLONE)) == NULL) {
+                morphPlanDestroy(&plan);
                 pixaDestroy(&pixad);
                 return (PIXA *)ERROR_PTR("pix1 not found", __func__, NULL);
             }
-            if ((pix2 = pixMorphCompSequence(pix1, sequence, 0)) == NULL) {
+            if ((pix2 = pixApplyMorphPlan(pix1, plan)) == NULL) {
+                pixDestroy(&pix1);
+                morphPlanDestroy(&plan);
                 pixaDestroy(&pixad);
                 return (PIXA *)ERROR_PTR("pix2 not made", __func__, NULL);
             }
@@ -305,6 +343,7 @@ PIXA    *pixad;
         }
     }
 
+    morphPlanDestroy(&plan);
     return pixad;
 }
 
@@ -415,6 +454,8 @@ PIXA    *pixam, *pixad;
  *          operation to take place.
  *      (4) The input pixam should have a boxa giving the locations
  *          of the regions in pixs.
+ *      (5) The sequence is parsed once, by morphPlanCreate(), and the
+ *          plan is applied to each region.
  * </pre>
  */
 PIXA *
@@ -424,10 +465,11 @@ pixaMorphSequenceByRegion(PIX         *pixs,
                           l_int32      minw,
                           l_int32      minh)
 {
-l_int32  n, i, w, h, same, maxd, fullpa, fullba;
-BOX     *box;
-PIX     *pix1, *pix2, *pix3;
-PIXA    *pixad;
+l_int32       n, i, w, h, same, maxd, fullpa, fullba;
+BOX          *box;
+L_MORPHPLAN  *plan;
+PIX          *pix1, *pix2, *pix3;
+PIXA         *pixad;
 
     if (!pixs)
         return (PIXA *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -447,8 +489,14 @@ PIXA    *pixad;
     if (minw <= 0) minw = 1;
     if (minh <= 0) minh = 1;
 
-    if ((pixad = pixaCreate(n)) == NULL)
+        /* Parse the sequence once for all the regions */
+    if ((plan = morphPlanCreate(sequence, L_MORPH_SEQ_COMP_ROP)) == NULL)
+        return (PIXA *)ERROR_PTR("plan not made", __func__, NULL);
+
+    if ((pixad = pixaCreate(n)) == NULL) {
+        morphPlanDestroy(&plan);
         return (PIXA *)ERROR_PTR("pixad not made", __func__, NULL);
+    }
 
         /* Use the rectangle to remove the appropriate part of pixs;
          * then AND with the mask component to get the actual fg
@@ -460,7 +508,7 @@ PIXA    *pixad;
             box = pixaGetBox(pixam, i, L_COPY);
             pix2 = pixClipRectangle(pixs, box, NULL);
             pixAnd(pix2, pix2, pix1);
-            pix3 = pixMorphCompSequence(pix2, sequence, 0);
+            pix3 = pixApplyMorphPlan(pix2, plan);
             pixDestroy(&pix1);
             pixDestroy(&pix2);
             if (!pix3) {
@@ -474,6 +522,7 @@ PIXA    *pixad;
         }
     }
 
+    morphPlanDestroy(&plan);
     return pixad;
 }
 
@@ -523,7 +572,7 @@ SEL     *sel;
         else if (type == L_MORPH_CLOSE)
             pixt = pixClose(NULL, pixs, sel);
         else  /* type == L_MORPH_HMT */
-            pixt = pixHMT(NULL, pixs, sel);
+            pixt = pixHMTSearch(pixs, sel, NULL);
         pixOr(pixd, pixd, pixt);
         pixDestroy(&pixt);
     }
@@ -575,7 +624,7 @@ SEL     *sel;
         else if (type == L_MORPH_CLOSE)
             pixt = pixClose(NULL, pixs, sel);
         else  /* type == L_MORPH_HMT */
-            pixt = pixHMT(NULL, pixs, sel);
+            pixt = pixHMTSearch(pixs, sel, NULL);
         pixAnd(pixd, pixd, pixt);
         pixDestroy(&pixt);
     }
@@ -1064,7 +1113,7 @@ SEL     *sel_3;
 
 
 /*-----------------------------------------------------------------*
- *                   Granulometry on binary images                 *
+ *                           Granulometry                          *
  *-----------------------------------------------------------------*/
 /*!
  * \brief   pixRunHistogramMorph()
@@ -1150,6 +1199,197 @@ SEL       *sel_2a;
 }
 
 
+/*!
+ * \brief   pixGranulometry()
+ *
+ * \param[in]    pixs        1 or 8 bpp; no colormap
+ * \param[in]    direction   L_HORIZ, L_VERT for lines;
+ *                           L_BOTH_DIRECTIONS for square bricks
+ * \param[in]    maxsize     largest size of the Sel
+ * \param[out]   pnaspec     [optional] pattern spectrum
+ * \param[out]   pnadist     [optional] size distribution
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This finds the result of openings of pixs by lines or
+ *          square bricks of every size from 1 to %maxsize, without
+ *          doing a separate opening for each size.
+ *      (2) The measure of an opened image is its number of fg pixels
+ *          for 1 bpp, and the sum of its pixel values for 8 bpp.
+ *          The size distribution %nadist has the measure of the
+ *          opening by a Sel of each size k, for k = 0, ... %maxsize,
+ *          where the opening for k = 0 and k = 1 is pixs itself.
+ *          The pattern spectrum %naspec has the measure that is
+ *          removed by going from size k to size k + 1; i.e., the
+ *          measure of the image parts of size k.  naspec[0] is 0.
+ *          The parts larger than %maxsize are not in %naspec, so
+ *          the sum of %naspec can be less than nadist[0].
+ *      (3) The Sels must fit within the image.  For 1 bpp, this is
+ *          the same as pixOpenBrick() with asymmetric b.c.  For 8 bpp,
+ *          it is the same as pixOpenGray() on the image with an
+ *          added black border that is wider than the Sel.
+ *      (4) For lines, each row or column is done in a single pass.
+ *          The opening of a line by a segment of length k keeps the
+ *          parts of the line at each level that are in intervals of
+ *          length at least k, so each interval at each level is
+ *          assigned to its length in the spectrum.  The intervals are
+ *          found with a stack, as in finding the largest rectangle
+ *          under a histogram.
+ *      (5) For square bricks, the erosion by a k x k brick is found
+ *          from the erosion by a (k - 1) x (k - 1) brick with a 2 x 2
+ *          erosion, and the opening is the dilation of that erosion,
+ *          which is done with running ops whose cost grows only
+ *          with the log of k.  This stops when the erosion is empty.
+ *      (6) For area openings, see pixAreaGranulometry().
+ * </pre>
+ */
+l_ok
+pixGranulometry(PIX     *pixs,
+                l_int32  direction,
+                l_int32  maxsize,
+                NUMA   **pnaspec,
+                NUMA   **pnadist)
+{
+l_int32     d;
+l_float64  *spec;
+
+    if (pnaspec) *pnaspec = NULL;
+    if (pnadist) *pnadist = NULL;
+    if (!pnaspec && !pnadist)
+        return ERROR_INT("no output requested", __func__, 1);
+    if (!pixs)
+        return ERROR_INT("pixs not defined", __func__, 1);
+    d = pixGetDepth(pixs);
+    if (d != 1 && d != 8)
+        return ERROR_INT("pixs not 1 or 8 bpp", __func__, 1);
+    if (pixGetColormap(pixs))
+        return ERROR_INT("pixs has colormap", __func__, 1);
+    if (direction != L_HORIZ && direction != L_VERT &&
+        direction != L_BOTH_DIRECTIONS)
+        return ERROR_INT("invalid direction", __func__, 1);
+    if (maxsize < 1)
+        return ERROR_INT("maxsize < 1", __func__, 1);
+
+        /* spec[k] holds the measure of parts of size k, for
+         * k = 1, ... maxsize, and spec[maxsize + 1] holds the
+         * measure of all larger parts. */
+    spec = (l_float64 *)LEPT_CALLOC(maxsize + 2, sizeof(l_float64));
+    if (direction != L_BOTH_DIRECTIONS)
+        granulometryLinear(pixs, direction, maxsize, spec);
+    else if (d == 1)
+        granulometryBrickBinary(pixs, maxsize, spec);
+    else
+        granulometryBrickGray(pixs, maxsize, spec);
+    granulometryMakeNumas(spec, maxsize, pnaspec, pnadist);
+    LEPT_FREE(spec);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixAreaGranulometry()
+ *
+ * \param[in]    pixs           1, 8 or 16 bpp; no colormap
+ * \param[in]    connectivity   4 or 8
+ * \param[in]    maxsize        largest area
+ * \param[out]   pnaspec        [optional] pattern spectrum
+ * \param[out]   pnadist        [optional] size distribution
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the granulometry for area openings, which remove
+ *          the connected components with fewer than k pixels.
+ *          The output is as in pixGranulometry(), with the size
+ *          being the area: for 1 bpp, naspec[k] is the number of fg
+ *          pixels in components of area k.
+ *      (2) For 1 bpp, all the area openings are found from one
+ *          labelling of the connected components.
+ *      (3) For 8 and 16 bpp, the measure is the sum of pixel values,
+ *          and the area openings are found from the max-tree.  Each
+ *          node of area a and height h above its parent contributes
+ *          a * h to naspec[a].  The root, which is the whole image at
+ *          its minimum level, is never removed by pixAreaOpen(), so it
+ *          is counted as larger than %maxsize.  Then nadist[k] is the
+ *          sum of pixel values after pixAreaOpen() with %minarea = k,
+ *          for all k, including k > w * h.
+ * </pre>
+ */
+l_ok
+pixAreaGranulometry(PIX     *pixs,
+                    l_int32  connectivity,
+                    l_int32  maxsize,
+                    NUMA   **pnaspec,
+                    NUMA   **pnadist)
+{
+l_int32     i, n, d, area, height, index;
+l_float64  *spec;
+BOXA       *boxa;
+NUMA       *na, *naheight;
+PIXA       *pixa;
+L_MAXTREE  *tree;
+
+    if (pnaspec) *pnaspec = NULL;
+    if (pnadist) *pnadist = NULL;
+    if (!pnaspec && !pnadist)
+        return ERROR_INT("no output requested", __func__, 1);
+    if (!pixs)
+        return ERROR_INT("pixs not defined", __func__, 1);
+    d = pixGetDepth(pixs);
+    if (d != 1 && d != 8 && d != 16)
+        return ERROR_INT("pixs not 1, 8 or 16 bpp", __func__, 1);
+    if (pixGetColormap(pixs))
+        return ERROR_INT("pixs has colormap", __func__, 1);
+    if (connectivity != 4 && connectivity != 8)
+        return ERROR_INT("connectivity not 4 or 8", __func__, 1);
+    if (maxsize < 1)
+        return ERROR_INT("maxsize < 1", __func__, 1);
+
+    spec = (l_float64 *)LEPT_CALLOC(maxsize + 2, sizeof(l_float64));
+    if (!spec)
+        return ERROR_INT("spec not made", __func__, 1);
+    if (d == 1) {
+        if ((boxa = pixConnComp(pixs, &pixa, connectivity)) == NULL) {
+            LEPT_FREE(spec);
+            return ERROR_INT("boxa not made", __func__, 1);
+        }
+        na = pixaCountPixels(pixa);
+        n = numaGetCount(na);
+        for (i = 0; i < n; i++) {
+            numaGetIValue(na, i, &area);
+            spec[L_MIN(area, maxsize + 1)] += area;
+        }
+        boxaDestroy(&boxa);
+        pixaDestroy(&pixa);
+    } else {
+        if ((tree = maxtreeCreate(pixs, L_MAX_TREE, connectivity)) == NULL) {
+            LEPT_FREE(spec);
+            return ERROR_INT("tree not made", __func__, 1);
+        }
+        if (maxtreeGetNodeAttributes(tree, L_MT_AREA, &na, &naheight)) {
+            maxtreeDestroy(&tree);
+            LEPT_FREE(spec);
+            return ERROR_INT("node attributes not made", __func__, 1);
+        }
+        n = numaGetCount(na);  /* the root is last */
+        for (i = 0; i < n; i++) {
+            numaGetIValue(na, i, &area);
+            numaGetIValue(naheight, i, &height);
+            index = (i == n - 1) ? maxsize + 1 : L_MIN(area, maxsize + 1);
+            spec[index] += (l_float64)area * height;
+        }
+        numaDestroy(&naheight);
+        maxtreeDestroy(&tree);
+    }
+    granulometryMakeNumas(spec, maxsize, pnaspec, pnadist);
+
+    LEPT_FREE(spec);
+    numaDestroy(&na);
+    return 0;
+}
+
+
 /*-----------------------------------------------------------------*
  *            Composite operations on grayscale images             *
  *-----------------------------------------------------------------*/
@@ -1595,3 +1835,337 @@ l_int32   *ctab, *stab;
     }
     return 0;
 }
+
+
+/*-----------------------------------------------------------------*
+ *                 Static helpers for granulometry                 *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   granulometryLinear()
+ *
+ * \param[in]    pixs        1 or 8 bpp
+ * \param[in]    direction   L_HORIZ, L_VERT
+ * \param[in]    maxsize     largest size of the Sel
+ * \param[in]    spec        accumulates the measure of parts of each size
+ * \return  void
+ */
+static void
+granulometryLinear(PIX        *pixs,
+                   l_int32     direction,
+                   l_int32     maxsize,
+                   l_float64  *spec)
+{
+l_int32    i, j, w, h, d, wpl, n;
+l_int32   *vals, *starts, *levels;
+l_uint32  *data, *line;
+
+    pixGetDimensions(pixs, &w, &h, &d);
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    n = L_MAX(w, h);
+    vals = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    starts = (l_int32 *)LEPT_CALLOC(n + 1, sizeof(l_int32));
+    levels = (l_int32 *)LEPT_CALLOC(n + 1, sizeof(l_int32));
+
+    if (direction == L_HORIZ) {
+        for (i = 0; i < h; i++) {
+            line = data + i * wpl;
+            for (j = 0; j < w; j++)
+                vals[j] = (d == 1) ? GET_DATA_BIT(line, j)
+                                   : GET_DATA_BYTE(line, j);
+            lineSpectrumLow(vals, w, starts, levels, maxsize, spec);
+        }
+    } else {  /* direction == L_VERT */
+        for (j = 0; j < w; j++) {
+            for (i = 0; i < h; i++) {
+                line = data + i * wpl;
+                vals[i] = (d == 1) ? GET_DATA_BIT(line, j)
+                                   : GET_DATA_BYTE(line, j);
+            }
+            lineSpectrumLow(vals, h, starts, levels, maxsize, spec);
+        }
+    }
+
+    LEPT_FREE(vals);
+    LEPT_FREE(starts);
+    LEPT_FREE(levels);
+}
+
+
+/*!
+ * \brief   lineSpectrumLow()
+ *
+ * \param[in]    vals      values on the line
+ * \param[in]    n         number of values
+ * \param[in]    starts    buffer of n + 1 for the stack
+ * \param[in]    levels    buffer of n + 1 for the stack
+ * \param[in]    maxsize   largest size of the Sel
+ * \param[in]    spec      accumulates the measure of parts of each size
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Consider each maximal interval on which all values are at
+ *          least some level.  Going up from the level of the larger of
+ *          the two values just outside the interval (0 outside the
+ *          line), the interval stays the same until the level of its
+ *          smallest value.  The measure between these two levels,
+ *          (length * height), survives the openings by segments up
+ *          to the length of the interval, and no others.
+ *      (2) The stack holds the start and level of nested intervals
+ *          that are still open, with increasing levels.  An interval
+ *          is closed when a smaller value is found.
+ * </pre>
+ */
+static void
+lineSpectrumLow(l_int32    *vals,
+                l_int32     n,
+                l_int32    *starts,
+                l_int32    *levels,
+                l_int32     maxsize,
+                l_float64  *spec)
+{
+l_int32  x, val, start, len, parent, nstack;
+
+    nstack = 0;
+    for (x = 0; x <= n; x++) {
+        val = (x < n) ? vals[x] : 0;  /* close all intervals at the end */
+        start = x;
+        while (nstack > 0 && levels[nstack - 1] > val) {
+            nstack--;
+            start = starts[nstack];
+            parent = (nstack > 0) ? levels[nstack - 1] : 0;
+            parent = L_MAX(parent, val);
+            len = x - start;
+            spec[L_MIN(len, maxsize + 1)] +=
+                    (l_float64)len * (levels[nstack] - parent);
+        }
+        if (nstack == 0 || levels[nstack - 1] < val) {
+            starts[nstack] = start;
+            levels[nstack] = val;
+            nstack++;
+        }
+    }
+}
+
+
+/*!
+ * \brief   granulometryBrickBinary()
+ *
+ * \param[in]    pixs      1 bpp
+ * \param[in]    maxsize   largest size of the Sel
+ * \param[in]    spec      accumulates the measure of parts of each size
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The erosion by a k x k brick, with its origin at the UL
+ *          corner, is the set of UL corners of k x k squares of fg.
+ *          Corners of squares that would go outside the image are
+ *          removed, so the result does not depend on the morphological
+ *          boundary condition.
+ * </pre>
+ */
+static void
+granulometryBrickBinary(PIX        *pixs,
+                        l_int32     maxsize,
+                        l_float64  *spec)
+{
+l_int32  k, w, h, count, prev, empty;
+PIX     *pixe, *pixd;
+SEL     *sel, *sel2;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    sel2 = selCreateBrick(2, 2, 0, 0, SEL_HIT);
+    pixe = pixCopy(NULL, pixs);
+    pixd = pixCreateTemplate(pixs);
+    pixCountPixels(pixs, &prev, NULL);  /* opening by 1 x 1 */
+    for (k = 2; k <= maxsize + 1; k++) {
+        pixErode(pixe, pixe, sel2);
+        pixRasterop(pixe, w - k + 1, 0, k - 1, h, PIX_CLR, NULL, 0, 0);
+        pixRasterop(pixe, 0, h - k + 1, w, k - 1, PIX_CLR, NULL, 0, 0);
+        pixZero(pixe, &empty);
+        count = 0;
+        if (!empty) {
+            sel = selCreateBrick(k, k, 0, 0, SEL_HIT);
+            pixDilate(pixd, pixe, sel);
+            selDestroy(&sel);
+            pixCountPixels(pixd, &count, NULL);
+        }
+        spec[k - 1] += prev - count;
+        prev = count;
+        if (empty) break;
+    }
+    spec[maxsize + 1] += prev;
+
+    pixDestroy(&pixe);
+    pixDestroy(&pixd);
+    selDestroy(&sel2);
+}
+
+
+/*!
+ * \brief   granulometryBrickGray()
+ *
+ * \param[in]    pixs      8 bpp
+ * \param[in]    maxsize   largest size of the Sel
+ * \param[in]    spec      accumulates the measure of parts of each size
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the grayscale version of granulometryBrickBinary(),
+ *          working on byte arrays.  Corners of squares that would go
+ *          outside the image are set to 0, which does not change
+ *          the dilation.
+ * </pre>
+ */
+static void
+granulometryBrickGray(PIX        *pixs,
+                      l_int32     maxsize,
+                      l_float64  *spec)
+{
+l_int32     i, j, k, w, h, wpl, maxval;
+l_uint8    *era, *dila, *pe;
+l_uint32   *data, *line;
+l_float64   sum, prev;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    era = (l_uint8 *)LEPT_CALLOC((size_t)w * h, sizeof(l_uint8));
+    dila = (l_uint8 *)LEPT_CALLOC((size_t)w * h, sizeof(l_uint8));
+    prev = 0.0;
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        pe = era + (size_t)i * w;
+        for (j = 0; j < w; j++) {
+            pe[j] = GET_DATA_BYTE(line, j);
+            prev += pe[j];
+        }
+    }
+
+    for (k = 2; k <= maxsize + 1; k++) {
+            /* Erode by 2 x 2 in place, with the origin at the UL corner */
+        maxval = 0;
+        for (i = 0; i < h; i++) {
+            pe = era + (size_t)i * w;
+            if (i == h - 1) {
+                memset(pe, 0, w);
+                break;
+            }
+            for (j = 0; j < w - 1; j++) {
+                pe[j] = L_MIN(pe[j], pe[j + 1]);
+                pe[j] = L_MIN(pe[j], pe[j + w]);
+                pe[j] = L_MIN(pe[j], pe[j + w + 1]);
+                maxval = L_MAX(maxval, pe[j]);
+            }
+            pe[w - 1] = 0;
+        }
+
+            /* Dilate by k x k, with the origin at the LR corner */
+        sum = 0.0;
+        if (maxval > 0) {
+            memcpy(dila, era, (size_t)w * h);
+            runningMaxLow(dila, w, h, L_HORIZ, k);
+            runningMaxLow(dila, w, h, L_VERT, k);
+            for (i = 0; i < w * h; i++)
+                sum += dila[i];
+        }
+        spec[k - 1] += prev - sum;
+        prev = sum;
+        if (maxval == 0) break;
+    }
+    spec[maxsize + 1] += prev;
+
+    LEPT_FREE(era);
+    LEPT_FREE(dila);
+}
+
+
+/*!
+ * \brief   runningMaxLow()
+ *
+ * \param[in]    data     w x h bytes; changed in place
+ * \param[in]    w, h     size
+ * \param[in]    orient   L_HORIZ, L_VERT
+ * \param[in]    size     of the window
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each value is replaced by the max of the %size values
+ *          ending at it, going left or up, with 0 outside the image.
+ *      (2) The window is doubled at each step, going backward so that
+ *          the values read have not yet been changed.  The last step
+ *          overlaps two windows of the largest power of 2 that is
+ *          less than %size, to get a window of %size.
+ * </pre>
+ */
+static void
+runningMaxLow(l_uint8  *data,
+              l_int32   w,
+              l_int32   h,
+              l_int32   orient,
+              l_int32   size)
+{
+l_int32   i, j, len, shift;
+l_uint8  *p, *q;
+
+    for (len = 1; len < size; len *= 2) {
+            /* Window of 2 * len, except for a final partial step */
+        shift = L_MIN(len, size - len);
+        if (orient == L_HORIZ) {
+            for (i = 0; i < h; i++) {
+                p = data + (size_t)i * w;
+                for (j = w - 1; j >= shift; j--)
+                    p[j] = L_MAX(p[j], p[j - shift]);
+            }
+        } else {  /* orient == L_VERT */
+            for (i = h - 1; i >= shift; i--) {
+                p = data + (size_t)i * w;
+                q = p - (size_t)shift * w;
+                for (j = 0; j < w; j++)
+                    p[j] = L_MAX(p[j], q[j]);
+            }
+        }
+    }
+}
+
+
+/*!
+ * \brief   granulometryMakeNumas()
+ *
+ * \param[in]    spec       measure of parts of each size; size maxsize + 2
+ * \param[in]    maxsize    largest size of the Sel
+ * \param[out]   pnaspec    [optional] pattern spectrum
+ * \param[out]   pnadist    [optional] size distribution
+ * \return  void
+ */
+static void
+granulometryMakeNumas(l_float64  *spec,
+                      l_int32     maxsize,
+                      NUMA      **pnaspec,
+                      NUMA      **pnadist)
+{
+l_int32    k;
+l_float64  sum;
+NUMA      *na;
+
+    if (pnaspec) {
+        na = numaCreate(maxsize + 1);
+        numaAddNumber(na, 0);
+        for (k = 1; k <= maxsize; k++)
+            numaAddNumber(na, spec[k]);
+        *pnaspec = na;
+    }
+    if (pnadist) {
+        na = numaMakeConstant(0, maxsize + 1);
+        for (k = maxsize + 1, sum = 0.0; k >= 1; k--) {
+            sum += spec[k];
+            if (k <= maxsize) numaSetValue(na, k, sum);
+        }
+        numaSetValue(na, 0, sum);
+        *pnadist = na;
+    }
+}
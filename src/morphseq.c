@@ -43,6 +43,13 @@
  *      Parser verifier for binary morphological operations
  *            l_int32  morphSequenceVerify()
  *
+ *      Compiled sequences of binary morphological operations
+ *            L_MORPHPLAN  *morphPlanCreate()
+ *            void          morphPlanDestroy()
+ *            PIX          *pixApplyMorphPlan()
+ *            PIXA         *pixaApplyMorphPlan()
+ *            static PIX   *morphPlanBrick()
+ *
  *      Run a sequence of grayscale morphological operations
  *            PIX     *pixGrayMorphSequence()
  *
@@ -58,6 +65,26 @@
 #include <string.h>
 #include "allheaders.h"
 
+    /* Operations in a compiled sequence.  Each step has StepSize ints:
+     * the operation, followed by its args: (w, h) for the brick
+     * operations, the levels for the reduction and the factor for
+     * the expansion.  OpClose is a closing that is not safe; it is
+     * only made by fusing a dilation and an erosion. */
+enum {
+    OpDilate = 1,
+    OpErode = 2,
+    OpOpen = 3,
+    OpClose = 4,
+    OpCloseSafe = 5,
+    OpReduce = 6,
+    OpExpand = 7
+};
+
+static const l_int32  StepSize = 5;
+
+static PIX *morphPlanBrick(PIX *pixd, PIX *pixs, l_int32 op, l_int32 w,
+                           l_int32 h, l_int32 method);
+
 /*-------------------------------------------------------------------------*
  *         Run a sequence of binary rasterop morphological operations      *
  *-------------------------------------------------------------------------*/
@@ -849,6 +876,417 @@ l_int32  intlogbase2[5] = {1, 2, 3, 0, 4};  /* of arg/4 */
 }
 
 
+/*-------------------------------------------------------------------------*
+ *          Compiled sequences of binary morphological operations         *
+ *-------------------------------------------------------------------------*/
+/*!
+ * \brief   morphPlanCreate()
+ *
+ * \param[in]    sequence   string specifying sequence
+ * \param[in]    method     L_MORPH_SEQ_ROP, L_MORPH_SEQ_COMP_ROP,
+ *                          L_MORPH_SEQ_DWA or L_MORPH_SEQ_COMP_DWA
+ * \return  plan, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This parses and verifies a sequence of binary morphological
+ *          operations once, so that it can be applied to any number
+ *          of images with pixApplyMorphPlan().  See pixMorphSequence()
+ *          for the format of %sequence.
+ *      (2) %method chooses the functions that carry out the operations:
+ *          those of pixMorphSequence(), pixMorphCompSequence(),
+ *          pixMorphSequenceDwa() or pixMorphCompSequenceDwa().
+ *          The results are the same as from that function.
+ *      (3) For L_MORPH_SEQ_ROP, some adjacent operations are fused:
+ *            ~ An erosion followed by a dilation with the same brick
+ *              is an opening.
+ *            ~ A dilation followed by an erosion with the same brick
+ *              is a closing.  This is not a safe closing, just as the
+ *              sequence is not.
+ *          These are done in place, without an intermediate image.
+ *          pixOpenBrick() and pixCloseBrick() are exactly the erosion
+ *          and dilation in sequence, so the result is unchanged.
+ *          That is not true of the other methods: for example, with
+ *          SYMMETRIC_MORPH_BC pixOpenCompBrick() differs from
+ *          pixErodeCompBrick() followed by pixDilateCompBrick()
+ *          near the image boundary.  Their steps are never fused.
+ * </pre>
+ */
+L_MORPHPLAN *
+morphPlanCreate(const char  *sequence,
+                l_int32      method)
+{
+char         *rawop, *op;
+l_int32       nops, i, j, n, nred, w, h, fact, fuse;
+l_int32      *step, *prev;
+L_MORPHPLAN  *plan;
+SARRAY       *sa;
+
+    if (!sequence)
+        return (L_MORPHPLAN *)ERROR_PTR("sequence not defined", __func__, NULL);
+    if (method != L_MORPH_SEQ_ROP && method != L_MORPH_SEQ_COMP_ROP &&
+        method != L_MORPH_SEQ_DWA && method != L_MORPH_SEQ_COMP_DWA)
+        return (L_MORPHPLAN *)ERROR_PTR("invalid method", __func__, NULL);
+
+        /* Split sequence into individual operations and verify */
+    sa = sarrayCreate(0);
+    sarraySplitString(sa, sequence, "+");
+    if (!morphSequenceVerify(sa)) {
+        sarrayDestroy(&sa);
+        return (L_MORPHPLAN *)ERROR_PTR("sequence not valid", __func__, NULL);
+    }
+    nops = sarrayGetCount(sa);
+
+    plan = (L_MORPHPLAN *)LEPT_CALLOC(1, sizeof(L_MORPHPLAN));
+    plan->method = method;
+    plan->steps = (l_int32 *)LEPT_CALLOC(StepSize * L_MAX(1, nops),
+                                         sizeof(l_int32));
+    fuse = (method == L_MORPH_SEQ_ROP);
+    n = 0;
+    for (i = 0; i < nops; i++) {
+        rawop = sarrayGetString(sa, i, L_NOCOPY);
+        op = stringRemoveChars(rawop, " \n\t");
+        step = plan->steps + StepSize * n;
+        prev = (n > 0) ? step - StepSize : NULL;
+        switch (op[0])
+        {
+        case 'd':
+        case 'D':
+            sscanf(&op[1], "%d.%d", &w, &h);
+            if (fuse && prev && prev[0] == OpErode && prev[1] == w &&
+                prev[2] == h) {
+                prev[0] = OpOpen;
+                break;
+            }
+            step[0] = OpDilate;
+            step[1] = w;
+            step[2] = h;
+            n++;
+            break;
+        case 'e':
+        case 'E':
+            sscanf(&op[1], "%d.%d", &w, &h);
+            if (fuse && prev && prev[0] == OpDilate && prev[1] == w &&
+                prev[2] == h) {
+                prev[0] = OpClose;
+                break;
+            }
+            step[0] = OpErode;
+            step[1] = w;
+            step[2] = h;
+            n++;
+            break;
+        case 'o':
+        case 'O':
+        case 'c':
+        case 'C':
+            sscanf(&op[1], "%d.%d", &w, &h);
+            step[0] = (op[0] == 'o' || op[0] == 'O') ? OpOpen : OpCloseSafe;
+            step[1] = w;
+            step[2] = h;
+            n++;
+            break;
+        case 'r':
+        case 'R':
+            nred = strlen(op) - 1;
+            step[0] = OpReduce;
+            for (j = 0; j < nred; j++)
+                step[j + 1] = op[j + 1] - '0';
+            n++;
+            break;
+        case 'x':
+        case 'X':
+            sscanf(&op[1], "%d", &fact);
+            step[0] = OpExpand;
+            step[1] = fact;
+            n++;
+            break;
+        case 'b':
+        case 'B':
+            sscanf(&op[1], "%d", &plan->border);
+            break;
+        default:
+            /* All invalid ops are caught in morphSequenceVerify() */
+            break;
+        }
+        LEPT_FREE(op);
+    }
+    plan->nsteps = n;
+
+    sarrayDestroy(&sa);
+    return plan;
+}
+
+
+/*!
+ * \brief   morphPlanDestroy()
+ *
+ * \param[in,out]   pplan   will be set to null before returning
+ * \return  void
+ */
+void
+morphPlanDestroy(L_MORPHPLAN  **pplan)
+{
+L_MORPHPLAN  *plan;
+
+    if (pplan == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((plan = *pplan) == NULL)
+        return;
+
+    LEPT_FREE(plan->steps);
+    pixDestroy(&plan->pixt);
+    LEPT_FREE(plan);
+    *pplan = NULL;
+}
+
+
+/*!
+ * \brief   pixApplyMorphPlan()
+ *
+ * \param[in]    pixs    1 bpp
+ * \param[in]    plan    from morphPlanCreate()
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A new image is always produced; the input image is not changed.
+ *      (2) The first operation reads from %pixs directly, and openings
+ *          and closings are done in place.  Dilations and erosions write
+ *          into a scratch image, which is then swapped with the current
+ *          image.  The scratch image is kept in the plan for the next
+ *          call, so with images of the same size, a sequence without
+ *          reductions or expansions usually makes only one new image
+ *          for each call, which is returned.
+ *      (3) Because the plan holds the scratch image, a plan must not be
+ *          used by more than one thread at a time.
+ * </pre>
+ */
+PIX *
+pixApplyMorphPlan(PIX          *pixs,
+                  L_MORPHPLAN  *plan)
+{
+l_int32   i, owned;
+l_int32  *step;
+PIX      *pixc, *pixt, *pix1;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", __func__, NULL);
+    if (!plan)
+        return (PIX *)ERROR_PTR("plan not defined", __func__, NULL);
+
+        /* %pixc is the current image.  Until it is %owned, it is
+         * %pixs and must not be changed. */
+    pixt = plan->pixt;
+    plan->pixt = NULL;
+    if (plan->border > 0) {
+        pixc = pixAddBorder(pixs, plan->border, 0);
+        owned = TRUE;
+    } else {
+        pixc = pixClone(pixs);
+        owned = FALSE;
+    }
+
+    for (i = 0; i < plan->nsteps && pixc; i++) {
+        step = plan->steps + StepSize * i;
+        switch (step[0])
+        {
+        case OpDilate:
+        case OpErode:
+            if ((pix1 = morphPlanBrick(pixt, pixc, step[0], step[1], step[2],
+                                       plan->method)) == NULL) {
+                pixDestroy(&pixt);
+                pixDestroy(&pixc);
+                break;
+            }
+            if (owned) {
+                pixt = pixc;
+            } else {
+                pixDestroy(&pixc);
+                pixt = NULL;
+            }
+            pixc = pix1;
+            owned = TRUE;
+            break;
+        case OpOpen:
+        case OpClose:
+        case OpCloseSafe:
+            pix1 = morphPlanBrick((owned) ? pixc : pixt, pixc, step[0],
+                                  step[1], step[2], plan->method);
+            if (!pix1) {
+                pixDestroy(&pixt);
+                pixDestroy(&pixc);
+                break;
+            }
+            if (!owned) {  /* the result is in the scratch image */
+                pixDestroy(&pixc);
+                pixt = NULL;
+            }
+            pixc = pix1;
+            owned = TRUE;
+            break;
+        case OpReduce:
+            pix1 = pixReduceRankBinaryCascade(pixc, step[1], step[2],
+                                              step[3], step[4]);
+            pixDestroy(&pixc);
+            pixc = pix1;
+            owned = TRUE;
+            break;
+        case OpExpand:
+            pix1 = pixExpandReplicate(pixc, step[1]);
+            pixDestroy(&pixc);
+            pixc = pix1;
+            owned = TRUE;
+            break;
+        default:
+            break;
+        }
+    }
+    plan->pixt = pixt;
+    if (!pixc)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+
+    if (plan->border > 0) {
+        pix1 = pixRemoveBorder(pixc, plan->border);
+        pixDestroy(&pixc);
+        pixc = pix1;
+    } else if (!owned) {  /* no operations */
+        pix1 = pixCopy(NULL, pixc);
+        pixDestroy(&pixc);
+        pixc = pix1;
+    }
+    return pixc;
+}
+
+
+/*!
+ * \brief   pixaApplyMorphPlan()
+ *
+ * \param[in]    pixas    of 1 bpp pix
+ * \param[in]    plan     from morphPlanCreate()
+ * \return  pixad, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This applies the plan to each pix in %pixas, with
+ *          pixApplyMorphPlan().  The boxa, if any, is copied to %pixad.
+ * </pre>
+ */
+PIXA *
+pixaApplyMorphPlan(PIXA         *pixas,
+                   L_MORPHPLAN  *plan)
+{
+l_int32  n, i;
+BOXA    *boxa;
+PIX     *pix1, *pix2;
+PIXA    *pixad;
+
+    if (!pixas)
+        return (PIXA *)ERROR_PTR("pixas not defined", __func__, NULL);
+    if (!plan)
+        return (PIXA *)ERROR_PTR("plan not defined", __func__, NULL);
+
+    n = pixaGetCount(pixas);
+    if ((pixad = pixaCreate(n)) == NULL)
+        return (PIXA *)ERROR_PTR("pixad not made", __func__, NULL);
+    for (i = 0; i < n; i++) {
+        pix1 = pixaGetPix(pixas, i, L_CLONE);
+        pix2 = pixApplyMorphPlan(pix1, plan);
+        pixDestroy(&pix1);
+        if (!pix2) {
+            pixaDestroy(&pixad);
+            return (PIXA *)ERROR_PTR("pix2 not made", __func__, NULL);
+        }
+        pixaAddPix(pixad, pix2, L_INSERT);
+    }
+    boxa = pixaGetBoxa(pixas, L_COPY);
+    pixaSetBoxa(pixad, boxa, L_INSERT);
+    return pixad;
+}
+
+
+/*!
+ * \brief   morphPlanBrick()
+ *
+ * \param[in]    pixd      [optional] can be null, equal to pixs, or different
+ * \param[in]    pixs      1 bpp
+ * \param[in]    op        OpDilate, OpErode, OpOpen, OpClose, OpCloseSafe
+ * \param[in]    w, h      brick dimensions
+ * \param[in]    method    L_MORPH_SEQ_ROP, etc.
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) OpClose is only made for L_MORPH_SEQ_ROP.
+ * </pre>
+ */
+static PIX *
+morphPlanBrick(PIX     *pixd,
+               PIX     *pixs,
+               l_int32  op,
+               l_int32  w,
+               l_int32  h,
+               l_int32  method)
+{
+    if (method == L_MORPH_SEQ_ROP) {
+        switch (op)
+        {
+        case OpDilate:
+            return pixDilateBrick(pixd, pixs, w, h);
+        case OpErode:
+            return pixErodeBrick(pixd, pixs, w, h);
+        case OpOpen:
+            return pixOpenBrick(pixd, pixs, w, h);
+        case OpClose:
+            return pixCloseBrick(pixd, pixs, w, h);
+        case OpCloseSafe:
+            return pixCloseSafeBrick(pixd, pixs, w, h);
+        }
+    } else if (method == L_MORPH_SEQ_COMP_ROP) {
+        switch (op)
+        {
+        case OpDilate:
+            return pixDilateCompBrick(pixd, pixs, w, h);
+        case OpErode:
+            return pixErodeCompBrick(pixd, pixs, w, h);
+        case OpOpen:
+            return pixOpenCompBrick(pixd, pixs, w, h);
+        case OpCloseSafe:
+            return pixCloseSafeCompBrick(pixd, pixs, w, h);
+        }
+    } else if (method == L_MORPH_SEQ_DWA) {
+        switch (op)
+        {
+        case OpDilate:
+            return pixDilateBrickDwa(pixd, pixs, w, h);
+        case OpErode:
+            return pixErodeBrickDwa(pixd, pixs, w, h);
+        case OpOpen:
+            return pixOpenBrickDwa(pixd, pixs, w, h);
+        case OpCloseSafe:
+            return pixCloseBrickDwa(pixd, pixs, w, h);
+        }
+    } else {  /* L_MORPH_SEQ_COMP_DWA */
+        switch (op)
+        {
+        case OpDilate:
+            return pixDilateCompBrickDwa(pixd, pixs, w, h);
+        case OpErode:
+            return pixErodeCompBrickDwa(pixd, pixs, w, h);
+        case OpOpen:
+            return pixOpenCompBrickDwa(pixd, pixs, w, h);
+        case OpCloseSafe:
+            return pixCloseCompBrickDwa(pixd, pixs, w, h);
+        }
+    }
+    return (PIX *)ERROR_PTR("invalid op", __func__, NULL);
+}
+
+
 /*-----------------------------------------------------------------*
  *       Run a sequence of grayscale morphological operations      *
  *-----------------------------------------------------------------*/
@@ -1075,7 +1513,9 @@ SARRAY  *sa;
  * <pre>
  * Notes:
  *      (1) This works on 32 bpp rgb images.
- *      (2) Each component is processed separately.
+ *      (2) Each component is processed separately.  The operations
+ *          work directly on the packed rgb pixels, so the image is
+ *          never split into components between steps.
  *      (3) This runs a pipeline of operations; no branching is allowed.
  *      (4) This only uses brick SELs.
  *      (5) A new image is always produced; the input image is not changed.
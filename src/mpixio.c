@@ -0,0 +1,876 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file mpixio.c
+ * <pre>
+ *
+ *    Page-aligned uncompressed container for pix, pixa and fpix,
+ *    designed to be opened with mmap() and read without copying.
+ *
+ *      Writing mpix containers
+ *           l_int32     pixWriteMpix()
+ *           l_int32     pixaWriteMpix()
+ *           l_int32     fpixWriteMpix()
+ *           static l_int32  mpixWriteStream()
+ *
+ *      Opening and closing mpix containers
+ *           L_MPIX     *mpixOpen()
+ *           void        mpixClose()
+ *
+ *      Mpix accessors
+ *           l_int32     mpixGetCount()
+ *           l_int32     mpixGetType()
+ *           l_int32     mpixGetImageInfo()
+ *           const l_uint32  *mpixGetRaster()
+ *           const char      *mpixGetText()
+ *           BOX        *mpixGetBox()
+ *
+ *      Extracting images
+ *           PIX        *mpixGetPix()
+ *           PIXA       *mpixGetPixa()
+ *           FPIX       *mpixGetFPix()
+ *
+ *    The spix format (spixio.c) and pixacomp serialization both copy the
+ *    raster data through a header into a new buffer.  An mpix container
+ *    instead puts every raster at a page-aligned offset in the file,
+ *    in the native in-memory layout of the pix or fpix, so that after
+ *    the file is mapped, mpixGetRaster() returns a read-only pointer to
+ *    the pixels with no copying at all.  When a pix is required,
+ *    mpixGetPix() makes it with a single memcpy of the raster.
+ *
+ *    The file layout, in units of l_uint32 words, is:
+ *      Header (MPIX_HEADER_WORDS):
+ *          [0,1]  "lmpx" and "raw\0" -- ID for file type
+ *          [2]    version number (MPIX_VERSION_NUMBER)
+ *          [3]    0x01020304, written in native byte order
+ *          [4]    container type: L_MPIX_PIX, L_MPIX_PIXA or L_MPIX_FPIX
+ *          [5]    number of images
+ *          [6]    alignment of raster data in bytes (MPIX_ALIGNMENT)
+ *      Directory (MPIX_DIR_WORDS for each image):
+ *          [0]    1 for pix; 2 for fpix
+ *          [1-5]  w, h, d, spp, wpl
+ *          [6-8]  xres, yres, input format
+ *          [9]    1 if a box follows; 0 otherwise
+ *          [10-13] box x, y, w, h
+ *          [14]   number of colors in the colormap; 0 if none
+ *          [15]   number of bytes of text, including the trailing null
+ *          [16,17] byte offset of colormap (low, high words)
+ *          [18,19] byte offset of text (low, high words)
+ *          [20,21] byte offset of raster data (low, high words)
+ *          [22-31] reserved
+ *      Colormaps (4 bytes/color) and text strings
+ *      Raster data for each image, starting on a multiple of MPIX_ALIGNMENT
+ *
+ *    Notes:
+ *      (1) Because the raster data is in native layout, a container
+ *          must be read on a machine with the same byte order as the
+ *          one on which it was written.  This is verified on opening.
+ *      (2) On Windows, or wherever mmap() is not available, mpixOpen()
+ *          reads the entire file into memory, and the accessors
+ *          behave identically.
+ *      (3) As with spix, this is not intended to be a secure file format
+ *          for data from untrusted sources, but the directory entries
+ *          are checked to be consistent with the size of the file.
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  /* !_WIN32 */
+
+#include <string.h>
+#include "allheaders.h"
+#include "pix_internal.h"
+
+    /* Container layout */
+#define  MPIX_HEADER_WORDS   16
+#define  MPIX_DIR_WORDS      32
+#define  MPIX_ALIGNMENT      4096
+
+    /* Directory entry kinds */
+static const l_uint32  MpixKindPix = 1;
+static const l_uint32  MpixKindFPix = 2;
+
+    /* Image dimension limits */
+static const l_int32  MaxAllowedWidth = 1000000;
+static const l_int32  MaxAllowedHeight = 1000000;
+
+static l_int32 mpixWriteStream(FILE *fp, l_int32 type, PIX **pixs,
+                               FPIX *fpix, BOXA *boxa, l_int32 n);
+static l_uint64 mpixGetOffset(const l_uint32 *entry, l_int32 index);
+static l_int32 mpixVerifyEntry(L_MPIX *mp, l_int32 index);
+
+
+/*-----------------------------------------------------------------------*
+ *                        Writing mpix containers                        *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   pixWriteMpix()
+ *
+ * \param[in]    filename
+ * \param[in]    pix        all depths; colormap OK
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The resolution, input format, text and colormap are saved.
+ * </pre>
+ */
+l_ok
+pixWriteMpix(const char  *filename,
+             PIX         *pix)
+{
+l_int32  ret;
+FILE    *fp;
+
+    if (!filename)
+        return ERROR_INT("filename not defined", __func__, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", __func__, 1);
+
+    if ((fp = fopenWriteStream(filename, "wb+")) == NULL)
+        return ERROR_INT_1("stream not opened", filename, __func__, 1);
+    ret = mpixWriteStream(fp, L_MPIX_PIX, &pix, NULL, NULL, 1);
+    fclose(fp);
+    if (ret)
+        return ERROR_INT_1("mpix not written", filename, __func__, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixaWriteMpix()
+ *
+ * \param[in]    filename
+ * \param[in]    pixa       all depths; colormaps OK
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A box is saved with each pix for which there is a box
+ *          in the pixa boxa.
+ * </pre>
+ */
+l_ok
+pixaWriteMpix(const char  *filename,
+              PIXA        *pixa)
+{
+l_int32  i, n, ret;
+BOXA    *boxa;
+FILE    *fp;
+PIX    **pixs;
+
+    if (!filename)
+        return ERROR_INT("filename not defined", __func__, 1);
+    if (!pixa)
+        return ERROR_INT("pixa not defined", __func__, 1);
+    if ((n = pixaGetCount(pixa)) == 0)
+        return ERROR_INT("pixa is empty", __func__, 1);
+
+    pixs = (PIX **)LEPT_CALLOC(n, sizeof(PIX *));
+    for (i = 0; i < n; i++)
+        pixs[i] = pixaGetPix(pixa, i, L_CLONE);
+    boxa = pixaGetBoxa(pixa, L_CLONE);
+    if ((fp = fopenWriteStream(filename, "wb+")) == NULL) {
+        ret = 1;
+    } else {
+        ret = mpixWriteStream(fp, L_MPIX_PIXA, pixs, NULL, boxa, n);
+        fclose(fp);
+    }
+    for (i = 0; i < n; i++)
+        pixDestroy(&pixs[i]);
+    LEPT_FREE(pixs);
+    boxaDestroy(&boxa);
+    if (ret)
+        return ERROR_INT_1("mpix not written", filename, __func__, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   fpixWriteMpix()
+ *
+ * \param[in]    filename
+ * \param[in]    fpix
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+fpixWriteMpix(const char  *filename,
+              FPIX        *fpix)
+{
+l_int32  ret;
+FILE    *fp;
+
+    if (!filename)
+        return ERROR_INT("filename not defined", __func__, 1);
+    if (!fpix)
+        return ERROR_INT("fpix not defined", __func__, 1);
+
+    if ((fp = fopenWriteStream(filename, "wb+")) == NULL)
+        return ERROR_INT_1("stream not opened", filename, __func__, 1);
+    ret = mpixWriteStream(fp, L_MPIX_FPIX, NULL, fpix, NULL, 1);
+    fclose(fp);
+    if (ret)
+        return ERROR_INT_1("mpix not written", filename, __func__, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   mpixWriteStream()
+ *
+ * \param[in]    fp      file stream opened for write
+ * \param[in]    type    L_MPIX_PIX, L_MPIX_PIXA or L_MPIX_FPIX
+ * \param[in]    pixs    array of %n pix; NULL for L_MPIX_FPIX
+ * \param[in]    fpix    for L_MPIX_FPIX; NULL otherwise
+ * \param[in]    boxa    [optional] boxes for the pix
+ * \param[in]    n       number of images
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See the top of this file for the layout.  The header,
+ *          directory, colormaps and text are assembled in memory and
+ *          written first; then each raster is written at its aligned
+ *          offset, with zero padding between rasters.
+ * </pre>
+ */
+static l_int32
+mpixWriteStream(FILE     *fp,
+                l_int32   type,
+                PIX     **pixs,
+                FPIX     *fpix,
+                BOXA     *boxa,
+                l_int32   n)
+{
+char       *text;
+l_uint8    *cdata, *meta, *pad;
+l_int32     i, w, h, d, ncolors, nbox, textbytes, bx, by, bw, bh;
+l_int32     xres, yres;
+l_uint32   *header, *entry;
+l_uint64    offset, metabytes, rbytes, total, nwritten;
+size_t      headbytes;
+PIX        *pix;
+PIXCMAP    *cmap;
+
+    nbox = (boxa) ? boxaGetCount(boxa) : 0;
+    headbytes = 4 * (MPIX_HEADER_WORDS + (size_t)n * MPIX_DIR_WORDS);
+    header = (l_uint32 *)LEPT_CALLOC(headbytes / 4, sizeof(l_uint32));
+    memcpy(header, "lmpxraw", 8);
+    header[2] = MPIX_VERSION_NUMBER;
+    header[3] = 0x01020304;
+    header[4] = type;
+    header[5] = n;
+    header[6] = MPIX_ALIGNMENT;
+
+        /* Fill the directory; colormaps and text are put in a
+         * metadata block that follows it */
+    metabytes = 0;
+    for (i = 0; i < n; i++) {
+        entry = header + MPIX_HEADER_WORDS + i * MPIX_DIR_WORDS;
+        if (type == L_MPIX_FPIX) {
+            fpixGetDimensions(fpix, &w, &h);
+            fpixGetResolution(fpix, &xres, &yres);
+            entry[0] = MpixKindFPix;
+            entry[1] = w;
+            entry[2] = h;
+            entry[3] = 32;
+            entry[4] = 1;
+            entry[5] = fpixGetWpl(fpix);
+            entry[6] = xres;
+            entry[7] = yres;
+            continue;
+        }
+        pix = pixs[i];
+        pixGetDimensions(pix, &w, &h, &d);
+        entry[0] = MpixKindPix;
+        entry[1] = w;
+        entry[2] = h;
+        entry[3] = d;
+        entry[4] = pixGetSpp(pix);
+        entry[5] = pixGetWpl(pix);
+        entry[6] = pixGetXRes(pix);
+        entry[7] = pixGetYRes(pix);
+        entry[8] = pixGetInputFormat(pix);
+        if (i < nbox) {
+            boxaGetBoxGeometry(boxa, i, &bx, &by, &bw, &bh);
+            entry[9] = 1;
+            entry[10] = bx;
+            entry[11] = by;
+            entry[12] = bw;
+            entry[13] = bh;
+        }
+        if ((cmap = pixGetColormap(pix)) != NULL) {
+            entry[14] = pixcmapGetCount(cmap);
+            offset = headbytes + metabytes;
+            entry[16] = (l_uint32)(offset & 0xffffffff);
+            entry[17] = (l_uint32)(offset >> 32);
+            metabytes += 4 * entry[14];
+        }
+        if ((text = pixGetText(pix)) != NULL) {
+            entry[15] = strlen(text) + 1;
+            offset = headbytes + metabytes;
+            entry[18] = (l_uint32)(offset & 0xffffffff);
+            entry[19] = (l_uint32)(offset >> 32);
+            metabytes += entry[15];
+        }
+    }
+
+        /* Assign the aligned raster offsets */
+    offset = headbytes + metabytes;
+    for (i = 0; i < n; i++) {
+        entry = header + MPIX_HEADER_WORDS + i * MPIX_DIR_WORDS;
+        offset = MPIX_ALIGNMENT * ((offset + MPIX_ALIGNMENT - 1) /
+                                   MPIX_ALIGNMENT);
+        entry[20] = (l_uint32)(offset & 0xffffffff);
+        entry[21] = (l_uint32)(offset >> 32);
+        offset += 4 * (l_uint64)entry[5] * entry[2];
+    }
+    total = offset;
+
+        /* Write the header, directory and metadata */
+    nwritten = fwrite(header, 1, headbytes, fp);
+    meta = (metabytes > 0) ? (l_uint8 *)LEPT_CALLOC(metabytes, 1) : NULL;
+    for (i = 0; i < n && type != L_MPIX_FPIX; i++) {
+        entry = header + MPIX_HEADER_WORDS + i * MPIX_DIR_WORDS;
+        if ((ncolors = entry[14]) > 0) {
+            pixcmapSerializeToMemory(pixGetColormap(pixs[i]), 4, &ncolors,
+                                     &cdata);
+            memcpy(meta + mpixGetOffset(entry, 16) - headbytes, cdata,
+                   4 * ncolors);
+            LEPT_FREE(cdata);
+        }
+        if ((textbytes = entry[15]) > 0) {
+            memcpy(meta + mpixGetOffset(entry, 18) - headbytes,
+                   pixGetText(pixs[i]), textbytes);
+        }
+    }
+    if (meta) {
+        nwritten += fwrite(meta, 1, metabytes, fp);
+        LEPT_FREE(meta);
+    }
+
+        /* Write the rasters, padding each to its aligned offset */
+    pad = (l_uint8 *)LEPT_CALLOC(MPIX_ALIGNMENT, 1);
+    for (i = 0; i < n; i++) {
+        entry = header + MPIX_HEADER_WORDS + i * MPIX_DIR_WORDS;
+        offset = mpixGetOffset(entry, 20);
+        if (nwritten > offset || offset - nwritten >= MPIX_ALIGNMENT)
+            break;  /* a previous write failed */
+        nwritten += fwrite(pad, 1, offset - nwritten, fp);
+        rbytes = 4 * (l_uint64)entry[5] * entry[2];
+        if (type == L_MPIX_FPIX) {
+            nwritten += fwrite(fpixGetData(fpix), 1, rbytes, fp);
+        } else {
+            nwritten += fwrite(pixGetData(pixs[i]), 1, rbytes, fp);
+        }
+    }
+    LEPT_FREE(pad);
+    LEPT_FREE(header);
+    if (nwritten != total)
+        return ERROR_INT("write error", __func__, 1);
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                  Opening and closing mpix containers                  *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   mpixOpen()
+ *
+ * \param[in]    filename
+ * \return  mpix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The file is mapped read-only, and stays mapped until
+ *          mpixClose() is called.  Pointers returned by mpixGetRaster()
+ *          and mpixGetText() are only valid until then.
+ *      (2) Every directory entry is validated against the file size.
+ * </pre>
+ */
+L_MPIX *
+mpixOpen(const char  *filename)
+{
+l_uint8  *data;
+l_int32   i, n, mapped;
+size_t    size;
+L_MPIX   *mp;
+
+    if (!filename)
+        return (L_MPIX *)ERROR_PTR("filename not defined", __func__, NULL);
+
+    data = NULL;
+    size = 0;
+    mapped = 0;
+#ifndef _WIN32
+    {
+    char        *fname;
+    int          fd;
+    struct stat  st;
+    void        *addr;
+
+    fname = genPathname(filename, NULL);
+    fd = open(fname, O_RDONLY);
+    LEPT_FREE(fname);
+    if (fd >= 0) {
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = st.st_size;
+            addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED) {
+                data = (l_uint8 *)addr;
+                mapped = 1;
+            }
+        }
+        close(fd);
+    }
+    }
+#endif  /* !_WIN32 */
+    if (!data) {  /* not mapped; read the file */
+        if ((data = l_binaryRead(filename, &size)) == NULL)
+            return (L_MPIX *)ERROR_PTR_1("data not read", filename,
+                                         __func__, NULL);
+    }
+
+    mp = (L_MPIX *)LEPT_CALLOC(1, sizeof(L_MPIX));
+    mp->data = data;
+    mp->size = size;
+    mp->mapped = mapped;
+    if (size < 4 * MPIX_HEADER_WORDS || memcmp(data, "lmpxraw", 8) != 0) {
+        mpixClose(&mp);
+        return (L_MPIX *)ERROR_PTR_1("not an mpix file", filename,
+                                     __func__, NULL);
+    }
+    mp->dir = (l_uint32 *)data + MPIX_HEADER_WORDS;
+    if (((l_uint32 *)data)[2] != MPIX_VERSION_NUMBER) {
+        mpixClose(&mp);
+        return (L_MPIX *)ERROR_PTR("invalid mpix version", __func__, NULL);
+    }
+    if (((l_uint32 *)data)[3] != 0x01020304) {
+        mpixClose(&mp);
+        return (L_MPIX *)ERROR_PTR("mpix written with other byte order",
+                                   __func__, NULL);
+    }
+    mp->type = ((l_uint32 *)data)[4];
+    n = ((l_uint32 *)data)[5];
+    if (n < 1 ||
+        4 * (MPIX_HEADER_WORDS + (l_uint64)n * MPIX_DIR_WORDS) > size) {
+        mpixClose(&mp);
+        return (L_MPIX *)ERROR_PTR("invalid number of images", __func__, NULL);
+    }
+    mp->n = n;
+    for (i = 0; i < n; i++) {
+        if (mpixVerifyEntry(mp, i)) {
+            mpixClose(&mp);
+            return (L_MPIX *)ERROR_PTR("invalid directory entry",
+                                       __func__, NULL);
+        }
+    }
+    return mp;
+}
+
+
+/*!
+ * \brief   mpixClose()
+ *
+ * \param[in,out]   pmp   will be set to null before returning
+ * \return  void
+ */
+void
+mpixClose(L_MPIX  **pmp)
+{
+L_MPIX  *mp;
+
+    if (pmp == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((mp = *pmp) == NULL)
+        return;
+
+#ifndef _WIN32
+    if (mp->mapped)
+        munmap(mp->data, mp->size);
+    else
+        LEPT_FREE(mp->data);
+#else
+    LEPT_FREE(mp->data);
+#endif  /* !_WIN32 */
+    LEPT_FREE(mp);
+    *pmp = NULL;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                            Mpix accessors                             *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   mpixGetCount()
+ *
+ * \param[in]    mp
+ * \return  number of images, or 0 on error
+ */
+l_int32
+mpixGetCount(L_MPIX  *mp)
+{
+    if (!mp)
+        return ERROR_INT("mp not defined", __func__, 0);
+    return mp->n;
+}
+
+
+/*!
+ * \brief   mpixGetType()
+ *
+ * \param[in]    mp
+ * \return  L_MPIX_PIX, L_MPIX_PIXA or L_MPIX_FPIX; 0 on error
+ */
+l_int32
+mpixGetType(L_MPIX  *mp)
+{
+    if (!mp)
+        return ERROR_INT("mp not defined", __func__, 0);
+    return mp->type;
+}
+
+
+/*!
+ * \brief   mpixGetImageInfo()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \param[out]   pw, ph, pd [optional] each can be null
+ * \param[out]   pwpl       [optional] 32-bit words/line
+ * \param[out]   piscmap    [optional] 1 if cmap exists; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+mpixGetImageInfo(L_MPIX   *mp,
+                 l_int32   index,
+                 l_int32  *pw,
+                 l_int32  *ph,
+                 l_int32  *pd,
+                 l_int32  *pwpl,
+                 l_int32  *piscmap)
+{
+l_uint32  *entry;
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pd) *pd = 0;
+    if (pwpl) *pwpl = 0;
+    if (piscmap) *piscmap = 0;
+    if (!mp)
+        return ERROR_INT("mp not defined", __func__, 1);
+    if (index < 0 || index >= mp->n)
+        return ERROR_INT("invalid index", __func__, 1);
+
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (pw) *pw = entry[1];
+    if (ph) *ph = entry[2];
+    if (pd) *pd = entry[3];
+    if (pwpl) *pwpl = entry[5];
+    if (piscmap) *piscmap = (entry[14] > 0) ? 1 : 0;
+    return 0;
+}
+
+
+/*!
+ * \brief   mpixGetRaster()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \param[out]   pwpl       [optional] 32-bit words/line
+ * \return  read-only pointer to the raster data, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a view into the mapped file, with the same layout
+ *          as the data in a pix (or an fpix).  No data is copied.
+ *          Do not write to it or free it, and do not use it after
+ *          calling mpixClose().
+ * </pre>
+ */
+const l_uint32 *
+mpixGetRaster(L_MPIX   *mp,
+              l_int32   index,
+              l_int32  *pwpl)
+{
+l_uint32  *entry;
+
+    if (pwpl) *pwpl = 0;
+    if (!mp)
+        return (l_uint32 *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (index < 0 || index >= mp->n)
+        return (l_uint32 *)ERROR_PTR("invalid index", __func__, NULL);
+
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (pwpl) *pwpl = entry[5];
+    return (const l_uint32 *)(mp->data + mpixGetOffset(entry, 20));
+}
+
+
+/*!
+ * \brief   mpixGetText()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \return  read-only pointer to the text string; NULL if there is none
+ *
+ * <pre>
+ * Notes:
+ *      (1) As with mpixGetRaster(), this points into the mapped file.
+ * </pre>
+ */
+const char *
+mpixGetText(L_MPIX   *mp,
+            l_int32   index)
+{
+l_uint32  *entry;
+
+    if (!mp)
+        return (char *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (index < 0 || index >= mp->n)
+        return (char *)ERROR_PTR("invalid index", __func__, NULL);
+
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (entry[15] == 0)
+        return NULL;
+    return (const char *)(mp->data + mpixGetOffset(entry, 18));
+}
+
+
+/*!
+ * \brief   mpixGetBox()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \return  box, or NULL if there is no box or on error
+ */
+BOX *
+mpixGetBox(L_MPIX   *mp,
+           l_int32   index)
+{
+l_uint32  *entry;
+
+    if (!mp)
+        return (BOX *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (index < 0 || index >= mp->n)
+        return (BOX *)ERROR_PTR("invalid index", __func__, NULL);
+
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (entry[9] == 0)
+        return NULL;
+    return boxCreate(entry[10], entry[11], entry[12], entry[13]);
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                           Extracting images                           *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   mpixGetPix()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The raster data is copied with a single memcpy; the
+ *          colormap, text, resolution and input format are restored.
+ * </pre>
+ */
+PIX *
+mpixGetPix(L_MPIX   *mp,
+           l_int32   index)
+{
+l_uint32  *entry;
+PIX       *pix;
+PIXCMAP   *cmap;
+
+    if (!mp)
+        return (PIX *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (index < 0 || index >= mp->n)
+        return (PIX *)ERROR_PTR("invalid index", __func__, NULL);
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (entry[0] != MpixKindPix)
+        return (PIX *)ERROR_PTR("image is not a pix", __func__, NULL);
+
+    if ((pix = pixCreateNoInit(entry[1], entry[2], entry[3])) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", __func__, NULL);
+    memcpy(pix->data, mp->data + mpixGetOffset(entry, 20),
+           4 * (size_t)entry[5] * entry[2]);
+    pixSetSpp(pix, entry[4]);
+    pixSetResolution(pix, entry[6], entry[7]);
+    pixSetInputFormat(pix, entry[8]);
+    if (entry[14] > 0) {
+        cmap = pixcmapDeserializeFromMemory(mp->data +
+                                            mpixGetOffset(entry, 16),
+                                            4, entry[14]);
+        if (pixSetColormap(pix, cmap)) {
+            pixDestroy(&pix);
+            return (PIX *)ERROR_PTR("invalid colormap", __func__, NULL);
+        }
+    }
+    if (entry[15] > 0)
+        pixSetText(pix, (const char *)(mp->data + mpixGetOffset(entry, 18)));
+    return pix;
+}
+
+
+/*!
+ * \brief   mpixGetPixa()
+ *
+ * \param[in]    mp
+ * \return  pixa, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) All the pix are extracted, along with their boxes.
+ * </pre>
+ */
+PIXA *
+mpixGetPixa(L_MPIX  *mp)
+{
+l_int32  i;
+BOX     *box;
+PIX     *pix;
+PIXA    *pixa;
+
+    if (!mp)
+        return (PIXA *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (mp->type == L_MPIX_FPIX)
+        return (PIXA *)ERROR_PTR("mp holds an fpix", __func__, NULL);
+
+    pixa = pixaCreate(mp->n);
+    for (i = 0; i < mp->n; i++) {
+        if ((pix = mpixGetPix(mp, i)) == NULL) {
+            pixaDestroy(&pixa);
+            return (PIXA *)ERROR_PTR("pix not made", __func__, NULL);
+        }
+        pixaAddPix(pixa, pix, L_INSERT);
+        if ((box = mpixGetBox(mp, i)) != NULL)
+            pixaAddBox(pixa, box, L_INSERT);
+    }
+    return pixa;
+}
+
+
+/*!
+ * \brief   mpixGetFPix()
+ *
+ * \param[in]    mp
+ * \param[in]    index      of image in container
+ * \return  fpix, or NULL on error
+ */
+FPIX *
+mpixGetFPix(L_MPIX   *mp,
+            l_int32   index)
+{
+l_uint32  *entry;
+FPIX      *fpix;
+
+    if (!mp)
+        return (FPIX *)ERROR_PTR("mp not defined", __func__, NULL);
+    if (index < 0 || index >= mp->n)
+        return (FPIX *)ERROR_PTR("invalid index", __func__, NULL);
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    if (entry[0] != MpixKindFPix)
+        return (FPIX *)ERROR_PTR("image is not an fpix", __func__, NULL);
+
+    if ((fpix = fpixCreate(entry[1], entry[2])) == NULL)
+        return (FPIX *)ERROR_PTR("fpix not made", __func__, NULL);
+    memcpy(fpixGetData(fpix), mp->data + mpixGetOffset(entry, 20),
+           4 * (size_t)entry[5] * entry[2]);
+    fpixSetResolution(fpix, entry[6], entry[7]);
+    return fpix;
+}
+
+
+/*-----------------------------------------------------------------------*
+ *                            Static helpers                             *
+ *-----------------------------------------------------------------------*/
+    /* Returns the 64-bit offset stored in two words of a directory entry */
+static l_uint64
+mpixGetOffset(const l_uint32  *entry,
+              l_int32          index)
+{
+    return (l_uint64)entry[index] | ((l_uint64)entry[index + 1] << 32);
+}
+
+
+    /* Returns 1 if the directory entry is not consistent with the file */
+static l_int32
+mpixVerifyEntry(L_MPIX   *mp,
+                l_int32   index)
+{
+l_int32    w, h, d, wpl;
+l_uint32  *entry;
+l_uint64   offset;
+
+    entry = mp->dir + index * MPIX_DIR_WORDS;
+    w = entry[1];
+    h = entry[2];
+    d = entry[3];
+    wpl = entry[5];
+    if (w < 1 || w > MaxAllowedWidth || h < 1 || h > MaxAllowedHeight)
+        return 1;
+    if (entry[0] == MpixKindPix) {
+        if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16 && d != 32)
+            return 1;
+        if (wpl != (w * d + 31) / 32)
+            return 1;
+        if (entry[14] > 256 || (entry[14] > 0 && d > 8))
+            return 1;
+    } else if (entry[0] == MpixKindFPix) {
+        if (d != 32 || wpl != w)
+            return 1;
+    } else {
+        return 1;
+    }
+
+    offset = mpixGetOffset(entry, 20);
+    if (offset % 4 || offset + 4 * (l_uint64)wpl * h > mp->size)
+        return 1;
+    offset = mpixGetOffset(entry, 16);
+    if (offset + 4 * (l_uint64)entry[14] > mp->size)
+        return 1;
+    offset = mpixGetOffset(entry, 18);
+    if (entry[15] > 0 && (offset + entry[15] > mp->size ||
+                          mp->data[offset + entry[15] - 1] != '\0'))
+        return 1;
+    return 0;
+}
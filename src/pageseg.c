@@ -30,6 +30,7 @@
  *
  *      Top level page segmentation
  *          l_int32   pixGetRegionsBinary()
+ *          l_int32   pixPyramidGetRegionsBinary()
  *
  *      Halftone region extraction
  *          PIX      *pixGenHalftoneMask()    **Deprecated wrapper**
@@ -59,6 +60,7 @@
  *
  *      How many text columns
  *          l_int32   pixCountTextColumns()
+ *          l_int32   pixPyramidCountTextColumns()
  *
  *      Decision: text vs photo
  *          l_int32   pixDecideIfText()
@@ -118,6 +120,9 @@ static PIX *pixRescaleForCropping(PIX *pixs, l_int32 w, l_int32 h,
  * Notes:
  *      (1) It is best to deskew the image before segmenting.
  *      (2) Passing in %pixadb enables debug output.
+ *      (3) This makes a temporary pyramid on %pixs.  If other analysis
+ *          is to be done on the same page, make the pyramid once and
+ *          call pixPyramidGetRegionsBinary() instead.
  * </pre>
  */
 l_ok
@@ -127,8 +132,49 @@ pixGetRegionsBinary(PIX   *pixs,
                     PIX  **ppixtb,
                     PIXA  *pixadb)
 {
+l_int32      ret;
+PIXPYRAMID  *pyr;
+
+    if (ppixhm) *ppixhm = NULL;
+    if (ppixtm) *ppixtm = NULL;
+    if (ppixtb) *ppixtb = NULL;
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return ERROR_INT("pixs undefined or not 1 bpp", __func__, 1);
+
+    if ((pyr = pixPyramidCreate(pixs)) == NULL)
+        return ERROR_INT("pyr not made", __func__, 1);
+    ret = pixPyramidGetRegionsBinary(pyr, ppixhm, ppixtm, ppixtb, pixadb);
+    pixPyramidDestroy(&pyr);
+    return ret;
+}
+
+
+/*!
+ * \brief   pixPyramidGetRegionsBinary()
+ *
+ * \param[in]    pyr       pyramid on a 1 bpp image, assumed to be
+ *                         300 to 400 ppi
+ * \param[out]   ppixhm    [optional] halftone mask
+ * \param[out]   ppixtm    [optional] textline mask
+ * \param[out]   ppixtb    [optional] textblock mask
+ * \param[in]    pixadb    input for collecting debug pix; use NULL to skip
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixGetRegionsBinary().  The 2x rank reduction is taken
+ *          from %pyr, so it is shared with other analysis on the page.
+ * </pre>
+ */
+l_ok
+pixPyramidGetRegionsBinary(PIXPYRAMID  *pyr,
+                           PIX        **ppixhm,
+                           PIX        **ppixtm,
+                           PIX        **ppixtb,
+                           PIXA        *pixadb)
+{
 l_int32  w, h, htfound, tlfound;
-PIX     *pixr, *pix1, *pix2;
+PIX     *pixs, *pixr, *pix1, *pix2;
 PIX     *pixtext;  /* text pixels only */
 PIX     *pixhm2;   /* halftone mask; 2x reduction */
 PIX     *pixhm;    /* halftone mask;  */
@@ -142,16 +188,23 @@ PIX     *pixtb;    /* textblock mask */
     if (ppixhm) *ppixhm = NULL;
     if (ppixtm) *ppixtm = NULL;
     if (ppixtb) *ppixtb = NULL;
-    if (!pixs || pixGetDepth(pixs) != 1)
-        return ERROR_INT("pixs undefined or not 1 bpp", __func__, 1);
+    if (!pyr)
+        return ERROR_INT("pyr not defined", __func__, 1);
+    if ((pixs = pixPyramidGetSource(pyr)) == NULL)
+        return ERROR_INT("pixs not defined", __func__, 1);
+    if (pixGetDepth(pixs) != 1) {
+        pixDestroy(&pixs);
+        return ERROR_INT("pixs not 1 bpp", __func__, 1);
+    }
     pixGetDimensions(pixs, &w, &h, NULL);
     if (w < MinWidth || h < MinHeight) {
         L_ERROR("pix too small: w = %d, h = %d\n", __func__, w, h);
+        pixDestroy(&pixs);
         return 1;
     }
 
         /* 2x reduce, to 150 -200 ppi */
-    pixr = pixReduceRankBinaryCascade(pixs, 1, 0, 0, 0);
+    pixr = pixPyramidGetBinary(pyr, 1, 0, 0, 0);
     if (pixadb) pixaAddPix(pixadb, pixr, L_COPY);
 
         /* Get the halftone mask */
@@ -269,6 +322,7 @@ PIX     *pixtb;    /* textblock mask */
     else
         pixDestroy(&pixtb);
 
+    pixDestroy(&pixs);
     return 0;
 }
 
@@ -1774,6 +1828,9 @@ PIXA    *pixa1, *pixa2;
  *      (3) If no text is found (essentially a blank page),
  *          this returns ncols = 0.
  *      (4) For debug output, input a pre-allocated pixa.
+ *      (5) This makes a temporary pyramid on %pixs.  To share the
+ *          reductions with other analysis on the same page, use
+ *          pixPyramidCountTextColumns().
  * </pre>
  */
 l_ok
@@ -1784,23 +1841,76 @@ pixCountTextColumns(PIX       *pixs,
                     l_int32   *pncols,
                     PIXA      *pixadb)
 {
+l_int32      ret;
+PIXPYRAMID  *pyr;
+
+    if (!pncols)
+        return ERROR_INT("&ncols not defined", __func__, 1);
+    *pncols = -1;  /* init */
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return ERROR_INT("pixs not defined or not 1 bpp", __func__, 1);
+
+    if ((pyr = pixPyramidCreate(pixs)) == NULL)
+        return ERROR_INT("pyr not made", __func__, 1);
+    ret = pixPyramidCountTextColumns(pyr, deltafract, peakfract, clipfract,
+                                     pncols, pixadb);
+    pixPyramidDestroy(&pyr);
+    return ret;
+}
+
+
+/*!
+ * \brief   pixPyramidCountTextColumns()
+ *
+ * \param[in]    pyr         pyramid on a 1 bpp image
+ * \param[in]    deltafract  fraction of (max - min) to be used in the delta
+ *                           for extrema finding; typ 0.3
+ * \param[in]    peakfract   fraction of (max - min) to be used to threshold
+ *                            the peak value; typ. 0.5
+ * \param[in]    clipfract   fraction of image dimension removed on each side;
+ *                           typ. 0.1, which leaves w and h reduced by 0.8
+ * \param[out]   pncols      number of columns; -1 if not determined
+ * \param[in]    pixadb      [optional] pre-allocated, for showing
+ *                           intermediate computation; use null to skip
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixCountTextColumns().  The rank reduction to between
+ *          37 and 75 ppi is taken from %pyr.
+ * </pre>
+ */
+l_ok
+pixPyramidCountTextColumns(PIXPYRAMID  *pyr,
+                           l_float32    deltafract,
+                           l_float32    peakfract,
+                           l_float32    clipfract,
+                           l_int32     *pncols,
+                           PIXA        *pixadb)
+{
 l_int32    w, h, res, i, n, npeak;
 l_float32  scalefact, redfact, minval, maxval, val4, val5, fract;
 BOX       *box;
 NUMA      *na1, *na2, *na3, *na4, *na5;
-PIX       *pix1, *pix2, *pix3, *pix4, *pix5;
+PIX       *pixs, *pix1, *pix2, *pix3, *pix4, *pix5;
 
     if (!pncols)
         return ERROR_INT("&ncols not defined", __func__, 1);
     *pncols = -1;  /* init */
-    if (!pixs || pixGetDepth(pixs) != 1)
-        return ERROR_INT("pixs not defined or not 1 bpp", __func__, 1);
+    if (!pyr)
+        return ERROR_INT("pyr not defined", __func__, 1);
     if (deltafract < 0.15 || deltafract > 0.75)
         L_WARNING("deltafract not in [0.15 ... 0.75]\n", __func__);
     if (peakfract < 0.25 || peakfract > 0.9)
         L_WARNING("peakfract not in [0.25 ... 0.9]\n", __func__);
     if (clipfract < 0.0 || clipfract >= 0.5)
         return ERROR_INT("clipfract not in [0.0 ... 0.5)\n", __func__, 1);
+    if ((pixs = pixPyramidGetSource(pyr)) == NULL)
+        return ERROR_INT("pixs not defined", __func__, 1);
+    if (pixGetDepth(pixs) != 1) {
+        pixDestroy(&pixs);
+        return ERROR_INT("pixs not 1 bpp", __func__, 1);
+    }
     if (pixadb) pixaAddPix(pixadb, pixs, L_COPY);
 
         /* Scale to between 37.5 and 75 ppi */
@@ -1818,13 +1928,13 @@ PIX       *pix1, *pix2, *pix3, *pix4, *pix5;
         if (redfact < 2.0)
             pix1 = pixClone(pixs);
         else if (redfact < 4.0)
-            pix1 = pixReduceRankBinaryCascade(pixs, 1, 0, 0, 0);
+            pix1 = pixPyramidGetBinary(pyr, 1, 0, 0, 0);
         else if (redfact < 8.0)
-            pix1 = pixReduceRankBinaryCascade(pixs, 1, 2, 0, 0);
+            pix1 = pixPyramidGetBinary(pyr, 1, 2, 0, 0);
         else if (redfact < 16.0)
-            pix1 = pixReduceRankBinaryCascade(pixs, 1, 2, 2, 0);
+            pix1 = pixPyramidGetBinary(pyr, 1, 2, 2, 0);
         else
-            pix1 = pixReduceRankBinaryCascade(pixs, 1, 2, 2, 2);
+            pix1 = pixPyramidGetBinary(pyr, 1, 2, 2, 2);
     }
     if (pixadb) pixaAddPix(pixadb, pix1, L_COPY);
 
@@ -1884,6 +1994,7 @@ PIX       *pix1, *pix2, *pix3, *pix4, *pix5;
         numaDestroy(&na5);
     }
 
+    pixDestroy(&pixs);
     pixDestroy(&pix1);
     pixDestroy(&pix2);
     pixDestroy(&pix3);
@@ -1971,7 +2082,7 @@ SEL       *sel1;
     selSetElement(sel1, 40, 10, SEL_MISS);
     selSetElement(sel1, 60, 0, SEL_MISS);
     selSetElement(sel1, 60, 10, SEL_MISS);
-    pix3 = pixHMT(NULL, pix1, sel1);
+    pix3 = pixHMTSearch(pix1, sel1, NULL);
     pix4 = pixSeedfillBinaryRestricted(NULL, pix3, pix1, 8, 5, 1000);
     pix5 = pixXor(NULL, pix1, pix4);
     pixDestroy(&pix2);
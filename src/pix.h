@@ -63,6 +63,7 @@
  *         struct Ptaa
  *         struct Pixacc
  *         struct PixTiling
+ *         struct PixPyramid
  *         struct FPix
  *         struct FPixa
  *         struct DPix
@@ -278,6 +279,12 @@ typedef struct Pixacc PIXACC;
 /*! Pix tiling */
 typedef struct PixTiling PIXTILING;
 
+/*-------------------------------------------------------------------------*
+ *                              Pix pyramid                                *
+ *-------------------------------------------------------------------------*/
+/*! Pix pyramid */
+typedef struct PixPyramid PIXPYRAMID;
+
 /*-------------------------------------------------------------------------*
  *                       FPix: pix with float array                        *
  *-------------------------------------------------------------------------*/
@@ -302,6 +309,25 @@ typedef struct PixComp PIXC;
 /*! Array of compressed pix */
 typedef struct PixaComp PIXAC;
 
+/*-------------------------------------------------------------------------*
+ *                  Memory-mapped uncompressed containers                  *
+ *-------------------------------------------------------------------------*/
+/*! Mapped container of uncompressed pix, pixa or fpix */
+typedef struct L_Mpix L_MPIX;
+
+/*! Mpix container types */
+enum {
+    L_MPIX_PIX = 1,        /*!< container holds a single pix             */
+    L_MPIX_PIXA = 2,       /*!< container holds the pix and boxes of pixa */
+    L_MPIX_FPIX = 3        /*!< container holds a single fpix            */
+};
+
+/*-------------------------------------------------------------------------*
+ *                    Precomputed geometric remapping                      *
+ *-------------------------------------------------------------------------*/
+/*! Map from dest pixels to src locations, for repeated warping */
+typedef struct L_Remap L_REMAP;
+
 
 
 /*-------------------------------------------------------------------------*
@@ -937,6 +963,17 @@ enum {
     L_SAMPLED = 2          /*!< nearest src pixel sampling only            */
 };
 
+/*-------------------------------------------------------------------------*
+ *                 Filter kernels for separable resampling                 *
+ *-------------------------------------------------------------------------*/
+/*! Resampling Filter */
+enum {
+    L_RESAMPLE_AREA = 1,     /*!< exact area (box) overlap                 */
+    L_RESAMPLE_TRIANGLE = 2, /*!< tent filter; bilinear for upscaling      */
+    L_RESAMPLE_MITCHELL = 3, /*!< Mitchell-Netravali cubic, B = C = 1/3    */
+    L_RESAMPLE_LANCZOS3 = 4  /*!< windowed sinc with 3 lobes               */
+};
+
 /*-------------------------------------------------------------------------*
  *                             Thinning flags                              *
  *-------------------------------------------------------------------------*/
@@ -1048,6 +1085,7 @@ enum {
  *    Flag(s) used in the 'special' pix field for non-default operations   *
  *      - 0 is default for chroma sampling in jpeg                         *
  *      - 10-19 are used for zlib compression in png write                 *
+ *      - 20-22 are used for speed/size presets in png write               *
  *      - 4 and 8 are used for specifying connectivity in labelling        *
  *-------------------------------------------------------------------------*/
 /*! Flags used in Pix::special */
@@ -1055,6 +1093,13 @@ enum {
     L_NO_CHROMA_SAMPLING_JPEG = 1   /*!< Write full resolution chroma      */
 };
 
+/*! Png write presets; stored in Pix::special with an offset of 20 */
+enum {
+    L_PNG_DEFAULT_PRESET = 0,  /*!< zlib default level; libpng filters    */
+    L_PNG_FAST_PRESET = 1,     /*!< fastest level; one cheap row filter   */
+    L_PNG_SMALL_PRESET = 2     /*!< best level; all row filters tried     */
+};
+
 /*-------------------------------------------------------------------------*
  *          Handling negative values in conversion to unsigned int         *
  *-------------------------------------------------------------------------*/
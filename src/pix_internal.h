@@ -62,11 +62,14 @@
  *       struct Ptaa
  *       struct Pixacc
  *       struct PixTiling
+ *       struct PixPyramid
  *       struct FPix
  *       struct FPixa
  *       struct DPix
  *       struct PixComp
  *       struct PixaComp
+ *       struct L_Mpix
+ *       struct L_Remap
  *
  *  This file can be #included after allheaders.h in source files that
  *  require direct access to the internal data fields in these structs.
@@ -337,6 +340,19 @@ struct PixTiling
 };
 
 
+/*-------------------------------------------------------------------------*
+ *                              Pix pyramid                                *
+ *-------------------------------------------------------------------------*/
+/*! Pix pyramid */
+struct PixPyramid
+{
+    struct Pix          *pix;       /*!< input pix (a clone)               */
+    struct Pixa         *pixab;     /*!< binary rank reductions            */
+    struct Numa         *nakey;     /*!< rank levels for each one in pixab */
+    struct Pixa         *pixaa;     /*!< area reductions by 2, 4, 8, ...   */
+};
+
+
 /*-------------------------------------------------------------------------*
  *                       FPix: pix with float array                        *
  *-------------------------------------------------------------------------*/
@@ -423,4 +439,40 @@ struct PixaComp
     struct Boxa         *boxa;      /*!< array of boxes                    */
 };
 
+
+/*-------------------------------------------------------------------------*
+ *             Mpix: memory-mapped container of uncompressed images        *
+ *-------------------------------------------------------------------------*/
+#define  MPIX_VERSION_NUMBER 1  /*!< Version for mpix container files    */
+
+/*! Memory-mapped container of uncompressed images */
+struct L_Mpix
+{
+    l_int32              type;      /*!< L_MPIX_PIX, L_MPIX_PIXA, ...      */
+    l_int32              n;         /*!< number of images                  */
+    l_int32              mapped;    /*!< 1 if mapped; 0 if read to memory  */
+    size_t               size;      /*!< number of bytes in the file       */
+    l_uint8             *data;      /*!< start of the file data            */
+    l_uint32            *dir;       /*!< directory of image entries        */
+};
+
+
+/*-------------------------------------------------------------------------*
+ *                    Precomputed geometric remapping                      *
+ *-------------------------------------------------------------------------*/
+/*! Map from each dest pixel to its location in the src */
+struct L_Remap
+{
+    l_int32              w;         /*!< width of dest                     */
+    l_int32              h;         /*!< height of dest                    */
+    l_int32              ws;        /*!< width of src                      */
+    l_int32              hs;        /*!< height of src                     */
+    struct FPix         *fpixx;     /*!< src x location for each dest pixel */
+    struct FPix         *fpixy;     /*!< src y location for each dest pixel */
+    l_int32             *xloc;      /*!< src x in units of 1/16 pixel;     */
+                                    /*!< -1 if outside the src             */
+    l_int32             *yloc;      /*!< src y in units of 1/16 pixel;     */
+                                    /*!< -1 if outside the src             */
+};
+
 #endif  /* LEPTONICA_PIX_INTERNAL_H */
@@ -0,0 +1,319 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+
+/*!
+ * \file  pixpyramid.c
+ * <pre>
+ *
+ *        PIXPYRAMID      *pixPyramidCreate()
+ *        void             pixPyramidDestroy()
+ *        PIX             *pixPyramidGetSource()
+ *        PIX             *pixPyramidGetBinary()
+ *        PIX             *pixPyramidGetArea()
+ *        static l_int32   pixPyramidFindBinary()
+ *
+ *   Many page analysis functions start by reducing a full resolution
+ *   image by 2x, 4x or 8x.  When several of them are run on the same
+ *   page, the same reductions are made over and over.  A PixPyramid
+ *   holds a clone of the page image, and makes each reduction the
+ *   first time it is requested, saving it for later requests.
+ *
+ *   Two kinds of reduction are provided:
+ *    ~ Binary rank reductions, with the same cascade of rank levels
+ *      as in pixReduceRankBinaryCascade().  Each result is saved with
+ *      the sequence of levels that generated it, and a reduction is
+ *      made from the largest saved reduction that is a prefix of
+ *      the requested sequence.  For example, after (1, 1) is made,
+ *      a request for (1, 1, 2) needs only one more 2x reduction,
+ *      and a request for (1) needs none.
+ *    ~ Area mapping reductions, by 2^n, of gray and color images.
+ *      Each level is made by pixScaleAreaMap2() on the previous one.
+ *
+ *   The returned images are clones of those held in the pyramid, and
+ *   must not be altered.  Typical usage on a binary page image:
+ *
+ *     PIXPYRAMID  *pyr = pixPyramidCreate(pixb);
+ *     pixPyramidFindSkew(pyr, &angle, &conf);
+ *     pixPyramidGetRegionsBinary(pyr, &pixhm, &pixtm, &pixtb, NULL);
+ *     pixPyramidCountTextColumns(pyr, 0.3, 0.5, 0.1, &ncols, NULL);
+ *     pixPyramidDestroy(&pyr);
+ *
+ *   where the 2x and 4x rank reductions are made only once.
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include "allheaders.h"
+#include "pix_internal.h"
+
+    /* Maximum number of 2x area reductions */
+static const l_int32  MaxAreaReductions = 8;
+
+static l_int32 pixPyramidFindBinary(PIXPYRAMID *pyr, l_int32 key);
+
+/*!
+ * \brief   pixPyramidCreate()
+ *
+ * \param[in]    pixs    full resolution image; any depth; colormap OK
+ * \return  pyramid, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) We put a clone of pixs in the PixPyramid.  No reductions
+ *          are made until they are requested.
+ * </pre>
+ */
+PIXPYRAMID *
+pixPyramidCreate(PIX  *pixs)
+{
+PIXPYRAMID  *pyr;
+
+    if (!pixs)
+        return (PIXPYRAMID *)ERROR_PTR("pixs not defined", __func__, NULL);
+
+    pyr = (PIXPYRAMID *)LEPT_CALLOC(1, sizeof(PIXPYRAMID));
+    pyr->pix = pixClone(pixs);
+    pyr->pixab = pixaCreate(0);
+    pyr->nakey = numaCreate(0);
+    pyr->pixaa = pixaCreate(0);
+    return pyr;
+}
+
+
+/*!
+ * \brief   pixPyramidDestroy()
+ *
+ * \param[in,out]   ppyr   will be set to null before returning
+ * \return  void
+ */
+void
+pixPyramidDestroy(PIXPYRAMID  **ppyr)
+{
+PIXPYRAMID  *pyr;
+
+    if (ppyr == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+
+    if ((pyr = *ppyr) == NULL)
+        return;
+
+    pixDestroy(&pyr->pix);
+    pixaDestroy(&pyr->pixab);
+    numaDestroy(&pyr->nakey);
+    pixaDestroy(&pyr->pixaa);
+    LEPT_FREE(pyr);
+    *ppyr = NULL;
+}
+
+
+/*!
+ * \brief   pixPyramidGetSource()
+ *
+ * \param[in]    pyr
+ * \return  clone of the full resolution image, or NULL on error
+ */
+PIX *
+pixPyramidGetSource(PIXPYRAMID  *pyr)
+{
+    if (!pyr)
+        return (PIX *)ERROR_PTR("pyr not defined", __func__, NULL);
+    return pixClone(pyr->pix);
+}
+
+
+/*!
+ * \brief   pixPyramidGetBinary()
+ *
+ * \param[in]    pyr      with a 1 bpp image
+ * \param[in]    level1   threshold, in the set {0, 1, 2, 3, 4}
+ * \param[in]    level2   threshold, in the set {0, 1, 2, 3, 4}
+ * \param[in]    level3   threshold, in the set {0, 1, 2, 3, 4}
+ * \param[in]    level4   threshold, in the set {0, 1, 2, 3, 4}
+ * \return  clone of the reduced image, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as
+ *             pixReduceRankBinaryCascade(pixs, level1, ... level4)
+ *          but the reduction is made only if it has not already been
+ *          made, and it is started from the most reduced saved image
+ *          that was made with the same initial sequence of levels.
+ *      (2) Use level = 0 to truncate the cascade.  If %level1 == 0,
+ *          this returns a clone of the full resolution image.
+ *      (3) The returned pix is held by the pyramid.  Do not alter it.
+ * </pre>
+ */
+PIX *
+pixPyramidGetBinary(PIXPYRAMID  *pyr,
+                    l_int32      level1,
+                    l_int32      level2,
+                    l_int32      level3,
+                    l_int32      level4)
+{
+l_int32   i, n, index;
+l_int32   levels[4], keys[4];
+l_uint8  *tab;
+PIX      *pix1, *pix2;
+
+    if (!pyr)
+        return (PIX *)ERROR_PTR("pyr not defined", __func__, NULL);
+    if (pixGetDepth(pyr->pix) != 1)
+        return (PIX *)ERROR_PTR("pyr pix not binary", __func__, NULL);
+    if (level1 > 4 || level2 > 4 || level3 > 4 || level4 > 4)
+        return (PIX *)ERROR_PTR("levels must not exceed 4", __func__, NULL);
+
+        /* Find the number of reductions, up to the first level that
+         * is 0.  The key for the first i + 1 reductions is the
+         * sequence of their levels, written as a decimal number. */
+    levels[0] = level1;
+    levels[1] = level2;
+    levels[2] = level3;
+    levels[3] = level4;
+    for (n = 0; n < 4; n++) {
+        if (levels[n] <= 0) break;
+        keys[n] = (n == 0) ? levels[0] : 10 * keys[n - 1] + levels[n];
+    }
+    if (n == 0)
+        return pixClone(pyr->pix);
+
+        /* Find the most reduced saved image that starts the cascade */
+    index = -1;
+    for (i = n; i > 0; i--) {
+        if ((index = pixPyramidFindBinary(pyr, keys[i - 1])) >= 0)
+            break;
+    }
+    if (i == n)
+        return pixaGetPix(pyr->pixab, index, L_CLONE);
+    if (i == 0)
+        pix1 = pixClone(pyr->pix);
+    else
+        pix1 = pixaGetPix(pyr->pixab, index, L_CLONE);
+
+        /* Make and save the rest of the cascade */
+    if ((tab = makeSubsampleTab2x()) == NULL) {
+        pixDestroy(&pix1);
+        return (PIX *)ERROR_PTR("tab not made", __func__, NULL);
+    }
+    for (; i < n; i++) {
+        pix2 = pixReduceRankBinary2(pix1, levels[i], tab);
+        pixDestroy(&pix1);
+        if (!pix2) {
+            LEPT_FREE(tab);
+            return (PIX *)ERROR_PTR("pix2 not made", __func__, NULL);
+        }
+        pixaAddPix(pyr->pixab, pix2, L_INSERT);
+        numaAddNumber(pyr->nakey, keys[i]);
+        pix1 = pixClone(pix2);
+    }
+    LEPT_FREE(tab);
+    return pix1;
+}
+
+
+/*!
+ * \brief   pixPyramidGetArea()
+ *
+ * \param[in]    pyr     with a 1, 2, 4, 8 or 32 bpp image; colormap OK
+ * \param[in]    nred    number of 2x reductions; 0 ... 8
+ * \return  clone of the image reduced by 2^nred, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each reduction is made by pixScaleAreaMap2() on the previous
+ *          one, so a colormap is removed at the first reduction.
+ *          For 1 bpp, the first reduction is made by pixScaleToGray2().
+ *      (2) If %nred == 0, this returns a clone of the full resolution
+ *          image.
+ *      (3) The returned pix is held by the pyramid.  Do not alter it.
+ * </pre>
+ */
+PIX *
+pixPyramidGetArea(PIXPYRAMID  *pyr,
+                  l_int32      nred)
+{
+l_int32  i, n, d;
+PIX     *pix1, *pix2;
+
+    if (!pyr)
+        return (PIX *)ERROR_PTR("pyr not defined", __func__, NULL);
+    if (nred < 0 || nred > MaxAreaReductions)
+        return (PIX *)ERROR_PTR("nred not in [0 ... 8]", __func__, NULL);
+    d = pixGetDepth(pyr->pix);
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("pyr pix not 1, 2, 4, 8 or 32 bpp",
+                                __func__, NULL);
+
+    if (nred == 0)
+        return pixClone(pyr->pix);
+    n = pixaGetCount(pyr->pixaa);
+    if (nred <= n)
+        return pixaGetPix(pyr->pixaa, nred - 1, L_CLONE);
+
+        /* Make and save the remaining reductions */
+    pix1 = (n == 0) ? pixClone(pyr->pix)
+                    : pixaGetPix(pyr->pixaa, n - 1, L_CLONE);
+    for (i = n; i < nred; i++) {
+        if (i == 0 && d == 1)
+            pix2 = pixScaleToGray2(pix1);
+        else
+            pix2 = pixScaleAreaMap2(pix1);
+        pixDestroy(&pix1);
+        if (!pix2)
+            return (PIX *)ERROR_PTR("pix2 not made", __func__, NULL);
+        pixaAddPix(pyr->pixaa, pix2, L_INSERT);
+        pix1 = pixClone(pix2);
+    }
+    return pix1;
+}
+
+
+/*!
+ * \brief   pixPyramidFindBinary()
+ *
+ * \param[in]    pyr
+ * \param[in]    key     sequence of rank levels, as a decimal number
+ * \return  index of the saved binary reduction, or -1 if not found
+ */
+static l_int32
+pixPyramidFindBinary(PIXPYRAMID  *pyr,
+                     l_int32      key)
+{
+l_int32  i, n, val;
+
+    n = numaGetCount(pyr->nakey);
+    for (i = 0; i < n; i++) {
+        numaGetIValue(pyr->nakey, i, &val);
+        if (val == key)
+            return i;
+    }
+    return -1;
+}
@@ -46,6 +46,10 @@
  *          l_int32     pixWritePng()  [ special top level ]
  *          l_int32     pixWriteStreamPng()
  *          l_int32     pixSetZlibCompression()
+ *          l_int32     pixSetPngPreset()
+ *          static void pngSetWriteOptions()
+ *          static void pngWriteSwappedRows()
+ *          static void pngWriteRgbRows()
  *
  *    Set flag for special read mode
  *          void        l_pngSetReadStrip16To8()
@@ -62,6 +66,14 @@
  *    Writing png to memory
  *          l_int32     pixWriteMemPng()
  *
+ *    Push decoding of png
+ *          static void pngPushInfoCallback()
+ *          static void pngPushConvertRow()
+ *          static void pngPushRowCallback()
+ *          static void pngPushEndCallback()
+ *          l_int32     pngPushDecode()
+ *          void        pngPushCleanup()
+ *
  *    Documentation: libpng.txt and example.c
  *
  *    On input (decompression from file), palette color images
@@ -96,6 +108,13 @@
  *    Note that if you are using the defined constants in zlib instead
  *    of the compression integers given above, you must include zlib.h.
  *
+ *    For throughput-limited writing, use pixSetPngPreset() instead.
+ *    The fast preset uses zlib level 1 with a single cheap row filter
+ *    (or run-length matching for packed images such as binary masks),
+ *    and the small preset uses level 9 and, for images of at least
+ *    8 bits/sample, tries all five row filters on every row, keeping
+ *    the one with the smallest sum of residuals.
+ *
  *    There is global for determining the size of retained samples:
  *             var_PNG_STRIP_16_to_8
  *    and a function l_pngSetReadStrip16To8() for setting it.
@@ -135,6 +154,9 @@
 #include "zlib.h"
 #else
 #define  Z_DEFAULT_COMPRESSION (-1)
+#define  Z_BEST_SPEED          1
+#define  Z_BEST_COMPRESSION    9
+#define  Z_RLE                 3
 #endif  /* HAVE_LIBZ */
 
 /* ------------------ Set default for read option -------------------- */
@@ -147,6 +169,16 @@ static l_int32   var_PNG_STRIP_16_TO_8 = 1;
 #define  DEBUG_WRITE    0
 #endif  /* ~NO_CONSOLE_IO */
 
+    /* Size of the zlib output buffer used with the png write presets */
+static const size_t  PngPresetBufferSize = 65536;
+
+static void pngSetWriteOptions(png_structp png_ptr, PIX *pix,
+                               l_int32 bit_depth, l_int32 cmflag);
+static void pngWriteSwappedRows(png_structp png_ptr, PIX *pix,
+                                l_uint32 *linebuf, l_int32 invert);
+static void pngWriteRgbRows(png_structp png_ptr, PIX *pix,
+                            png_bytep rowbuffer);
+
 
 /*---------------------------------------------------------------------*
  *                     Reading png through stream                      *
@@ -1054,7 +1086,7 @@ pixWriteStreamPng(FILE      *fp,
                   l_float32  gamma)
 {
 char         commentstring[] = "Comment";
-l_int32      i, j, k, wpl, d, spp, compval, valid;
+l_int32      i, wpl, d, spp, valid;
 l_int32      cmflag, opaque, max_trans, ncolors;
 l_int32     *rmap, *gmap, *bmap, *amap;
 l_uint32    *data, *ppixel;
@@ -1062,12 +1094,10 @@ png_byte     bit_depth, color_type;
 png_byte     alpha[256];
 png_uint_32  w, h;
 png_uint_32  xres, yres;
-png_bytep   *row_pointers;
 png_bytep    rowbuffer;
 png_structp  png_ptr;
 png_infop    info_ptr;
 png_colorp   palette;
-PIX         *pix1;
 PIXCMAP     *cmap;
 char        *text;
 
@@ -1125,26 +1155,17 @@ char        *text;
     }
 
         /* Set up png setjmp error handling */
-    pix1 = NULL;
-    row_pointers = NULL;
+    rowbuffer = NULL;
     if (setjmp(png_jmpbuf(png_ptr))) {
         png_destroy_write_struct(&png_ptr, &info_ptr);
-        LEPT_FREE(row_pointers);
-        pixDestroy(&pix1);
+        LEPT_FREE(rowbuffer);
         return ERROR_INT("internal png error", __func__, 1);
     }
 
     png_init_io(png_ptr, fp);
 
-        /* With best zlib compression (9), get between 1 and 10% improvement
-         * over default (6), but the compression is 3 to 10 times slower.
-         * Use the zlib default (6) as our default compression unless
-         * pix->special falls in the range [10 ... 19]; then subtract 10
-         * to get the compression value.  */
-    compval = Z_DEFAULT_COMPRESSION;
-    if (pix->special >= 10 && pix->special < 20)
-        compval = pix->special - 10;
-    png_set_compression_level(png_ptr, compval);
+        /* Set the zlib level, row filters and strategy */
+    pngSetWriteOptions(png_ptr, pix, bit_depth, cmflag);
 
     png_set_IHDR(png_ptr, info_ptr, w, h, bit_depth, color_type,
                  PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
@@ -1213,36 +1234,18 @@ char        *text;
     png_write_info(png_ptr, info_ptr);
 
     if ((d != 32) && (d != 24)) {  /* not rgb color */
-            /* Generate a temporary pix with bytes swapped.
+            /* Byte swap each row into a line buffer as it is written,
+             * rather than making a byte-swapped copy of the image.
              * For writing a 1 bpp image as png:
              *    ~ if no colormap, invert the data, because png writes
              *      black as 0
              *    ~ if colormapped, do not invert the data; the two RGBA
              *      colors can have any value.  */
-        if (d == 1 && !cmap) {
-            pix1 = pixInvert(NULL, pix);
-            pixEndianByteSwap(pix1);
-        } else {
-            pix1 = pixEndianByteSwapNew(pix);
-        }
-        if (!pix1) {
-            png_destroy_write_struct(&png_ptr, &info_ptr);
-            return ERROR_INT("pix1 not made", __func__, 1);
-        }
-
-            /* Make and assign array of image row pointers */
-        row_pointers = (png_bytep *)LEPT_CALLOC(h, sizeof(png_bytep));
-        wpl = pixGetWpl(pix1);
-        data = pixGetData(pix1);
-        for (i = 0; i < h; i++)
-            row_pointers[i] = (png_bytep)(data + i * wpl);
-        png_set_rows(png_ptr, info_ptr, row_pointers);
-
-            /* Transfer the data */
-        png_write_image(png_ptr, row_pointers);
+        rowbuffer = (png_bytep)LEPT_CALLOC(pixGetWpl(pix), 4);
+        pngWriteSwappedRows(png_ptr, pix, (l_uint32 *)rowbuffer,
+                            (d == 1 && !cmap));
         png_write_end(png_ptr, info_ptr);
-        LEPT_FREE(row_pointers);
-        pixDestroy(&pix1);
+        LEPT_FREE(rowbuffer);
         png_destroy_write_struct(&png_ptr, &info_ptr);
         return 0;
     }
@@ -1257,19 +1260,7 @@ char        *text;
         }
     } else {  /* 32 bpp rgb and rgba.  If spp = 4, write the alpha channel */
         rowbuffer = (png_bytep)LEPT_CALLOC(w, 4);
-        for (i = 0; i < h; i++) {
-            ppixel = data + i * wpl;
-            for (j = k = 0; j < w; j++) {
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_RED);
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_GREEN);
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_BLUE);
-                if (spp == 4)
-                    rowbuffer[k++] = GET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL);
-                ppixel++;
-            }
-
-            png_write_rows(png_ptr, &rowbuffer, 1);
-        }
+        pngWriteRgbRows(png_ptr, pix, rowbuffer);
         LEPT_FREE(rowbuffer);
     }
 
@@ -1315,6 +1306,197 @@ pixSetZlibCompression(PIX     *pix,
 }
 
 
+/*!
+ * \brief   pixSetPngPreset()
+ *
+ * \param[in]    pix
+ * \param[in]    preset   L_PNG_DEFAULT_PRESET, L_PNG_FAST_PRESET,
+ *                         L_PNG_SMALL_PRESET
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This chooses the zlib level, the row filters and the zlib
+ *          strategy together, trading file size for encoding speed:
+ *            L_PNG_FAST_PRESET:  level 1.  For 8, 16 and 32 bpp images
+ *                                without a colormap, each row uses the
+ *                                'sub' filter.  For packed (1, 2 and
+ *                                4 bpp) and colormapped images, rows
+ *                                are not filtered and zlib uses only
+ *                                run-length matching, which is very
+ *                                fast on binary masks.
+ *            L_PNG_SMALL_PRESET: level 9.  For 8, 16 and 32 bpp images
+ *                                without a colormap, all five filters
+ *                                are tried on each row, and the one
+ *                                with the smallest sum of absolute
+ *                                residuals is used.  Packed and
+ *                                colormapped rows are not filtered.
+ *            L_PNG_DEFAULT_PRESET: same as pixSetZlibCompression() with
+ *                                the zlib default level; libpng chooses
+ *                                the filters.
+ *      (2) Like pixSetZlibCompression(), the preset is stored in the
+ *          'special' field of the pix, so the two are exclusive; the
+ *          last one called is used.
+ *      (3) The png output is standard in all cases; any decoder can read
+ *          it and it decodes to the same image.
+ * </pre>
+ */
+l_ok
+pixSetPngPreset(PIX     *pix,
+                l_int32  preset)
+{
+    if (!pix)
+        return ERROR_INT("pix not defined", __func__, 1);
+    if (preset != L_PNG_DEFAULT_PRESET && preset != L_PNG_FAST_PRESET &&
+        preset != L_PNG_SMALL_PRESET)
+        return ERROR_INT("invalid preset", __func__, 1);
+    pixSetSpecial(pix, 20 + preset);  /* valid range [20 ... 22] */
+    return 0;
+}
+
+
+/*!
+ * \brief   pngSetWriteOptions()
+ *
+ * \param[in]    png_ptr
+ * \param[in]    pix
+ * \param[in]    bit_depth   png bit depth of each sample
+ * \param[in]    cmflag      1 if writing a palette
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) With best zlib compression (9), get between 1 and 10%
+ *          improvement over default (6), but the compression is 3 to 10
+ *          times slower.  Use the zlib default (6) as our default
+ *          compression unless pix->special falls in the range [10 ... 19];
+ *          then subtract 10 to get the compression value.
+ *      (2) If pix->special is in [20 ... 22], use a preset; see
+ *          pixSetPngPreset().  The larger zlib output buffer used with
+ *          the presets reduces the number of IDAT chunks and write calls.
+ * </pre>
+ */
+static void
+pngSetWriteOptions(png_structp  png_ptr,
+                   PIX         *pix,
+                   l_int32      bit_depth,
+                   l_int32      cmflag)
+{
+l_int32  special, packed;
+
+    special = pix->special;
+    packed = (cmflag || bit_depth < 8);
+    if (special >= 10 && special < 20) {
+        png_set_compression_level(png_ptr, special - 10);
+    } else if (special == 20 + L_PNG_FAST_PRESET) {
+        png_set_compression_level(png_ptr, Z_BEST_SPEED);
+        png_set_compression_buffer_size(png_ptr, PngPresetBufferSize);
+        if (packed) {
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+            png_set_compression_strategy(png_ptr, Z_RLE);
+        } else {
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+        }
+    } else if (special == 20 + L_PNG_SMALL_PRESET) {
+        png_set_compression_level(png_ptr, Z_BEST_COMPRESSION);
+        png_set_compression_buffer_size(png_ptr, PngPresetBufferSize);
+        if (packed)  /* filtering across packed pixels does not pay */
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+        else
+            png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_ALL_FILTERS);
+    } else {
+        png_set_compression_level(png_ptr, Z_DEFAULT_COMPRESSION);
+    }
+}
+
+
+/*!
+ * \brief   pngWriteSwappedRows()
+ *
+ * \param[in]    png_ptr
+ * \param[in]    pix        1, 2, 4, 8 or 16 bpp
+ * \param[in]    linebuf    buffer of at least wpl words
+ * \param[in]    invert     1 to invert the data
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) png requires the bytes in MSB to LSB order.  On little-endian
+ *          machines, the bytes in each word of a raster line are swapped
+ *          into %linebuf before the line is written.  This avoids making
+ *          a byte-swapped (and possibly inverted) copy of the image.
+ *      (2) The pad bits at the end of each line are written as 0,
+ *          whether or not the data is inverted.
+ * </pre>
+ */
+static void
+pngWriteSwappedRows(png_structp  png_ptr,
+                    PIX         *pix,
+                    l_uint32    *linebuf,
+                    l_int32      invert)
+{
+l_int32    i, j, w, h, d, wpl, nbits;
+l_uint32   word, endmask;
+l_uint32  *line;
+
+    pixGetDimensions(pix, &w, &h, &d);
+    wpl = pixGetWpl(pix);
+    line = pixGetData(pix);
+    nbits = (w * d) & 31;  /* bits of image data in the last word */
+    endmask = (nbits == 0) ? 0xffffffff : ~(0xffffffff >> nbits);
+    for (i = 0; i < h; i++, line += wpl) {
+        for (j = 0; j < wpl; j++) {
+            word = (invert) ? ~line[j] : line[j];
+            if (j == wpl - 1)  /* keep the pad bits cleared */
+                word &= endmask;
+#ifdef L_LITTLE_ENDIAN
+            word = (word >> 24) |
+                   ((word >> 8) & 0x0000ff00) |
+                   ((word << 8) & 0x00ff0000) |
+                   (word << 24);
+#endif  /* L_LITTLE_ENDIAN */
+            linebuf[j] = word;
+        }
+        png_write_row(png_ptr, (png_bytep)linebuf);
+    }
+}
+
+
+/*!
+ * \brief   pngWriteRgbRows()
+ *
+ * \param[in]    png_ptr
+ * \param[in]    pix         32 bpp rgb; rgba if spp == 4
+ * \param[in]    rowbuffer   buffer of at least 4 * w bytes
+ * \return  void
+ */
+static void
+pngWriteRgbRows(png_structp  png_ptr,
+                PIX         *pix,
+                png_bytep    rowbuffer)
+{
+l_int32    i, j, k, w, h, wpl, spp;
+l_uint32   pixel;
+l_uint32  *line;
+
+    pixGetDimensions(pix, &w, &h, NULL);
+    wpl = pixGetWpl(pix);
+    spp = pixGetSpp(pix);
+    line = pixGetData(pix);
+    for (i = 0; i < h; i++, line += wpl) {
+        for (j = k = 0; j < w; j++) {
+            pixel = line[j];
+            rowbuffer[k++] = (pixel >> L_RED_SHIFT) & 0xff;
+            rowbuffer[k++] = (pixel >> L_GREEN_SHIFT) & 0xff;
+            rowbuffer[k++] = (pixel >> L_BLUE_SHIFT) & 0xff;
+            if (spp == 4)
+                rowbuffer[k++] = (pixel >> L_ALPHA_SHIFT) & 0xff;
+        }
+        png_write_row(png_ptr, rowbuffer);
+    }
+}
+
+
 /*---------------------------------------------------------------------*
  *              Set flag for stripping 16 bits on reading              *
  *---------------------------------------------------------------------*/
@@ -1964,7 +2146,7 @@ pixWriteMemPng(l_uint8  **pfiledata,
                l_float32  gamma)
 {
 char         commentstring[] = "Comment";
-l_int32      i, j, k, wpl, d, spp, cmflag, opaque, ncolors, compval, valid;
+l_int32      i, wpl, d, spp, cmflag, opaque, ncolors, valid;
 l_int32     *rmap, *gmap, *bmap, *amap;
 l_uint32    *data, *ppixel;
 png_byte     bit_depth, color_type;
@@ -1974,7 +2156,6 @@ png_bytep    rowbuffer;
 png_structp  png_ptr;
 png_infop    info_ptr;
 png_colorp   palette;
-PIX         *pix1;
 PIXCMAP     *cmap;
 char        *text;
 MEMIODATA    state;
@@ -2044,25 +2225,19 @@ MEMIODATA    state;
     }
 
         /* Set up png setjmp error handling */
-    pix1 = NULL;
+    rowbuffer = NULL;
     if (setjmp(png_jmpbuf(png_ptr))) {
         png_destroy_write_struct(&png_ptr, &info_ptr);
-        pixDestroy(&pix1);
+        LEPT_FREE(rowbuffer);
+        memio_free(&state);
         return ERROR_INT("internal png error", __func__, 1);
     }
 
     png_set_write_fn(png_ptr, &state, memio_png_write_data,
                      (png_flush_ptr)NULL);
 
-        /* With best zlib compression (9), get between 1 and 10% improvement
-         * over default (6), but the compression is 3 to 10 times slower.
-         * Use the zlib default (6) as our default compression unless
-         * pix->special falls in the range [10 ... 19]; then subtract 10
-         * to get the compression value.  */
-    compval = Z_DEFAULT_COMPRESSION;
-    if (pix->special >= 10 && pix->special < 20)
-        compval = pix->special - 10;
-    png_set_compression_level(png_ptr, compval);
+        /* Set the zlib level, row filters and strategy */
+    pngSetWriteOptions(png_ptr, pix, bit_depth, cmflag);
 
     png_set_IHDR(png_ptr, info_ptr, w, h, bit_depth, color_type,
                  PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
@@ -2124,32 +2299,14 @@ MEMIODATA    state;
     png_write_info(png_ptr, info_ptr);
 
     if ((d != 32) && (d != 24)) {  /* not rgb color */
-            /* Generate a temporary pix with bytes swapped.
-             * For writing a 1 bpp image as png:
-             *    ~ if no colormap, invert the data, because png writes
-             *      black as 0
-             *    ~ if colormapped, do not invert the data; the two RGBA
-             *      colors can have any value.  */
-        if (d == 1 && !cmap) {
-            pix1 = pixInvert(NULL, pix);
-            pixEndianByteSwap(pix1);
-        } else {
-            pix1 = pixEndianByteSwapNew(pix);
-        }
-        if (!pix1) {
-            png_destroy_write_struct(&png_ptr, &info_ptr);
-            memio_free(&state);
-            return ERROR_INT("pix1 not made", __func__, 1);
-        }
-
-            /* Transfer the data */
-        wpl = pixGetWpl(pix1);
-        data = pixGetData(pix1);
-        for (i = 0; i < h; i++)
-            png_write_row(png_ptr, (png_bytep)(data + i * wpl));
+            /* Byte swap (and for 1 bpp without colormap, invert)
+             * each row as it is written; see pixWriteStreamPng(). */
+        rowbuffer = (png_bytep)LEPT_CALLOC(pixGetWpl(pix), 4);
+        pngWriteSwappedRows(png_ptr, pix, (l_uint32 *)rowbuffer,
+                            (d == 1 && !cmap));
         png_write_end(png_ptr, info_ptr);
 
-        pixDestroy(&pix1);
+        LEPT_FREE(rowbuffer);
         png_destroy_write_struct(&png_ptr, &info_ptr);
         memio_png_flush(&state);
         *pfiledata = (l_uint8 *)state.m_Buffer;
@@ -2169,19 +2326,7 @@ MEMIODATA    state;
         }
     } else {  /* 32 bpp rgb and rgba.  If spp = 4, write the alpha channel */
         rowbuffer = (png_bytep)LEPT_CALLOC(w, 4);
-        for (i = 0; i < h; i++) {
-            ppixel = data + i * wpl;
-            for (j = k = 0; j < w; j++) {
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_RED);
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_GREEN);
-                rowbuffer[k++] = GET_DATA_BYTE(ppixel, COLOR_BLUE);
-                if (spp == 4)
-                    rowbuffer[k++] = GET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL);
-                ppixel++;
-            }
-
-            png_write_rows(png_ptr, &rowbuffer, 1);
-        }
+        pngWriteRgbRows(png_ptr, pix, rowbuffer);
         LEPT_FREE(rowbuffer);
     }
     png_write_end(png_ptr, info_ptr);
@@ -2195,6 +2340,360 @@ MEMIODATA    state;
     return 0;
 }
 
+
+/*---------------------------------------------------------------------*
+ *                         Push decoding of png                        *
+ *---------------------------------------------------------------------*/
+    /*! State of the progressive png reader used by a push decoder */
+struct PngPushState
+{
+    png_structp    png_ptr;
+    png_infop      info_ptr;
+    L_PUSHDEC     *pd;        /*!< the push decoder that owns this          */
+    PIXCMAP       *cmap;      /*!< palette, used for conversion with tRNS   */
+    png_bytep      trans;     /*!< transparency array for the palette       */
+    l_int32        ntrans;    /*!< number of entries in the trans array     */
+    l_int32        spp;       /*!< samples/pixel in the png rows            */
+    l_int32        bps;       /*!< bits/sample in the png rows              */
+    l_int32        tRNS;      /*!< 1 if there is a tRNS chunk               */
+    l_int32        invert;    /*!< 1 for 1 bpp without colormap             */
+    png_uint_32    rowbytes;  /*!< bytes in each png row                    */
+    l_uint8       *rawdata;   /*!< combined rows, for interlaced png        */
+};
+typedef struct PngPushState  PNGPUSHSTATE;
+
+/*!
+ * \brief   pngPushInfoCallback()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Called by libpng when the header chunks have been read.
+ *          This sets the transforms and makes the image to be filled,
+ *          following the same rules as pixReadStreamPng().
+ * </pre>
+ */
+static void
+pngPushInfoCallback(png_structp  png_ptr,
+                    png_infop    info_ptr)
+{
+l_int32        d, spp, cindex, num_palette, num_trans;
+png_byte       bit_depth, color_type;
+png_uint_32    w, h, xres, yres;
+png_bytep      trans;
+png_colorp     palette;
+PIX           *pix;
+PIXCMAP       *cmap;
+PNGPUSHSTATE  *ps;
+
+    ps = (PNGPUSHSTATE *)png_get_progressive_ptr(png_ptr);
+    if (var_PNG_STRIP_16_TO_8 == 1)
+        png_set_strip_16(png_ptr);
+    png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+
+    w = png_get_image_width(png_ptr, info_ptr);
+    h = png_get_image_height(png_ptr, info_ptr);
+    bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    color_type = png_get_color_type(png_ptr, info_ptr);
+    spp = png_get_channels(png_ptr, info_ptr);
+    ps->rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    ps->tRNS = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) ? 1 : 0;
+    ps->spp = spp;
+    ps->bps = bit_depth;
+    d = (spp == 1) ? bit_depth : 4 * bit_depth;
+    if (spp != 1 && bit_depth != 8)
+        png_error(png_ptr, "spp > 1 requires 8 bps; turn on 16 --> 8 stripping");
+
+    cmap = NULL;
+    if (color_type == PNG_COLOR_TYPE_PALETTE ||
+        color_type == PNG_COLOR_MASK_PALETTE) {
+        png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
+        cmap = pixcmapCreate(d);
+        for (cindex = 0; cindex < num_palette; cindex++)
+            pixcmapAddColor(cmap, palette[cindex].red, palette[cindex].green,
+                            palette[cindex].blue);
+    }
+
+    if (spp == 1 && ps->tRNS) {  /* converted to RGBA */
+        ps->cmap = cmap;  /* NULL gives a fully transparent image */
+        if (cmap) {
+            png_get_tRNS(png_ptr, info_ptr, &trans, &num_trans, NULL);
+            if (!trans)
+                png_error(png_ptr, "cmap, tRNS, but no transparency array");
+            ps->trans = trans;
+            ps->ntrans = num_trans;
+        }
+        pix = pixCreate(w, h, 32);
+        if (pix) pixSetSpp(pix, 4);
+    } else {
+        pix = pixCreate(w, h, d);
+        if (pix) {
+            pixSetSpp(pix, (spp == 2) ? 4 : spp);
+            if (pixSetColormap(pix, cmap)) {
+                pixDestroy(&pix);
+                png_error(png_ptr, "invalid colormap");
+            }
+        } else {
+            pixcmapDestroy(&cmap);
+        }
+    }
+    if (!pix)
+        png_error(png_ptr, "pix not made");
+    pixSetInputFormat(pix, IFF_PNG);
+    xres = png_get_x_pixels_per_meter(png_ptr, info_ptr);
+    yres = png_get_y_pixels_per_meter(png_ptr, info_ptr);
+    pixSetXRes(pix, (l_int32)((l_float32)xres / 39.37 + 0.5));  /* to ppi */
+    pixSetYRes(pix, (l_int32)((l_float32)yres / 39.37 + 0.5));  /* to ppi */
+    ps->pd->pix = pix;
+    ps->invert = (d == 1 && !cmap);
+
+        /* Interlaced rows are combined in a buffer over the passes */
+    if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE) {
+        if ((ps->rawdata = (l_uint8 *)LEPT_CALLOC((size_t)h,
+                                                  ps->rowbytes)) == NULL)
+            png_error(png_ptr, "rawdata not made");
+    }
+    ps->pd->status = L_PUSHDEC_DECODING;
+}
+
+
+/*!
+ * \brief   pngPushConvertRow()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Converts one row of png data to row %i of the image,
+ *          as is done for the entire image in pixReadStreamPng().
+ * </pre>
+ */
+static void
+pngPushConvertRow(PNGPUSHSTATE  *ps,
+                  png_bytep      rowptr,
+                  l_int32        i)
+{
+l_int32    j, k, w, d, wpl, bitpos, mask, index, rval, gval, bval;
+l_uint32  *line, *ppixel;
+PIX       *pix;
+
+    pix = ps->pd->pix;
+    w = pixGetWidth(pix);
+    wpl = pixGetWpl(pix);
+    line = pixGetData(pix) + i * wpl;
+    if (ps->spp == 1 && !ps->tRNS) {  /* copy straight to pix */
+        for (j = 0; j < ps->rowbytes; j++) {
+            if (ps->invert)
+                SET_DATA_BYTE(line, j, ~rowptr[j] & 0xff);
+            else
+                SET_DATA_BYTE(line, j, rowptr[j]);
+        }
+    } else if (ps->spp == 2) {  /* grayscale + alpha; convert to RGBA */
+        for (j = k = 0, ppixel = line; j < w; j++, ppixel++) {
+            SET_DATA_BYTE(ppixel, COLOR_RED, rowptr[k]);
+            SET_DATA_BYTE(ppixel, COLOR_GREEN, rowptr[k]);
+            SET_DATA_BYTE(ppixel, COLOR_BLUE, rowptr[k++]);
+            SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowptr[k++]);
+        }
+    } else if (ps->spp == 3 || ps->spp == 4) {
+        for (j = k = 0, ppixel = line; j < w; j++, ppixel++) {
+            SET_DATA_BYTE(ppixel, COLOR_RED, rowptr[k++]);
+            SET_DATA_BYTE(ppixel, COLOR_GREEN, rowptr[k++]);
+            SET_DATA_BYTE(ppixel, COLOR_BLUE, rowptr[k++]);
+            if (ps->spp == 3)
+                SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, 255);
+            else
+                SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowptr[k++]);
+        }
+    } else if (ps->cmap) {  /* colormap + alpha; convert to RGBA */
+        d = ps->bps;
+        mask = (1 << d) - 1;
+        for (j = 0, ppixel = line; j < w; j++, ppixel++) {
+            bitpos = j * d;
+            index = (rowptr[bitpos >> 3] >> (8 - d - (bitpos & 7))) & mask;
+            pixcmapGetColor(ps->cmap, index, &rval, &gval, &bval);
+            composeRGBPixel(rval, gval, bval, ppixel);
+                /* Missing entries are opaque */
+            SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL,
+                          index < ps->ntrans ? ps->trans[index] : 255);
+        }
+    }  /* else gray with tRNS: by convention, fully transparent */
+}
+
+
+/*!
+ * \brief   pngPushRowCallback()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Called by libpng for each decoded row.  With interlace
+ *          handling, it is called for every row in every pass, with
+ *          %new_row == NULL for rows that don't change in the pass.
+ *      (2) Interlaced rows are complete in the last pass (6), which
+ *          visits the rows in order, so every row up to %row_num is
+ *          then finished.
+ * </pre>
+ */
+static void
+pngPushRowCallback(png_structp  png_ptr,
+                   png_bytep    new_row,
+                   png_uint_32  row_num,
+                   int          pass)
+{
+l_int32        i;
+l_uint8       *rowptr;
+L_PUSHDEC     *pd;
+PNGPUSHSTATE  *ps;
+
+    ps = (PNGPUSHSTATE *)png_get_progressive_ptr(png_ptr);
+    pd = ps->pd;
+    if (!pd->pix || row_num >= pixGetHeight(pd->pix))
+        return;
+
+    if (!ps->rawdata) {  /* not interlaced */
+        if (!new_row) return;
+        pngPushConvertRow(ps, new_row, row_num);
+        pd->nrows = row_num + 1;
+        return;
+    }
+
+    rowptr = ps->rawdata + (size_t)row_num * ps->rowbytes;
+    png_progressive_combine_row(png_ptr, rowptr, new_row);
+    if (pass == 6) {
+        for (i = pd->nrows; i <= row_num; i++)
+            pngPushConvertRow(ps, ps->rawdata + (size_t)i * ps->rowbytes, i);
+        pd->nrows = row_num + 1;
+    }
+}
+
+
+/*!
+ * \brief   pngPushEndCallback()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Called by libpng after the IEND chunk.  This finishes any
+ *          interlaced rows not yet converted, and makes the final
+ *          adjustments of pixReadStreamPng().
+ * </pre>
+ */
+static void
+pngPushEndCallback(png_structp  png_ptr,
+                   png_infop    info_ptr)
+{
+l_int32        i, h, num_text, valid;
+png_textp      text_ptr;
+L_PUSHDEC     *pd;
+PIX           *pix1;
+PIXCMAP       *cmap;
+PNGPUSHSTATE  *ps;
+
+    ps = (PNGPUSHSTATE *)png_get_progressive_ptr(png_ptr);
+    pd = ps->pd;
+    if (!pd->pix)
+        png_error(png_ptr, "no image data");
+    h = pixGetHeight(pd->pix);
+    if (ps->rawdata) {
+        for (i = pd->nrows; i < h; i++)
+            pngPushConvertRow(ps, ps->rawdata + (size_t)i * ps->rowbytes, i);
+        LEPT_FREE(ps->rawdata);
+        ps->rawdata = NULL;
+    }
+    pd->nrows = h;
+
+        /* Remove the colormap from 1 bpp, without changing the values */
+    if (pixGetDepth(pd->pix) == 1 && pixGetColormap(pd->pix)) {
+        if ((pix1 = pixRemoveColormap(pd->pix,
+                                      REMOVE_CMAP_BASED_ON_SRC)) == NULL)
+            png_error(png_ptr, "colormap not removed");
+        pixDestroy(&pd->pix);
+        pd->pix = pix1;
+    }
+
+    png_get_text(png_ptr, info_ptr, &text_ptr, &num_text);
+    if (num_text && text_ptr)
+        pixSetText(pd->pix, text_ptr->text);
+
+    if ((cmap = pixGetColormap(pd->pix)) != NULL) {
+        pixcmapIsValid(cmap, pd->pix, &valid);
+        if (!valid)
+            png_error(png_ptr, "colormap is not valid");
+    }
+    pixSetPadBits(pd->pix, 0);
+    pd->status = L_PUSHDEC_DONE;
+}
+
+
+/*!
+ * \brief   pngPushDecode()
+ *
+ * \param[in]    pd    push decoder
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is called by the push decoder (pushdecode.c) whenever
+ *          data arrives.  The data not yet seen is passed to the libpng
+ *          progressive reader, which fills rows of pd->pix through
+ *          the callbacks.
+ *      (2) The result is the same as with pixReadMemPng().
+ * </pre>
+ */
+l_ok
+pngPushDecode(L_PUSHDEC  *pd)
+{
+size_t         start, nbytes;
+PNGPUSHSTATE  *ps;
+
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+
+    if (!pd->codec) {
+        ps = (PNGPUSHSTATE *)LEPT_CALLOC(1, sizeof(PNGPUSHSTATE));
+        ps->pd = pd;
+        pd->codec = ps;
+        if ((ps->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                           (png_voidp)NULL, NULL, NULL)) == NULL)
+            return ERROR_INT("png_ptr not made", __func__, 1);
+        if ((ps->info_ptr = png_create_info_struct(ps->png_ptr)) == NULL)
+            return ERROR_INT("info_ptr not made", __func__, 1);
+        png_set_progressive_read_fn(ps->png_ptr, ps, pngPushInfoCallback,
+                                    pngPushRowCallback, pngPushEndCallback);
+    }
+    ps = (PNGPUSHSTATE *)pd->codec;
+
+    if (setjmp(png_jmpbuf(ps->png_ptr)))
+        return ERROR_INT("internal png error", __func__, 1);
+
+    if (pd->nbytes > pd->offset) {
+        start = pd->offset;
+        nbytes = pd->nbytes - start;
+        pd->offset = pd->nbytes;
+        png_process_data(ps->png_ptr, ps->info_ptr, pd->data + start, nbytes);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   pngPushCleanup()
+ *
+ * \param[in]    pd    push decoder
+ * \return  void
+ */
+void
+pngPushCleanup(L_PUSHDEC  *pd)
+{
+PNGPUSHSTATE  *ps;
+
+    if (!pd || !pd->codec) return;
+    ps = (PNGPUSHSTATE *)pd->codec;
+    if (ps->png_ptr)
+        png_destroy_read_struct(&ps->png_ptr, &ps->info_ptr, NULL);
+    pixcmapDestroy(&ps->cmap);
+    LEPT_FREE(ps->rawdata);
+    LEPT_FREE(ps);
+    pd->codec = NULL;
+}
+
 /* --------------------------------------------*/
 #endif  /* HAVE_LIBPNG */
 /* --------------------------------------------*/
@@ -117,6 +117,13 @@ l_ok pixSetZlibCompression(PIX *pix, l_int32 compval)
 
 /* ----------------------------------------------------------------------*/
 
+l_ok pixSetPngPreset(PIX *pix, l_int32 preset)
+{
+    return ERROR_INT("function not present", __func__, 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
 void l_pngSetReadStrip16To8(l_int32 flag)
 {
     L_ERROR("function not present\n", __func__);
@@ -138,6 +145,21 @@ l_ok pixWriteMemPng(l_uint8 **pfiledata, size_t *pfilesize, PIX *pix,
     return ERROR_INT("function not present", __func__, 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+l_ok pngPushDecode(L_PUSHDEC *pd)
+{
+    return ERROR_INT("function not present", __func__, 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void pngPushCleanup(L_PUSHDEC *pd)
+{
+    L_ERROR("function not present\n", __func__);
+    return;
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBPNG */
 /* --------------------------------------------*/
@@ -50,6 +50,7 @@
  *           l_int32   getProjectiveXformCoeffs()
  *           l_int32   projectiveXformSampledPt()
  *           l_int32   projectiveXformPt()
+ *           l_int32   projectiveLinePositions()
  *
  *      A projective transform can be specified as a specific functional
  *      mapping between 4 points in the source and 4 points in the dest.
@@ -445,11 +446,10 @@ pixProjectiveColor(PIX        *pixs,
                    l_float32  *vc,
                    l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
-l_uint32   val;
+l_int32    i, w, h, d, wpls, wpld, withalpha;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
-PIX       *pix1, *pix2, *pixd;
+PIX       *pixd;
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
@@ -462,31 +462,35 @@ PIX       *pix1, *pix2, *pixd;
     datas = pixGetData(pixs);
     wpls = pixGetWpl(pixs);
     pixd = pixCreateTemplate(pixs);
-    pixSetAllArbitrary(pixd, colorval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
+
+        /* If rgba, the alpha component is transformed with the others,
+         * and opaque alpha is brought in from outside */
+    withalpha = (pixGetSpp(pixs) == 4);
+    if (withalpha)
+        pixSetAllArbitrary(pixd, (colorval & 0xffffff00) | 0xff);
+    else
+        pixSetAllArbitrary(pixd, colorval);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            projectiveXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
-                                        &val);
-            *(lined + j) = val;
-        }
-    }
-
-        /* If rgba, transform the pixs alpha channel and insert in pixd */
-    if (pixGetSpp(pixs) == 4) {
-        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
-        pix2 = pixProjectiveGray(pix1, vc, 255);  /* bring in opaque */
-        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
-        pixDestroy(&pix1);
-        pixDestroy(&pix2);
+        projectiveLinePositions(vc, i, w, h, w, xpa, ypa);
+        linearInterpolateLineColor(datas, wpls, w, h, xpa, ypa, w,
+                                   withalpha, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -545,9 +549,9 @@ pixProjectiveGray(PIX        *pixs,
                   l_float32  *vc,
                   l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, w, h, wpls, wpld;
+l_int32   *xpa, *ypa;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
 PIX       *pixd;
 
     if (!pixs)
@@ -564,18 +568,24 @@ PIX       *pixd;
     pixSetAllArbitrary(pixd, grayval);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    xpa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    ypa = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!xpa || !ypa) {
+        LEPT_FREE(xpa);
+        LEPT_FREE(ypa);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("xpa and ypa not made", __func__, NULL);
+    }
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination lines */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            projectiveXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
-            SET_DATA_BYTE(lined, j, val);
-        }
+        projectiveLinePositions(vc, i, w, h, w, xpa, ypa);
+        linearInterpolateLineGray(datas, wpls, w, h, xpa, ypa, w, lined);
     }
 
+    LEPT_FREE(xpa);
+    LEPT_FREE(ypa);
     return pixd;
 }
 
@@ -906,3 +916,65 @@ l_float64  denom;
     *pyp = factor * (vc[3] * x + vc[4] * y + vc[5]);
     return 0;
 }
+
+
+/*!
+ * \brief   projectiveLinePositions()
+ *
+ * \param[in]    vc         vector of 8 coefficients
+ * \param[in]    y          dest line
+ * \param[in]    w, h       of src image
+ * \param[in]    n          number of dest pixels on the line
+ * \param[in]    xpa, ypa   arrays of size %n for src locations
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This generates the src locations, in units of 1/16 pixel,
+ *          for a line of dest pixels, for use by
+ *          linearInterpolateLineGray() and linearInterpolateLineColor().
+ *          Dest pixels whose src location is outside the src image
+ *          are given a location of -1.
+ *      (2) The numerators and denominator of the transform are each
+ *          stepped by a constant increment along the line, so only
+ *          one division is required for each dest pixel.
+ * </pre>
+ */
+l_ok
+projectiveLinePositions(l_float32  *vc,
+                        l_int32     y,
+                        l_int32     w,
+                        l_int32     h,
+                        l_int32     n,
+                        l_int32    *xpa,
+                        l_int32    *ypa)
+{
+l_int32    j;
+l_float64  xnum, ynum, denom, factor, xs, ys;
+
+    if (!vc)
+        return ERROR_INT("vc not defined", __func__, 1);
+    if (!xpa || !ypa)
+        return ERROR_INT("xpa and ypa not both defined", __func__, 1);
+
+    xnum = (l_float64)vc[1] * y + vc[2];
+    ynum = (l_float64)vc[4] * y + vc[5];
+    denom = (l_float64)vc[7] * y + 1.0;
+    for (j = 0; j < n; j++) {
+        xpa[j] = ypa[j] = -1;
+        if (denom != 0.0) {
+            factor = 1.0 / denom;
+            xs = factor * xnum;
+            ys = factor * ynum;
+                /* NaNs fail these tests */
+            if (xs >= 0.0 && ys >= 0.0 && xs < w && ys < h) {
+                xpa[j] = (l_int32)(16.0 * xs);
+                ypa[j] = (l_int32)(16.0 * ys);
+            }
+        }
+        xnum += vc[0];
+        ynum += vc[3];
+        denom += vc[6];
+    }
+    return 0;
+}
@@ -0,0 +1,448 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file pushdecode.c
+ * <pre>
+ *
+ *    Push (incremental) decoding of compressed images.
+ *
+ *      Create/destroy
+ *           L_PUSHDEC  *pushdecCreate()
+ *           void        pushdecDestroy()
+ *
+ *      Supplying data
+ *           l_int32     pushdecFeed()
+ *           l_int32     pushdecFinish()
+ *           static l_int32  pushdecRun()
+ *
+ *      Accessors
+ *           l_int32     pushdecGetStatus()
+ *           l_int32     pushdecGetInfo()
+ *           PIX        *pushdecGetBand()
+ *           PIX        *pushdecGetPix()
+ *
+ *    pixReadMem() and pixReadStream() need the entire compressed image
+ *    before they return anything.  A push decoder is instead handed the
+ *    data in chunks as they arrive, and after each chunk it decodes as
+ *    many rows as the data allows.  Typical use:
+ *
+ *        L_PUSHDEC *pd = pushdecCreate(IFF_UNKNOWN);
+ *        while ((n = <receive up to size bytes into buf>) > 0) {
+ *            pushdecFeed(pd, buf, n);
+ *            while ((pixb = pushdecGetBand(pd, &y)) != NULL) {
+ *                <process the rows [y ... y + pixGetHeight(pixb) - 1]>
+ *                pixDestroy(&pixb);
+ *            }
+ *        }
+ *        pushdecFinish(pd);
+ *        <get the remaining band>
+ *        pix = pushdecGetPix(pd);
+ *        pushdecDestroy(&pd);
+ *
+ *    Rows are produced incrementally for:
+ *      ~ png (libpng progressive reader).  For interlaced png, rows
+ *        become complete during the last pass.
+ *      ~ jpeg (libjpeg with a suspending data source).  For progressive
+ *        jpeg, libjpeg reads all the scans before producing any rows.
+ *      ~ tiff with strips, for the common single-sample layouts
+ *        (1, 2, 4, 8 and 16 bps, with or without colormap), once the
+ *        first directory has arrived.  Each strip is decoded as soon
+ *        as its data is present.
+ *      ~ webp (libwebp incremental decoder).
+ *    All other formats and layouts (e.g., tiled or rgb tiff, bmp, pnm)
+ *    are decoded in one shot by pixReadMem() when pushdecFinish()
+ *    is called, and the entire image is then available as one band.
+ *
+ *    The image that is finally returned by pushdecGetPix() is the same
+ *    as the one returned by pixReadMem().  The bands are clipped from
+ *    the image as it is being decoded, so for 1 bpp colormapped png
+ *    and tiff, where the colormap is removed only after the last row
+ *    has been decoded, the bands still have the colormap.
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <string.h>
+#include "allheaders.h"
+
+    /* Initial size of the array for the compressed data */
+static const size_t  InitialDataSize = 65536;
+
+static l_int32 pushdecRun(L_PUSHDEC *pd);
+
+
+/*---------------------------------------------------------------------*
+ *                           Create/destroy                            *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pushdecCreate()
+ *
+ * \param[in]    format    IFF_PNG, IFF_JFIF_JPEG, etc; use IFF_UNKNOWN
+ *                         to determine the format from the data
+ * \return  pd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With IFF_UNKNOWN, the format is found from the first 12 bytes
+ *          of data, using findFileFormatBuffer().
+ *      (2) All tiff compression types are handled by the tiff decoder,
+ *          so any of the IFF_TIFF_* formats can be used for tiff.
+ * </pre>
+ */
+L_PUSHDEC *
+pushdecCreate(l_int32  format)
+{
+L_PUSHDEC  *pd;
+
+    if (format < IFF_UNKNOWN || format > IFF_SPIX)
+        return (L_PUSHDEC *)ERROR_PTR("invalid format", __func__, NULL);
+
+    pd = (L_PUSHDEC *)LEPT_CALLOC(1, sizeof(L_PUSHDEC));
+    if ((pd->data = (l_uint8 *)LEPT_MALLOC(InitialDataSize)) == NULL) {
+        LEPT_FREE(pd);
+        return (L_PUSHDEC *)ERROR_PTR("data not made", __func__, NULL);
+    }
+    pd->nalloc = InitialDataSize;
+    pd->format = format;
+    pd->status = L_PUSHDEC_WAITING;
+    return pd;
+}
+
+
+/*!
+ * \brief   pushdecDestroy()
+ *
+ * \param[in,out]   ppd    will be set to null before returning
+ * \return  void
+ */
+void
+pushdecDestroy(L_PUSHDEC  **ppd)
+{
+L_PUSHDEC  *pd;
+
+    if (ppd == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((pd = *ppd) == NULL)
+        return;
+
+    if (pd->codec) {
+        if (pd->format == IFF_PNG)
+            pngPushCleanup(pd);
+        else if (pd->format == IFF_JFIF_JPEG)
+            jpegPushCleanup(pd);
+        else if (pd->format == IFF_WEBP)
+            webpPushCleanup(pd);
+        else if (L_FORMAT_IS_TIFF(pd->format))
+            tiffPushCleanup(pd);
+    }
+    pixDestroy(&pd->pix);
+    LEPT_FREE(pd->data);
+    LEPT_FREE(pd);
+    *ppd = NULL;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                            Supplying data                           *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pushdecFeed()
+ *
+ * \param[in]    pd
+ * \param[in]    data      next chunk of compressed data
+ * \param[in]    nbytes    size of the chunk; can be 0
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The data is appended to what has already been received,
+ *          and then as much as possible of the image is decoded.
+ *          Use pushdecGetBand() to get the newly completed rows.
+ *      (2) An error is returned if the data is found to be invalid,
+ *          or if more data is supplied after pushdecFinish().
+ *          Once an error has occurred, the status stays at
+ *          L_PUSHDEC_ERROR, but the rows completed before the
+ *          error can still be extracted.
+ * </pre>
+ */
+l_ok
+pushdecFeed(L_PUSHDEC      *pd,
+            const l_uint8  *data,
+            size_t          nbytes)
+{
+size_t    newsize;
+l_uint8  *newdata;
+
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+    if (!data && nbytes > 0)
+        return ERROR_INT("data not defined", __func__, 1);
+    if (pd->status == L_PUSHDEC_ERROR)
+        return ERROR_INT("decoder has failed", __func__, 1);
+    if (pd->eof && nbytes > 0)
+        return ERROR_INT("data supplied after finish", __func__, 1);
+
+    if (pd->nbytes + nbytes > pd->nalloc) {
+        newsize = L_MAX(2 * pd->nalloc, pd->nbytes + nbytes);
+        if ((newdata = (l_uint8 *)LEPT_REALLOC(pd->data, newsize)) == NULL)
+            return ERROR_INT("data not extended", __func__, 1);
+        pd->data = newdata;
+        pd->nalloc = newsize;
+    }
+    if (nbytes > 0)
+        memcpy(pd->data + pd->nbytes, data, nbytes);
+    pd->nbytes += nbytes;
+    return pushdecRun(pd);
+}
+
+
+/*!
+ * \brief   pushdecFinish()
+ *
+ * \param[in]    pd
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Call this when all the data has been supplied.  Formats that
+ *          are not decoded incrementally are decoded here.
+ *      (2) If the data ends before the image is complete, this returns
+ *          an error, and the status is L_PUSHDEC_ERROR.  The rows that
+ *          were completed can still be extracted with pushdecGetBand().
+ * </pre>
+ */
+l_ok
+pushdecFinish(L_PUSHDEC  *pd)
+{
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+    if (pd->status == L_PUSHDEC_ERROR)
+        return ERROR_INT("decoder has failed", __func__, 1);
+    if (pd->eof)
+        return 0;
+
+    pd->eof = 1;
+    if (pushdecRun(pd))
+        return 1;
+    if (pd->status != L_PUSHDEC_DONE) {
+        pd->status = L_PUSHDEC_ERROR;
+        return ERROR_INT("data ended before image was complete", __func__, 1);
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   pushdecRun()
+ *
+ * \param[in]    pd
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Identifies the format if necessary, and hands the new data
+ *          to the codec.  Formats without an incremental decoder wait
+ *          for the end of the data and use pixReadMem().
+ * </pre>
+ */
+static l_int32
+pushdecRun(L_PUSHDEC  *pd)
+{
+l_int32  format, ret;
+
+    if (pd->status == L_PUSHDEC_DONE)
+        return 0;
+
+    if (pd->format == IFF_UNKNOWN) {
+        if (pd->nbytes < 12 && !pd->eof)
+            return 0;
+        if (pd->nbytes < 12) {
+            pd->status = L_PUSHDEC_ERROR;
+            return ERROR_INT("too little data to find format", __func__, 1);
+        }
+        findFileFormatBuffer(pd->data, &format);
+        if (format == IFF_UNKNOWN) {
+            pd->status = L_PUSHDEC_ERROR;
+            return ERROR_INT("format not identified", __func__, 1);
+        }
+        pd->format = format;
+    }
+
+    if (pd->format == IFF_PNG) {
+        ret = pngPushDecode(pd);
+    } else if (pd->format == IFF_JFIF_JPEG) {
+        ret = jpegPushDecode(pd);
+    } else if (pd->format == IFF_WEBP) {
+        ret = webpPushDecode(pd);
+    } else if (L_FORMAT_IS_TIFF(pd->format)) {
+        ret = tiffPushDecode(pd);
+    } else {  /* decode in one shot */
+        ret = 0;
+        if (pd->eof) {
+            pd->offset = pd->nbytes;
+            if ((pd->pix = pixReadMem(pd->data, pd->nbytes)) == NULL) {
+                ret = 1;
+            } else {
+                pd->nrows = pixGetHeight(pd->pix);
+                pd->status = L_PUSHDEC_DONE;
+            }
+        }
+    }
+
+    if (ret) {
+        pd->status = L_PUSHDEC_ERROR;
+        return ERROR_INT("decoding failed", __func__, 1);
+    }
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                              Accessors                              *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pushdecGetStatus()
+ *
+ * \param[in]    pd
+ * \return  status L_PUSHDEC_WAITING, etc., or L_PUSHDEC_ERROR on error
+ */
+l_int32
+pushdecGetStatus(L_PUSHDEC  *pd)
+{
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, L_PUSHDEC_ERROR);
+    return pd->status;
+}
+
+
+/*!
+ * \brief   pushdecGetInfo()
+ *
+ * \param[in]    pd
+ * \param[out]   pw, ph, pdepth   [optional] size and depth of the image
+ * \param[out]   pnrows           [optional] number of completed rows
+ * \return  0 if OK, 1 on error or if the header has not been read
+ *
+ * <pre>
+ * Notes:
+ *      (1) The size and depth are those of the image as it is decoded;
+ *          see the notes at the top of this file for the cases where
+ *          the final image has a different depth.
+ * </pre>
+ */
+l_ok
+pushdecGetInfo(L_PUSHDEC  *pd,
+               l_int32    *pw,
+               l_int32    *ph,
+               l_int32    *pdepth,
+               l_int32    *pnrows)
+{
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pdepth) *pdepth = 0;
+    if (pnrows) *pnrows = 0;
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+    if (!pd->pix)
+        return 1;
+
+    pixGetDimensions(pd->pix, pw, ph, pdepth);
+    if (pnrows) *pnrows = pd->nrows;
+    return 0;
+}
+
+
+/*!
+ * \brief   pushdecGetBand()
+ *
+ * \param[in]    pd
+ * \param[out]   py     [optional] location of the band in the image
+ * \return  pixd band of completed rows not returned previously,
+ *                    or NULL if there are none
+ *
+ * <pre>
+ * Notes:
+ *      (1) The returned band has the full width of the image, and is
+ *          a copy, so decoding can continue while it is processed.
+ *      (2) Each completed row is returned exactly once, in order from
+ *          the top of the image.  Returning NULL is not an error.
+ * </pre>
+ */
+PIX *
+pushdecGetBand(L_PUSHDEC  *pd,
+               l_int32    *py)
+{
+l_int32  w;
+BOX     *box;
+PIX     *pixd;
+
+    if (py) *py = 0;
+    if (!pd)
+        return (PIX *)ERROR_PTR("pd not defined", __func__, NULL);
+    if (!pd->pix || pd->nrows <= pd->nout)
+        return NULL;
+
+    w = pixGetWidth(pd->pix);
+    box = boxCreate(0, pd->nout, w, pd->nrows - pd->nout);
+    pixd = pixClipRectangle(pd->pix, box, NULL);
+    boxDestroy(&box);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("band not made", __func__, NULL);
+    pixSetSpp(pixd, pixGetSpp(pd->pix));
+    pixSetInputFormat(pixd, pixGetInputFormat(pd->pix));
+    if (py) *py = pd->nout;
+    pd->nout = pd->nrows;
+    return pixd;
+}
+
+
+/*!
+ * \brief   pushdecGetPix()
+ *
+ * \param[in]    pd
+ * \return  pix the decoded image, or NULL if it is not complete
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns a clone of the decoded image, and is only
+ *          available when the status is L_PUSHDEC_DONE.
+ * </pre>
+ */
+PIX *
+pushdecGetPix(L_PUSHDEC  *pd)
+{
+    if (!pd)
+        return (PIX *)ERROR_PTR("pd not defined", __func__, NULL);
+    if (pd->status != L_PUSHDEC_DONE)
+        return (PIX *)ERROR_PTR("image not complete", __func__, NULL);
+    return pixClone(pd->pix);
+}
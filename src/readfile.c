@@ -38,6 +38,10 @@
  *
  *      Read header information from file
  *           l_int32    pixReadHeader()
+ *           l_int32    pixReadHeaderFull()
+ *           l_int32    pixReadHeadersSA()
+ *           static l_int32  parseHeaderBmp()
+ *           static l_int32  parseHeaderGif()
  *
  *      Format finders
  *           l_int32    findFileFormat()
@@ -76,7 +80,9 @@
 #endif  /* HAVE_CONFIG_H */
 
 #include <string.h>
+#include <sys/stat.h>
 #include "allheaders.h"
+#include "bmp.h"
 
     /* Output files for ioFormatTest(). */
 static const char *FILE_BMP  =  "/tmp/lept/format/file.bmp";
@@ -103,6 +109,25 @@ static const unsigned char JP2K_IMAGE_DATA[12] = { 0x00, 0x00, 0x00, 0x0c,
                                                    0x6a, 0x50, 0x20, 0x20,
                                                    0x0d, 0x0a, 0x87, 0x0a };
 
+extern const char *ImageFileFormatExtensions[];
+
+    /* Number of bytes read from the start of a bmp, gif or webp file
+     * for parsing the header.  If the header is not found within this
+     * many bytes, the entire file is read. */
+static const size_t  HeaderProbeBytes = 16384;
+
+    /* Version of the header cache file written by pixReadHeadersSA() */
+static const l_int32  HeaderCacheVersion = 1;
+
+static l_int32 parseHeaderBmp(const l_uint8 *data, size_t size, l_int32 *pw,
+                              l_int32 *ph, l_int32 *pbps, l_int32 *pspp,
+                              l_int32 *pres, l_int32 *piscmap);
+static l_int32 parseHeaderGif(const l_uint8 *data, size_t size, l_int32 *pw,
+                              l_int32 *ph, l_int32 *pbps, l_int32 *pspp,
+                              l_int32 *piscmap);
+static l_int32 getFileSizeAndTime(const char *filename, l_int64 *psize,
+                                  l_int64 *pmtime);
+
 
 /*---------------------------------------------------------------------*
  *          Top-level functions for reading images from file           *
@@ -426,8 +451,10 @@ PIXCMAP  *cmap;
  * <pre>
  * Notes:
  *      (1) This reads the actual headers for jpeg, png, tiff and pnm.
- *          For bmp and gif, we cheat and read the entire file into a pix,
- *          from which we extract the "header" information.
+ *          For bmp and gif, the header is parsed from the first few KB
+ *          of the file; the image data is not decoded.
+ *      (2) See pixReadHeaderFull() to also get the resolution and
+ *          the number of pages.
  * </pre>
  */
 l_ok
@@ -439,51 +466,108 @@ pixReadHeader(const char  *filename,
               l_int32     *pspp,
               l_int32     *piscmap)
 {
-l_int32  format, ret, w, h, d, bps, spp, iscmap;
-l_int32  type;  /* ignored */
-FILE    *fp;
-PIX     *pix;
+    return pixReadHeaderFull(filename, pformat, pw, ph, pbps, pspp,
+                             NULL, NULL, piscmap);
+}
+
+
+/*!
+ * \brief   pixReadHeaderFull()
+ *
+ * \param[in]    filename    with full pathname or in local directory
+ * \param[out]   pformat     [optional] file format
+ * \param[out]   pw, ph      [optional] width and height
+ * \param[out]   pbps        [optional] bits/sample
+ * \param[out]   pspp        [optional] samples/pixel 1, 3 or 4
+ * \param[out]   pres        [optional] x resolution in ppi; 0 if unknown
+ * \param[out]   pnpages     [optional] number of images in the file
+ * \param[out]   piscmap     [optional] 1 if cmap exists; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The file is opened once, and only the header data is read.
+ *          For jpeg, png, tiff, pnm, jp2k and spix, the codec header
+ *          readers are used on the stream.  For bmp, gif and webp, the
+ *          first HeaderProbeBytes are read and parsed.
+ *      (2) The page count is walked through the tiff IFDs without
+ *          reading any image data.  It is 1 for all other formats.
+ *      (3) The resolution is requested from the codec only if %pres
+ *          is defined.  It is not available for gif, webp, pnm or spix.
+ * </pre>
+ */
+l_ok
+pixReadHeaderFull(const char  *filename,
+                  l_int32     *pformat,
+                  l_int32     *pw,
+                  l_int32     *ph,
+                  l_int32     *pbps,
+                  l_int32     *pspp,
+                  l_int32     *pres,
+                  l_int32     *pnpages,
+                  l_int32     *piscmap)
+{
+l_uint8  *data;
+l_int32   format, ret, w, h, d, bps, spp, res, yres, npages, iscmap;
+l_int32   type;  /* ignored */
+size_t    size;
+FILE     *fp;
 
     if (pw) *pw = 0;
     if (ph) *ph = 0;
     if (pbps) *pbps = 0;
     if (pspp) *pspp = 0;
+    if (pres) *pres = 0;
+    if (pnpages) *pnpages = 0;
     if (piscmap) *piscmap = 0;
     if (pformat) *pformat = 0;
     iscmap = 0;  /* init to false */
+    res = 0;
+    npages = 1;
     if (!filename)
         return ERROR_INT("filename not defined", __func__, 1);
 
     if ((fp = fopenReadStream(filename)) == NULL)
         return ERROR_INT_1("image file not found", filename, __func__, 1);
     findFileFormatStream(fp, &format);
-    fclose(fp);
 
+    ret = 0;
     switch (format)
     {
-    case IFF_BMP:  /* cheating: reading the entire file */
-        if ((pix = pixRead(filename)) == NULL)
-            return ERROR_INT_1( "bmp: pix not read", filename, __func__, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        bps = (d == 32) ? 8 : d;
-        spp = pixGetSpp(pix);
-        iscmap = (pixGetColormap(pix)) ? 1 : 0;
-        pixDestroy(&pix);
+    case IFF_BMP:
+    case IFF_GIF:
+    case IFF_WEBP:
+        data = l_binaryReadSelectStream(fp, 0, HeaderProbeBytes, &size);
+        if (format == IFF_BMP) {
+            ret = parseHeaderBmp(data, size, &w, &h, &bps, &spp, &res,
+                                 &iscmap);
+        } else if (format == IFF_GIF) {
+            ret = parseHeaderGif(data, size, &w, &h, &bps, &spp, &iscmap);
+            if (ret && size == HeaderProbeBytes) {  /* try the whole file */
+                LEPT_FREE(data);
+                data = l_binaryReadStream(fp, &size);
+                ret = parseHeaderGif(data, size, &w, &h, &bps, &spp,
+                                     &iscmap);
+            }
+        } else {  /* IFF_WEBP */
+            ret = readHeaderMemWebP(data, size, &w, &h, &spp);
+            bps = 8;
+        }
+        LEPT_FREE(data);
         break;
 
     case IFF_JFIF_JPEG:
-        ret = readHeaderJpeg(filename, &w, &h, &spp, NULL, NULL);
+        ret = freadHeaderJpeg(fp, &w, &h, &spp, NULL, NULL);
         bps = 8;
-        if (ret)
-            return ERROR_INT_1("jpeg: no header info returned",
-                               filename, __func__, 1);
+        if (!ret && pres)
+            fgetJpegResolution(fp, &res, &yres);
         break;
 
     case IFF_PNG:
-        ret = readHeaderPng(filename, &w, &h, &bps, &spp, &iscmap);
-        if (ret)
-            return ERROR_INT_1("png: no header info returned",
-                               filename, __func__, 1);
+        rewind(fp);
+        ret = freadHeaderPng(fp, &w, &h, &bps, &spp, &iscmap);
+        if (!ret && pres)
+            fgetPngResolution(fp, &res, &yres);
         break;
 
     case IFF_TIFF:
@@ -495,70 +579,468 @@ PIX     *pix;
     case IFF_TIFF_ZIP:
     case IFF_TIFF_JPEG:
             /* Reading page 0 by default; possibly redefine format */
-        ret = readHeaderTiff(filename, 0, &w, &h, &bps, &spp, NULL, &iscmap,
-                             &format);
-        if (ret)
-            return ERROR_INT_1("tiff: no header info returned",
-                               filename, __func__, 1);
+        ret = freadHeaderTiff(fp, 0, &w, &h, &bps, &spp, &res, &iscmap,
+                              &format);
+        if (!ret && pnpages) {
+            rewind(fp);
+            tiffGetCount(fp, &npages);
+        }
         break;
 
     case IFF_PNM:
-        ret = readHeaderPnm(filename, &w, &h, &d, &type, &bps, &spp);
-        if (ret)
-            return ERROR_INT_1("pnm: no header info returned",
-                               filename, __func__, 1);
-        break;
-
-    case IFF_GIF:  /* cheating: reading the entire file */
-        if ((pix = pixRead(filename)) == NULL)
-            return ERROR_INT_1( "gif: pix not read", filename, __func__, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        iscmap = 1;  /* always colormapped; max 256 colors */
-        spp = 1;
-        bps = d;
+        rewind(fp);
+        ret = freadHeaderPnm(fp, &w, &h, &d, &type, &bps, &spp);
         break;
 
     case IFF_JP2:
-        ret = readHeaderJp2k(filename, &w, &h, &bps, &spp, NULL);
+        ret = freadHeaderJp2k(fp, &w, &h, &bps, &spp, NULL);
+        if (!ret && pres)
+            fgetJp2kResolution(fp, &res, &yres);
         break;
 
-    case IFF_WEBP:
-        if (readHeaderWebP(filename, &w, &h, &spp))
-            return ERROR_INT_1("webp: no header info returned",
-                               filename, __func__, 1);
-        bps = 8;
+    case IFF_SPIX:
+        rewind(fp);
+        ret = freadHeaderSpix(fp, &w, &h, &bps, &spp, &iscmap);
         break;
 
     case IFF_PS:
+        fclose(fp);
         if (pformat) *pformat = format;
         return ERROR_INT("PostScript reading is not supported\n", __func__, 1);
 
     case IFF_LPDF:
+        fclose(fp);
         if (pformat) *pformat = format;
         return ERROR_INT("Pdf reading is not supported\n", __func__, 1);
 
-    case IFF_SPIX:
-        ret = readHeaderSpix(filename, &w, &h, &bps, &spp, &iscmap);
-        if (ret)
-            return ERROR_INT_1("spix: no header info returned",
-                               filename, __func__, 1);
-        break;
-
     case IFF_UNKNOWN:
+        fclose(fp);
         return ERROR_INT_1("unknown format in file", filename, __func__, 1);
     }
+    fclose(fp);
+    if (ret) {
+        L_ERROR("%s: no header info returned from %s\n", __func__,
+                ImageFileFormatExtensions[format], filename);
+        return 1;
+    }
 
     if (pw) *pw = w;
     if (ph) *ph = h;
     if (pbps) *pbps = bps;
     if (pspp) *pspp = spp;
+    if (pres) *pres = res;
+    if (pnpages) *pnpages = npages;
     if (piscmap) *piscmap = iscmap;
     if (pformat) *pformat = format;
     return 0;
 }
 
 
+/*!
+ * \brief   pixReadHeadersSA()
+ *
+ * \param[in]    sa          full pathnames for all files
+ * \param[in]    cachefile   [optional] file for caching header data;
+ *                           use NULL to skip caching
+ * \param[out]   pnaformat   [optional] file format
+ * \param[out]   pnaw        [optional] width
+ * \param[out]   pnah        [optional] height
+ * \param[out]   pnabps      [optional] bits/sample
+ * \param[out]   pnaspp      [optional] samples/pixel
+ * \param[out]   pnares      [optional] x resolution in ppi; 0 if unknown
+ * \param[out]   pnapages    [optional] number of images in the file
+ * \param[out]   pnacmap     [optional] 1 if cmap exists; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does a header-only probe of every file in %sa, using
+ *          pixReadHeaderFull().  Each output numa has one entry for
+ *          each file, in the same order as %sa.
+ *      (2) A file that cannot be probed is not an error: a warning is
+ *          issued and all its entries are 0.  Because IFF_UNKNOWN == 0,
+ *          such files can be found in %naformat.
+ *      (3) If %cachefile is defined, it is read (if it exists) before
+ *          any file is probed.  A file whose entry in the cache has the
+ *          same byte size and modification time as the file on disk is
+ *          not opened.  The cache is then rewritten with the data for
+ *          all files in %sa, followed by the cached entries for files
+ *          that are not in %sa.
+ *      (4) The cache is a text file with one line for each image:
+ *            size mtime format w h bps spp res npages iscmap filename
+ *          where filename is the rest of the line.
+ * </pre>
+ */
+l_ok
+pixReadHeadersSA(SARRAY      *sa,
+                 const char  *cachefile,
+                 NUMA       **pnaformat,
+                 NUMA       **pnaw,
+                 NUMA       **pnah,
+                 NUMA       **pnabps,
+                 NUMA       **pnaspp,
+                 NUMA       **pnares,
+                 NUMA       **pnapages,
+                 NUMA       **pnacmap)
+{
+char        buf[128];
+char       *fname, *line, *str;
+l_uint8    *data;
+l_int32     i, j, n, ncache, index, pos, version, found;
+l_int32     format, w, h, bps, spp, res, npages, iscmap;
+l_int32    *used;
+l_int64     fsize, mtime, size1, time1;
+l_uint64    hash;
+size_t      nbytes;
+L_AMAP     *amap;
+RB_TYPE     key, value;
+RB_TYPE    *pval;
+NUMA       *naf, *naw, *nah, *nabps, *naspp, *nares, *napages, *nacmap;
+SARRAY     *sacache, *saout;
+
+    if (pnaformat) *pnaformat = NULL;
+    if (pnaw) *pnaw = NULL;
+    if (pnah) *pnah = NULL;
+    if (pnabps) *pnabps = NULL;
+    if (pnaspp) *pnaspp = NULL;
+    if (pnares) *pnares = NULL;
+    if (pnapages) *pnapages = NULL;
+    if (pnacmap) *pnacmap = NULL;
+    if (!sa)
+        return ERROR_INT("sa not defined", __func__, 1);
+    if (!pnaformat && !pnaw && !pnah && !pnabps && !pnaspp && !pnares &&
+        !pnapages && !pnacmap)
+        return ERROR_INT("no output requested", __func__, 1);
+
+        /* Read the cache, and make a map from the hashed filename
+         * to the line index in the cache */
+    sacache = NULL;
+    amap = l_amapCreate(L_UINT_TYPE);
+    if (cachefile) {
+        if (getFileSizeAndTime(cachefile, &size1, &time1) == 0) {
+            data = l_binaryRead(cachefile, &nbytes);
+            sacache = sarrayCreateLinesFromString((char *)data, 0);
+            LEPT_FREE(data);
+            line = sarrayGetString(sacache, 0, L_NOCOPY);
+            if (!line ||
+                sscanf(line, "# leptonica header cache, version %d",
+                       &version) != 1 || version != HeaderCacheVersion) {
+                L_WARNING("invalid cache file %s; ignoring\n", __func__,
+                          cachefile);
+                sarrayDestroy(&sacache);
+            }
+        }
+    }
+    if (!sacache)
+        sacache = sarrayCreate(1);
+    ncache = sarrayGetCount(sacache);
+    for (i = 1; i < ncache; i++) {
+        line = sarrayGetString(sacache, i, L_NOCOPY);
+        if (sscanf(line, "%lld %lld %d %d %d %d %d %d %d %d %n",
+                   &size1, &time1, &format, &w, &h, &bps, &spp, &res,
+                   &npages, &iscmap, &pos) != 10)
+            continue;
+        l_hashStringToUint64(line + pos, &hash);
+        key.utype = hash;
+        value.itype = i;
+        l_amapInsert(amap, key, value);
+    }
+    used = (l_int32 *)LEPT_CALLOC(L_MAX(1, ncache), sizeof(l_int32));
+
+    n = sarrayGetCount(sa);
+    naf = numaCreate(n);
+    naw = numaCreate(n);
+    nah = numaCreate(n);
+    nabps = numaCreate(n);
+    naspp = numaCreate(n);
+    nares = numaCreate(n);
+    napages = numaCreate(n);
+    nacmap = numaCreate(n);
+    saout = sarrayCreate(n + ncache);
+    snprintf(buf, sizeof(buf), "# leptonica header cache, version %d",
+             HeaderCacheVersion);
+    sarrayAddString(saout, buf, L_COPY);
+    for (i = 0; i < n; i++) {
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        fsize = mtime = -1;
+        getFileSizeAndTime(fname, &fsize, &mtime);
+
+            /* Look for an entry in the cache that is still valid.
+             * Any entry for this file is replaced in the new cache. */
+        found = FALSE;
+        l_hashStringToUint64(fname, &hash);
+        key.utype = hash;
+        if ((pval = l_amapFind(amap, key)) != NULL) {
+            index = pval->itype;
+            line = sarrayGetString(sacache, index, L_NOCOPY);
+            sscanf(line, "%lld %lld %d %d %d %d %d %d %d %d %n",
+                   &size1, &time1, &format, &w, &h, &bps, &spp, &res,
+                   &npages, &iscmap, &pos);
+            if (!strcmp(line + pos, fname)) {
+                used[index] = 1;
+                if (size1 == fsize && time1 == mtime)
+                    found = TRUE;
+            }
+        }
+
+            /* Otherwise, probe the file */
+        if (!found) {
+            if (pixReadHeaderFull(fname, &format, &w, &h, &bps, &spp,
+                                  &res, &npages, &iscmap)) {
+                L_WARNING("header not read from file %s\n", __func__, fname);
+                format = w = h = bps = spp = res = npages = iscmap = 0;
+            }
+        }
+        numaAddNumber(naf, format);
+        numaAddNumber(naw, w);
+        numaAddNumber(nah, h);
+        numaAddNumber(nabps, bps);
+        numaAddNumber(naspp, spp);
+        numaAddNumber(nares, res);
+        numaAddNumber(napages, npages);
+        numaAddNumber(nacmap, iscmap);
+        if (format != IFF_UNKNOWN && fsize >= 0) {
+            snprintf(buf, sizeof(buf), "%lld %lld %d %d %d %d %d %d %d %d ",
+                     fsize, mtime, format, w, h, bps, spp, res, npages,
+                     iscmap);
+            sarrayAddString(saout, stringJoin(buf, fname), L_INSERT);
+        }
+    }
+
+        /* Rewrite the cache, retaining the entries not used here */
+    if (cachefile) {
+        for (j = 1; j < ncache; j++) {
+            if (used[j]) continue;
+            line = sarrayGetString(sacache, j, L_NOCOPY);
+            if (line[0] != '\0')
+                sarrayAddString(saout, line, L_COPY);
+        }
+        str = sarrayToString(saout, 1);
+        l_binaryWrite(cachefile, "w", str, strlen(str));
+        LEPT_FREE(str);
+    }
+
+    if (pnaformat) *pnaformat = naf; else numaDestroy(&naf);
+    if (pnaw) *pnaw = naw; else numaDestroy(&naw);
+    if (pnah) *pnah = nah; else numaDestroy(&nah);
+    if (pnabps) *pnabps = nabps; else numaDestroy(&nabps);
+    if (pnaspp) *pnaspp = naspp; else numaDestroy(&naspp);
+    if (pnares) *pnares = nares; else numaDestroy(&nares);
+    if (pnapages) *pnapages = napages; else numaDestroy(&napages);
+    if (pnacmap) *pnacmap = nacmap; else numaDestroy(&nacmap);
+    LEPT_FREE(used);
+    l_amapDestroy(&amap);
+    sarrayDestroy(&sacache);
+    sarrayDestroy(&saout);
+    return 0;
+}
+
+
+/*!
+ * \brief   parseHeaderBmp()
+ *
+ * \param[in]    data      beginning of bmp file data
+ * \param[in]    size      number of bytes in %data
+ * \param[out]   pw, ph    width and height
+ * \param[out]   pbps      bits/sample
+ * \param[out]   pspp      samples/pixel
+ * \param[out]   pres      x resolution in ppi
+ * \param[out]   piscmap   1 if cmap exists; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This parses the file header and the first 40 bytes of the
+ *          info header, and returns the same values that would be
+ *          found in the pix made by pixReadMemBmp().
+ *      (2) pixReadMemBmp() removes the colormap from a 1 bpp image,
+ *          as in pixRemoveColormap() with REMOVE_CMAP_BASED_ON_SRC.
+ *          The colors are taken to be opaque, so the pix is 1 bpp if
+ *          the colormap is black and white, 32 bpp rgb if it has color,
+ *          and 8 bpp gray otherwise.  The two colormap entries are
+ *          read to find which, and %iscmap is 0.
+ * </pre>
+ */
+static l_int32
+parseHeaderBmp(const l_uint8  *data,
+               size_t          size,
+               l_int32        *pw,
+               l_int32        *ph,
+               l_int32        *pbps,
+               l_int32        *pspp,
+               l_int32        *pres,
+               l_int32        *piscmap)
+{
+l_int32         offset, ihbytes, w, h, depth, compression, xres, ncolors;
+l_int32         i, hascolor, blackwhite;
+const l_uint8  *cta;
+
+    if (!data || size < BMP_FHBYTES + BMP_IHBYTES)
+        return ERROR_INT("bmp header data too small", __func__, 1);
+    if (data[0] != 'B' || data[1] != 'M')
+        return ERROR_INT("not bmp format", __func__, 1);
+
+    offset = data[10] | (data[11] << 8) | (data[12] << 16) |
+             ((l_uint32)data[13] << 24);
+    ihbytes = data[14] | (data[15] << 8) | (data[16] << 16) |
+              ((l_uint32)data[17] << 24);
+    w = data[18] | (data[19] << 8) | (data[20] << 16) |
+        ((l_uint32)data[21] << 24);
+    h = data[22] | (data[23] << 8) | (data[24] << 16) |
+        ((l_uint32)data[25] << 24);
+    depth = data[28] | (data[29] << 8);
+    compression = data[30] | (data[31] << 8) | (data[32] << 16) |
+                  ((l_uint32)data[33] << 24);
+    xres = data[38] | (data[39] << 8) | (data[40] << 16) |
+           ((l_uint32)data[41] << 24);
+    if (h < 0) h = -h;
+    if (compression != 0)
+        return ERROR_INT("cannot read compressed BMP files", __func__, 1);
+    if (ihbytes != 40 && ihbytes != 108 && ihbytes != 124)
+        return ERROR_INT("invalid ihbytes", __func__, 1);
+    if (w < 1 || h < 1)
+        return ERROR_INT("invalid image dimensions", __func__, 1);
+    if (depth != 1 && depth != 2 && depth != 4 && depth != 8 &&
+        depth != 16 && depth != 24 && depth != 32)
+        return ERROR_INT("invalid depth", __func__, 1);
+    ncolors = (offset - (l_int32)BMP_FHBYTES - ihbytes) / 4;  /* RGBA_QUAD */
+
+    *pw = w;
+    *ph = h;
+    *pbps = (depth >= 24) ? 8 : depth;
+    if (depth <= 16)
+        *pspp = 1;
+    else if (depth == 24)
+        *pspp = 3;
+    else  /* depth == 32 */
+        *pspp = 4;
+    *pres = (xres > 0) ? (l_int32)((l_float32)xres / 39.37 + 0.5) : 0;
+    *piscmap = (ncolors > 0 && depth <= 8) ? 1 : 0;
+
+        /* The colormap of a 1 bpp image is removed when it is read */
+    if (depth == 1 && ncolors > 0) {
+        if (size < BMP_FHBYTES + ihbytes + 2 * 4)
+            return ERROR_INT("bmp colormap not in data", __func__, 1);
+        cta = data + BMP_FHBYTES + ihbytes;  /* b, g, r, a for each color */
+        hascolor = FALSE;
+        for (i = 0; i < 2; i++) {
+            if (cta[4 * i] != cta[4 * i + 1] || cta[4 * i] != cta[4 * i + 2])
+                hascolor = TRUE;
+        }
+        blackwhite = (cta[2] == 0 && cta[6] == 255) ||
+                     (cta[2] == 255 && cta[6] == 0);
+        if (hascolor) {
+            *pbps = 8;
+            *pspp = 3;
+        } else if (!blackwhite) {
+            *pbps = 8;
+        }
+        *piscmap = 0;
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   parseHeaderGif()
+ *
+ * \param[in]    data      beginning of gif file data
+ * \param[in]    size      number of bytes in %data
+ * \param[out]   pw, ph    width and height of the first image
+ * \param[out]   pbps      bits/sample
+ * \param[out]   pspp      samples/pixel; always 1
+ * \param[out]   piscmap   always 1
+ * \return  0 if OK, 1 on error or if the first image descriptor is
+ *              not found in %data
+ *
+ * <pre>
+ * Notes:
+ *      (1) This skips the global color table and any extension blocks
+ *          to get to the first image descriptor.  As in gifToPix(), the
+ *          depth is determined by the size of the local color table,
+ *          if it exists, and otherwise by the global color table.
+ * </pre>
+ */
+static l_int32
+parseHeaderGif(const l_uint8  *data,
+               size_t          size,
+               l_int32        *pw,
+               l_int32        *ph,
+               l_int32        *pbps,
+               l_int32        *pspp,
+               l_int32        *piscmap)
+{
+l_int32  ncolors, bits;
+size_t   pos;
+
+    if (!data || size < 13)
+        return ERROR_INT("gif header data too small", __func__, 1);
+    if (strncmp((const char *)data, "GIF8", 4) != 0)
+        return ERROR_INT("not gif format", __func__, 1);
+
+        /* Logical screen descriptor, followed by the global color table */
+    ncolors = (data[10] & 0x80) ? 1 << ((data[10] & 0x07) + 1) : 0;
+    pos = 13 + 3 * ncolors;
+
+        /* Skip extension blocks up to the first image descriptor */
+    while (pos < size && data[pos] == 0x21) {
+        pos += 2;  /* introducer and label */
+        while (pos < size && data[pos] != 0)
+            pos += data[pos] + 1;
+        pos++;  /* block terminator */
+    }
+    if (pos + 10 > size || data[pos] != 0x2c)
+        return 1;  /* not found here; not necessarily an error */
+
+    *pw = data[pos + 5] | (data[pos + 6] << 8);
+    *ph = data[pos + 7] | (data[pos + 8] << 8);
+    if (data[pos + 9] & 0x80)  /* local color table */
+        ncolors = 1 << ((data[pos + 9] & 0x07) + 1);
+    if (*pw <= 0 || *ph <= 0 || ncolors == 0)
+        return ERROR_INT("invalid gif image descriptor", __func__, 1);
+    if (ncolors <= 2)
+        bits = 1;
+    else if (ncolors <= 4)
+        bits = 2;
+    else if (ncolors <= 16)
+        bits = 4;
+    else
+        bits = 8;
+    *pbps = bits;
+    *pspp = 1;
+    *piscmap = 1;
+    return 0;
+}
+
+
+/*!
+ * \brief   getFileSizeAndTime()
+ *
+ * \param[in]    filename
+ * \param[out]   psize     size of file in bytes
+ * \param[out]   pmtime    time of last modification
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+getFileSizeAndTime(const char  *filename,
+                   l_int64     *psize,
+                   l_int64     *pmtime)
+{
+char        *realname;
+l_int32      ret;
+struct stat  st;
+
+    realname = genPathname(filename, NULL);
+    ret = stat(realname, &st);
+    LEPT_FREE(realname);
+    if (ret != 0)
+        return 1;
+    *psize = (l_int64)st.st_size;
+    *pmtime = (l_int64)st.st_mtime;
+    return 0;
+}
+
+
 /*---------------------------------------------------------------------*
  *                            Format finders                           *
  *---------------------------------------------------------------------*/
@@ -938,8 +1420,7 @@ PIXCMAP  *cmap;
  * <pre>
  * Notes:
  *      (1) This reads the actual headers for jpeg, png, tiff, jp2k and pnm.
- *          For bmp and gif, we cheat and read all the data into a pix,
- *          from which we extract the "header" information.
+ *          For bmp and gif, the header fields are parsed directly.
  *      (2) The amount of data required depends on the format.  For
  *          png, it requires less than 30 bytes, but for jpeg it can
  *          require most of the compressed file.  In practice, the data
@@ -958,9 +1439,8 @@ pixReadHeaderMem(const l_uint8  *data,
                  l_int32        *pspp,
                  l_int32        *piscmap)
 {
-l_int32  format, ret, w, h, d, bps, spp, iscmap;
+l_int32  format, ret, w, h, d, bps, spp, res, iscmap;
 l_int32  type;  /* not used */
-PIX     *pix;
 
     if (pw) *pw = 0;
     if (ph) *ph = 0;
@@ -978,13 +1458,10 @@ PIX     *pix;
 
     switch (format)
     {
-    case IFF_BMP:  /* cheating: read the pix */
-        if ((pix = pixReadMemBmp(data, size)) == NULL)
-            return ERROR_INT( "bmp: pix not read", __func__, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        bps = (d == 32) ? 8 : d;
-        spp = (d == 32) ? 3 : 1;
+    case IFF_BMP:
+        ret = parseHeaderBmp(data, size, &w, &h, &bps, &spp, &res, &iscmap);
+        if (ret)
+            return ERROR_INT( "bmp: no header info returned", __func__, 1);
         break;
 
     case IFF_JFIF_JPEG:
@@ -1021,14 +1498,10 @@ PIX     *pix;
             return ERROR_INT( "pnm: no header info returned", __func__, 1);
         break;
 
-    case IFF_GIF:  /* cheating: read the pix */
-        if ((pix = pixReadMemGif(data, size)) == NULL)
-            return ERROR_INT( "gif: pix not read", __func__, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        iscmap = 1;  /* always colormapped; max 256 colors */
-        spp = 1;
-        bps = d;
+    case IFF_GIF:
+        ret = parseHeaderGif(data, size, &w, &h, &bps, &spp, &iscmap);
+        if (ret)
+            return ERROR_INT( "gif: no header info returned", __func__, 1);
         break;
 
     case IFF_JP2:
@@ -1072,7 +1545,6 @@ PIX     *pix;
 /*---------------------------------------------------------------------*
  *                    Output image file information                    *
  *---------------------------------------------------------------------*/
-extern const char *ImageFileFormatExtensions[];
 
 /*!
  * \brief   writeImageFileInfo()
@@ -0,0 +1,821 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+
+/*!
+ * \file remap.c
+ * <pre>
+ *
+ *      Create/destroy
+ *           L_REMAP    *remapCreate()
+ *           void        remapDestroy()
+ *
+ *      Generating remaps from transforms
+ *           L_REMAP    *remapCreateAffine()
+ *           L_REMAP    *remapCreateBilinear()
+ *           L_REMAP    *remapCreateProjective()
+ *           static L_REMAP  *remapCreateFromXform()
+ *           L_REMAP    *remapCreateFromDewarp()
+ *           L_REMAP    *remapCompose()
+ *
+ *      Accessors
+ *           l_int32     remapGetDimensions()
+ *           l_int32     remapGetMaps()
+ *
+ *      Applying a remap to an image
+ *           PIX        *pixRemap()
+ *           static PIX *pixRemapSampled()
+ *
+ *      Static helpers
+ *           static l_int32    remapMakeLocations()
+ *           static l_float32  interpolateFloat()
+ *
+ *    The affine, bilinear and projective image transforms and the
+ *    dewarping functions compute the src location of every dest pixel
+ *    each time they are called.  When the same geometric correction is
+ *    to be applied to many images of the same size, such as frames
+ *    from a fixed camera, the src locations can be computed once and
+ *    stored in an L_REMAP.
+ *
+ *    The remap holds the src location of each dest pixel in two fpix,
+ *    one for x and one for y.  These can be made from any of the
+ *    transforms, from a dewarp model, or supplied directly.  Two remaps
+ *    can be composed into one, so that a sequence of corrections is
+ *    applied with a single resampling.  The locations are also kept in
+ *    a compact fixed point form, in units of 1/16 pixel, with locations
+ *    outside the src marked invalid, so that pixRemap() has no transform
+ *    arithmetic or bounds checking to do.  Interpolation is the same as
+ *    in pixAffine() and the other transforms.
+ *
+ *    A remap is not modified by pixRemap(), so it can be shared by
+ *    threads that are each remapping different images.
+ *
+ *    Typical use, with %vc the coefficients of the transform from dest
+ *    to src, as used by pixProjective():
+ *        L_REMAP *remap = remapCreateProjective(vc, w, h, w, h);
+ *        for (i = 0; i < n; i++) {
+ *            PIX *pixs = pixaGetPix(pixa, i, L_CLONE);
+ *            PIX *pixd = pixRemap(pixs, remap, L_INTERPOLATED,
+ *                                 L_BRING_IN_WHITE);
+ *            ...
+ *        }
+ *        remapDestroy(&remap);
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <string.h>
+#include "allheaders.h"
+#include "pix_internal.h"
+
+    /* Transforms that can be used to generate a remap */
+enum {
+    L_REMAP_AFFINE = 1,
+    L_REMAP_BILINEAR = 2,
+    L_REMAP_PROJECTIVE = 3
+};
+
+static L_REMAP *remapCreateFromXform(l_float32 *vc, l_int32 type, l_int32 w,
+                                     l_int32 h, l_int32 ws, l_int32 hs);
+static PIX *pixRemapSampled(PIX *pixs, L_REMAP *remap, l_int32 incolor);
+static l_int32 remapMakeLocations(L_REMAP *remap);
+static l_float32 interpolateFloat(l_float32 *data, l_int32 wpl, l_int32 w,
+                                  l_int32 h, l_float32 x, l_float32 y);
+
+
+/*--------------------------------------------------------------------------*
+ *                              Create/destroy                              *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   remapCreate()
+ *
+ * \param[in]    fpixx    src x location for each dest pixel
+ * \param[in]    fpixy    src y location for each dest pixel
+ * \param[in]    ws, hs   size of the src images to be remapped
+ * \return  remap, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) %fpixx and %fpixy must be the same size, which is the size
+ *          of the dest.  The remap holds clones of them.
+ *      (2) Dest pixels whose src location is outside the src, of size
+ *          %ws x %hs, are brought in from outside by pixRemap().
+ * </pre>
+ */
+L_REMAP *
+remapCreate(FPIX    *fpixx,
+            FPIX    *fpixy,
+            l_int32  ws,
+            l_int32  hs)
+{
+l_int32   w, h, wy, hy;
+L_REMAP  *remap;
+
+    if (!fpixx || !fpixy)
+        return (L_REMAP *)ERROR_PTR("fpixx and fpixy not both defined",
+                                    __func__, NULL);
+    if (ws < 1 || hs < 1)
+        return (L_REMAP *)ERROR_PTR("invalid src size", __func__, NULL);
+    fpixGetDimensions(fpixx, &w, &h);
+    fpixGetDimensions(fpixy, &wy, &hy);
+    if (w != wy || h != hy)
+        return (L_REMAP *)ERROR_PTR("fpix sizes differ", __func__, NULL);
+
+    remap = (L_REMAP *)LEPT_CALLOC(1, sizeof(L_REMAP));
+    remap->w = w;
+    remap->h = h;
+    remap->ws = ws;
+    remap->hs = hs;
+    remap->fpixx = fpixClone(fpixx);
+    remap->fpixy = fpixClone(fpixy);
+    if (remapMakeLocations(remap)) {
+        remapDestroy(&remap);
+        return (L_REMAP *)ERROR_PTR("locations not made", __func__, NULL);
+    }
+    return remap;
+}
+
+
+/*!
+ * \brief   remapDestroy()
+ *
+ * \param[in,out]   premap    will be set to null before returning
+ * \return  void
+ */
+void
+remapDestroy(L_REMAP  **premap)
+{
+L_REMAP  *remap;
+
+    if (premap == NULL) {
+        L_WARNING("ptr address is null!\n", __func__);
+        return;
+    }
+    if ((remap = *premap) == NULL)
+        return;
+
+    fpixDestroy(&remap->fpixx);
+    fpixDestroy(&remap->fpixy);
+    LEPT_FREE(remap->xloc);
+    LEPT_FREE(remap->yloc);
+    LEPT_FREE(remap);
+    *premap = NULL;
+}
+
+
+/*--------------------------------------------------------------------------*
+ *                    Generating remaps from transforms                     *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   remapCreateAffine()
+ *
+ * \param[in]    vc       vector of 6 coefficients for the affine
+ *                        transform from dest to src
+ * \param[in]    w, h     size of dest
+ * \param[in]    ws, hs   size of src
+ * \return  remap, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) With %vc from getAffineXformCoeffs(ptad, ptas, &vc), and
+ *          the dest the same size as the src, pixRemap() gives the
+ *          same result as pixAffine().
+ * </pre>
+ */
+L_REMAP *
+remapCreateAffine(l_float32  *vc,
+                  l_int32     w,
+                  l_int32     h,
+                  l_int32     ws,
+                  l_int32     hs)
+{
+    return remapCreateFromXform(vc, L_REMAP_AFFINE, w, h, ws, hs);
+}
+
+
+/*!
+ * \brief   remapCreateBilinear()
+ *
+ * \param[in]    vc       vector of 8 coefficients for the bilinear
+ *                        transform from dest to src
+ * \param[in]    w, h     size of dest
+ * \param[in]    ws, hs   size of src
+ * \return  remap, or NULL on error
+ */
+L_REMAP *
+remapCreateBilinear(l_float32  *vc,
+                    l_int32     w,
+                    l_int32     h,
+                    l_int32     ws,
+                    l_int32     hs)
+{
+    return remapCreateFromXform(vc, L_REMAP_BILINEAR, w, h, ws, hs);
+}
+
+
+/*!
+ * \brief   remapCreateProjective()
+ *
+ * \param[in]    vc       vector of 8 coefficients for the projective
+ *                        transform from dest to src
+ * \param[in]    w, h     size of dest
+ * \param[in]    ws, hs   size of src
+ * \return  remap, or NULL on error
+ */
+L_REMAP *
+remapCreateProjective(l_float32  *vc,
+                      l_int32     w,
+                      l_int32     h,
+                      l_int32     ws,
+                      l_int32     hs)
+{
+    return remapCreateFromXform(vc, L_REMAP_PROJECTIVE, w, h, ws, hs);
+}
+
+
+/*!
+ * \brief   remapCreateFromXform()
+ *
+ * \param[in]    vc       vector of coefficients for the transform
+ *                        from dest to src
+ * \param[in]    type     L_REMAP_AFFINE, L_REMAP_BILINEAR or
+ *                        L_REMAP_PROJECTIVE
+ * \param[in]    w, h     size of dest
+ * \param[in]    ws, hs   size of src
+ * \return  remap, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The src locations are computed in double precision.  Where
+ *          the projective transform is singular, the location is
+ *          set outside the src.
+ * </pre>
+ */
+static L_REMAP *
+remapCreateFromXform(l_float32  *vc,
+                     l_int32     type,
+                     l_int32     w,
+                     l_int32     h,
+                     l_int32     ws,
+                     l_int32     hs)
+{
+l_int32     i, j;
+l_float32  *linex, *liney;
+l_float64   x, y, denom;
+FPIX       *fpixx, *fpixy;
+L_REMAP    *remap;
+
+    if (!vc)
+        return (L_REMAP *)ERROR_PTR("vc not defined", __func__, NULL);
+    if (w < 1 || h < 1)
+        return (L_REMAP *)ERROR_PTR("invalid dest size", __func__, NULL);
+
+    if ((fpixx = fpixCreate(w, h)) == NULL)
+        return (L_REMAP *)ERROR_PTR("fpixx not made", __func__, NULL);
+    if ((fpixy = fpixCreate(w, h)) == NULL) {
+        fpixDestroy(&fpixx);
+        return (L_REMAP *)ERROR_PTR("fpixy not made", __func__, NULL);
+    }
+    for (i = 0; i < h; i++) {
+        linex = fpixGetData(fpixx) + i * w;
+        liney = fpixGetData(fpixy) + i * w;
+        for (j = 0; j < w; j++) {
+            if (type == L_REMAP_AFFINE) {
+                x = (l_float64)vc[0] * j + (l_float64)vc[1] * i + vc[2];
+                y = (l_float64)vc[3] * j + (l_float64)vc[4] * i + vc[5];
+            } else if (type == L_REMAP_BILINEAR) {
+                x = (l_float64)vc[0] * j + (l_float64)vc[1] * i +
+                    (l_float64)vc[2] * j * i + vc[3];
+                y = (l_float64)vc[4] * j + (l_float64)vc[5] * i +
+                    (l_float64)vc[6] * j * i + vc[7];
+            } else {  /* L_REMAP_PROJECTIVE */
+                denom = (l_float64)vc[6] * j + (l_float64)vc[7] * i + 1.0;
+                if (denom == 0.0) {
+                    x = y = -1.0;
+                } else {
+                    x = ((l_float64)vc[0] * j + (l_float64)vc[1] * i +
+                         vc[2]) / denom;
+                    y = ((l_float64)vc[3] * j + (l_float64)vc[4] * i +
+                         vc[5]) / denom;
+                }
+            }
+            linex[j] = (l_float32)x;
+            liney[j] = (l_float32)y;
+        }
+    }
+
+    remap = remapCreate(fpixx, fpixy, ws, hs);
+    fpixDestroy(&fpixx);
+    fpixDestroy(&fpixy);
+    return remap;
+}
+
+
+/*!
+ * \brief   remapCreateFromDewarp()
+ *
+ * \param[in]    dew        with a valid vertical disparity model
+ * \param[in]    w, h       size of the images to be dewarped
+ * \param[in]    x, y       origin for generation of disparity arrays;
+ *                          see dewarpaApplyDisparity()
+ * \param[in]    usehoriz   1 to also correct horizontal disparity,
+ *                          if the model has a valid horizontal array
+ * \return  remap, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This makes a remap that does the vertical and (optionally)
+ *          horizontal disparity corrections of dewarpaApplyDisparity()
+ *          in one step.  The dest and src are both of size %w x %h.
+ *      (2) The full resolution disparity arrays are generated in %dew
+ *          if necessary.  They are not needed after the remap is made,
+ *          and can be removed with dewarpMinimize().
+ *      (3) The vertical correction is applied first, so the horizontal
+ *          disparity is used to find the location in the vertically
+ *          corrected image, and the vertical disparity is interpolated
+ *          at that location.
+ * </pre>
+ */
+L_REMAP *
+remapCreateFromDewarp(L_DEWARP  *dew,
+                      l_int32    w,
+                      l_int32    h,
+                      l_int32    x,
+                      l_int32    y,
+                      l_int32    usehoriz)
+{
+l_int32     i, j, fw, fh;
+l_int32     fwh, fhh;
+l_float32   xs;
+l_float32  *datav, *datah, *linex, *liney;
+FPIX       *fpixx, *fpixy;
+L_REMAP    *remap;
+PIX        *pix;
+
+    if (!dew)
+        return (L_REMAP *)ERROR_PTR("dew not defined", __func__, NULL);
+    if (w < 1 || h < 1)
+        return (L_REMAP *)ERROR_PTR("invalid size", __func__, NULL);
+    if (!dew->vvalid)
+        return (L_REMAP *)ERROR_PTR("no valid vertical model", __func__, NULL);
+
+        /* The header is only used for its size */
+    pix = pixCreateHeader(w, h, 1);
+    dewarpPopulateFullRes(dew, pix, x, y);
+    pixDestroy(&pix);
+    if (!dew->fullvdispar)
+        return (L_REMAP *)ERROR_PTR("fullvdispar not made", __func__, NULL);
+    fpixGetDimensions(dew->fullvdispar, &fw, &fh);
+    if (fw < w || fh < h)
+        return (L_REMAP *)ERROR_PTR("invalid fpix size", __func__, NULL);
+    datav = fpixGetData(dew->fullvdispar);
+    datah = NULL;
+    fwh = 0;
+    if (usehoriz && dew->hsuccess && dew->hvalid && dew->fullhdispar) {
+        fpixGetDimensions(dew->fullhdispar, &fwh, &fhh);
+        if (fwh >= w && fhh >= h)
+            datah = fpixGetData(dew->fullhdispar);
+    }
+
+    fpixx = fpixCreate(w, h);
+    fpixy = fpixCreate(w, h);
+    for (i = 0; i < h; i++) {
+        linex = fpixGetData(fpixx) + i * w;
+        liney = fpixGetData(fpixy) + i * w;
+        for (j = 0; j < w; j++) {
+            xs = (datah) ? j - datah[i * fwh + j] : j;
+            linex[j] = xs;
+            liney[j] = i - interpolateFloat(datav, fw, fw, fh,
+                                            L_MIN(L_MAX(xs, 0.0), fw - 1), i);
+        }
+    }
+
+    remap = remapCreate(fpixx, fpixy, w, h);
+    fpixDestroy(&fpixx);
+    fpixDestroy(&fpixy);
+    return remap;
+}
+
+
+/*!
+ * \brief   remapCompose()
+ *
+ * \param[in]    remap1    applied first
+ * \param[in]    remap2    applied second
+ * \return  remap that does both, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The dest of %remap1 is the src of %remap2, so they must
+ *          have the same size.  The result has the src of %remap1
+ *          and the dest of %remap2.
+ *      (2) For each dest pixel, the src location in %remap2 is used to
+ *          interpolate the src location in %remap1.  Applying the result
+ *          resamples the image once, rather than twice.
+ * </pre>
+ */
+L_REMAP *
+remapCompose(L_REMAP  *remap1,
+             L_REMAP  *remap2)
+{
+l_int32     i, j, w1, h1, w, h;
+l_float32   xs, ys;
+l_float32  *datax1, *datay1, *datax2, *datay2, *linex, *liney;
+FPIX       *fpixx, *fpixy;
+L_REMAP    *remap;
+
+    if (!remap1 || !remap2)
+        return (L_REMAP *)ERROR_PTR("remap1 and remap2 not both defined",
+                                    __func__, NULL);
+    w1 = remap1->w;
+    h1 = remap1->h;
+    if (remap2->ws != w1 || remap2->hs != h1)
+        return (L_REMAP *)ERROR_PTR("remap sizes don't match", __func__, NULL);
+
+    w = remap2->w;
+    h = remap2->h;
+    datax1 = fpixGetData(remap1->fpixx);
+    datay1 = fpixGetData(remap1->fpixy);
+    datax2 = fpixGetData(remap2->fpixx);
+    datay2 = fpixGetData(remap2->fpixy);
+    fpixx = fpixCreate(w, h);
+    fpixy = fpixCreate(w, h);
+    for (i = 0; i < h; i++) {
+        linex = fpixGetData(fpixx) + i * w;
+        liney = fpixGetData(fpixy) + i * w;
+        for (j = 0; j < w; j++) {
+            xs = datax2[i * w + j];
+            ys = datay2[i * w + j];
+            if (xs >= 0.0 && ys >= 0.0 && xs < w1 && ys < h1) {
+                linex[j] = interpolateFloat(datax1, w1, w1, h1, xs, ys);
+                liney[j] = interpolateFloat(datay1, w1, w1, h1, xs, ys);
+            } else {
+                linex[j] = liney[j] = -1.0;
+            }
+        }
+    }
+
+    remap = remapCreate(fpixx, fpixy, remap1->ws, remap1->hs);
+    fpixDestroy(&fpixx);
+    fpixDestroy(&fpixy);
+    return remap;
+}
+
+
+/*--------------------------------------------------------------------------*
+ *                                Accessors                                 *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   remapGetDimensions()
+ *
+ * \param[in]    remap
+ * \param[out]   pw, ph     [optional] size of dest
+ * \param[out]   pws, phs   [optional] size of src
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+remapGetDimensions(L_REMAP  *remap,
+                   l_int32  *pw,
+                   l_int32  *ph,
+                   l_int32  *pws,
+                   l_int32  *phs)
+{
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pws) *pws = 0;
+    if (phs) *phs = 0;
+    if (!remap)
+        return ERROR_INT("remap not defined", __func__, 1);
+
+    if (pw) *pw = remap->w;
+    if (ph) *ph = remap->h;
+    if (pws) *pws = remap->ws;
+    if (phs) *phs = remap->hs;
+    return 0;
+}
+
+
+/*!
+ * \brief   remapGetMaps()
+ *
+ * \param[in]    remap
+ * \param[out]   pfpixx   [optional] clone of the src x locations
+ * \param[out]   pfpixy   [optional] clone of the src y locations
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+remapGetMaps(L_REMAP  *remap,
+             FPIX    **pfpixx,
+             FPIX    **pfpixy)
+{
+    if (pfpixx) *pfpixx = NULL;
+    if (pfpixy) *pfpixy = NULL;
+    if (!remap)
+        return ERROR_INT("remap not defined", __func__, 1);
+
+    if (pfpixx) *pfpixx = fpixClone(remap->fpixx);
+    if (pfpixy) *pfpixy = fpixClone(remap->fpixy);
+    return 0;
+}
+
+
+/*--------------------------------------------------------------------------*
+ *                       Applying a remap to an image                       *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   pixRemap()
+ *
+ * \param[in]    pixs      any depth; colormap ok; size of the remap src
+ * \param[in]    remap
+ * \param[in]    type      L_INTERPOLATED, L_SAMPLED
+ * \param[in]    incolor   L_BRING_IN_WHITE, L_BRING_IN_BLACK
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For L_INTERPOLATED, the colormap is removed and 2 and 4 bpp
+ *          images are converted to 8 bpp, as in pixAffine().  The alpha
+ *          component of an rgba image is interpolated with the others,
+ *          and opaque alpha is brought in.  1 and 16 bpp images are
+ *          always sampled.
+ *      (2) For L_SAMPLED, the depth and colormap are preserved.
+ * </pre>
+ */
+PIX *
+pixRemap(PIX      *pixs,
+         L_REMAP  *remap,
+         l_int32   type,
+         l_int32   incolor)
+{
+l_int32    i, w, h, d, ws, hs, wpls, wpld, withalpha;
+l_uint32   val;
+l_uint32  *datas, *datad;
+PIX       *pixt, *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (!remap)
+        return (PIX *)ERROR_PTR("remap not defined", __func__, NULL);
+    if (type != L_INTERPOLATED && type != L_SAMPLED)
+        return (PIX *)ERROR_PTR("invalid type", __func__, NULL);
+    if (incolor != L_BRING_IN_WHITE && incolor != L_BRING_IN_BLACK)
+        return (PIX *)ERROR_PTR("invalid incolor", __func__, NULL);
+    pixGetDimensions(pixs, &ws, &hs, &d);
+    if (ws != remap->ws || hs != remap->hs)
+        return (PIX *)ERROR_PTR("pixs not size of remap src", __func__, NULL);
+
+    if (type == L_SAMPLED || d == 1 || d == 16)
+        return pixRemapSampled(pixs, remap, incolor);
+
+        /* Remove colormap if it exists; convert 2 and 4 bpp to 8 bpp */
+    if (pixGetColormap(pixs))
+        pixt = pixRemoveColormap(pixs, REMOVE_CMAP_BASED_ON_SRC);
+    else if (d == 2 || d == 4)
+        pixt = pixConvertTo8(pixs, FALSE);
+    else
+        pixt = pixClone(pixs);
+    d = pixGetDepth(pixt);
+    if (d != 8 && d != 32) {
+        pixDestroy(&pixt);
+        return pixRemapSampled(pixs, remap, incolor);
+    }
+
+    w = remap->w;
+    h = remap->h;
+    if ((pixd = pixCreate(w, h, d)) == NULL) {
+        pixDestroy(&pixt);
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+    }
+    pixCopyResolution(pixd, pixt);
+    pixCopyInputFormat(pixd, pixt);
+    pixSetSpp(pixd, pixGetSpp(pixt));
+    withalpha = (d == 32 && pixGetSpp(pixt) == 4);
+    if (d == 8)
+        val = (incolor == L_BRING_IN_WHITE) ? 255 : 0;
+    else  /* d == 32 */
+        val = (incolor == L_BRING_IN_WHITE) ? 0xffffff00 : 0;
+    if (withalpha)  /* bring in opaque */
+        val |= 0xff;
+    pixSetAllArbitrary(pixd, val);
+
+    datas = pixGetData(pixt);
+    wpls = pixGetWpl(pixt);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        if (d == 8)
+            linearInterpolateLineGray(datas, wpls, ws, hs, remap->xloc + i * w,
+                                      remap->yloc + i * w, w,
+                                      datad + i * wpld);
+        else
+            linearInterpolateLineColor(datas, wpls, ws, hs,
+                                       remap->xloc + i * w,
+                                       remap->yloc + i * w, w, withalpha,
+                                       datad + i * wpld);
+    }
+
+    pixDestroy(&pixt);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixRemapSampled()
+ *
+ * \param[in]    pixs      any depth; colormap ok
+ * \param[in]    remap
+ * \param[in]    incolor   L_BRING_IN_WHITE, L_BRING_IN_BLACK
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each dest pixel takes the value of the src pixel nearest
+ *          its src location.
+ * </pre>
+ */
+static PIX *
+pixRemapSampled(PIX      *pixs,
+                L_REMAP  *remap,
+                l_int32   incolor)
+{
+l_int32    i, j, w, h, d, ws, hs, wpls, wpld, x, y, cmapindex;
+l_int32   *xloc, *yloc;
+l_uint32  *datas, *datad, *lines, *lined;
+PIX       *pixd;
+PIXCMAP   *cmap;
+
+    pixGetDimensions(pixs, &ws, &hs, &d);
+    w = remap->w;
+    h = remap->h;
+    if ((pixd = pixCreate(w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+    pixCopyResolution(pixd, pixs);
+    pixCopyInputFormat(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    pixSetSpp(pixd, pixGetSpp(pixs));
+
+        /* Init all dest pixels to color to be brought in from outside */
+    if ((cmap = pixGetColormap(pixd)) != NULL) {
+        pixcmapAddBlackOrWhite(cmap, (incolor == L_BRING_IN_WHITE) ? 1 : 0,
+                               &cmapindex);
+        pixSetAllArbitrary(pixd, cmapindex);
+    } else if ((d == 1 && incolor == L_BRING_IN_BLACK) ||
+               (d > 1 && incolor == L_BRING_IN_WHITE)) {
+        pixSetAll(pixd);
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        xloc = remap->xloc + i * w;
+        yloc = remap->yloc + i * w;
+        for (j = 0; j < w; j++) {
+            if (xloc[j] < 0 || yloc[j] < 0) continue;
+            x = L_MIN((xloc[j] + 8) >> 4, ws - 1);
+            y = L_MIN((yloc[j] + 8) >> 4, hs - 1);
+            lines = datas + y * wpls;
+            switch (d)
+            {
+            case 1:
+                if (GET_DATA_BIT(lines, x))
+                    SET_DATA_BIT(lined, j);
+                else
+                    CLEAR_DATA_BIT(lined, j);
+                break;
+            case 2:
+                SET_DATA_DIBIT(lined, j, GET_DATA_DIBIT(lines, x));
+                break;
+            case 4:
+                SET_DATA_QBIT(lined, j, GET_DATA_QBIT(lines, x));
+                break;
+            case 8:
+                SET_DATA_BYTE(lined, j, GET_DATA_BYTE(lines, x));
+                break;
+            case 16:
+                SET_DATA_TWO_BYTES(lined, j, GET_DATA_TWO_BYTES(lines, x));
+                break;
+            default:  /* 32 bpp */
+                lined[j] = lines[x];
+                break;
+            }
+        }
+    }
+
+    return pixd;
+}
+
+
+/*--------------------------------------------------------------------------*
+ *                              Static helpers                              *
+ *--------------------------------------------------------------------------*/
+/*!
+ * \brief   remapMakeLocations()
+ *
+ * \param[in]    remap    with the fpix maps
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This makes the fixed point src locations, in units of 1/16
+ *          pixel, that are used by pixRemap().  Locations outside the
+ *          src, and NaNs, are set to -1.
+ * </pre>
+ */
+static l_int32
+remapMakeLocations(L_REMAP  *remap)
+{
+l_int32     i, n, ws, hs;
+l_float32   x, y;
+l_float32  *datax, *datay;
+
+    n = remap->w * remap->h;
+    remap->xloc = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    remap->yloc = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    if (!remap->xloc || !remap->yloc)
+        return ERROR_INT("location arrays not made", __func__, 1);
+
+    ws = remap->ws;
+    hs = remap->hs;
+    datax = fpixGetData(remap->fpixx);
+    datay = fpixGetData(remap->fpixy);
+    for (i = 0; i < n; i++) {
+        x = datax[i];
+        y = datay[i];
+        if (x >= 0.0 && y >= 0.0 && x < ws && y < hs) {
+            remap->xloc[i] = (l_int32)(16.0 * x);
+            remap->yloc[i] = (l_int32)(16.0 * y);
+        } else {
+            remap->xloc[i] = remap->yloc[i] = -1;
+        }
+    }
+    return 0;
+}
+
+
+/*!
+ * \brief   interpolateFloat()
+ *
+ * \param[in]    data     float array
+ * \param[in]    wpl      number of floats in each line
+ * \param[in]    w, h     size of array
+ * \param[in]    x, y     location, with 0 <= x < w and 0 <= y < h
+ * \return  interpolated value
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is linear interpolation at full precision, using the
+ *          last row and column for locations beyond them.
+ * </pre>
+ */
+static l_float32
+interpolateFloat(l_float32  *data,
+                 l_int32     wpl,
+                 l_int32     w,
+                 l_int32     h,
+                 l_float32   x,
+                 l_float32   y)
+{
+l_int32     xp, yp, xp2, yp2;
+l_float32   xf, yf;
+l_float32  *line1, *line2;
+
+    xp = (l_int32)x;
+    yp = (l_int32)y;
+    xf = x - xp;
+    yf = y - yp;
+    xp2 = L_MIN(xp + 1, w - 1);
+    yp2 = L_MIN(yp + 1, h - 1);
+    line1 = data + yp * wpl;
+    line2 = data + yp2 * wpl;
+    return (1.0 - yf) * ((1.0 - xf) * line1[xp] + xf * line1[xp2]) +
+           yf * ((1.0 - xf) * line2[xp] + xf * line2[xp2]);
+}
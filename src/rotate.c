@@ -63,6 +63,7 @@ extern l_float32  AlphaMaskBorderVals[2];
 static const l_float32  MinAngleToRotate = 0.001f;  /* radians; ~0.06 deg */
 static const l_float32  Max1BppShearAngle = 0.06f;  /* radians; ~3 deg    */
 static const l_float32  LimitShearAngle = 0.35f;    /* radians; ~20 deg   */
+static const l_float32  MaxLIShearAngle = 0.06f;    /* radians; ~3 deg    */
 
 /*------------------------------------------------------------------*
  *                  General rotation about the center               *
@@ -95,6 +96,9 @@ static const l_float32  LimitShearAngle = 0.35f;    /* radians; ~20 deg   */
  *          original width and height allows the expansion to
  *          stop at the maximum required size, which is a square
  *          with side = sqrt(w*w + h*h).
+ *      (7) For rotation by area mapping with angles up to about 3 degrees,
+ *          such as for deskewing, we use pixRotate3ShearLI(), which
+ *          gives nearly the same result and is faster.
  * </pre>
  */
 PIX *
@@ -174,6 +178,8 @@ PIXCMAP   *cmap;
         pixd = pixRotateShearCenter(pix3, angle, incolor);
     } else if (type == L_ROTATE_SAMPLING) {
         pixd = pixRotateBySampling(pix3, w / 2, h / 2, angle, incolor);
+    } else if (L_ABS(angle) <= MaxLIShearAngle) {  /* see note (7) */
+        pixd = pixRotate3ShearLI(pix3, w / 2, h / 2, angle, incolor);
     } else {  /* rotate by area mapping */
         fillval = 0;
         if (incolor == L_BRING_IN_WHITE) {
@@ -36,6 +36,8 @@
  *
  *      90-degree rotation (both directions)
  *            PIX             *pixRotate90()
+ *            static l_int32   rotate90Low()
+ *            static void      transposeWords()
  *
  *      Left-right flip
  *            PIX             *pixFlipLR()
@@ -57,6 +59,10 @@
 #include <string.h>
 #include "allheaders.h"
 
+static l_int32 rotate90Low(l_uint32 *datad, l_int32 wd, l_int32 hd,
+                           l_int32 d, l_int32 wpld, l_uint32 *datas,
+                           l_int32 wpls, l_int32 direction);
+static void transposeWords(l_uint32 *a, l_int32 d);
 static l_uint8 *makeReverseByteTab1(void);
 static l_uint8 *makeReverseByteTab2(void);
 static l_uint8 *makeReverseByteTab4(void);
@@ -156,6 +162,10 @@ l_int32  d;
  *      (1) This does a 90 degree rotation of the image about the center,
  *          either cw or ccw, returning a new pix.
  *      (2) The direction must be either 1 (cw) or -1 (ccw).
+ *      (3) The rotation is a transpose, with either the rows or the
+ *          columns taken in reverse order.  It is done in square blocks
+ *          of pixels that fill one 32-bit word in each of 32/d rows;
+ *          see rotate90Low().
  * </pre>
  */
 PIX *
@@ -163,9 +173,7 @@ pixRotate90(PIX     *pixs,
             l_int32  direction)
 {
 l_int32    wd, hd, d, wpls, wpld;
-l_int32    i, j, k, m, iend, nswords;
-l_uint32   val, word;
-l_uint32  *lines, *datas, *lined, *datad;
+l_uint32  *datas, *datad;
 PIX       *pixd;
 
     if (!pixs)
@@ -188,186 +196,168 @@ PIX       *pixd;
     wpls = pixGetWpl(pixs);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
+    if (rotate90Low(datad, wd, hd, d, wpld, datas, wpls, direction)) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("rotation failed", __func__, NULL);
+    }
+    return pixd;
+}
 
-    if (direction == 1) {  /* clockwise */
-        switch (d)
-        {
-            case 32:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        lined[j] = lines[i];
-                        lines -= wpls;
-                    }
-                }
-                break;
-            case 16:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_TWO_BYTES(lines, i)))
-                            SET_DATA_TWO_BYTES(lined, j, val);
-                        lines -= wpls;
-                    }
-                }
-                break;
-            case 8:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_BYTE(lines, i)))
-                            SET_DATA_BYTE(lined, j, val);
-                        lines -= wpls;
-                    }
-                }
-                break;
-            case 4:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_QBIT(lines, i)))
-                            SET_DATA_QBIT(lined, j, val);
-                        lines -= wpls;
-                    }
-                }
-                break;
-            case 2:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas + (wd - 1) * wpls;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_DIBIT(lines, i)))
-                            SET_DATA_DIBIT(lined, j, val);
-                        lines -= wpls;
-                    }
-                }
-                break;
-            case 1:
-                nswords = hd / 32;
-                for (j = 0; j < wd; j++) {
-                    lined = datad;
-                    lines = datas + (wd - 1 - j) * wpls;
-                    for (k = 0; k < nswords; k++) {
-                        word = lines[k];
-                        if (!word) {
-                            lined += 32 * wpld;
-                            continue;
-                        } else {
-                            iend = 32 * (k + 1);
-                            for (m = 0, i = 32 * k; i < iend; i++, m++) {
-                                if ((word << m) & 0x80000000)
-                                    SET_DATA_BIT(lined, j);
-                                lined += wpld;
-                            }
-                        }
-                    }
-                    for (i = 32 * nswords; i < hd; i++) {
-                        if (GET_DATA_BIT(lines, i))
-                            SET_DATA_BIT(lined, j);
-                        lined += wpld;
-                    }
-                }
-                break;
-            default:
-                pixDestroy(&pixd);
-                L_ERROR("illegal depth: %d\n", __func__, d);
-                break;
-        }
-    } else  {     /* direction counter-clockwise */
-        switch (d)
-        {
-            case 32:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        lined[j] = lines[hd - 1 - i];
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 16:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_TWO_BYTES(lines, hd - 1 - i)))
-                            SET_DATA_TWO_BYTES(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 8:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_BYTE(lines, hd - 1 - i)))
-                            SET_DATA_BYTE(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 4:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_QBIT(lines, hd - 1 - i)))
-                            SET_DATA_QBIT(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 2:
-                for (i = 0; i < hd; i++) {
-                    lined = datad + i * wpld;
-                    lines = datas;
-                    for (j = 0; j < wd; j++) {
-                        if ((val = GET_DATA_DIBIT(lines, hd - 1 - i)))
-                            SET_DATA_DIBIT(lined, j, val);
-                        lines += wpls;
-                    }
-                }
-                break;
-            case 1:
-                nswords = hd / 32;
-                for (j = 0; j < wd; j++) {
-                    lined = datad + (hd - 1) * wpld;
-                    lines = datas + (wd - 1 - j) * wpls;
-                    for (k = 0; k < nswords; k++) {
-                        word = lines[k];
-                        if (!word) {
-                            lined -= 32 * wpld;
-                            continue;
-                        } else {
-                            iend = 32 * (k + 1);
-                            for (m = 0, i = 32 * k; i < iend; i++, m++) {
-                                if ((word << m) & 0x80000000)
-                                    SET_DATA_BIT(lined, wd - 1 - j);
-                                lined -= wpld;
-                            }
-                        }
-                    }
-                    for (i = 32 * nswords; i < hd; i++) {
-                        if (GET_DATA_BIT(lines, i))
-                            SET_DATA_BIT(lined, wd - 1 - j);
-                        lined -= wpld;
-                    }
+
+/*!
+ * \brief   rotate90Low()
+ *
+ * \param[in]    datad       dest data
+ * \param[in]    wd, hd      dest width and height
+ * \param[in]    d           depth: 1, 2, 4, 8, 16 or 32 bpp
+ * \param[in]    wpld        dest words/line
+ * \param[in]    datas       src data
+ * \param[in]    wpls        src words/line
+ * \param[in]    direction   clockwise = 1, counterclockwise = -1
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Let n = 32 / d, the number of pixels in a word.  A block
+ *          of n src rows, taking one word from each row, is an n x n
+ *          matrix of pixels.  It is transposed in registers, and each
+ *          of the resulting n words is stored in a different dest row.
+ *          The 8, 16 and 32 bpp blocks are written out explicitly;
+ *          the others use transposeWords().
+ *      (2) For cw rotation the src rows are taken bottom to top;
+ *          for ccw rotation the dest rows are written bottom to top.
+ *      (3) The blocks are visited in vertical bands of src words,
+ *          so that the 2 * 32 dest rows being written and the src
+ *          words being read both stay in the cache.
+ *      (4) Missing src rows at the end of the last dest word are
+ *          read from a line of 0 words, so the dest pad bits are clear.
+ *          Src pad bits at the end of each src row are transposed into
+ *          dest rows beyond hd, which are not written.
+ * </pre>
+ */
+static l_int32
+rotate90Low(l_uint32  *datad,
+            l_int32    wd,
+            l_int32    hd,
+            l_int32    d,
+            l_int32    wpld,
+            l_uint32  *datas,
+            l_int32    wpls,
+            l_int32    direction)
+{
+l_int32    n, nr, band, i, k, r, jw, ks, ksstart, ksend, row, dstep;
+l_uint32   a0, a1, a2, a3, t;
+l_uint32   a[32];
+l_uint32  *lined, *zeroline;
+l_uint32  *lines[32];
+
+    if ((zeroline = (l_uint32 *)LEPT_CALLOC(wpls, sizeof(l_uint32))) == NULL)
+        return ERROR_INT("zeroline not made", __func__, 1);
+
+    n = 32 / d;
+    band = 2 * d;  /* 2 * n dest rows are written in each band */
+    dstep = (direction == 1) ? wpld : -wpld;
+    for (ksstart = 0; ksstart < wpls; ksstart += band) {
+        ksend = L_MIN(ksstart + band, wpls);
+        for (jw = 0; jw < wpld; jw++) {
+            for (k = 0; k < n; k++) {
+                row = jw * n + k;
+                if (row >= wd)
+                    lines[k] = zeroline;
+                else if (direction == 1)  /* cw */
+                    lines[k] = datas + (wd - 1 - row) * wpls;
+                else
+                    lines[k] = datas + row * wpls;
+            }
+            for (ks = ksstart; ks < ksend; ks++) {
+                i = ks * n;  /* first dest row, before any reversal */
+                nr = L_MIN(n, hd - i);
+                if (direction == 1)
+                    lined = datad + i * wpld + jw;
+                else
+                    lined = datad + (hd - 1 - i) * wpld + jw;
+                if (d == 32) {
+                    *lined = lines[0][ks];
+                } else if (d == 16) {
+                    a0 = lines[0][ks];
+                    a1 = lines[1][ks];
+                    lined[0] = (a0 & 0xffff0000) | (a1 >> 16);
+                    if (nr == 2)
+                        lined[dstep] = (a0 << 16) | (a1 & 0xffff);
+                } else if (d == 8) {
+                    a0 = lines[0][ks];
+                    a1 = lines[1][ks];
+                    a2 = lines[2][ks];
+                    a3 = lines[3][ks];
+                    t = (a0 ^ (a2 >> 16)) & 0xffff;
+                    a0 ^= t;
+                    a2 ^= t << 16;
+                    t = (a1 ^ (a3 >> 16)) & 0xffff;
+                    a1 ^= t;
+                    a3 ^= t << 16;
+                    t = (a0 ^ (a1 >> 8)) & 0x00ff00ff;
+                    a0 ^= t;
+                    a1 ^= t << 8;
+                    t = (a2 ^ (a3 >> 8)) & 0x00ff00ff;
+                    a2 ^= t;
+                    a3 ^= t << 8;
+                    lined[0] = a0;
+                    if (nr > 1)
+                        lined[dstep] = a1;
+                    if (nr > 2)
+                        lined[2 * dstep] = a2;
+                    if (nr > 3)
+                        lined[3 * dstep] = a3;
+                } else {  /* d < 8 */
+                    for (k = 0; k < n; k++)
+                        a[k] = lines[k][ks];
+                    transposeWords(a, d);
+                    for (r = 0; r < nr; r++, lined += dstep)
+                        *lined = a[r];
                 }
-                break;
-            default:
-                pixDestroy(&pixd);
-                L_ERROR("illegal depth: %d\n", __func__, d);
-                break;
+            }
         }
     }
 
-    return pixd;
+    LEPT_FREE(zeroline);
+    return 0;
+}
+
+
+/*!
+ * \brief   transposeWords()
+ *
+ * \param[in]    a       array of 32/d words
+ * \param[in]    d       depth: 1, 2, 4, 8, 16 or 32 bpp
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The 32/d words in %a are taken as a square matrix of pixels,
+ *          one row per word, with the first pixel in the MSB.  This
+ *          transposes the matrix in place.
+ *      (2) This is the recursive block swap from Hacker's Delight:
+ *          at each stage, the upper right and lower left sub-blocks
+ *          of each block are exchanged, starting with blocks of
+ *          16 bits and halving down to the pixel size.
+ * </pre>
+ */
+static void
+transposeWords(l_uint32  *a,
+               l_int32    d)
+{
+l_int32   n, j, jr, k;
+l_uint32  m, t;
+
+    n = 32 / d;
+    for (j = 16, m = 0x0000ffff; j >= d; j >>= 1, m ^= (m << j)) {
+        jr = j / d;  /* row distance between the swapped sub-blocks */
+        for (k = 0; k < n; k = (k + jr + 1) & ~jr) {
+            t = (a[k] ^ (a[k + jr] >> j)) & m;
+            a[k] ^= t;
+            a[k + jr] ^= (t << j);
+        }
+    }
 }
 
 
@@ -34,6 +34,9 @@
  *              PIX      *pixRotate2Shear()
  *              PIX      *pixRotate3Shear()
  *
+ *      Interpolated shear rotation about arbitrary point using 3 shears
+ *              PIX      *pixRotate3ShearLI()
+ *
  *      Shear rotation in-place about arbitrary point using 3 shears
  *              l_int32   pixRotateShearIP()
  *
@@ -380,6 +383,107 @@ PIX       *pix1, *pix2, *pixd;
 }
 
 
+/*------------------------------------------------------------------*
+ *        Interpolated rotation about an arbitrary point            *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   pixRotate3ShearLI()
+ *
+ * \param[in]    pixs         1, 8 or 32 bpp, or cmapped
+ * \param[in]    xcen, ycen   center of rotation
+ * \param[in]    angle        radians
+ * \param[in]    incolor      L_BRING_IN_WHITE, L_BRING_IN_BLACK;
+ * \return  pixd, or NULL on error.
+ *
+ * <pre>
+ * Notes:
+ *      (1) This rotates the image about the given point with 3 shears,
+ *          each of which shifts rows or columns by a fractional amount
+ *          with linear interpolation.  It is much smoother than
+ *          pixRotate3Shear(), and it gives nearly the same result as
+ *          rotation by area mapping; the three 1D interpolations
+ *          smooth sharp edges slightly more.  Each shear has a constant
+ *          fractional shift along a row or column, so it is faster
+ *          than area mapping, which interpolates in 2D at each pixel.
+ *          It should only be used for angles smaller than
+ *          MaxThreeShearAngle.  For larger angles, a warning is issued.
+ *      (2) A positive angle gives a clockwise rotation.
+ *      (3) 3-shear rotation by a specified angle is equivalent
+ *          to the sequential transformations
+ *            x' = x + tan(angle/2) * (y - ycen)     for first x-shear
+ *            y' = y + sin(angle) * (x - xcen)       for y-shear
+ *            x' = x + tan(angle/2) * (y - ycen)     for second x-shear
+ *          Unlike pixRotate3Shear(), the shear in the middle is vertical,
+ *          because a horizontal interpolated shear is faster than
+ *          a vertical one.
+ *      (4) A 1 bpp image can not be interpolated, so it is rotated
+ *          with pixRotate3Shear().  A colormap is removed.
+ *      (5) This brings in 'incolor' pixels from outside the image.
+ *      (6) If the image has an alpha layer, it is rotated separately,
+ *          bringing in opaque pixels.
+ * </pre>
+ */
+PIX *
+pixRotate3ShearLI(PIX       *pixs,
+                  l_int32    xcen,
+                  l_int32    ycen,
+                  l_float32  angle,
+                  l_int32    incolor)
+{
+l_int32    w, h, d;
+l_float32  vangle;
+PIX       *pix1, *pix2, *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (incolor != L_BRING_IN_WHITE && incolor != L_BRING_IN_BLACK)
+        return (PIX *)ERROR_PTR("invalid incolor value", __func__, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 8 && d != 32 && !pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs not 1, 8, 32 bpp or cmapped",
+                                __func__, NULL);
+    if (xcen < 0 || xcen >= w || ycen < 0 || ycen >= h)
+        return (PIX *)ERROR_PTR("center not in image", __func__, NULL);
+
+    if (L_ABS(angle) > MaxShearAngle) {
+        L_ERROR("%6.2f radians; too large for shear rotation\n", __func__,
+                L_ABS(angle));
+        return NULL;
+    }
+    if (L_ABS(angle) < MinAngleToRotate)
+        return pixClone(pixs);
+    if (L_ABS(angle) > MaxThreeShearAngle) {
+        L_WARNING("%6.2f radians; large angle for 3-shear rotation\n",
+                  __func__, L_ABS(angle));
+    }
+    if (d == 1)
+        return pixRotate3Shear(pixs, xcen, ycen, angle, incolor);
+
+        /* The colormap, if any, is removed in the first shear */
+    vangle = atan(sin(angle));
+    if ((pix1 = pixHShearLI(pixs, ycen, angle / 2.f, incolor)) == NULL)
+        return (PIX *)ERROR_PTR("pix1 not made", __func__, NULL);
+    pix2 = pixVShearLI(pix1, xcen, vangle, incolor);
+    pixDestroy(&pix1);
+    if (!pix2)
+        return (PIX *)ERROR_PTR("pix2 not made", __func__, NULL);
+    pixd = pixHShearLI(pix2, ycen, angle / 2.f, incolor);
+    pixDestroy(&pix2);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+
+    if (pixGetDepth(pixd) == 32 && pixGetSpp(pixs) == 4) {
+        pix1 = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);
+            /* L_BRING_IN_WHITE brings in opaque for the alpha component */
+        pix2 = pixRotate3ShearLI(pix1, xcen, ycen, angle, L_BRING_IN_WHITE);
+        pixSetRGBComponent(pixd, pix2, L_ALPHA_CHANNEL);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    return pixd;
+}
+
+
 /*------------------------------------------------------------------*
  *             Rotations in-place about an arbitrary point          *
  *------------------------------------------------------------------*/
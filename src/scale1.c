@@ -72,6 +72,10 @@
  *               PIX      *pixScaleAreaMap2()
  *               PIX      *pixScaleAreaMapToSize()
  *
+ *         Separable resampling with a filter kernel
+ *               PIX      *pixScaleWithFilter()
+ *               PIX      *pixScaleToSizeWithFilter()
+ *
  *         Binary scaling by closest pixel sampling
  *               PIX      *pixScaleBinary()
  *               PIX      *pixScaleBinaryWithShift()
@@ -110,6 +114,13 @@
  *
  *         Binary scaling by closest pixel sampling
  *               static l_int32    scaleBinaryLow()
+ *
+ *         Separable resampling with a filter kernel
+ *               static l_int32    scaleWithFilterLow()
+ *               static void       filterRowLow()
+ *               static void       filterPackRowLow()
+ *               static l_int32    makeFilterWeights()
+ *               static l_float64  filterKernel()
  * </pre>
  */
 
@@ -118,8 +129,13 @@
 #endif  /* HAVE_CONFIG_H */
 
 #include <string.h>
+#include <math.h>
 #include "allheaders.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif  /* M_PI */
+
 static void scaleColorLILow(l_uint32 *datad, l_int32 wd, l_int32 hd,
                             l_int32 wpld, l_uint32 *datas, l_int32 ws,
                             l_int32 hs, l_int32 wpls);
@@ -165,6 +181,26 @@ static l_int32 scaleBinaryLow(l_uint32 *datad, l_int32 wd, l_int32 hd,
                               l_int32 wpld, l_uint32 *datas, l_int32 ws,
                               l_int32 hs, l_int32 wpls,
                               l_float32 shiftx, l_float32 shifty);
+static l_int32 scaleWithFilterLow(l_uint32 *datad, l_int32 wd, l_int32 hd,
+                                  l_int32 wpld, l_uint32 *datas, l_int32 ws,
+                                  l_int32 hs, l_int32 wpls, l_int32 nc,
+                                  l_int32 filtertype);
+static void filterRowLow(l_int32 *hrow, l_int16 *srow, l_int32 wd,
+                         l_int32 nc, l_int32 ntx, l_int32 *leftx,
+                         l_int16 *wtx);
+static void filterPackRowLow(l_uint32 *lined, l_int32 *vals, l_int32 wd,
+                             l_int32 nc);
+static l_int32 makeFilterWeights(l_int32 ns, l_int32 nd, l_int32 filtertype,
+                                 l_int32 *pntaps, l_int32 **pleft,
+                                 l_int16 **pweight);
+static l_float64 filterKernel(l_int32 filtertype, l_float64 x);
+
+    /* Fixed-point parameters for separable filtering */
+static const l_int32  FilterWeightOne = 1 << 14;  /* 14 fraction bits */
+static const l_int32  FilterRowShift = 8;     /* after horizontal pass */
+static const l_int32  FilterRoundRow = 1 << 7;
+static const l_int32  FilterShiftOut = 20;    /* 2 * 14 - 8 */
+static const l_int32  FilterRoundOut = 1 << 19;
 
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_OVERFLOW   0
@@ -2129,6 +2165,162 @@ l_float32  scalex, scaley;
 }
 
 
+/*------------------------------------------------------------------*
+ *            Separable resampling with a filter kernel             *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   pixScaleWithFilter()
+ *
+ * \param[in]    pixs         1, 2, 4, 8, 16 or 32 bpp; colormap OK
+ * \param[in]    scalex       must be > 0.0
+ * \param[in]    scaley       must be > 0.0
+ * \param[in]    filtertype   L_RESAMPLE_AREA, L_RESAMPLE_TRIANGLE,
+ *                            L_RESAMPLE_MITCHELL, L_RESAMPLE_LANCZOS3
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The output size is computed as in pixScale().  See
+ *          pixScaleToSizeWithFilter() for details.
+ * </pre>
+ */
+PIX *
+pixScaleWithFilter(PIX       *pixs,
+                   l_float32  scalex,
+                   l_float32  scaley,
+                   l_int32    filtertype)
+{
+l_int32  ws, hs, wd, hd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (scalex <= 0.0 || scaley <= 0.0)
+        return (PIX *)ERROR_PTR("scale factor <= 0", __func__, NULL);
+
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    wd = (l_int32)(scalex * (l_float32)ws + 0.5);
+    hd = (l_int32)(scaley * (l_float32)hs + 0.5);
+    if (wd < 1 || hd < 1)
+        return (PIX *)ERROR_PTR("pixd too small", __func__, NULL);
+    return pixScaleToSizeWithFilter(pixs, wd, hd, filtertype);
+}
+
+
+/*!
+ * \brief   pixScaleToSizeWithFilter()
+ *
+ * \param[in]    pixs         1, 2, 4, 8, 16 or 32 bpp; colormap OK
+ * \param[in]    wd           target width; use 0 if using height as target
+ * \param[in]    hd           target height; use 0 if using width as target
+ * \param[in]    filtertype   L_RESAMPLE_AREA, L_RESAMPLE_TRIANGLE,
+ *                            L_RESAMPLE_MITCHELL, L_RESAMPLE_LANCZOS3
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a separable resampler.  For each dest column and
+ *          each dest row, the contributing src pixels and their weights
+ *          are computed once, in fixed point, and normalized to sum
+ *          exactly to 1.  The image is then filtered horizontally and
+ *          vertically using only integer arithmetic.  Horizontally
+ *          filtered rows are kept in a small circular buffer, so the
+ *          extra memory is a few rows of the dest width.
+ *      (2) For reduction, the kernel is stretched by the reduction
+ *          factor, so that it acts as an antialiasing lowpass filter.
+ *          For expansion, it interpolates between src pixels.  The
+ *          scale factors can differ in x and y, and either can be
+ *          a reduction or an expansion.
+ *      (3) Filter choice:
+ *          * L_RESAMPLE_AREA weights each src pixel by its overlap with
+ *            the dest pixel.  For reduction it gives nearly the same
+ *            result as pixScaleAreaMap(); it is about twice as fast
+ *            for gray and somewhat slower for color.
+ *          * L_RESAMPLE_TRIANGLE is linear interpolation for expansion
+ *            and a tent-weighted average for reduction.
+ *          * L_RESAMPLE_MITCHELL is a cubic with little ringing and
+ *            slight blurring; a good general choice.
+ *          * L_RESAMPLE_LANCZOS3 is the sharpest, but can show some
+ *            ringing at strong edges.
+ *      (4) Filtering is done on 8 bpp gray and 32 bpp rgb.  If spp == 4,
+ *          the alpha component is filtered along with the color.
+ *          A colormap is removed, and 1, 2, 4 and 16 bpp images are
+ *          converted to 8 bpp.
+ *      (5) Dest pixel centers are placed at
+ *              xs = (xd + 0.5) * (ws / wd) - 0.5
+ *          in the src, so the image is not shifted by the scaling.
+ *          Src pixels beyond the boundary are replicated from the edge.
+ *      (6) The output scaled image has the dimension(s) you specify:
+ *          - To specify the width with isotropic scaling, set %hd = 0.
+ *          - To specify the height with isotropic scaling, set %wd = 0.
+ *          - If both %wd and %hd are specified, the image is scaled
+ *             (in general, anisotropically) to that size.
+ *          - It is an error to set both %wd and %hd to 0.
+ * </pre>
+ */
+PIX *
+pixScaleToSizeWithFilter(PIX     *pixs,
+                         l_int32  wd,
+                         l_int32  hd,
+                         l_int32  filtertype)
+{
+l_int32    ws, hs, d, nc, wpls, wpld, ret;
+l_uint32  *datas, *datad;
+PIX       *pix1, *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (wd <= 0 && hd <= 0)
+        return (PIX *)ERROR_PTR("neither wd nor hd > 0", __func__, NULL);
+    if (filtertype != L_RESAMPLE_AREA && filtertype != L_RESAMPLE_TRIANGLE &&
+        filtertype != L_RESAMPLE_MITCHELL && filtertype != L_RESAMPLE_LANCZOS3)
+        return (PIX *)ERROR_PTR("invalid filtertype", __func__, NULL);
+
+    pixGetDimensions(pixs, &ws, &hs, &d);
+    if (wd <= 0)
+        wd = L_MAX(1, (l_int32)((l_float32)hd * ws / (l_float32)hs + 0.5));
+    else if (hd <= 0)
+        hd = L_MAX(1, (l_int32)((l_float32)wd * hs / (l_float32)ws + 0.5));
+
+        /* Remove colormap if necessary; convert to 8 or 32 bpp */
+    if (pixGetColormap(pixs))
+        pix1 = pixRemoveColormap(pixs, REMOVE_CMAP_BASED_ON_SRC);
+    else
+        pix1 = pixClone(pixs);
+    d = pixGetDepth(pix1);
+    if (d != 8 && d != 32) {
+        pixDestroy(&pix1);
+        pix1 = pixConvertTo8(pixs, FALSE);
+        d = 8;
+    }
+    if (!pix1)
+        return (PIX *)ERROR_PTR("pix1 not made", __func__, NULL);
+    nc = (d == 8) ? 1 : ((pixGetSpp(pix1) == 4) ? 4 : 3);
+
+    if ((pixd = pixCreate(wd, hd, d)) == NULL) {
+        pixDestroy(&pix1);
+        return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+    }
+    pixSetSpp(pixd, pixGetSpp(pix1));
+    pixCopyText(pixd, pix1);
+    pixCopyInputFormat(pixd, pix1);
+    pixCopyResolution(pixd, pix1);
+    pixScaleResolution(pixd, (l_float32)wd / (l_float32)ws,
+                       (l_float32)hd / (l_float32)hs);
+    datas = pixGetData(pix1);
+    wpls = pixGetWpl(pix1);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    ret = scaleWithFilterLow(datad, wd, hd, wpld, datas, ws, hs, wpls,
+                             nc, filtertype);
+    pixDestroy(&pix1);
+    if (ret) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("filtering failed", __func__, NULL);
+    }
+    return pixd;
+}
+
+
 /*------------------------------------------------------------------*
  *               Binary scaling by closest pixel sampling           *
  *------------------------------------------------------------------*/
@@ -3791,3 +3983,430 @@ l_float32  wratio, hratio;
     LEPT_FREE(scol);
     return 0;
 }
+
+
+/*------------------------------------------------------------------*
+ *            Separable resampling with a filter kernel             *
+ *------------------------------------------------------------------*/
+/*
+ * \brief   scaleWithFilterLow()
+ *
+ * <pre>
+ * Notes:
+ *      (1) %nc is the number of components: 1 for 8 bpp gray, 3 for rgb
+ *          and 4 for rgba.  Src rows are read a word at a time and
+ *          unpacked into 4 values: 4 gray pixels, or the r, g, b and
+ *          alpha components of a color pixel.  For rgb, the alpha byte
+ *          is not filtered in either pass, and it is written as 0
+ *          in the dest.
+ *      (2) Weights have 14 fraction bits.  The result of the first pass
+ *          is rounded to 6 fraction bits, so that it fits in 16 bits
+ *          and the second pass can't overflow 32 bits, even with the
+ *          negative lobes of the cubic and sinc kernels.
+ *      (3) The vertical pass multiplies entire rows by a single weight,
+ *          which is much cheaper per sample than the horizontal pass.
+ *          So the horizontal pass is applied to the fewer of the src
+ *          and dest rows:
+ *          * For vertical reduction (hd <= hs), each dest row is
+ *            accumulated directly from the src rows, and then
+ *            filtered horizontally.
+ *          * For vertical expansion, src rows are filtered horizontally
+ *            as they are needed and cached in a circular buffer of
+ *            nty rows, indexed by src row modulo nty.  The src rows
+ *            for each dest row are consecutive and the set never moves
+ *            up, so each src row is filtered only once.
+ * </pre>
+ */
+static l_int32
+scaleWithFilterLow(l_uint32  *datad,
+                   l_int32    wd,
+                   l_int32    hd,
+                   l_int32    wpld,
+                   l_uint32  *datas,
+                   l_int32    ws,
+                   l_int32    hs,
+                   l_int32    wpls,
+                   l_int32    nc,
+                   l_int32    filtertype)
+{
+l_int32    i, j, k, m, ncb, ntx, nty, irow, slot, nsvals, nvals, ret;
+l_int16    wt;
+l_int16   *wtx, *wty, *srow, *buf, *bufrow;
+l_int32   *leftx, *lefty, *rowid, *acc, *hrow;
+l_uint32   word;
+l_uint32  *lines;
+
+    wtx = wty = srow = buf = NULL;
+    leftx = lefty = rowid = acc = hrow = NULL;
+    ret = 1;
+    if (makeFilterWeights(ws, wd, filtertype, &ntx, &leftx, &wtx) ||
+        makeFilterWeights(hs, hd, filtertype, &nty, &lefty, &wty)) {
+        L_ERROR("weight tables not made\n", __func__);
+        goto cleanup;
+    }
+    ncb = (nc == 1) ? 1 : 4;  /* components in the buffers */
+    nsvals = 4 * wpls;  /* includes padding at the end of the src row */
+    nvals = ncb * wd;
+
+    if (hd <= hs) {  /* vertical pass first */
+        acc = (l_int32 *)LEPT_CALLOC(nsvals, sizeof(l_int32));
+        srow = (l_int16 *)LEPT_CALLOC(nsvals, sizeof(l_int16));
+        hrow = (l_int32 *)LEPT_CALLOC(nvals, sizeof(l_int32));
+        if (!acc || !srow || !hrow) {
+            L_ERROR("buffers not made\n", __func__);
+            goto cleanup;
+        }
+        for (i = 0; i < hd; i++) {
+            memset(acc, 0, 4LL * nsvals);
+            for (k = 0; k < nty; k++) {
+                if ((wt = wty[i * nty + k]) == 0)
+                    continue;
+                lines = datas + (lefty[i] + k) * wpls;
+                if (nc == 3) {  /* skip the alpha byte */
+                    for (j = 0, m = 0; j < wpls; j++, m += 4) {
+                        word = lines[j];
+                        acc[m] += wt * (l_int32)(word >> 24);
+                        acc[m + 1] += wt * (l_int32)((word >> 16) & 0xff);
+                        acc[m + 2] += wt * (l_int32)((word >> 8) & 0xff);
+                    }
+                } else {
+                    for (j = 0, m = 0; j < wpls; j++, m += 4) {
+                        word = lines[j];
+                        acc[m] += wt * (l_int32)(word >> 24);
+                        acc[m + 1] += wt * (l_int32)((word >> 16) & 0xff);
+                        acc[m + 2] += wt * (l_int32)((word >> 8) & 0xff);
+                        acc[m + 3] += wt * (l_int32)(word & 0xff);
+                    }
+                }
+            }
+            for (m = 0; m < nsvals; m++)
+                srow[m] = (acc[m] + FilterRoundRow) >> FilterRowShift;
+            filterRowLow(hrow, srow, wd, nc, ntx, leftx, wtx);
+            filterPackRowLow(datad + i * wpld, hrow, wd, nc);
+        }
+    } else {  /* horizontal pass first */
+        rowid = (l_int32 *)LEPT_CALLOC(nty, sizeof(l_int32));
+        srow = (l_int16 *)LEPT_CALLOC(nsvals, sizeof(l_int16));
+        hrow = (l_int32 *)LEPT_CALLOC(nvals, sizeof(l_int32));
+        buf = (l_int16 *)LEPT_CALLOC((size_t)nty * nvals, sizeof(l_int16));
+        acc = (l_int32 *)LEPT_CALLOC(nvals, sizeof(l_int32));
+        if (!rowid || !srow || !hrow || !buf || !acc) {
+            L_ERROR("buffers not made\n", __func__);
+            goto cleanup;
+        }
+        for (k = 0; k < nty; k++)
+            rowid[k] = -1;
+        for (i = 0; i < hd; i++) {
+            memset(acc, 0, 4LL * nvals);
+            for (k = 0; k < nty; k++) {
+                if ((wt = wty[i * nty + k]) == 0)
+                    continue;
+                irow = lefty[i] + k;
+                slot = irow % nty;
+                bufrow = buf + slot * nvals;
+                if (rowid[slot] != irow) {  /* filter the src row */
+                    lines = datas + irow * wpls;
+                    for (j = 0, m = 0; j < wpls; j++, m += 4) {
+                        word = lines[j];
+                        srow[m] = word >> 24;
+                        srow[m + 1] = (word >> 16) & 0xff;
+                        srow[m + 2] = (word >> 8) & 0xff;
+                        srow[m + 3] = word & 0xff;
+                    }
+                    filterRowLow(hrow, srow, wd, nc, ntx, leftx, wtx);
+                    for (m = 0; m < nvals; m++)
+                        bufrow[m] = (hrow[m] + FilterRoundRow) >>
+                                    FilterRowShift;
+                    rowid[slot] = irow;
+                }
+                for (m = 0; m < nvals; m++)
+                    acc[m] += wt * bufrow[m];
+            }
+            filterPackRowLow(datad + i * wpld, acc, wd, nc);
+        }
+    }
+    ret = 0;
+
+cleanup:
+    LEPT_FREE(leftx);
+    LEPT_FREE(wtx);
+    LEPT_FREE(lefty);
+    LEPT_FREE(wty);
+    LEPT_FREE(rowid);
+    LEPT_FREE(srow);
+    LEPT_FREE(hrow);
+    LEPT_FREE(buf);
+    LEPT_FREE(acc);
+    return ret;
+}
+
+
+/*
+ * \brief   filterRowLow()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Filters one row horizontally from %srow into %hrow.
+ *          Both hold 1 (gray) or 4 (color) interleaved components
+ *          per pixel.  For rgb (%nc == 3), the alpha component is
+ *          skipped.  The output is not shifted.
+ *      (2) The taps for each dest pixel are consecutive src pixels,
+ *          so for color the components of each tap are adjacent and
+ *          are accumulated together.
+ * </pre>
+ */
+static void
+filterRowLow(l_int32  *hrow,
+             l_int16  *srow,
+             l_int32   wd,
+             l_int32   nc,
+             l_int32   ntx,
+             l_int32  *leftx,
+             l_int16  *wtx)
+{
+l_int32   j, k, wt, sum, sum0, sum1, sum2, sum3;
+l_int16  *ps, *pwt;
+
+    pwt = wtx;
+    if (nc == 1) {
+        for (j = 0; j < wd; j++, pwt += ntx) {
+            ps = srow + leftx[j];
+            sum = 0;
+            for (k = 0; k < ntx; k++)
+                sum += pwt[k] * ps[k];
+            hrow[j] = sum;
+        }
+        return;
+    } else if (nc == 3) {
+        for (j = 0; j < wd; j++, pwt += ntx, hrow += 4) {
+            ps = srow + 4 * leftx[j];
+            sum0 = sum1 = sum2 = 0;
+            for (k = 0; k < ntx; k++, ps += 4) {
+                wt = pwt[k];
+                sum0 += wt * ps[0];
+                sum1 += wt * ps[1];
+                sum2 += wt * ps[2];
+            }
+            hrow[0] = sum0;
+            hrow[1] = sum1;
+            hrow[2] = sum2;
+        }
+        return;
+    }
+
+    for (j = 0; j < wd; j++, pwt += ntx, hrow += 4) {
+        ps = srow + 4 * leftx[j];
+        sum0 = sum1 = sum2 = sum3 = 0;
+        for (k = 0; k < ntx; k++, ps += 4) {
+            wt = pwt[k];
+            sum0 += wt * ps[0];
+            sum1 += wt * ps[1];
+            sum2 += wt * ps[2];
+            sum3 += wt * ps[3];
+        }
+        hrow[0] = sum0;
+        hrow[1] = sum1;
+        hrow[2] = sum2;
+        hrow[3] = sum3;
+    }
+}
+
+
+/*
+ * \brief   filterPackRowLow()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Rounds the filtered values, which have 20 fraction bits,
+ *          clips them to [0 ... 255] and writes them to the dest row.
+ *          The values are overwritten.
+ * </pre>
+ */
+static void
+filterPackRowLow(l_uint32  *lined,
+                 l_int32   *vals,
+                 l_int32    wd,
+                 l_int32    nc)
+{
+l_int32   j, m, nvals, val;
+l_uint32  pixel;
+
+    nvals = (nc == 1) ? wd : 4 * wd;
+    for (m = 0; m < nvals; m++) {
+        val = (vals[m] + FilterRoundOut) >> FilterShiftOut;
+        vals[m] = L_MIN(255, L_MAX(0, val));
+    }
+    if (nc == 1) {
+        for (j = 0; j < wd; j++)
+            SET_DATA_BYTE(lined, j, vals[j]);
+        return;
+    }
+
+    for (j = 0, m = 0; j < wd; j++, m += 4) {
+        pixel = ((l_uint32)vals[m] << L_RED_SHIFT) |
+                ((l_uint32)vals[m + 1] << L_GREEN_SHIFT) |
+                ((l_uint32)vals[m + 2] << L_BLUE_SHIFT);
+        if (nc == 4)
+            pixel |= (l_uint32)vals[m + 3] << L_ALPHA_SHIFT;
+        lined[j] = pixel;
+    }
+}
+
+
+/*
+ * \brief   makeFilterWeights()
+ *
+ * \param[in]    ns           size of src in the filtering direction
+ * \param[in]    nd           size of dest in the filtering direction
+ * \param[in]    filtertype   L_RESAMPLE_AREA, ...
+ * \param[out]   pntaps       number of taps for each dest pixel
+ * \param[out]   pleft        array of nd src indices of the first tap
+ * \param[out]   pweight      array of nd * ntaps fixed-point weights
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Dest pixel j uses the src pixels left[j], ... ,
+ *          left[j] + ntaps - 1, with weights at j * ntaps, ...
+ *          The taps always lie within the src.  Kernel values
+ *          that fall outside are added to the boundary tap, which
+ *          replicates the boundary pixels.
+ *      (2) The weights for each dest pixel sum exactly to
+ *          FilterWeightOne; any rounding error is added to the
+ *          largest weight.
+ * </pre>
+ */
+static l_int32
+makeFilterWeights(l_int32    ns,
+                  l_int32    nd,
+                  l_int32    filtertype,
+                  l_int32   *pntaps,
+                  l_int32  **pleft,
+                  l_int16  **pweight)
+{
+l_int32     j, k, nraw, ntaps, rawleft, left, m, imax, isum;
+l_int16    *weight, *pw;
+l_int32    *leftarr;
+l_float64   ratio, fscale, support, center, start, end, val, sum;
+l_float64  *fw;
+
+    *pntaps = 0;
+    *pleft = NULL;
+    *pweight = NULL;
+    ratio = (l_float64)ns / (l_float64)nd;
+    if (filtertype == L_RESAMPLE_AREA) {
+        fscale = support = 0.0;  /* not used */
+        nraw = (l_int32)ceil(ratio) + 1;
+    } else {
+        fscale = L_MAX(1.0, ratio);
+        if (filtertype == L_RESAMPLE_TRIANGLE)
+            support = fscale;
+        else if (filtertype == L_RESAMPLE_MITCHELL)
+            support = 2.0 * fscale;
+        else  /* L_RESAMPLE_LANCZOS3 */
+            support = 3.0 * fscale;
+        nraw = (l_int32)ceil(2.0 * support) + 1;
+    }
+    ntaps = L_MIN(nraw, ns);
+
+    leftarr = (l_int32 *)LEPT_CALLOC(nd, sizeof(l_int32));
+    weight = (l_int16 *)LEPT_CALLOC((size_t)nd * ntaps, sizeof(l_int16));
+    fw = (l_float64 *)LEPT_CALLOC(ntaps, sizeof(l_float64));
+    if (!leftarr || !weight || !fw) {
+        LEPT_FREE(leftarr);
+        LEPT_FREE(weight);
+        LEPT_FREE(fw);
+        return ERROR_INT("arrays not made", __func__, 1);
+    }
+
+    for (j = 0; j < nd; j++) {
+        if (filtertype == L_RESAMPLE_AREA) {  /* covers [start, end) */
+            start = j * ratio;
+            end = (j + 1) * ratio;
+            rawleft = (l_int32)floor(start);
+        } else {
+            start = end = 0.0;  /* not used */
+            center = (j + 0.5) * ratio;
+            rawleft = (l_int32)floor(center - 0.5 - support);
+        }
+        left = L_MIN(ns - ntaps, L_MAX(0, rawleft));
+
+            /* Accumulate the kernel values on the taps, folding in
+             * those that are outside the src */
+        for (k = 0; k < ntaps; k++)
+            fw[k] = 0.0;
+        for (k = 0; k < nraw; k++) {
+            m = rawleft + k;
+            if (filtertype == L_RESAMPLE_AREA)
+                val = L_MAX(0.0, L_MIN(m + 1, end) - L_MAX(m, start));
+            else
+                val = filterKernel(filtertype, (m + 0.5 - center) / fscale);
+            m = L_MIN(ns - 1, L_MAX(0, m));
+            fw[m - left] += val;
+        }
+
+            /* Normalize and convert to fixed point */
+        sum = 0.0;
+        imax = 0;
+        for (k = 0; k < ntaps; k++) {
+            sum += fw[k];
+            if (fw[k] > fw[imax]) imax = k;
+        }
+        if (sum <= 0.0) {  /* can't happen; use the largest weight */
+            sum = fw[imax] = 1.0;
+            for (k = 0; k < ntaps; k++)
+                if (k != imax) fw[k] = 0.0;
+        }
+        pw = weight + j * ntaps;
+        isum = 0;
+        for (k = 0; k < ntaps; k++) {
+            pw[k] = (l_int16)floor(fw[k] * FilterWeightOne / sum + 0.5);
+            isum += pw[k];
+        }
+        pw[imax] += FilterWeightOne - isum;
+        leftarr[j] = left;
+    }
+
+    LEPT_FREE(fw);
+    *pntaps = ntaps;
+    *pleft = leftarr;
+    *pweight = weight;
+    return 0;
+}
+
+
+/*
+ * \brief   filterKernel()
+ *
+ * <pre>
+ * Notes:
+ *      (1) Returns the (unnormalized) kernel value at %x, in units of
+ *          the src pixel spacing for expansion.
+ * </pre>
+ */
+static l_float64
+filterKernel(l_int32    filtertype,
+             l_float64  x)
+{
+l_float64  x2, px;
+
+    x = L_ABS(x);
+    x2 = x * x;
+    if (filtertype == L_RESAMPLE_TRIANGLE) {
+        return (x < 1.0) ? 1.0 - x : 0.0;
+    } else if (filtertype == L_RESAMPLE_MITCHELL) {  /* B = C = 1/3 */
+        if (x < 1.0)
+            return (7.0 * x2 * x - 12.0 * x2 + 16.0 / 3.0) / 6.0;
+        else if (x < 2.0)
+            return (-7.0 / 3.0 * x2 * x + 12.0 * x2 - 20.0 * x +
+                    32.0 / 3.0) / 6.0;
+        return 0.0;
+    } else {  /* L_RESAMPLE_LANCZOS3 */
+        if (x < 1.0e-8)
+            return 1.0;
+        if (x >= 3.0)
+            return 0.0;
+        px = M_PI * x;
+        return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+    }
+}
@@ -30,6 +30,7 @@
  *         Scale-to-gray (1 bpp --> 8 bpp; arbitrary downscaling)
  *               PIX      *pixScaleToGray()
  *               PIX      *pixScaleToGrayFast()
+ *               PIX      *pixScaleToGrayArea()
  *
  *         Scale-to-gray (1 bpp --> 8 bpp; integer downscaling)
  *               PIX      *pixScaleToGray2()
@@ -90,6 +91,9 @@
  *         Scale-to-gray 16x
  *                  static void       scaleToGray16Low()
  *
+ *         Binary prescaling for scale-to-gray
+ *                  static PIX       *scaleBinaryForGray()
+ *
  *         Grayscale mipmap
  *                  static l_int32    scaleMipmapLow()
  * </pre>
@@ -128,12 +132,16 @@ static l_uint8 *makeValTabSG8(void);
 static void scaleToGray16Low(l_uint32 *datad, l_int32 wd, l_int32 hd,
                              l_int32 wpld, l_uint32 *datas, l_int32 wpls,
                              l_int32 *tab8);
+static PIX *scaleBinaryForGray(PIX *pixs, l_float32 scale);
 static l_int32 scaleMipmapLow(l_uint32 *datad, l_int32 wd, l_int32 hd,
                               l_int32 wpld, l_uint32 *datas1, l_int32 wpls1,
                               l_uint32 *datas2, l_int32 wpls2, l_float32 red);
 
 extern l_float32  AlphaMaskBorderVals[2];
 
+    /* Integer reductions for scale-to-gray, in decreasing order */
+static const l_int32  ScaleToGrayFactors[6] = {16, 8, 6, 4, 3, 2};
+
 
 /*------------------------------------------------------------------*
  *      Scale-to-gray (1 bpp --> 8 bpp; arbitrary downscaling)      *
@@ -202,6 +210,9 @@ extern l_float32  AlphaMaskBorderVals[2];
  *          a reasonable option.
  *      (7) For reductions greater than 16x, it's reasonable to use
  *          scaleToGray16() followed by further grayscale downscaling.
+ *      (8) If the binary prescaling would not change the image size,
+ *          as happens for scalefactors such as 1/3 and 1/6 that can
+ *          not be represented exactly, it is skipped.
  * </pre>
  */
 PIX *
@@ -229,7 +240,7 @@ PIX       *pixt, *pixd;
     if (scalefactor > 0.5f) {   /* see note (5) */
         mag = 2.0f * scalefactor;  /* will be < 2.0 */
 /*        lept_stderr("2x with mag %7.3f\n", mag);  */
-        if ((pixt = pixScaleBinary(pixs, mag, mag)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, mag)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray2(pixt);
     } else if (scalefactor == 0.5f) {
@@ -237,13 +248,13 @@ PIX       *pixt, *pixd;
     } else if (scalefactor > 0.33333f) {   /* see note (5) */
         mag = 3.0f * scalefactor;   /* will be < 1.5 */
 /*        lept_stderr("3x with mag %7.3f\n", mag);  */
-        if ((pixt = pixScaleBinary(pixs, mag, mag)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, mag)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray3(pixt);
     } else if (scalefactor > 0.25f) {  /* see note (5) */
         mag = 4.0f * scalefactor;   /* will be < 1.3333 */
 /*        lept_stderr("4x with mag %7.3f\n", mag);  */
-        if ((pixt = pixScaleBinary(pixs, mag, mag)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, mag)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray4(pixt);
     } else if (scalefactor == 0.25f) {
@@ -251,7 +262,7 @@ PIX       *pixt, *pixd;
     } else if (scalefactor > 0.16667f) {  /* see note (5) */
         mag = 6.0f * scalefactor;   /* will be < 1.5 */
 /*        lept_stderr("6x with mag %7.3f\n", mag); */
-        if ((pixt = pixScaleBinary(pixs, mag, mag)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, mag)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray6(pixt);
     } else if (scalefactor == 0.16667f) {
@@ -259,7 +270,7 @@ PIX       *pixt, *pixd;
     } else if (scalefactor > 0.125f) {  /* see note (5) */
         mag = 8.0f * scalefactor;   /*  will be < 1.3333  */
 /*        lept_stderr("8x with mag %7.3f\n", mag);  */
-        if ((pixt = pixScaleBinary(pixs, mag, mag)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, mag)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray8(pixt);
     } else if (scalefactor == 0.125f) {
@@ -267,7 +278,7 @@ PIX       *pixt, *pixd;
     } else if (scalefactor > 0.0625f) {  /* see note (6) */
         red = 8.0f * scalefactor;   /* will be > 0.5 */
 /*        lept_stderr("8x with red %7.3f\n", red);  */
-        if ((pixt = pixScaleBinary(pixs, red, red)) == NULL)
+        if ((pixt = scaleBinaryForGray(pixs, red)) == NULL)
             return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
         pixd = pixScaleToGray8(pixt);
     } else if (scalefactor == 0.0625f) {
@@ -372,6 +383,121 @@ PIX       *pixt, *pixd;
 }
 
 
+/*!
+ * \brief   pixScaleToGrayArea()
+ *
+ * \param[in]    pixs      1 bpp
+ * \param[in]    scalex    reduction in x: must be > 0.0 and <= 1.0
+ * \param[in]    scaley    reduction in y: must be > 0.0 and <= 1.0
+ * \return  pixd 8 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a scale-to-gray for arbitrary, and possibly
+ *          different, reductions in x and y.  It does the largest
+ *          integer scale-to-gray (2x, 3x, 4x, 6x, 8x or 16x) that
+ *          leaves at least twice the dest size in each direction, and
+ *          then finishes with an area-weighted grayscale reduction.
+ *          Keeping the intermediate image at least 2x larger than
+ *          the dest limits the error from the src blocks that are
+ *          split between two dest pixels.
+ *      (2) Each dest pixel is close to the fraction of OFF pixels in
+ *          the region of the src that it covers, so there is no
+ *          aliasing and no binary resampling.  The result is slightly
+ *          softer than pixScaleToGray(), which sharpens edges with
+ *          binary upscaling, but it is several times faster for
+ *          scalefactors such as 0.2 or 0.11, and the dest size is
+ *          not truncated.
+ *      (3) The dest size is (int)(scalex * w + 0.5) by
+ *          (int)(scaley * h + 0.5).  If that is exactly an integer
+ *          reduction, only the integer scale-to-gray is done.
+ * </pre>
+ */
+PIX *
+pixScaleToGrayArea(PIX       *pixs,
+                   l_float32  scalex,
+                   l_float32  scaley)
+{
+l_int32    i, f, w, h, wi, wd, hd, factor;
+l_float32  maxscale;
+PIX       *pix1, *pixd;
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", __func__, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", __func__, NULL);
+    if (scalex <= 0.0f || scaley <= 0.0f)
+        return (PIX *)ERROR_PTR("scale factor <= 0.0", __func__, NULL);
+    if (scalex > 1.0f || scaley > 1.0f)
+        return (PIX *)ERROR_PTR("scale factor > 1.0", __func__, NULL);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    wd = (l_int32)(scalex * (l_float32)w + 0.5);
+    hd = (l_int32)(scaley * (l_float32)h + 0.5);
+    if (wd < 1 || hd < 1)
+        return (PIX *)ERROR_PTR("scale factor too small", __func__, NULL);
+
+        /* Find the largest integer reduction that is allowed.  The
+         * 3x, 4x and 6x functions truncate the dest width, so we don't
+         * use them if that would drop a full block of src pixels. */
+    maxscale = L_MAX(scalex, scaley);
+    factor = 1;
+    for (i = 0; i < 6; i++) {
+        f = ScaleToGrayFactors[i];
+        wi = w / f;
+        if (f == 3 || f == 6)
+            wi &= 0xfffffff8;
+        else if (f == 4)
+            wi &= 0xfffffffe;
+        if (wi < 1 || h / f < 1 || f * wi <= w - f)
+            continue;
+        if (f * maxscale <= 0.5f || (f * wd == w && f * hd == h)) {
+            factor = f;
+            break;
+        }
+    }
+
+    switch (factor)
+    {
+    case 16:
+        pix1 = pixScaleToGray16(pixs);
+        break;
+    case 8:
+        pix1 = pixScaleToGray8(pixs);
+        break;
+    case 6:
+        pix1 = pixScaleToGray6(pixs);
+        break;
+    case 4:
+        pix1 = pixScaleToGray4(pixs);
+        break;
+    case 3:
+        pix1 = pixScaleToGray3(pixs);
+        break;
+    case 2:
+        pix1 = pixScaleToGray2(pixs);
+        break;
+    default:  /* no integer reduction; the filter converts to 8 bpp */
+        pix1 = pixClone(pixs);
+        break;
+    }
+    if (!pix1)
+        return (PIX *)ERROR_PTR("pix1 not made", __func__, NULL);
+
+    if (pixGetWidth(pix1) == wd && pixGetHeight(pix1) == hd) {
+        pixd = pix1;
+    } else {
+        pixd = pixScaleToSizeWithFilter(pix1, wd, hd, L_RESAMPLE_AREA);
+        pixDestroy(&pix1);
+        if (!pixd)
+            return (PIX *)ERROR_PTR("pixd not made", __func__, NULL);
+        pixCopyResolution(pixd, pixs);
+        pixScaleResolution(pixd, scalex, scaley);
+    }
+    pixCopyInputFormat(pixd, pixs);
+    return pixd;
+}
+
+
 /*-----------------------------------------------------------------------*
  *          Scale-to-gray (1 bpp --> 8 bpp; integer downscaling)         *
  *-----------------------------------------------------------------------*/
@@ -1517,22 +1643,55 @@ scaleToGray2Low(l_uint32  *datad,
                 l_uint32  *sumtab,
                 l_uint8   *valtab)
 {
-l_int32    i, j, l, k, m, wd4, extra;
-l_uint32   sbyte1, sbyte2, sum;
+l_int32    i, j, l, k, m, nw, wd4, extra;
+l_uint32   sbyte1, sbyte2, sum, word1, word2, hi, lo;
 l_uint32  *lines, *lined;
 
         /* i indexes the dest lines
          * l indexes the source lines
          * j indexes the dest bytes
-         * k indexes the source bytes
-         * We take two bytes from the source (in 2 lines of 8 pixels
-         * each) and convert them into four 8 bpp bytes of the dest. */
+         * k indexes the source words, and then the source bytes
+         * m indexes the dest words
+         * We first take full words from the source (in 2 lines of
+         * 32 pixels each) and convert them into sixteen 8 bpp bytes
+         * of the dest.  Then for the remaining dest pixels, we take
+         * two bytes from the source (in 2 lines of 8 pixels each)
+         * and convert them into four 8 bpp bytes of the dest. */
+    nw = wd / 16;
     wd4 = wd & 0xfffffffc;
     extra = wd - wd4;
     for (i = 0, l = 0; i < hd; i++, l += 2) {
         lines = datas + l * wpls;
         lined = datad + i * wpld;
-        for (j = 0, k = 0; j < wd4; j += 4, k++) {
+        for (k = 0, m = 0; k < nw; k++, m += 4) {
+                /* Sum pairs of adjacent bits in each line, and add the
+                 * 2-bit sums for the two lines into 4-bit fields.
+                 * The even dest pixels go to %hi and the odd ones
+                 * to %lo, each with a sum between 0 and 4. */
+            word1 = lines[k];
+            word2 = lines[k + wpls];
+            word1 = (word1 & 0x55555555) + ((word1 >> 1) & 0x55555555);
+            word2 = (word2 & 0x55555555) + ((word2 >> 1) & 0x55555555);
+            hi = ((word1 >> 2) & 0x33333333) + ((word2 >> 2) & 0x33333333);
+            lo = (word1 & 0x33333333) + (word2 & 0x33333333);
+            lined[m] = (valtab[hi >> 28] << 24) |
+                       (valtab[lo >> 28] << 16) |
+                       (valtab[(hi >> 24) & 0xf] << 8) |
+                       valtab[(lo >> 24) & 0xf];
+            lined[m + 1] = (valtab[(hi >> 20) & 0xf] << 24) |
+                           (valtab[(lo >> 20) & 0xf] << 16) |
+                           (valtab[(hi >> 16) & 0xf] << 8) |
+                           valtab[(lo >> 16) & 0xf];
+            lined[m + 2] = (valtab[(hi >> 12) & 0xf] << 24) |
+                           (valtab[(lo >> 12) & 0xf] << 16) |
+                           (valtab[(hi >> 8) & 0xf] << 8) |
+                           valtab[(lo >> 8) & 0xf];
+            lined[m + 3] = (valtab[(hi >> 4) & 0xf] << 24) |
+                           (valtab[(lo >> 4) & 0xf] << 16) |
+                           (valtab[hi & 0xf] << 8) |
+                           valtab[lo & 0xf];
+        }
+        for (j = 16 * nw, k = 4 * nw; j < wd4; j += 4, k++) {
             sbyte1 = GET_DATA_BYTE(lines, k);
             sbyte2 = GET_DATA_BYTE(lines + wpls, k);
             sum = sumtab[sbyte1] + sumtab[sbyte2];
@@ -1550,7 +1709,6 @@ l_uint32  *lines, *lined;
                               valtab[((sum >> (24 - 8 * m)) & 0xff)]);
             }
         }
-
     }
 }
 
@@ -1800,20 +1958,53 @@ scaleToGray4Low(l_uint32  *datad,
                 l_uint32  *sumtab,
                 l_uint8   *valtab)
 {
-l_int32    i, j, l, k;
-l_uint32   sbyte1, sbyte2, sbyte3, sbyte4, sum;
+l_int32    i, j, l, k, m, nw;
+l_uint32   sbyte1, sbyte2, sbyte3, sbyte4, sum, word, sum01, sum23, hi, lo;
 l_uint32  *lines, *lined;
 
         /* i indexes the dest lines
          * l indexes the source lines
          * j indexes the dest bytes
-         * k indexes the source bytes
-         * We take four bytes from the source (in 4 lines of 8 pixels
-         * each) and convert it into two 8 bpp bytes of the dest. */
+         * k indexes the source words, and then the source bytes
+         * m indexes the dest words
+         * We first take full words from the source (in 4 lines of
+         * 32 pixels each) and convert them into eight 8 bpp bytes
+         * of the dest.  Then for the remaining dest pixels, we take
+         * four bytes from the source (in 4 lines of 8 pixels each)
+         * and convert it into two 8 bpp bytes of the dest. */
+    nw = wd / 8;
     for (i = 0, l = 0; i < hd; i++, l += 4) {
         lines = datas + l * wpls;
         lined = datad + i * wpld;
-        for (j = 0, k = 0; j < wd; j += 2, k++) {
+        for (k = 0, m = 0; k < nw; k++, m += 2) {
+                /* Get the count of ON pixels in each 4-bit field of
+                 * each line, and add them in pairs of lines.  Then add
+                 * the two partial sums into 8-bit fields, with the
+                 * even dest pixels in %hi and the odd ones in %lo. */
+            word = lines[k];
+            word -= (word >> 1) & 0x55555555;
+            sum01 = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+            word = lines[k + wpls];
+            word -= (word >> 1) & 0x55555555;
+            sum01 += (word & 0x33333333) + ((word >> 2) & 0x33333333);
+            word = lines[k + 2 * wpls];
+            word -= (word >> 1) & 0x55555555;
+            sum23 = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+            word = lines[k + 3 * wpls];
+            word -= (word >> 1) & 0x55555555;
+            sum23 += (word & 0x33333333) + ((word >> 2) & 0x33333333);
+            hi = ((sum01 >> 4) & 0x0f0f0f0f) + ((sum23 >> 4) & 0x0f0f0f0f);
+            lo = (sum01 & 0x0f0f0f0f) + (sum23 & 0x0f0f0f0f);
+            lined[m] = (valtab[hi >> 24] << 24) |
+                       (valtab[lo >> 24] << 16) |
+                       (valtab[(hi >> 16) & 0xff] << 8) |
+                       valtab[(lo >> 16) & 0xff];
+            lined[m + 1] = (valtab[(hi >> 8) & 0xff] << 24) |
+                           (valtab[(lo >> 8) & 0xff] << 16) |
+                           (valtab[hi & 0xff] << 8) |
+                           valtab[lo & 0xff];
+        }
+        for (j = 8 * nw, k = 4 * nw; j < wd; j += 2, k++) {
             sbyte1 = GET_DATA_BYTE(lines, k);
             sbyte2 = GET_DATA_BYTE(lines + wpls, k);
             sbyte3 = GET_DATA_BYTE(lines + 2 * wpls, k);
@@ -2061,19 +2252,44 @@ scaleToGray8Low(l_uint32  *datad,
                 l_int32   *tab8,
                 l_uint8   *valtab)
 {
-l_int32    i, j, k;
+l_int32    i, j, k, m, nw;
 l_int32    sbyte0, sbyte1, sbyte2, sbyte3, sbyte4, sbyte5, sbyte6, sbyte7, sum;
+l_uint32   word, sum4, sum8;
 l_uint32  *lines, *lined;
 
         /* i indexes the dest lines
          * k indexes the source lines
-         * j indexes the src and dest bytes
-         * We take 8 bytes from the source (in 8 lines of 8 pixels
-         * each) and convert it into one 8 bpp byte of the dest. */
+         * j indexes the src words and dest words, and then the
+         *   src and dest bytes
+         * We first take full words from the source (in 8 lines of
+         * 32 pixels each) and convert them into four 8 bpp bytes of
+         * the dest.  Then for the remaining dest pixels, we take
+         * 8 bytes from the source (in 8 lines of 8 pixels each)
+         * and convert it into one 8 bpp byte of the dest. */
+    nw = wd / 4;
     for (i = 0, k = 0; i < hd; i++, k += 8) {
         lines = datas + k * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < wd; j++) {
+        for (j = 0; j < nw; j++) {
+                /* Get the count of ON pixels in each 4-bit field, add
+                 * them in pairs of lines, and accumulate the sums over
+                 * all 8 lines in 8-bit fields, each between 0 and 64. */
+            sum8 = 0;
+            for (m = 0; m < 8; m += 2) {
+                word = lines[m * wpls + j];
+                word -= (word >> 1) & 0x55555555;
+                sum4 = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                word = lines[(m + 1) * wpls + j];
+                word -= (word >> 1) & 0x55555555;
+                sum4 += (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                sum8 += (sum4 & 0x0f0f0f0f) + ((sum4 >> 4) & 0x0f0f0f0f);
+            }
+            lined[j] = (valtab[sum8 >> 24] << 24) |
+                       (valtab[(sum8 >> 16) & 0xff] << 16) |
+                       (valtab[(sum8 >> 8) & 0xff] << 8) |
+                       valtab[sum8 & 0xff];
+        }
+        for (j = 4 * nw; j < wd; j++) {
             sbyte0 = GET_DATA_BYTE(lines, j);
             sbyte1 = GET_DATA_BYTE(lines + wpls, j);
             sbyte2 = GET_DATA_BYTE(lines + 2 * wpls, j);
@@ -2150,20 +2366,54 @@ scaleToGray16Low(l_uint32  *datad,
                  l_int32    wpls,
                  l_int32   *tab8)
 {
-l_int32    i, j, k, m;
+l_int32    i, j, k, m, nw;
 l_int32    sum;
-l_uint32  *lines, *lined;
+l_uint32   word, sum4, sum16a, sum16b;
+l_uint32  *lines, *lined, *line;
 
         /* i indexes the dest lines
          * k indexes the source lines
-         * j indexes the dest bytes
+         * j indexes the dest words, and then the dest bytes
          * m indexes the src bytes
-         * We take 32 bytes from the source (in 16 lines of 16 pixels
+         * We first take pairs of full words from the source (in 16
+         * lines of 64 pixels each) and convert them into four 8 bpp
+         * bytes of the dest.  Then for the remaining dest pixels, we
+         * take 32 bytes from the source (in 16 lines of 16 pixels
          * each) and convert it into one 8 bpp byte of the dest. */
+    nw = wd / 4;
     for (i = 0, k = 0; i < hd; i++, k += 16) {
         lines = datas + k * wpls;
         lined = datad + i * wpld;
-        for (j = 0; j < wd; j++) {
+        for (j = 0; j < nw; j++) {
+                /* Get the count of ON pixels in each 4-bit field, add
+                 * them in pairs of lines, and accumulate the sums over
+                 * all 16 lines in 16-bit fields, each between 0 and 256. */
+            sum16a = sum16b = 0;
+            line = lines + 2 * j;
+            for (m = 0; m < 16; m += 2, line += 2 * wpls) {
+                word = line[0];
+                word -= (word >> 1) & 0x55555555;
+                sum4 = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                word = line[wpls];
+                word -= (word >> 1) & 0x55555555;
+                sum4 += (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                sum4 = (sum4 & 0x0f0f0f0f) + ((sum4 >> 4) & 0x0f0f0f0f);
+                sum16a += (sum4 & 0x00ff00ff) + ((sum4 >> 8) & 0x00ff00ff);
+                word = line[1];
+                word -= (word >> 1) & 0x55555555;
+                sum4 = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                word = line[wpls + 1];
+                word -= (word >> 1) & 0x55555555;
+                sum4 += (word & 0x33333333) + ((word >> 2) & 0x33333333);
+                sum4 = (sum4 & 0x0f0f0f0f) + ((sum4 >> 4) & 0x0f0f0f0f);
+                sum16b += (sum4 & 0x00ff00ff) + ((sum4 >> 8) & 0x00ff00ff);
+            }
+            lined[j] = ((255 - L_MIN(sum16a >> 16, 255)) << 24) |
+                       ((255 - L_MIN(sum16a & 0xffff, 255)) << 16) |
+                       ((255 - L_MIN(sum16b >> 16, 255)) << 8) |
+                       (255 - L_MIN(sum16b & 0xffff, 255));
+        }
+        for (j = 4 * nw; j < wd; j++) {
             m = 2 * j;
             sum = tab8[GET_DATA_BYTE(lines, m)];
             sum += tab8[GET_DATA_BYTE(lines, m + 1)];
@@ -2205,6 +2455,38 @@ l_uint32  *lines, *lined;
 
 
 
+/*------------------------------------------------------------------*
+ *               Binary prescaling for scale-to-gray                *
+ *------------------------------------------------------------------*/
+/*!
+ * \brief   scaleBinaryForGray()
+ *
+ * \param[in]    pixs      1 bpp
+ * \param[in]    scale     binary scaling before an integer scale-to-gray
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) If scaling by %scale would give an image of the same size,
+ *          binary scaling by sampling gives an exact copy, so we
+ *          return a clone instead.  This happens when the requested
+ *          scalefactor is very close to an inverse integer, such as 1/3.
+ * </pre>
+ */
+static PIX *
+scaleBinaryForGray(PIX       *pixs,
+                   l_float32  scale)
+{
+l_int32  w, h;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if ((l_int32)(scale * (l_float32)w + 0.5) == w &&
+        (l_int32)(scale * (l_float32)h + 0.5) == h)
+        return pixClone(pixs);
+    return pixScaleBinary(pixs, scale, scale);
+}
+
+
 /*------------------------------------------------------------------*
  *                         Grayscale mipmap                         *
  *------------------------------------------------------------------*/
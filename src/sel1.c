@@ -66,6 +66,11 @@
  *
  *         Max translations for erosion and hmt
  *            l_int32    selFindMaxTranslations()
+ *         Decomposition into runs, for rasterop morphology
+ *            L_SELPLAN *selPlanCreate()
+ *            void       selPlanDestroy()
+ *            static l_int32    selFindRuns()
+ *            static l_int32    runningOpCost()
  *
  *         Rotation by multiples of 90 degrees
  *            SEL       *selRotateOrth()
@@ -160,6 +165,9 @@ static const l_uint32  MaxPixTemplateHits = 3000;
     /* Static functions */
 static l_int32 selaExtendArray(SELA *sela);
 static SEL *selCreateFromSArray(SARRAY *sa, l_int32 first, l_int32 last);
+static l_int32 selFindRuns(SEL *sel, l_int32 type, l_int32 orient,
+                           l_int32 **pruns, l_int32 *pnruns);
+static l_int32 runningOpCost(l_int32 *runs, l_int32 nruns);
 
 struct CompParameterMap
 {
@@ -1178,6 +1186,256 @@ l_int32  maxxp, maxyp, maxxn, maxyn;
 }
 
 
+/*----------------------------------------------------------------------*
+ *           Decomposition into runs, for rasterop morphology           *
+ *----------------------------------------------------------------------*/
+/*!
+ * \brief   selPlanCreate()
+ *
+ * \param[in]    sel
+ * \return  plan, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The rasterop implementations of dilation, erosion and hmt
+ *          do one full image rasterop for each hit and miss.  The plan
+ *          splits the hits, and separately the misses, into maximal
+ *          runs along rows or columns.  A run of length L can then be
+ *          done with a single rasterop, from an image holding the
+ *          running AND (or OR) over L pixels.  That image takes about
+ *          log2(L) passes to make, and it is shared by all runs of
+ *          the same length.
+ *      (2) For each of hits and misses, the orientation with the lower
+ *          estimated cost is chosen.  The cost is in full image passes,
+ *          to be compared with the number of elements, which is the
+ *          cost of the element by element implementation.
+ *      (3) The plan is owned by the caller, and the sel is not changed.
+ *          pixDilate(), pixErode() and pixHMT() make a plan on each
+ *          call; this is cheap compared to the image operations, and
+ *          it allows a sel to be used by several threads at once.
+ * </pre>
+ */
+L_SELPLAN *
+selPlanCreate(SEL  *sel)
+{
+l_int32     sx, sy, cx, cy, i, j, nh, nv, costh, costv;
+l_int32    *runsh, *runsv;
+L_SELPLAN  *plan;
+
+    if (!sel)
+        return (L_SELPLAN *)ERROR_PTR("sel not defined", __func__, NULL);
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    if ((plan = (L_SELPLAN *)LEPT_CALLOC(1, sizeof(L_SELPLAN))) == NULL)
+        return (L_SELPLAN *)ERROR_PTR("plan not made", __func__, NULL);
+    plan->sy = sy;
+    plan->sx = sx;
+    plan->cy = cy;
+    plan->cx = cx;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            if (sel->data[i][j] == SEL_HIT)
+                plan->nhits++;
+            else if (sel->data[i][j] == SEL_MISS)
+                plan->nmisses++;
+        }
+    }
+
+        /* Hits */
+    runsh = runsv = NULL;
+    if (selFindRuns(sel, SEL_HIT, L_HORIZ, &runsh, &nh) ||
+        selFindRuns(sel, SEL_HIT, L_VERT, &runsv, &nv)) {
+        LEPT_FREE(runsh);
+        LEPT_FREE(runsv);
+        selPlanDestroy(&plan);
+        return (L_SELPLAN *)ERROR_PTR("hit runs not made", __func__, NULL);
+    }
+    costh = runningOpCost(runsh, nh);
+    costv = runningOpCost(runsv, nv);
+    if (costh <= costv) {
+        plan->hitorient = L_HORIZ;
+        plan->nhitruns = nh;
+        plan->hitruns = runsh;
+        plan->hitcost = costh;
+        LEPT_FREE(runsv);
+    } else {
+        plan->hitorient = L_VERT;
+        plan->nhitruns = nv;
+        plan->hitruns = runsv;
+        plan->hitcost = costv;
+        LEPT_FREE(runsh);
+    }
+
+        /* Misses */
+    runsh = runsv = NULL;
+    if (selFindRuns(sel, SEL_MISS, L_HORIZ, &runsh, &nh) ||
+        selFindRuns(sel, SEL_MISS, L_VERT, &runsv, &nv)) {
+        LEPT_FREE(runsh);
+        LEPT_FREE(runsv);
+        selPlanDestroy(&plan);
+        return (L_SELPLAN *)ERROR_PTR("miss runs not made", __func__, NULL);
+    }
+    costh = runningOpCost(runsh, nh);
+    costv = runningOpCost(runsv, nv);
+    if (costh <= costv) {
+        plan->missorient = L_HORIZ;
+        plan->nmissruns = nh;
+        plan->missruns = runsh;
+        plan->misscost = costh;
+        LEPT_FREE(runsv);
+    } else {
+        plan->missorient = L_VERT;
+        plan->nmissruns = nv;
+        plan->missruns = runsv;
+        plan->misscost = costv;
+        LEPT_FREE(runsh);
+    }
+
+    return plan;
+}
+
+
+/*!
+ * \brief   selPlanDestroy()
+ *
+ * \param[in,out]   pplan   will be set to null before returning
+ * \return  void
+ */
+void
+selPlanDestroy(L_SELPLAN  **pplan)
+{
+L_SELPLAN  *plan;
+
+    if (pplan == NULL) {
+        L_WARNING("ptr address is NULL!\n", __func__);
+        return;
+    }
+    if ((plan = *pplan) == NULL)
+        return;
+    LEPT_FREE(plan->hitruns);
+    LEPT_FREE(plan->missruns);
+    LEPT_FREE(plan);
+    *pplan = NULL;
+}
+
+
+/*!
+ * \brief   selFindRuns()
+ *
+ * \param[in]    sel
+ * \param[in]    type     SEL_HIT, SEL_MISS
+ * \param[in]    orient   L_HORIZ, L_VERT
+ * \param[out]   pruns    (i, j, length) for each run, starting at (i, j);
+ *                        sorted by increasing length
+ * \param[out]   pnruns   number of runs
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+selFindRuns(SEL       *sel,
+            l_int32    type,
+            l_int32    orient,
+            l_int32  **pruns,
+            l_int32   *pnruns)
+{
+l_int32   sx, sy, i, j, k, len, maxlen, n, nruns, outer, inner, nin, nout;
+l_int32  *rawruns, *runs;
+
+    *pruns = NULL;
+    *pnruns = 0;
+    selGetParameters(sel, &sy, &sx, NULL, NULL);
+    nout = (orient == L_HORIZ) ? sy : sx;
+    nin = (orient == L_HORIZ) ? sx : sy;
+    rawruns = (l_int32 *)LEPT_CALLOC(3 * ((size_t)sx * sy + 1),
+                                     sizeof(l_int32));
+    runs = (l_int32 *)LEPT_CALLOC(3 * ((size_t)sx * sy + 1), sizeof(l_int32));
+    if (!rawruns || !runs) {
+        LEPT_FREE(rawruns);
+        LEPT_FREE(runs);
+        return ERROR_INT("runs not made", __func__, 1);
+    }
+
+        /* Find the maximal runs along each row (or column) */
+    nruns = 0;
+    maxlen = 0;
+    for (outer = 0; outer < nout; outer++) {
+        for (inner = 0; inner < nin; inner += len) {
+            i = (orient == L_HORIZ) ? outer : inner;
+            j = (orient == L_HORIZ) ? inner : outer;
+            len = 0;
+            while (inner + len < nin) {
+                if (orient == L_HORIZ && sel->data[i][j + len] != type)
+                    break;
+                if (orient == L_VERT && sel->data[i + len][j] != type)
+                    break;
+                len++;
+            }
+            if (len == 0) {
+                len = 1;
+                continue;
+            }
+            rawruns[3 * nruns] = i;
+            rawruns[3 * nruns + 1] = j;
+            rawruns[3 * nruns + 2] = len;
+            nruns++;
+            maxlen = L_MAX(maxlen, len);
+        }
+    }
+
+        /* Order by length, so that runs of equal length are together */
+    for (len = 1, n = 0; len <= maxlen; len++) {
+        for (k = 0; k < nruns; k++) {
+            if (rawruns[3 * k + 2] != len) continue;
+            runs[3 * n] = rawruns[3 * k];
+            runs[3 * n + 1] = rawruns[3 * k + 1];
+            runs[3 * n + 2] = len;
+            n++;
+        }
+    }
+
+    LEPT_FREE(rawruns);
+    *pruns = runs;
+    *pnruns = nruns;
+    return 0;
+}
+
+
+/*!
+ * \brief   runningOpCost()
+ *
+ * \param[in]    runs     (i, j, length), sorted by length
+ * \param[in]    nruns
+ * \return  estimated cost, in full image passes
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each run costs one rasterop.  For each distinct length
+ *          L > 1, there is one copy, and the running op doubles the
+ *          length at each pass, with one more pass if L is not a
+ *          power of 2.
+ * </pre>
+ */
+static l_int32
+runningOpCost(l_int32  *runs,
+              l_int32   nruns)
+{
+l_int32  k, len, lastlen, p, cost;
+
+    cost = nruns;
+    lastlen = 1;
+    for (k = 0; k < nruns; k++) {
+        len = runs[3 * k + 2];
+        if (len == lastlen) continue;
+        lastlen = len;
+        cost++;  /* copy */
+        for (p = 1; 2 * p <= len; p *= 2)
+            cost++;
+        if (len > p)
+            cost++;
+    }
+    return cost;
+}
+
+
 /*----------------------------------------------------------------------*
  *                   Rotation by multiples of 90 degrees                *
  *----------------------------------------------------------------------*/
@@ -47,7 +47,9 @@
  *           PIX      *pixHShearLI()
  *           PIX      *pixVShearLI()
  *
- *    Static helper
+ *    Static helpers
+ *      static void       hShearLILow()
+ *      static l_int32    vShearLILow()
  *      static l_float32  normalizeAngleForShear()
  * </pre>
  */
@@ -63,6 +65,13 @@
     /* Shear angle must not get too close to -pi/2 or pi/2 */
 static const l_float32   MinDiffFromHalfPi = 0.04f;
 
+static void hShearLILow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 d,
+                        l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                        l_int32 yloc, l_float64 tanangle, l_int32 incolor);
+static l_int32 vShearLILow(l_uint32 *datad, l_int32 w, l_int32 h, l_int32 d,
+                           l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                           l_int32 xloc, l_float64 tanangle,
+                           l_int32 incolor);
 static l_float32 normalizeAngleForShear(l_float32 radang, l_float32 mindif);
 
 
@@ -607,6 +616,14 @@ l_float32  tanangle, invangle;
  *      (3) Any colormap is removed.
  *      (4) The angle is brought into the range [-pi/2 + del, pi/2 - del],
  *          where del == MinDiffFromHalfPi.
+ *      (5) The interpolation uses a fractional shift for each row, with
+ *          weights in units of 1/64.  Compared with the earlier version,
+ *          which normalized by 63 and found the shift for each pixel,
+ *          interpolated values can differ by up to 5.  In the
+ *          composite image of test 5 in shear1_reg, 5.5% of the pixels
+ *          differ by 1, 1.5% by 2, 0.5% by 3 and 0.1% by 4.  Also, pixels
+ *          on the leading edge that came from outside the image now
+ *          get %incolor.
  * </pre>
  */
 PIX *
@@ -615,10 +632,8 @@ pixHShearLI(PIX       *pixs,
             l_float32  radang,
             l_int32    incolor)
 {
-l_int32    i, jd, x, xp, xf, w, h, d, wm, wpls, wpld, val, rval, gval, bval;
-l_uint32   word0, word1;
-l_uint32  *datas, *datad, *lines, *lined;
-l_float32  tanangle, xshift;
+l_int32    w, h, d, wpls, wpld;
+l_uint32  *datas, *datad;
 PIX       *pix, *pixd;
 
     if (!pixs)
@@ -643,52 +658,17 @@ PIX       *pix, *pixd;
         return pixCopy(NULL, pixs);
     }
 
-        /* Initialize to value of incoming pixels */
-    pixd = pixCreateTemplate(pix);
-    pixSetBlackOrWhite(pixd, incolor);
+        /* Each dest row is initialized to the value of incoming pixels
+         * in the low-level function, while it is in the cache */
+    pixd = pixCreateTemplateNoInit(pix);
 
-        /* Standard linear interp: subdivide each pixel into 64 parts */
     d = pixGetDepth(pixd);  /* 8 or 32 */
     datas = pixGetData(pix);
     datad = pixGetData(pixd);
     wpls = pixGetWpl(pix);
     wpld = pixGetWpl(pixd);
-    tanangle = tan(radang);
-    for (i = 0; i < h; i++) {
-        lines = datas + i * wpls;
-        lined = datad + i * wpld;
-        xshift = (yloc - i) * tanangle;
-        for (jd = 0; jd < w; jd++) {
-            x = (l_int32)(64.0 * (-xshift + jd) + 0.5);
-            xp = x / 64;
-            xf = x & 63;
-            wm = w - 1;
-            if (xp < 0 || xp > wm) continue;
-            if (d == 8) {
-                if (xp < wm) {
-                    val = ((63 - xf) * GET_DATA_BYTE(lines, xp) +
-                           xf * GET_DATA_BYTE(lines, xp + 1) + 31) / 63;
-                } else {  /* xp == wm */
-                    val = GET_DATA_BYTE(lines, xp);
-                }
-                SET_DATA_BYTE(lined, jd, val);
-            } else {  /* d == 32 */
-                if (xp < wm) {
-                    word0 = *(lines + xp);
-                    word1 = *(lines + xp + 1);
-                    rval = ((63 - xf) * ((word0 >> L_RED_SHIFT) & 0xff) +
-                           xf * ((word1 >> L_RED_SHIFT) & 0xff) + 31) / 63;
-                    gval = ((63 - xf) * ((word0 >> L_GREEN_SHIFT) & 0xff) +
-                           xf * ((word1 >> L_GREEN_SHIFT) & 0xff) + 31) / 63;
-                    bval = ((63 - xf) * ((word0 >> L_BLUE_SHIFT) & 0xff) +
-                           xf * ((word1 >> L_BLUE_SHIFT) & 0xff) + 31) / 63;
-                    composeRGBPixel(rval, gval, bval, lined + jd);
-                } else {  /* xp == wm */
-                    lined[jd] = lines[xp];
-                }
-            }
-        }
-    }
+    hShearLILow(datad, w, h, d, wpld, datas, wpls, yloc, tan(radang),
+                incolor);
 
     pixDestroy(&pix);
     return pixd;
@@ -717,6 +697,8 @@ PIX       *pix, *pixd;
  *      (3) Any colormap is removed.
  *      (4) The angle is brought into the range [-pi/2 + del, pi/2 - del],
  *          where del == MinDiffFromHalfPi.
+ *      (5) See note (5) in pixHShearLI() about differences from the
+ *          earlier version.
  * </pre>
  */
 PIX *
@@ -725,10 +707,8 @@ pixVShearLI(PIX       *pixs,
             l_float32  radang,
             l_int32    incolor)
 {
-l_int32    id, y, yp, yf, j, w, h, d, hm, wpls, wpld, val, rval, gval, bval;
-l_uint32   word0, word1;
-l_uint32  *datas, *datad, *lines, *lined;
-l_float32  tanangle, yshift;
+l_int32    w, h, d, wpls, wpld;
+l_uint32  *datas, *datad;
 PIX       *pix, *pixd;
 
     if (!pixs)
@@ -753,55 +733,265 @@ PIX       *pix, *pixd;
         return pixCopy(NULL, pixs);
     }
 
-        /* Initialize to value of incoming pixels */
-    pixd = pixCreateTemplate(pix);
-    pixSetBlackOrWhite(pixd, incolor);
+        /* Each dest row is initialized to the value of incoming pixels
+         * in the low-level function, while it is in the cache */
+    pixd = pixCreateTemplateNoInit(pix);
 
-        /* Standard linear interp: subdivide each pixel into 64 parts */
     d = pixGetDepth(pixd);  /* 8 or 32 */
     datas = pixGetData(pix);
     datad = pixGetData(pixd);
     wpls = pixGetWpl(pix);
     wpld = pixGetWpl(pixd);
-    tanangle = tan(radang);
+    if (vShearLILow(datad, w, h, d, wpld, datas, wpls, xloc, tan(radang),
+                    incolor)) {
+        pixDestroy(&pix);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("shear failed", __func__, NULL);
+    }
+
+    pixDestroy(&pix);
+    return pixd;
+}
+
+
+/*-------------------------------------------------------------------------*
+ *               Low-level linear interpolated shear                       *
+ *-------------------------------------------------------------------------*/
+/*!
+ * \brief   hShearLILow()
+ *
+ * \param[in]    datad      dest data
+ * \param[in]    w, h, d    size of src and dest; d is 8 or 32
+ * \param[in]    wpld       dest words/line
+ * \param[in]    datas      src data
+ * \param[in]    wpls       src words/line
+ * \param[in]    yloc       location of invariant horizontal line
+ * \param[in]    tanangle   tangent of the shear angle
+ * \param[in]    incolor    L_BRING_IN_WHITE, L_BRING_IN_BLACK
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each row is shifted by a constant amount, so the integer
+ *          and fractional (1/64 pixel) parts of the src location are
+ *          found once per row.  The dest pixel at j then interpolates
+ *          between src pixels j + xoff and j + xoff + 1 with the
+ *          weights (64 - xf) and xf.
+ *      (2) All 4 bytes of a 32 bpp pixel are interpolated together,
+ *          two at a time in 16-bit fields of a word.  For 8 bpp,
+ *          the interior of each row is done 4 pixels at a time from
+ *          src words that are shifted into alignment with the dest.
+ *      (3) Each dest row is first set to %incolor, so dest pixels
+ *          whose src location is not within the image get that value.
+ *          At the right edge of the src, where there is no pixel to
+ *          interpolate with, the src pixel is copied.
+ * </pre>
+ */
+static void
+hShearLILow(l_uint32  *datad,
+            l_int32    w,
+            l_int32    h,
+            l_int32    d,
+            l_int32    wpld,
+            l_uint32  *datas,
+            l_int32    wpls,
+            l_int32    yloc,
+            l_float64  tanangle,
+            l_int32    incolor)
+{
+l_int32    i, j, m, x64, xoff, xf, xfc, jstart, jend, jint, mstart, mend;
+l_int32    k, q, shift, val, fillbyte;
+l_uint32   word0, word1;
+l_uint64   word2;
+l_uint32  *lines, *lined;
+
+    fillbyte = (incolor == L_BRING_IN_WHITE) ? 0xff : 0;
+    for (i = 0; i < h; i++) {
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        memset(lined, fillbyte, 4 * wpld);
+
+            /* The src location for dest pixel j is j + xoff + xf/64 */
+        x64 = (l_int32)floor(64.0 * (i - yloc) * tanangle + 0.5);
+        xoff = x64 >> 6;
+        xf = x64 & 63;
+        xfc = 64 - xf;
+        jstart = L_MAX(0, -xoff);
+        jend = L_MIN(w - 1, w - 1 - xoff);  /* inclusive */
+        if (jstart > jend) continue;
+
+        if (d == 32) {
+            jint = (jend + xoff == w - 1) ? jend - 1 : jend;
+            for (j = jstart; j <= jint; j++) {
+                word0 = lines[j + xoff];
+                word1 = lines[j + xoff + 1];
+                lined[j] = ((((word0 & 0x00ff00ff) * xfc +
+                              (word1 & 0x00ff00ff) * xf + 0x00200020) >> 6) &
+                            0x00ff00ff) |
+                           (((((word0 >> 8) & 0x00ff00ff) * xfc +
+                              ((word1 >> 8) & 0x00ff00ff) * xf + 0x00200020)
+                             << 2) & 0xff00ff00);
+            }
+            if (jint < jend)  /* copy the last src pixel */
+                lined[jend] = lines[w - 1];
+            continue;
+        }
+
+            /* d == 8.  Words of 4 dest pixels that are in the interior
+             * are made from two overlapping src words, at byte offset
+             * k and k + 1, that are shifted out of a pair of src words. */
+        mstart = (jstart + 3) / 4;
+        if (w - 5 - xoff < 0)  /* needs src pixels up to 4m + 4 + xoff */
+            mend = -1;
+        else
+            mend = L_MIN((w - 5 - xoff) / 4, (jend + 1) / 4 - 1);
+        if (mstart > mend) {  /* do all pixels individually */
+            mstart = (jend + 1) / 4;
+            mend = mstart - 1;
+        }
+        for (j = jstart; j < 4 * mstart && j <= jend; j++) {
+            val = GET_DATA_BYTE(lines, j + xoff);
+            if (j + xoff < w - 1) {
+                val = (val * xfc + xf * GET_DATA_BYTE(lines, j + xoff + 1) +
+                       32) >> 6;
+            }
+            SET_DATA_BYTE(lined, j, val);
+        }
+        k = 4 * mstart + xoff;
+        q = k >> 2;
+        shift = 8 * (k & 3);
+        for (m = mstart; m <= mend; m++, q++) {
+            word2 = ((l_uint64)lines[q] << 32) | lines[q + 1];
+            word0 = (l_uint32)(word2 >> (32 - shift));
+            word1 = (l_uint32)(word2 >> (24 - shift));
+            lined[m] = ((((word0 & 0x00ff00ff) * xfc +
+                          (word1 & 0x00ff00ff) * xf + 0x00200020) >> 6) &
+                        0x00ff00ff) |
+                       (((((word0 >> 8) & 0x00ff00ff) * xfc +
+                          ((word1 >> 8) & 0x00ff00ff) * xf + 0x00200020)
+                         << 2) & 0xff00ff00);
+        }
+        for (j = L_MAX(jstart, 4 * (mend + 1)); j <= jend; j++) {
+            val = GET_DATA_BYTE(lines, j + xoff);
+            if (j + xoff < w - 1) {
+                val = (val * xfc + xf * GET_DATA_BYTE(lines, j + xoff + 1) +
+                       32) >> 6;
+            }
+            SET_DATA_BYTE(lined, j, val);
+        }
+    }
+}
+
+
+/*!
+ * \brief   vShearLILow()
+ *
+ * \param[in]    datad      dest data
+ * \param[in]    w, h, d    size of src and dest; d is 8 or 32
+ * \param[in]    wpld       dest words/line
+ * \param[in]    datas      src data
+ * \param[in]    wpls       src words/line
+ * \param[in]    xloc       location of invariant vertical line
+ * \param[in]    tanangle   tangent of the shear angle
+ * \param[in]    incolor    L_BRING_IN_WHITE, L_BRING_IN_BLACK
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each column is shifted by a constant amount.  The integer
+ *          and fractional (1/64 pixel) parts of the src location are
+ *          found once per column, and the dest is then generated in
+ *          raster order, interpolating between the two src rows
+ *          that straddle the src location of each dest pixel.
+ *      (2) As with hShearLILow(), all 4 bytes of a 32 bpp pixel are
+ *          interpolated, and dest pixels whose src location is not
+ *          within the image are set to %incolor.
+ * </pre>
+ */
+static l_int32
+vShearLILow(l_uint32  *datad,
+            l_int32    w,
+            l_int32    h,
+            l_int32    d,
+            l_int32    wpld,
+            l_uint32  *datas,
+            l_int32    wpls,
+            l_int32    xloc,
+            l_float64  tanangle,
+            l_int32    incolor)
+{
+l_int32    i, j, j1, y64, ys, yf, fillbyte;
+l_int32   *yoff, *yfract, *runend;
+l_uint32   word0, word1;
+l_uint32  *lines, *lined;
+
+    yoff = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    yfract = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    runend = (l_int32 *)LEPT_CALLOC(w, sizeof(l_int32));
+    if (!yoff || !yfract || !runend) {
+        LEPT_FREE(yoff);
+        LEPT_FREE(yfract);
+        LEPT_FREE(runend);
+        return ERROR_INT("arrays not all made", __func__, 1);
+    }
+
+        /* The src location for dest pixel (j, i) is
+         * (j, i + yoff[j] + yfract[j]/64).  For small angles, yoff[]
+         * is constant over long runs of columns; for the run starting
+         * at j, runend[j] is the column just past the end of the run. */
     for (j = 0; j < w; j++) {
-        yshift = (j - xloc) * tanangle;
-        for (id = 0; id < h; id++) {
-            y = (l_int32)(64.0 * (-yshift + id) + 0.5);
-            yp = y / 64;
-            yf = y & 63;
-            hm = h - 1;
-            if (yp < 0 || yp > hm) continue;
-            lines = datas + yp * wpls;
-            lined = datad + id * wpld;
-            if (d == 8) {
-                if (yp < hm) {
-                    val = ((63 - yf) * GET_DATA_BYTE(lines, j) +
-                           yf * GET_DATA_BYTE(lines + wpls, j) + 31) / 63;
-                } else {  /* yp == hm */
-                    val = GET_DATA_BYTE(lines, j);
+        y64 = (l_int32)floor(64.0 * (xloc - j) * tanangle + 0.5);
+        yoff[j] = y64 >> 6;
+        yfract[j] = y64 & 63;
+    }
+    for (j = w - 1; j >= 0; j--)
+        runend[j] = (j < w - 1 && yoff[j + 1] == yoff[j]) ? runend[j + 1]
+                                                          : j + 1;
+
+        /* Within a run, the two src rows are the same for all pixels */
+    fillbyte = (incolor == L_BRING_IN_WHITE) ? 0xff : 0;
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        memset(lined, fillbyte, 4 * wpld);
+        for (j = 0; j < w; j = j1) {
+            j1 = runend[j];
+            ys = i + yoff[j];
+            if (ys < 0 || ys >= h) continue;
+            lines = datas + ys * wpls;
+            if (ys == h - 1) {  /* copy the src pixels */
+                for (; j < j1; j++) {
+                    if (d == 32)
+                        lined[j] = lines[j];
+                    else
+                        SET_DATA_BYTE(lined, j, GET_DATA_BYTE(lines, j));
                 }
-                SET_DATA_BYTE(lined, j, val);
-            } else {  /* d == 32 */
-                if (yp < hm) {
-                    word0 = *(lines + j);
-                    word1 = *(lines + wpls + j);
-                    rval = ((63 - yf) * ((word0 >> L_RED_SHIFT) & 0xff) +
-                           yf * ((word1 >> L_RED_SHIFT) & 0xff) + 31) / 63;
-                    gval = ((63 - yf) * ((word0 >> L_GREEN_SHIFT) & 0xff) +
-                           yf * ((word1 >> L_GREEN_SHIFT) & 0xff) + 31) / 63;
-                    bval = ((63 - yf) * ((word0 >> L_BLUE_SHIFT) & 0xff) +
-                           yf * ((word1 >> L_BLUE_SHIFT) & 0xff) + 31) / 63;
-                    composeRGBPixel(rval, gval, bval, lined + j);
-                } else {  /* yp == hm */
-                    lined[j] = lines[j];
+            } else if (d == 32) {
+                for (; j < j1; j++) {
+                    word0 = lines[j];
+                    word1 = lines[wpls + j];
+                    yf = yfract[j];
+                    lined[j] = ((((word0 & 0x00ff00ff) * (64 - yf) +
+                                  (word1 & 0x00ff00ff) * yf +
+                                  0x00200020) >> 6) & 0x00ff00ff) |
+                               (((((word0 >> 8) & 0x00ff00ff) * (64 - yf) +
+                                  ((word1 >> 8) & 0x00ff00ff) * yf +
+                                  0x00200020) << 2) & 0xff00ff00);
+                }
+            } else {  /* d == 8 */
+                for (; j < j1; j++) {
+                    yf = yfract[j];
+                    SET_DATA_BYTE(lined, j,
+                        (GET_DATA_BYTE(lines, j) * (64 - yf) +
+                         GET_DATA_BYTE(lines + wpls, j) * yf + 32) >> 6);
                 }
             }
         }
     }
 
-    pixDestroy(&pix);
-    return pixd;
+    LEPT_FREE(yoff);
+    LEPT_FREE(yfract);
+    LEPT_FREE(runend);
+    return 0;
 }
 
 
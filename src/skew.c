@@ -43,12 +43,18 @@
  *          l_int32    pixFindSkewSweepAndSearch()
  *          l_int32    pixFindSkewSweepAndSearchScore()
  *          l_int32    pixFindSkewSweepAndSearchScorePivot()
+ *          l_int32    pixPyramidFindSkew()
+ *          static l_int32  findSkewSweepAndSearch()
  *
  *      Search over arbitrary range of angles in orthogonal directions
  *          l_int32    pixFindSkewOrthogonalRange()
  *
  *      Differential square sum function for scoring
  *          l_int32    pixFindDifferentialSquareSum()
+ *          NUMA      *pixFindShearedDifferentialSquareSums()
+ *          static l_int32  *makeRowBytePrefixSums()
+ *          static l_int32   findShearedScores()
+ *          static l_int32   makeShearStrips()
  *
  *      Measures of variance of row sums
  *          l_int32    pixFindNormalizedSquareSum()
@@ -103,6 +109,20 @@
 #include <math.h>
 #include "allheaders.h"
 
+static l_int32 findSkewSweepAndSearch(PIXPYRAMID *pyr, l_float32 *pangle,
+                                      l_float32 *pconf, l_float32 *pendscore,
+                                      l_int32 redsweep, l_int32 redsearch,
+                                      l_float32 sweepcenter,
+                                      l_float32 sweeprange,
+                                      l_float32 sweepdelta,
+                                      l_float32 minbsdelta, l_int32 pivot);
+static l_int32 *makeRowBytePrefixSums(PIX *pixs);
+static l_int32 findShearedScores(PIX *pixs, l_int32 *prefix, l_int32 pivot,
+                                 l_int32 nangles, const l_float32 *angles,
+                                 l_float32 *scores);
+static l_int32 makeShearStrips(l_int32 w, l_int32 xloc, l_float32 radang,
+                               l_int32 *xb, l_int32 *shift, l_int32 *pn);
+
     /* Default sweep angle parameters for pixFindSkew() */
 static const l_float32  DefaultSweepRange = 7.0;   /* degrees */
 static const l_float32  DefaultSweepDelta = 1.0;   /* degrees */
@@ -131,6 +151,15 @@ static const l_int32  MinValidMaxscore = 10000;
      *  (height * width^2) */
 static const l_float32  MinscoreThreshFactor = 0.000002f;
 
+    /* Must match the value in shear.c.  Nearly vertical shears are
+     * scored by shearing the image rather than from the row sums. */
+static const l_float32  MinDiffFromHalfPi = 0.04f;
+
+    /* Shears with strips narrower than this, in pixels, are scored by
+     * shearing the image, which is then faster than summing over the
+     * strips.  The strip width is 1/tan(angle); this is about 10 deg. */
+static const l_float32  MinRowSumStripWidth = 6.0;
+
     /* Default binarization threshold value.
      * This is set deliberately above 130 to capture light foreground
      * with poor printing or images that are out of focus.  */
@@ -468,10 +497,10 @@ pixFindSkewSweep(PIX        *pixs,
                  l_float32   sweepdelta)
 {
 l_int32    ret, bzero, i, nangles;
-l_float32  deg2rad, theta;
-l_float32  sum, maxscore, maxangle;
+l_float32  theta;
+l_float32  maxscore, maxangle;
 NUMA      *natheta, *nascore;
-PIX       *pix, *pixt;
+PIX       *pix;
 
     if (!pangle)
         return ERROR_INT("&angle not defined", __func__, 1);
@@ -483,7 +512,6 @@ PIX       *pix, *pixt;
     if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
         return ERROR_INT("reduction must be in {1,2,4,8}", __func__, 1);
 
-    deg2rad = 3.1415926535f / 180.f;
     ret = 0;
 
         /* Generate reduced image, if requested */
@@ -504,35 +532,27 @@ PIX       *pix, *pixt;
 
     nangles = (l_int32)((2. * sweeprange) / sweepdelta + 1);
     natheta = numaCreate(nangles);
-    nascore = numaCreate(nangles);
-    pixt = pixCreateTemplate(pix);
-
-    if (!pix || !pixt) {
-        ret = ERROR_INT("pix and pixt not both made", __func__, 1);
-        goto cleanup;
-    }
-    if (!natheta || !nascore) {
-        ret = ERROR_INT("natheta and nascore not both made", __func__, 1);
-        goto cleanup;
-    }
-
     for (i = 0; i < nangles; i++) {
         theta = -sweeprange + i * sweepdelta;   /* degrees */
+        numaAddNumber(natheta, theta);
+    }
 
-            /* Shear pix about the UL corner and put the result in pixt */
-        pixVShearCorner(pixt, pix, deg2rad * theta, L_BRING_IN_WHITE);
-
-            /* Get score */
-        pixFindDifferentialSquareSum(pixt, &sum);
+        /* Get the scores for shear of pix about the UL corner */
+    nascore = pixFindShearedDifferentialSquareSums(pix, natheta,
+                                                   L_SHEAR_ABOUT_CORNER);
+    if (!nascore) {
+        ret = ERROR_INT("nascore not made", __func__, 1);
+        goto cleanup;
+    }
 
 #if  DEBUG_PRINT_SCORES
+    for (i = 0; i < nangles; i++) {
+        l_float32  sum;
+        numaGetFValue(natheta, i, &theta);
+        numaGetFValue(nascore, i, &sum);
         L_INFO("sum(%7.2f) = %7.0f\n", __func__, theta, sum);
-#endif  /* DEBUG_PRINT_SCORES */
-
-            /* Save the result in the output arrays */
-        numaAddNumber(nascore, sum);
-        numaAddNumber(natheta, theta);
     }
+#endif  /* DEBUG_PRINT_SCORES */
 
         /* Find the location of the maximum (i.e., the skew angle)
          * by fitting the largest data point and its two neighbors
@@ -567,7 +587,6 @@ PIX       *pix, *pixt;
 
 cleanup:
     pixDestroy(&pix);
-    pixDestroy(&pixt);
     numaDestroy(&nascore);
     numaDestroy(&natheta);
     return ret;
@@ -718,17 +737,8 @@ pixFindSkewSweepAndSearchScorePivot(PIX        *pixs,
                                     l_float32   minbsdelta,
                                     l_int32     pivot)
 {
-l_int32    ret, bzero, i, nangles, n, ratio, maxindex, minloc;
-l_int32    width, height;
-l_float32  deg2rad, theta, delta;
-l_float32  sum, maxscore, maxangle;
-l_float32  centerangle, leftcenterangle, rightcenterangle;
-l_float32  lefttemp, righttemp;
-l_float32  bsearchscore[5];
-l_float32  minscore, minthresh;
-l_float32  rangeleft;
-NUMA      *natheta, *nascore;
-PIX       *pixsw, *pixsch, *pixt1, *pixt2;
+l_int32      ret;
+PIXPYRAMID  *pyr;
 
     if (pendscore) *pendscore = 0.0;
     if (pangle) *pangle = 0.0;
@@ -746,18 +756,125 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
     if (pivot != L_SHEAR_ABOUT_CORNER && pivot != L_SHEAR_ABOUT_CENTER)
         return ERROR_INT("invalid pivot", __func__, 1);
 
-    deg2rad = 3.1415926535f / 180.f;
-    ret = 0;
+    pyr = pixPyramidCreate(pixs);
+    ret = findSkewSweepAndSearch(pyr, pangle, pconf, pendscore, redsweep,
+                                 redsearch, sweepcenter, sweeprange,
+                                 sweepdelta, minbsdelta, pivot);
+    pixPyramidDestroy(&pyr);
+    return ret;
+}
+
+
+/*!
+ * \brief   pixPyramidFindSkew()
+ *
+ * \param[in]    pyr      pyramid holding a 1 bpp image
+ * \param[out]   pangle   angle required to deskew, in degrees
+ * \param[out]   pconf    confidence value is ratio max/min scores
+ * \return  0 if OK, 1 on error or if angle measurement not valid
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the same as pixFindSkew(), except that the reduced
+ *          images are taken from %pyr, so that they can be shared with
+ *          other analysis of the same image.
+ * </pre>
+ */
+l_ok
+pixPyramidFindSkew(PIXPYRAMID  *pyr,
+                   l_float32   *pangle,
+                   l_float32   *pconf)
+{
+l_int32  ret;
+PIX     *pixs;
 
-        /* Generate reduced image for binary search, if requested */
-    if (redsearch == 1)
-        pixsch = pixClone(pixs);
-    else if (redsearch == 2)
-        pixsch = pixReduceRankBinaryCascade(pixs, 1, 0, 0, 0);
-    else if (redsearch == 4)
-        pixsch = pixReduceRankBinaryCascade(pixs, 1, 1, 0, 0);
-    else  /* redsearch == 8 */
-        pixsch = pixReduceRankBinaryCascade(pixs, 1, 1, 2, 0);
+    if (pangle) *pangle = 0.0;
+    if (pconf) *pconf = 0.0;
+    if (!pangle || !pconf)
+        return ERROR_INT("&angle and/or &conf not defined", __func__, 1);
+    if (!pyr)
+        return ERROR_INT("pyr not defined", __func__, 1);
+    pixs = pixPyramidGetSource(pyr);
+    ret = (pixGetDepth(pixs) != 1);
+    pixDestroy(&pixs);
+    if (ret)
+        return ERROR_INT("pyr pix not 1 bpp", __func__, 1);
+
+    return findSkewSweepAndSearch(pyr, pangle, pconf, NULL,
+                                  DefaultSweepReduction, DefaultBsReduction,
+                                  0.0, DefaultSweepRange, DefaultSweepDelta,
+                                  DefaultMinbsDelta, L_SHEAR_ABOUT_CORNER);
+}
+
+
+/*!
+ * \brief   findSkewSweepAndSearch()
+ *
+ * \param[in]    pyr          pyramid holding a 1 bpp image
+ * \param[out]   pangle       angle required to deskew; in degrees
+ * \param[out]   pconf        confidence given by ratio of max/min score
+ * \param[out]   pendscore    [optional] max score; use NULL to ignore
+ * \param[in]    redsweep     sweep reduction factor = 1, 2, 4 or 8
+ * \param[in]    redsearch    binary search reduction factor = 1, 2, 4 or 8;
+ *                            and must not exceed redsweep
+ * \param[in]    sweepcenter  angle about which sweep is performed; in degrees
+ * \param[in]    sweeprange   half the full range, taken about sweepcenter;
+ *                            in degrees
+ * \param[in]    sweepdelta   angle increment of sweep; in degrees
+ * \param[in]    minbsdelta   min binary search increment angle; in degrees
+ * \param[in]    pivot        L_SHEAR_ABOUT_CORNER, L_SHEAR_ABOUT_CENTER
+ * \return  0 if OK, 1 on error or if angle measurement not valid
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does the work for pixFindSkewSweepAndSearchScorePivot(),
+ *          which checks the input parameters.
+ *      (2) The reduced images are the rank binary cascades that were
+ *          used before; they are taken from %pyr.
+ * </pre>
+ */
+static l_int32
+findSkewSweepAndSearch(PIXPYRAMID  *pyr,
+                       l_float32   *pangle,
+                       l_float32   *pconf,
+                       l_float32   *pendscore,
+                       l_int32      redsweep,
+                       l_int32      redsearch,
+                       l_float32    sweepcenter,
+                       l_float32    sweeprange,
+                       l_float32    sweepdelta,
+                       l_float32    minbsdelta,
+                       l_int32      pivot)
+{
+l_int32    ret, bzero, i, nangles, n, ratio, maxindex, minloc;
+l_int32    width, height, nsch, nsw;
+l_int32    levels[4];
+l_int32   *prefixsw, *prefixsch;
+l_float32  delta;
+l_float32  maxscore, maxangle;
+l_float32  centerangle, leftcenterangle, rightcenterangle;
+l_float32  lefttemp, righttemp;
+l_float32  bsearchscore[5];
+l_float32  angles[3], scores[3];
+l_float32  minscore, minthresh;
+l_float32  rangeleft;
+l_float32 *sweepangles, *sweepscores;
+NUMA      *natheta, *nascore;
+PIX       *pixsw, *pixsch;
+
+    ret = 0;
+    prefixsw = prefixsch = NULL;
+    sweepangles = sweepscores = NULL;
+
+        /* Get reduced image for binary search, if requested.
+         * The rank levels are: 2x: (1); 4x: (1, 1); 8x: (1, 1, 2). */
+    levels[0] = levels[1] = levels[2] = levels[3] = 0;
+    nsch = 0;
+    if (redsearch >= 2) levels[nsch++] = 1;
+    if (redsearch >= 4) levels[nsch++] = 1;
+    if (redsearch == 8) levels[nsch++] = 2;
+    pixsch = pixPyramidGetBinary(pyr, levels[0], levels[1], levels[2],
+                                 levels[3]);
 
     pixZero(pixsch, &bzero);
     if (bzero) {
@@ -765,63 +882,69 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
         return 1;
     }
 
-        /* Generate reduced image for sweep, if requested */
+        /* Get reduced image for sweep, if requested, by further
+         * reduction of the search image with levels:
+         * 2x: (1); 4x: (1, 2); 8x: (1, 2, 2). */
     ratio = redsweep / redsearch;
     if (ratio == 1) {
         pixsw = pixClone(pixsch);
     } else {  /* ratio > 1 */
-        if (ratio == 2)
-            pixsw = pixReduceRankBinaryCascade(pixsch, 1, 0, 0, 0);
-        else if (ratio == 4)
-            pixsw = pixReduceRankBinaryCascade(pixsch, 1, 2, 0, 0);
-        else  /* ratio == 8 */
-            pixsw = pixReduceRankBinaryCascade(pixsch, 1, 2, 2, 0);
+        nsw = nsch;
+        if (ratio >= 2) levels[nsw++] = 1;
+        if (ratio >= 4) levels[nsw++] = 2;
+        if (ratio == 8) levels[nsw++] = 2;
+        pixsw = pixPyramidGetBinary(pyr, levels[0], levels[1], levels[2],
+                                    levels[3]);
     }
 
-    pixt1 = pixCreateTemplate(pixsw);
-    if (ratio == 1)
-        pixt2 = pixClone(pixt1);
-    else
-        pixt2 = pixCreateTemplate(pixsch);
-
     nangles = (l_int32)((2. * sweeprange) / sweepdelta + 1);
     natheta = numaCreate(nangles);
     nascore = numaCreate(nangles);
+    sweepangles = (l_float32 *)LEPT_CALLOC(nangles, sizeof(l_float32));
+    sweepscores = (l_float32 *)LEPT_CALLOC(nangles, sizeof(l_float32));
 
     if (!pixsch || !pixsw) {
         ret = ERROR_INT("pixsch and pixsw not both made", __func__, 1);
         goto cleanup;
     }
-    if (!pixt1 || !pixt2) {
-        ret = ERROR_INT("pixt1 and pixt2 not both made", __func__, 1);
-        goto cleanup;
-    }
     if (!natheta || !nascore) {
         ret = ERROR_INT("natheta and nascore not both made", __func__, 1);
         goto cleanup;
     }
+    if (!sweepangles || !sweepscores) {
+        ret = ERROR_INT("sweep arrays not both made", __func__, 1);
+        goto cleanup;
+    }
+
+        /* The sheared images are never made.  Instead, the row sums
+         * for each shear are accumulated from tables of pixel counts
+         * along each row, and all angles of the sweep are scored
+         * in one pass through the table. */
+    prefixsch = makeRowBytePrefixSums(pixsch);
+    if (ratio == 1)
+        prefixsw = prefixsch;
+    else
+        prefixsw = makeRowBytePrefixSums(pixsw);
+    if (!prefixsch || !prefixsw) {
+        ret = ERROR_INT("prefix sums not made", __func__, 1);
+        goto cleanup;
+    }
 
         /* Do sweep */
     rangeleft = sweepcenter - sweeprange;
+    for (i = 0; i < nangles; i++)
+        sweepangles[i] = rangeleft + i * sweepdelta;   /* degrees */
+    findShearedScores(pixsw, prefixsw, pivot, nangles, sweepangles,
+                      sweepscores);
     for (i = 0; i < nangles; i++) {
-        theta = rangeleft + i * sweepdelta;   /* degrees */
-
-            /* Shear pix and put the result in pixt1 */
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt1, pixsw, deg2rad * theta, L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt1, pixsw, deg2rad * theta, L_BRING_IN_WHITE);
-
-            /* Get score */
-        pixFindDifferentialSquareSum(pixt1, &sum);
-
 #if  DEBUG_PRINT_SCORES
-        L_INFO("sum(%7.2f) = %7.0f\n", __func__, theta, sum);
+        L_INFO("sum(%7.2f) = %7.0f\n", __func__, sweepangles[i],
+               sweepscores[i]);
 #endif  /* DEBUG_PRINT_SCORES */
 
             /* Save the result in the output arrays */
-        numaAddNumber(nascore, sum);
-        numaAddNumber(natheta, theta);
+        numaAddNumber(nascore, sweepscores[i]);
+        numaAddNumber(natheta, sweepangles[i]);
     }
 
         /* Find the largest of the set (maxscore at maxangle) */
@@ -861,25 +984,13 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
         /* Do binary search to find skew angle.
          * First, set up initial three points. */
     centerangle = maxangle;
-    if (pivot == L_SHEAR_ABOUT_CORNER) {
-        pixVShearCorner(pixt2, pixsch, deg2rad * centerangle, L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[2]);
-        pixVShearCorner(pixt2, pixsch, deg2rad * (centerangle - sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[0]);
-        pixVShearCorner(pixt2, pixsch, deg2rad * (centerangle + sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[4]);
-    } else {
-        pixVShearCenter(pixt2, pixsch, deg2rad * centerangle, L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[2]);
-        pixVShearCenter(pixt2, pixsch, deg2rad * (centerangle - sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[0]);
-        pixVShearCenter(pixt2, pixsch, deg2rad * (centerangle + sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[4]);
-    }
+    angles[0] = centerangle;
+    angles[1] = centerangle - sweepdelta;
+    angles[2] = centerangle + sweepdelta;
+    findShearedScores(pixsch, prefixsch, pivot, 3, angles, scores);
+    bsearchscore[2] = scores[0];
+    bsearchscore[0] = scores[1];
+    bsearchscore[4] = scores[2];
 
     numaAddNumber(nascore, bsearchscore[2]);
     numaAddNumber(natheta, centerangle);
@@ -892,27 +1003,16 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
     delta = 0.5f * sweepdelta;
     while (delta >= minbsdelta)
     {
-            /* Get the left intermediate score */
+            /* Get the left and right intermediate scores */
         leftcenterangle = centerangle - delta;
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt2, pixsch, deg2rad * leftcenterangle,
-                            L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt2, pixsch, deg2rad * leftcenterangle,
-                            L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[1]);
+        rightcenterangle = centerangle + delta;
+        angles[0] = leftcenterangle;
+        angles[1] = rightcenterangle;
+        findShearedScores(pixsch, prefixsch, pivot, 2, angles, scores);
+        bsearchscore[1] = scores[0];
+        bsearchscore[3] = scores[1];
         numaAddNumber(nascore, bsearchscore[1]);
         numaAddNumber(natheta, leftcenterangle);
-
-            /* Get the right intermediate score */
-        rightcenterangle = centerangle + delta;
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt2, pixsch, deg2rad * rightcenterangle,
-                            L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt2, pixsch, deg2rad * rightcenterangle,
-                            L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[3]);
         numaAddNumber(nascore, bsearchscore[3]);
         numaAddNumber(natheta, rightcenterangle);
 
@@ -1006,8 +1106,10 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
 cleanup:
     pixDestroy(&pixsw);
     pixDestroy(&pixsch);
-    pixDestroy(&pixt1);
-    pixDestroy(&pixt2);
+    if (prefixsw != prefixsch) LEPT_FREE(prefixsw);
+    LEPT_FREE(prefixsch);
+    LEPT_FREE(sweepangles);
+    LEPT_FREE(sweepscores);
     numaDestroy(&nascore);
     numaDestroy(&natheta);
     return ret;
@@ -1192,6 +1294,355 @@ NUMA      *na;
 }
 
 
+/*!
+ * \brief   pixFindShearedDifferentialSquareSums()
+ *
+ * \param[in]    pixs       1 bpp
+ * \param[in]    naangle    vertical shear angles, in degrees
+ * \param[in]    pivot      L_SHEAR_ABOUT_CORNER, L_SHEAR_ABOUT_CENTER
+ * \return  nasum of differential square sums, one for each angle,
+ *               or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For each angle, this gives the same result as vertically
+ *          shearing pixs with pixVShearCorner() or pixVShearCenter(),
+ *          bringing in white pixels, and calling
+ *          pixFindDifferentialSquareSum() on the sheared image.
+ *      (2) For angles up to about 10 degrees, the sheared images are
+ *          not made.  The shear moves vertical strips of the image up
+ *          or down by an integer number of rows, so each row sum of the
+ *          sheared image is a sum of pixel counts over strips of source
+ *          rows.  These counts are found from a table of pixel counts
+ *          along each row, up to each byte, that is made once for all
+ *          the angles.  This is several times faster than shearing
+ *          for small angles.
+ * </pre>
+ */
+NUMA *
+pixFindShearedDifferentialSquareSums(PIX     *pixs,
+                                     NUMA    *naangle,
+                                     l_int32  pivot)
+{
+l_int32     i, n;
+l_int32    *prefix;
+l_float32  *angles, *scores;
+NUMA       *nasum;
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (NUMA *)ERROR_PTR("pixs not defined or not 1 bpp",
+                                 __func__, NULL);
+    if (!naangle)
+        return (NUMA *)ERROR_PTR("naangle not defined", __func__, NULL);
+    if (pivot != L_SHEAR_ABOUT_CORNER && pivot != L_SHEAR_ABOUT_CENTER)
+        return (NUMA *)ERROR_PTR("invalid pivot", __func__, NULL);
+    if ((n = numaGetCount(naangle)) == 0)
+        return (NUMA *)ERROR_PTR("naangle is empty", __func__, NULL);
+
+    if ((prefix = makeRowBytePrefixSums(pixs)) == NULL)
+        return (NUMA *)ERROR_PTR("prefix not made", __func__, NULL);
+    angles = numaGetFArray(naangle, L_COPY);
+    scores = (l_float32 *)LEPT_CALLOC(n, sizeof(l_float32));
+    nasum = NULL;
+    if (!angles || !scores) {
+        L_ERROR("angles and scores not both made\n", __func__);
+    } else if (findShearedScores(pixs, prefix, pivot, n, angles, scores)) {
+        L_ERROR("scores not found\n", __func__);
+    } else {
+        nasum = numaCreate(n);
+        for (i = 0; i < n; i++)
+            numaAddNumber(nasum, scores[i]);
+    }
+
+    LEPT_FREE(prefix);
+    LEPT_FREE(angles);
+    LEPT_FREE(scores);
+    return nasum;
+}
+
+
+/*!
+ * \brief   makeRowBytePrefixSums()
+ *
+ * \param[in]    pixs      1 bpp
+ * \return  prefix array, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Let nb = (w + 7) / 8.  For row i, the nb + 1 entries
+ *          starting at prefix[i * (nb + 1)] give the number of fg pixels
+ *          in the first k bytes of the row, for k = 0, ... nb.
+ *      (2) The pixel count of row i in [0, x) is then
+ *            prefix[i * (nb + 1) + x / 8] +
+ *            tab8[byte (x / 8) of the row, masked to its first x % 8 bits]
+ *          The last entry includes any pad bits, but it is only used
+ *          for x = w when w is a multiple of 8.
+ * </pre>
+ */
+static l_int32 *
+makeRowBytePrefixSums(PIX  *pixs)
+{
+l_int32    i, k, w, h, wpl, nb;
+l_int32   *prefix, *pre, *tab8;
+l_uint32  *data, *line;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    nb = (w + 7) / 8;
+    if ((prefix = (l_int32 *)LEPT_CALLOC((size_t)h * (nb + 1),
+                                         sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("prefix not made", __func__, NULL);
+    tab8 = makePixelSumTab8();
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        pre = prefix + i * (nb + 1);
+        pre[0] = 0;
+        for (k = 0; k < nb; k++)
+            pre[k + 1] = pre[k] + tab8[GET_DATA_BYTE(line, k)];
+    }
+    LEPT_FREE(tab8);
+    return prefix;
+}
+
+
+/*!
+ * \brief   findShearedScores()
+ *
+ * \param[in]    pixs       1 bpp
+ * \param[in]    prefix     from makeRowBytePrefixSums() on pixs
+ * \param[in]    pivot      L_SHEAR_ABOUT_CORNER, L_SHEAR_ABOUT_CENTER
+ * \param[in]    nangles    number of shear angles
+ * \param[in]    angles     array of vertical shear angles, in degrees
+ * \param[out]   scores     array of differential square sums
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See pixFindShearedDifferentialSquareSums().  The row sums for
+ *          all the angles are accumulated in a single pass over the rows
+ *          of pixs, and the scores are then found exactly as in
+ *          pixFindDifferentialSquareSum().
+ *      (2) Large angles are scored by making the sheared image.
+ *          The shear strips are then narrow, and summing over them
+ *          is slower than shearing.  Also, angles near +-pi/2 are
+ *          changed by pixVShear().
+ * </pre>
+ */
+static l_int32
+findShearedScores(PIX              *pixs,
+                  l_int32          *prefix,
+                  l_int32           pivot,
+                  l_int32           nangles,
+                  const l_float32  *angles,
+                  l_float32        *scores)
+{
+l_int32    i, j, a, k, w, h, wpl, nb, xloc, n, f0, f1, ret;
+l_int32    skiph, skip, nskip;
+l_int32   *pre, *tab8, *rowsums, *rs, *nstrips, *sh;
+l_int32   *xb, *pindex, *bindex, *mask;
+l_uint32  *data, *line;
+l_float32  deg2rad, radang, diff, sum;
+PIX       *pixt;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    nb = (w + 7) / 8;
+    data = pixGetData(pixs);
+    wpl = pixGetWpl(pixs);
+    xloc = (pivot == L_SHEAR_ABOUT_CORNER) ? 0 : w / 2;
+    deg2rad = 3.1415926535f / 180.f;
+
+        /* For angle a, strip k covers columns [xb[k], xb[k + 1]) and
+         * is shifted down by sh[k].  The boundaries are stored as an
+         * index into the prefix row, and a byte and mask for the
+         * remaining bits; see makeRowBytePrefixSums().  The shifts are
+         * clamped to [-h, h], which does not change the rows that land
+         * in the image, and the row sums for each angle are padded by h
+         * on each side, so the shifted rows need not be checked. */
+    tab8 = makePixelSumTab8();
+    rowsums = (l_int32 *)LEPT_CALLOC((size_t)nangles * 3 * h,
+                                     sizeof(l_int32));
+    nstrips = (l_int32 *)LEPT_CALLOC(nangles, sizeof(l_int32));
+    xb = (l_int32 *)LEPT_CALLOC(w + 2, sizeof(l_int32));
+    sh = (l_int32 *)LEPT_CALLOC((size_t)nangles * (w + 1), sizeof(l_int32));
+    pindex = (l_int32 *)LEPT_CALLOC((size_t)nangles * (w + 2),
+                                    sizeof(l_int32));
+    bindex = (l_int32 *)LEPT_CALLOC((size_t)nangles * (w + 2),
+                                    sizeof(l_int32));
+    mask = (l_int32 *)LEPT_CALLOC((size_t)nangles * (w + 2),
+                                  sizeof(l_int32));
+    ret = 0;
+    if (!rowsums || !nstrips || !xb || !sh || !pindex || !bindex || !mask) {
+        ret = ERROR_INT("arrays not all made", __func__, 1);
+        goto cleanup;
+    }
+
+    for (a = 0; a < nangles; a++) {
+        radang = deg2rad * angles[a];
+        nstrips[a] = -1;  /* flag: score by shearing */
+        if (L_ABS(radang) > 3.14159265f / 2.0f - MinDiffFromHalfPi ||
+            L_ABS(tan(radang)) * MinRowSumStripWidth > 1.0)
+            continue;
+        makeShearStrips(w, xloc, radang, xb, sh + a * (w + 1), &nstrips[a]);
+        for (k = 0; k < nstrips[a]; k++) {
+            j = a * (w + 1) + k;
+            sh[j] = L_MAX(-h, L_MIN(h, sh[j]));
+        }
+        for (k = 0; k <= nstrips[a]; k++) {
+            j = a * (w + 2) + k;
+            pindex[j] = xb[k] >> 3;
+            bindex[j] = (xb[k] & 7) ? xb[k] >> 3 : 0;
+            mask[j] = (0xff00 >> (xb[k] & 7)) & 0xff;
+        }
+    }
+
+        /* Accumulate the row sums of the sheared images */
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        pre = prefix + i * (nb + 1);
+        for (a = 0; a < nangles; a++) {
+            if ((n = nstrips[a]) < 0) continue;
+            rs = rowsums + (3 * a + 1) * h + i;
+            j = a * (w + 2);
+            f0 = 0;
+            for (k = 0; k < n; k++) {
+                f1 = pre[pindex[j + k + 1]] +
+                     tab8[GET_DATA_BYTE(line, bindex[j + k + 1]) &
+                          mask[j + k + 1]];
+                rs[sh[a * (w + 1) + k]] += f1 - f0;
+                f0 = f1;
+            }
+        }
+    }
+
+        /* Score as in pixFindDifferentialSquareSum() */
+    skiph = (l_int32)(0.05 * w);
+    skip = L_MIN(h / 10, skiph);
+    nskip = L_MAX(skip / 2, 1);
+    pixt = NULL;
+    for (a = 0; a < nangles; a++) {
+        if (nstrips[a] < 0) {
+            if (!pixt) pixt = pixCreateTemplate(pixs);
+            if (pivot == L_SHEAR_ABOUT_CORNER)
+                pixVShearCorner(pixt, pixs, deg2rad * angles[a],
+                                L_BRING_IN_WHITE);
+            else
+                pixVShearCenter(pixt, pixs, deg2rad * angles[a],
+                                L_BRING_IN_WHITE);
+            pixFindDifferentialSquareSum(pixt, &scores[a]);
+            continue;
+        }
+        rs = rowsums + (3 * a + 1) * h;
+        sum = 0.0;
+        for (i = nskip; i < h - nskip; i++) {
+            diff = (l_float32)(rs[i] - rs[i - 1]);
+            sum += diff * diff;
+        }
+        scores[a] = sum;
+    }
+    pixDestroy(&pixt);
+
+cleanup:
+    LEPT_FREE(tab8);
+    LEPT_FREE(rowsums);
+    LEPT_FREE(nstrips);
+    LEPT_FREE(xb);
+    LEPT_FREE(sh);
+    LEPT_FREE(pindex);
+    LEPT_FREE(bindex);
+    LEPT_FREE(mask);
+    return ret;
+}
+
+
+/*!
+ * \brief   makeShearStrips()
+ *
+ * \param[in]    w         image width
+ * \param[in]    xloc      location of the vertical line of the shear
+ * \param[in]    radang    shear angle in radians, not near +-pi/2
+ * \param[out]   xb        strip boundaries; size w + 2
+ * \param[out]   shift     vertical shift of each strip; size w + 1
+ * \param[out]   pn        number of strips
+ * \return  0 if OK
+ *
+ * <pre>
+ * Notes:
+ *      (1) This generates the same strips as pixVShear(), which shears
+ *          by vertically shifting each strip with pixRasterop().
+ *          Strip k covers columns [xb[k], xb[k + 1]), with xb[0] = 0
+ *          and xb[n] = w, and it is shifted down by shift[k] rows.
+ *      (2) The strips to the left of the pivot are found from right
+ *          to left, so they are stored in reverse order at the end
+ *          of the arrays, and then moved to the front.
+ *      (3) Strips of zero width, which pixVShear() makes for angles
+ *          larger than pi/4, are omitted.  There are at most w + 1
+ *          strips, including the center strip.
+ * </pre>
+ */
+static l_int32
+makeShearStrips(l_int32    w,
+                l_int32    xloc,
+                l_float32  radang,
+                l_int32   *xb,
+                l_int32   *shift,
+                l_int32   *pn)
+{
+l_int32    sign, x, xincr, initxincr, vshift, nleft, nright, k;
+l_float32  tanangle, invangle;
+
+    *pn = 1;
+    xb[0] = 0;
+    xb[1] = w;
+    shift[0] = 0;
+    if (radang == 0.0 || tan(radang) == 0.0)
+        return 0;
+
+    sign = L_SIGN(radang);
+    tanangle = tan(radang);
+    invangle = L_ABS(1. / tanangle);
+    initxincr = (l_int32)(invangle / 2.);
+
+        /* Strips to the left of the center strip, stored from the
+         * end of the arrays: strip (w - k) is [xb[w - k], xb[w - k + 1]) */
+    nleft = 0;
+    for (vshift = -1, x = xloc - initxincr; x > 0; vshift--) {
+        xincr = (x - xloc) - (l_int32)(invangle * (vshift - 0.5) + 0.5);
+        if (x < xincr)  /* reduce for last one if req'd */
+            xincr = x;
+        if (xincr > 0) {
+            nleft++;
+            xb[w + 1 - nleft] = x;
+            shift[w + 1 - nleft] = sign * vshift;
+        }
+        x -= xincr;
+    }
+    for (k = 0; k < nleft; k++) {  /* move to the front */
+        xb[k + 1] = xb[w + 1 - nleft + k];
+        shift[k] = shift[w + 1 - nleft + k];
+    }
+
+        /* The center strip, and the strips to the right */
+    shift[nleft] = 0;
+    x = L_MIN(w, xloc + initxincr);
+    nright = 0;
+    for (vshift = 1; x < w; vshift++) {
+        xincr = (l_int32)(invangle * (vshift + 0.5) + 0.5) - (x - xloc);
+        if (w - x < xincr)  /* reduce for last one if req'd */
+            xincr = w - x;
+        if (xincr > 0) {
+            nright++;
+            xb[nleft + nright] = x;
+            shift[nleft + nright] = sign * vshift;
+        }
+        x += xincr;
+    }
+    *pn = nleft + nright + 1;
+    xb[*pn] = w;
+    return 0;
+}
+
+
 /*----------------------------------------------------------------*
  *                        Normalized square sum                   *
  *----------------------------------------------------------------*/
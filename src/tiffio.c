@@ -96,6 +96,12 @@
  *           l_int32    pixWriteMemTiff();
  *           l_int32    pixWriteMemTiffCustom();
  *
+ *     Push decoding of tiff
+ *      static l_int32    tiffPushDirectorySize()
+ *      static l_int32    tiffPushOpen()
+ *             l_int32    tiffPushDecode()
+ *             void       tiffPushCleanup()
+ *
  *  Note 1: To include all necessary functions, use libtiff version 3.7.4
  *          (from 2005) or later.
  *  Note 2: What compression methods in tiff are supported?
@@ -2882,6 +2888,368 @@ TIFF    *tif;
     return ret;
 }
 
+
+/*--------------------------------------------------------------*
+ *                     Push decoding of tiff                    *
+ *--------------------------------------------------------------*/
+    /*! State of the strip reader used by a push decoder */
+struct TiffPushState
+{
+    TIFF         *tif;          /*!< opened on the data received so far    */
+    L_MEMSTREAM  *mstream;      /*!< read stream; freed by TIFFClose()     */
+    l_int32       oneshot;      /*!< 1 to decode everything at the end     */
+    l_int32       nstrips;      /*!< number of strips in the image         */
+    l_int32       rowsperstrip; /*!< number of rows in each strip          */
+    l_int32       nextstrip;    /*!< index of the next strip to decode     */
+    l_int32       bps;          /*!< bits/sample (with spp = 1)            */
+    l_int32       tiffbpl;      /*!< bytes in each row of a strip          */
+    l_int32       invert;       /*!< 1 if the photometry requires inversion */
+    toff_t       *offsets;      /*!< byte offsets of the strips            */
+    toff_t       *counts;       /*!< byte counts of the strips             */
+    l_uint8      *stripbuf;     /*!< one decoded strip                     */
+};
+typedef struct TiffPushState  TIFFPUSHSTATE;
+
+    /* Size in bytes of each tiff field type, for types 0 to 18 */
+static const l_int32  TiffFieldTypeSize[19] =
+                 {0, 1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8, 4, 0, 0, 8, 8, 8};
+
+/*!
+ * \brief   tiffPushDirectorySize()
+ *
+ * \param[in]    data      tiff data received so far
+ * \param[in]    nbytes    number of bytes of data
+ * \param[out]   psize     number of bytes required to hold the first
+ *                         directory and the values it points to;
+ *                         0 if more data is needed to find this
+ * \return  0 if OK, 1 if not a classic tiff file
+ *
+ * <pre>
+ * Notes:
+ *      (1) libtiff reads the entire first directory when the file is
+ *          opened, so it can only be opened on partial data that
+ *          contains all of it.  This walks the directory entries to
+ *          find the extent of the data they require.
+ *      (2) BigTIFF is not handled here, and is decoded in one shot.
+ * </pre>
+ */
+static l_int32
+tiffPushDirectorySize(const l_uint8  *data,
+                      size_t          nbytes,
+                      size_t         *psize)
+{
+l_int32         msb, k, n, type;
+size_t          ifd, end, valoff, total;
+const l_uint8  *p;
+
+    *psize = 0;
+    if (nbytes < 8)
+        return 0;
+    if (data[0] == 'M' && data[1] == 'M')
+        msb = 1;
+    else if (data[0] == 'I' && data[1] == 'I')
+        msb = 0;
+    else
+        return 1;
+
+#define TIFF_UINT16(p)  (msb ? ((p)[0] << 8) | (p)[1] : ((p)[1] << 8) | (p)[0])
+#define TIFF_UINT32(p)  (msb ? \
+    ((size_t)(p)[0] << 24) | ((p)[1] << 16) | ((p)[2] << 8) | (p)[3] : \
+    ((size_t)(p)[3] << 24) | ((p)[2] << 16) | ((p)[1] << 8) | (p)[0])
+
+    if (TIFF_UINT16(data + 2) != 42)  /* BigTIFF is 43 */
+        return 1;
+    ifd = TIFF_UINT32(data + 4);
+    if (ifd + 2 > nbytes)
+        return 0;
+    n = TIFF_UINT16(data + ifd);
+    end = ifd + 2 + 12 * (size_t)n + 4;
+    if (end > nbytes)
+        return 0;
+    for (k = 0; k < n; k++) {
+        p = data + ifd + 2 + 12 * k;
+        type = TIFF_UINT16(p + 2);
+        if (type < 0 || type > 18) continue;  /* ignored by libtiff */
+        total = TIFF_UINT32(p + 4) * (size_t)TiffFieldTypeSize[type];
+        if (total > 4) {  /* the value is stored elsewhere */
+            valoff = TIFF_UINT32(p + 8);
+            end = L_MAX(end, valoff + total);
+        }
+    }
+    *psize = end;
+
+#undef TIFF_UINT16
+#undef TIFF_UINT32
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffPushOpen()
+ *
+ * \param[in]    pd    push decoder, with the first directory received
+ * \param[in]    ps    tiff push state
+ * \return  0 if OK, 1 if the image must be decoded in one shot
+ *
+ * <pre>
+ * Notes:
+ *      (1) The tiff is opened without memory mapping, because the data
+ *          in the push decoder can move when more data arrives.
+ *      (2) Strips are decoded incrementally for 1 spp images with
+ *          uint samples of 1, 2, 4, 8 or 16 bps, in the default
+ *          orientation.  The conversions are those of
+ *          pixReadFromTiffStream().  Everything else is decoded in
+ *          one shot by pixReadMemTiff().
+ * </pre>
+ */
+static l_int32
+tiffPushOpen(L_PUSHDEC      *pd,
+             TIFFPUSHSTATE  *ps)
+{
+char      *text;
+l_uint16   spp, bps, sample_fmt, tiffcomp, photometry, orientation;
+l_uint16  *redmap, *greenmap, *bluemap;
+l_int32    i, d, xres, yres, ncolors;
+l_uint32   w, h, rowsperstrip;
+TIFF      *tif;
+PIX       *pix;
+PIXCMAP   *cmap;
+
+    ps->mstream = memstreamCreateForRead(pd->data, pd->nbytes);
+    TIFFSetWarningHandler(NULL);  /* disable warnings */
+    TIFFSetErrorHandler(NULL);  /* disable error messages */
+    tif = TIFFClientOpen("tiffpush", "rm", (thandle_t)ps->mstream,
+                         tiffReadCallback, tiffWriteCallback,
+                         tiffSeekCallback, tiffCloseCallback,
+                         tiffSizeCallback, tiffMapCallback,
+                         tiffUnmapCallback);
+    if (!tif) {
+        LEPT_FREE(ps->mstream);
+        return 1;
+    }
+    ps->tif = tif;
+
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_fmt);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsperstrip);
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    if (TIFFGetField(tif, TIFFTAG_ORIENTATION, &orientation) == 0)
+        orientation = ORIENTATION_TOPLEFT;
+    if (sample_fmt != SAMPLEFORMAT_UINT || TIFFIsTiled(tif) ||
+        tiffcomp == COMPRESSION_OJPEG || spp != 1 ||
+        (bps != 1 && bps != 2 && bps != 4 && bps != 8 && bps != 16) ||
+        orientation != ORIENTATION_TOPLEFT || w == 0 || h == 0 ||
+        w > MaxTiffWidth || h > MaxTiffHeight || rowsperstrip == 0)
+        return 1;
+#if defined(COMPRESSION_WEBP)
+    if (tiffcomp == COMPRESSION_WEBP)
+        return 1;
+#endif  /* COMPRESSION_WEBP */
+
+    d = bps;
+    ps->bps = bps;
+    ps->tiffbpl = TIFFScanlineSize(tif);
+    if (ps->tiffbpl != (bps * w + 7) / 8)
+        return 1;
+    ps->rowsperstrip = L_MIN(rowsperstrip, h);
+    ps->nstrips = TIFFNumberOfStrips(tif);
+    if (ps->nstrips != (h + ps->rowsperstrip - 1) / ps->rowsperstrip)
+        return 1;
+    if (!TIFFGetField(tif, TIFFTAG_STRIPOFFSETS, &ps->offsets) ||
+        !TIFFGetField(tif, TIFFTAG_STRIPBYTECOUNTS, &ps->counts))
+        return 1;
+
+        /* Set up the colormap or the inversion, as in
+         * pixReadFromTiffStream() */
+    cmap = NULL;
+    if (TIFFGetField(tif, TIFFTAG_COLORMAP, &redmap, &greenmap, &bluemap)) {
+        if (bps > 8)
+            return 1;
+        cmap = pixcmapCreate(bps);
+        ncolors = 1 << bps;
+        for (i = 0; i < ncolors; i++)
+            pixcmapAddColor(cmap, redmap[i] >> 8, greenmap[i] >> 8,
+                            bluemap[i] >> 8);
+    } else {
+        if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometry)) {
+            if (tiffcomp == COMPRESSION_CCITTFAX3 ||
+                tiffcomp == COMPRESSION_CCITTFAX4 ||
+                tiffcomp == COMPRESSION_CCITTRLE ||
+                tiffcomp == COMPRESSION_CCITTRLEW) {
+                photometry = PHOTOMETRIC_MINISWHITE;
+            } else {
+                photometry = PHOTOMETRIC_MINISBLACK;
+            }
+        }
+        ps->invert = ((d == 1 && photometry == PHOTOMETRIC_MINISBLACK) ||
+                      (d == 8 && photometry == PHOTOMETRIC_MINISWHITE));
+    }
+
+    ps->stripbuf = (l_uint8 *)LEPT_CALLOC((size_t)ps->rowsperstrip,
+                                          ps->tiffbpl);
+    if ((pix = pixCreate(w, h, d)) == NULL || !ps->stripbuf) {
+        pixcmapDestroy(&cmap);
+        return 1;
+    }
+    if (pixSetColormap(pix, cmap)) {
+        pixDestroy(&pix);
+        return 1;
+    }
+    pixSetInputFormat(pix, IFF_TIFF);
+    if (getTiffStreamResolution(tif, &xres, &yres) == 0) {
+        pixSetXRes(pix, xres);
+        pixSetYRes(pix, yres);
+    }
+    text = NULL;
+    TIFFGetField(tif, TIFFTAG_IMAGEDESCRIPTION, &text);
+    if (text) pixSetText(pix, text);
+    pd->pix = pix;
+    pd->status = L_PUSHDEC_DECODING;
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffPushDecode()
+ *
+ * \param[in]    pd    push decoder
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is called by the push decoder (pushdecode.c) whenever
+ *          data arrives.  Once the first directory has arrived, the tiff
+ *          is opened, and after that each strip is decoded as soon as
+ *          all of its data is present.
+ *      (2) Note that libtiff writes the directory after the image data,
+ *          so for files written by leptonica, nothing can be decoded
+ *          until all the data has arrived.  Files with the directory
+ *          at the front are decoded strip by strip.
+ *      (3) Only the first image of a multipage tiff is decoded.
+ *          The result is the same as with pixReadMemTiff() for page 0.
+ * </pre>
+ */
+l_ok
+tiffPushDecode(L_PUSHDEC  *pd)
+{
+l_int32         i, j, y, nrows, h;
+size_t          size;
+l_uint8        *rowptr;
+l_uint32       *line;
+PIX            *pix1;
+TIFFPUSHSTATE  *ps;
+
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+
+    if (!pd->codec)
+        pd->codec = LEPT_CALLOC(1, sizeof(TIFFPUSHSTATE));
+    ps = (TIFFPUSHSTATE *)pd->codec;
+
+        /* Open when the first directory is here */
+    if (!ps->tif && !ps->oneshot) {
+        if (tiffPushDirectorySize(pd->data, pd->nbytes, &size)) {
+            ps->oneshot = 1;
+        } else if (size > 0 && size <= pd->nbytes) {
+            if (tiffPushOpen(pd, ps)) {
+                if (ps->tif) TIFFClose(ps->tif);
+                ps->tif = NULL;
+                pixDestroy(&pd->pix);
+                pd->status = L_PUSHDEC_WAITING;
+                ps->oneshot = 1;
+            }
+        } else if (pd->eof) {
+            ps->oneshot = 1;
+        }
+    }
+
+    if (ps->oneshot) {
+        if (!pd->eof)
+            return 0;
+        pd->offset = pd->nbytes;
+        if ((pd->pix = pixReadMemTiff(pd->data, pd->nbytes, 0)) == NULL)
+            return ERROR_INT("tiff decode failed", __func__, 1);
+        pd->nrows = pixGetHeight(pd->pix);
+        pd->status = L_PUSHDEC_DONE;
+        return 0;
+    }
+    if (!ps->tif)
+        return 0;
+
+        /* The data may have moved since the last call */
+    ps->mstream->buffer = pd->data;
+    ps->mstream->bufsize = pd->nbytes;
+    ps->mstream->hw = pd->nbytes;
+    pd->offset = pd->nbytes;
+
+        /* Decode each strip whose data is all here */
+    h = pixGetHeight(pd->pix);
+    while (ps->nextstrip < ps->nstrips) {
+        i = ps->nextstrip;
+        if (ps->offsets[i] + ps->counts[i] > pd->nbytes)
+            break;
+        y = i * ps->rowsperstrip;
+        nrows = L_MIN(ps->rowsperstrip, h - y);
+        if (TIFFReadEncodedStrip(ps->tif, i, ps->stripbuf,
+                                 (tsize_t)nrows * ps->tiffbpl) < 0) {
+            L_ERROR("read fail at strip %d\n", __func__, i);
+            return 1;
+        }
+        for (rowptr = ps->stripbuf; nrows > 0;
+             nrows--, y++, rowptr += ps->tiffbpl) {
+            line = pixGetData(pd->pix) + y * pixGetWpl(pd->pix);
+            if (ps->bps == 16) {
+                for (j = 0; j < ps->tiffbpl / 2; j++)
+                    SET_DATA_TWO_BYTES(line, j, ((l_uint16 *)rowptr)[j]);
+            } else if (ps->invert) {
+                for (j = 0; j < ps->tiffbpl; j++)
+                    SET_DATA_BYTE(line, j, ~rowptr[j] & 0xff);
+            } else {
+                for (j = 0; j < ps->tiffbpl; j++)
+                    SET_DATA_BYTE(line, j, rowptr[j]);
+            }
+        }
+        pd->nrows = y;
+        ps->nextstrip++;
+    }
+    if (pd->nrows < h)
+        return 0;
+
+        /* Remove the colormap for 1 bpp */
+    if (ps->bps == 1 && pixGetColormap(pd->pix)) {
+        if ((pix1 = pixRemoveColormap(pd->pix,
+                                      REMOVE_CMAP_BASED_ON_SRC)) == NULL)
+            return ERROR_INT("colormap not removed", __func__, 1);
+        pixDestroy(&pd->pix);
+        pd->pix = pix1;
+    }
+    pd->status = L_PUSHDEC_DONE;
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffPushCleanup()
+ *
+ * \param[in]    pd    push decoder
+ * \return  void
+ */
+void
+tiffPushCleanup(L_PUSHDEC  *pd)
+{
+TIFFPUSHSTATE  *ps;
+
+    if (!pd || !pd->codec) return;
+    ps = (TIFFPUSHSTATE *)pd->codec;
+    if (ps->tif) TIFFClose(ps->tif);  /* also frees the mstream */
+    LEPT_FREE(ps->stripbuf);
+    LEPT_FREE(ps);
+    pd->codec = NULL;
+}
+
 /* ---------------------------------------*/
 #endif  /* HAVE_LIBTIFF && HAVE_LIBJPEG   */
 /* ---------------------------------------*/
@@ -233,6 +233,21 @@ l_ok pixWriteMemTiffCustom(l_uint8 **pdata, size_t *psize, PIX *pix,
     return ERROR_INT("function not present", __func__, 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffPushDecode(L_PUSHDEC *pd)
+{
+    return ERROR_INT("function not present", __func__, 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void tiffPushCleanup(L_PUSHDEC *pd)
+{
+    L_ERROR("function not present\n", __func__);
+    return;
+}
+
 /* -----------------------------------------*/
 #endif  /* !HAVE_LIBTIFF || !HAVE_LIBJPEG   */
 /* -----------------------------------------*/
@@ -39,8 +39,14 @@
  *            static l_int32   wshedGetHeight()
  *            static void      pushNewPixel()
  *            static void      popNewPixel()
+ *            static L_WSHEAP  *wsheapCreate()
+ *            static void      wsheapDestroy()
+ *            static void      wsheapAdd()
+ *            static l_int32   wsheapRemove()
+ *            static L_WSQUEUE *wsqueueCreate()
+ *            static void      wsqueueDestroy()
  *            static void      pushWSPixel()
- *            static void      popWSPixel()
+ *            static l_int32   popWSPixel()
  *            static void      debugPrintLUT()
  *            static void      debugWshedMerge()
  *
@@ -49,6 +55,9 @@
  *            PIX             *wshedRenderFill()
  *            PIX             *wshedRenderColors()
  *
+ *      Marker-controlled watershed
+ *            PIX             *pixWatershedMarkers()
+ *
  *  The watershed function identifies the "catch basins" of the input
  *  8 bpp image, with respect to the specified seeds or "markers".
  *  The use is in segmentation, but the selection of the markers is
@@ -109,6 +118,18 @@
  *      Pix *pixd = wshedRenderFill(wshed);
  *
  *      wshedDestroy(&wshed);
+ *
+ *  The pixels are kept in a binary heap of (value, location, index)
+ *  entries in a single array, without allocating memory for each pixel.
+ *  It orders the entries exactly as an L_HEAP does, so pixels with
+ *  equal values are removed in the same order.  That order matters:
+ *  the basin levels and the mindepth tests depend on which of two
+ *  pixels with the same value reaches a saddle first.
+ *
+ *  A simpler marker-controlled watershed is given by pixWatershedMarkers().
+ *  It floods the image from a set of labelled markers, without minima
+ *  or depth tests, and returns either the label of the basin for every
+ *  pixel or the lines where the basins meet.
  * </pre>
  */
 
@@ -124,6 +145,14 @@
 
 static const l_uint32  MAX_LABEL_VALUE = 0x7fffffff;  /* largest l_int32 */
 
+    /* Special labels for pixWatershedMarkers() */
+static const l_int32  WshedInQueue = -1;
+static const l_int32  WshedLine = -2;
+
+    /* Neighbor offsets; the first 4 are for 4-connectivity */
+static const l_int32  Dx[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+static const l_int32  Dy[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+
 /*! New pixel coordinates */
 struct L_NewPixel
 {
@@ -132,15 +161,26 @@ struct L_NewPixel
 };
 typedef struct L_NewPixel  L_NEWPIXEL;
 
-/*! Wartshed pixel */
-struct L_WSPixel
+/*! Priority queue of watershed pixels, as a binary heap */
+struct L_WSHeap
 {
-    l_float32  val;    /*!< pixel value */
-    l_int32    x;      /*!< x coordinate */
-    l_int32    y;      /*!< y coordinate */
-    l_int32    index;  /*!< label for set to which pixel belongs */
+    l_int32    n;            /*!< number of entries in the heap           */
+    l_int32    nalloc;       /*!< number of entries allocated             */
+    l_int32   *array;        /*!< (value, x + w * y, index) for each      */
+};
+typedef struct L_WSHeap  L_WSHEAP;
+
+/*! Bucket queue of watershed pixels, with a FIFO for each level */
+struct L_WSQueue
+{
+    l_int32    minlevel;     /*!< no pixels are queued below this level   */
+    l_int32    count;        /*!< number of pixels in the queue           */
+    l_int32    head[256];    /*!< next entry to be removed at each level  */
+    l_int32    n[256];       /*!< number of entries added at each level   */
+    l_int32    nalloc[256];  /*!< size of the array at each level         */
+    l_int32   *array[256];   /*!< (x + w * y, index) for each entry       */
 };
-typedef struct L_WSPixel  L_WSPIXEL;
+typedef struct L_WSQueue  L_WSQUEUE;
 
 
     /* Static functions for obtaining bitmap of watersheds  */
@@ -164,11 +204,18 @@ static void pushNewPixel(L_QUEUE *lq, l_int32 x, l_int32 y,
                          l_int32 *pminy, l_int32 *pmaxy);
 static void popNewPixel(L_QUEUE *lq, l_int32 *px, l_int32 *py);
 
-    /* Static accessors for WSPixel on a heap */
-static void pushWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 val,
-                        l_int32 x, l_int32 y, l_int32 index);
-static void popWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 *pval,
-                       l_int32 *px, l_int32 *py, l_int32 *pindex);
+    /* Static heap and bucket queue for watershed pixels */
+static L_WSHEAP *wsheapCreate(void);
+static void wsheapDestroy(L_WSHEAP **pwh);
+static void wsheapAdd(L_WSHEAP *wh, l_int32 val, l_int32 pos, l_int32 index);
+static l_int32 wsheapRemove(L_WSHEAP *wh, l_int32 *pval, l_int32 *ppos,
+                            l_int32 *pindex);
+static L_WSQUEUE *wsqueueCreate(void);
+static void wsqueueDestroy(L_WSQUEUE **pwq);
+static void pushWSPixel(L_WSQUEUE *wq, l_int32 val, l_int32 pos,
+                        l_int32 index);
+static l_int32 popWSPixel(L_WSQUEUE *wq, l_int32 *pval, l_int32 *ppos,
+                          l_int32 *pindex);
 
     /* Static debug print output */
 static void debugPrintLUT(l_int32 *lut, l_int32 size, l_int32 debug);
@@ -314,19 +361,18 @@ char      minima_absorbed_into_seeded_basin[] =
 char      minima_absorbed_by_filler_or_another[] =
                  "Minima absorbed by filler or another";
 l_int32   nseeds, nother, nboth, arraysize;
-l_int32   i, j, val, x, y, w, h, index, mindepth;
-l_int32   imin, imax, jmin, jmax, cindex, clabel, nindex;
-l_int32   hindex, hlabel, hmin, hmax, minhindex, maxhindex;
-l_int32  *lut;
-l_uint32  ulabel, uval;
-void    **lines8, **linelab32;
-NUMA     *nalut, *nalevels, *nash, *namh, *nasi;
-NUMA    **links;
-L_HEAP   *lh;
-PIX      *pixmin, *pixsd;
-PIXA     *pixad;
-L_STACK  *rstack;
-PTA      *ptas, *ptao;
+l_int32     i, j, val, x, y, w, h, pos, index, mindepth;
+l_int32     imin, imax, jmin, jmax, cindex, clabel, nindex;
+l_int32     hindex, hlabel, hmin, hmax, minhindex, maxhindex;
+l_int32    *lut;
+l_uint32    ulabel, uval;
+void      **lines8, **linelab32;
+NUMA       *nalut, *nalevels, *nash, *namh, *nasi;
+NUMA      **links;
+L_WSHEAP   *wh;
+PIX        *pixmin, *pixsd;
+PIXA       *pixad;
+PTA        *ptas, *ptao;
 
     if (!wshed)
         return ERROR_INT("wshed not defined", __func__, 1);
@@ -335,8 +381,7 @@ PTA      *ptas, *ptao;
      *  Initialize priority queue and pixlab with seeds and minima  *
      * ------------------------------------------------------------ */
 
-    lh = lheapCreate(0, L_SORT_INCREASING);  /* remove lowest values first */
-    rstack = lstackCreate(0);  /* for reusing the WSPixels */
+    wh = wsheapCreate();  /* remove lowest values first */
     pixGetDimensions(wshed->pixs, &w, &h, NULL);
     lines8 = wshed->lines8;  /* wshed owns this */
     linelab32 = wshed->linelab32;  /* ditto */
@@ -348,7 +393,7 @@ PTA      *ptas, *ptao;
     for (i = 0; i < nseeds; i++) {
         ptaGetIPt(ptas, i, &x, &y);
         uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, i);
+        wsheapAdd(wh, (l_int32)uval, y * w + x, i);
     }
     wshed->ptas = ptas;
     nasi = numaMakeConstant(1, nseeds);  /* indicator array */
@@ -370,7 +415,7 @@ PTA      *ptas, *ptao;
     for (i = 0; i < nother; i++) {
         ptaGetIPt(ptao, i, &x, &y);
         uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, nseeds + i);
+        wsheapAdd(wh, (l_int32)uval, y * w + x, nseeds + i);
     }
     wshed->namh = namh;
 
@@ -401,8 +446,9 @@ PTA      *ptas, *ptao;
     nalevels = numaCreate(nseeds);
     wshed->nalevels = nalevels;  /* wshed owns this */
     L_INFO("nseeds = %d, nother = %d\n", __func__, nseeds, nother);
-    while (lheapGetCount(lh) > 0) {
-        popWSPixel(lh, rstack, &val, &x, &y, &index);
+    while (wsheapRemove(wh, &val, &pos, &index) == 0) {
+        y = pos / w;
+        x = pos - y * w;
 /*        lept_stderr("x = %d, y = %d, index = %d\n", x, y, index); */
         ulabel = GET_DATA_FOUR_BYTES(linelab32[y], x);
         if (ulabel == MAX_LABEL_VALUE)
@@ -422,7 +468,7 @@ PTA      *ptas, *ptao;
                 for (j = jmin; j <= jmax; j++) {
                     if (i == y && j == x) continue;
                     uval = GET_DATA_BYTE(lines8[i], j);
-                    pushWSPixel(lh, rstack, (l_int32)uval, j, i, cindex);
+                    wsheapAdd(wh, (l_int32)uval, i * w + j, cindex);
                 }
             }
         } else {  /* pixel is already labeled (differently); must resolve */
@@ -432,7 +478,6 @@ PTA      *ptas, *ptao;
                  * locate them and assign to both regions a new index
                  * for further waterfill.  If not, absorb the shallower
                  * watershed into the deeper one and continue filling it. */
-            pixGetPixel(pixsd, x, y, &uval);
             if (clabel < nseeds && cindex < nseeds) {
                 wshedGetHeight(wshed, val, clabel, &hlabel);
                 wshedGetHeight(wshed, val, cindex, &hindex);
@@ -524,8 +569,7 @@ PTA      *ptas, *ptao;
     pixDestroy(&pixmin);
     pixDestroy(&pixsd);
     ptaDestroy(&ptao);
-    lheapDestroy(&lh, TRUE);
-    lstackDestroy(&rstack, TRUE);
+    wsheapDestroy(&wh);
     return 0;
 }
 
@@ -874,101 +918,254 @@ L_NEWPIXEL  *np;
 
 
 /*
- * \brief   pushWSPixel()
+ * \brief   wsheapCreate()
  *
- * \param[in]    lh       priority queue
- * \param[in]    stack    of reusable WSPixels
- * \param[in]    val      pixel value: used for ordering the heap
- * \param[in]    x, y     pixel coordinates
- * \param[in]    index    label for set to which pixel belongs
- * \return    void
+ * \return  heap for watershed pixels, with the lowest value on top
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for adding a WSPixel to a heap.  It
- *          uses the storage stack to retrieve a WSPixel.
+ *      (1) This is used by wshedApply().  wsheapAdd() and
+ *          wsheapRemove() move the entries to the same places as
+ *          lheapAdd() and lheapRemove() with L_SORT_INCREASING, so
+ *          pixels with the same value come out in the same order as
+ *          from an L_HEAP.  Instead of swapping at each step, the
+ *          entries are shifted into a hole that is filled at the end.
  * </pre>
  */
+static L_WSHEAP *
+wsheapCreate(void)
+{
+    return (L_WSHEAP *)LEPT_CALLOC(1, sizeof(L_WSHEAP));
+}
+
+
+/*
+ * \brief   wsheapDestroy()
+ *
+ * \param[in,out]   pwh   will be set to null before returning
+ * \return  void
+ */
 static void
-pushWSPixel(L_HEAP   *lh,
-            L_STACK  *stack,
-            l_int32   val,
-            l_int32   x,
-            l_int32   y,
-            l_int32   index)
+wsheapDestroy(L_WSHEAP  **pwh)
 {
-L_WSPIXEL  *wsp;
+L_WSHEAP  *wh;
 
-    if (!lh) {
-        L_ERROR("heap not defined\n", __func__);
+    if ((wh = *pwh) == NULL)
         return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", __func__);
-        return;
-    }
+    LEPT_FREE(wh->array);
+    LEPT_FREE(wh);
+    *pwh = NULL;
+}
 
-        /* Get a wspixel to use */
-    if (lstackGetCount(stack) > 0)
-        wsp = (L_WSPIXEL *)lstackRemove(stack);
-    else
-        wsp = (L_WSPIXEL *)LEPT_CALLOC(1, sizeof(L_WSPIXEL));
 
-    wsp->val = (l_float32)val;
-    wsp->x = x;
-    wsp->y = y;
-    wsp->index = index;
-    lheapAdd(lh, wsp);
+/*
+ * \brief   wsheapAdd()
+ *
+ * \param[in]    wh       heap
+ * \param[in]    val      pixel value: used for ordering the heap
+ * \param[in]    pos      pixel location, x + w * y
+ * \param[in]    index    label for set to which pixel belongs
+ * \return    void
+ */
+static void
+wsheapAdd(L_WSHEAP  *wh,
+          l_int32    val,
+          l_int32    pos,
+          l_int32    index)
+{
+l_int32   ic, ip;
+l_int32  *array;
+
+    if (wh->n == wh->nalloc) {
+        wh->nalloc = L_MAX(256, 2 * wh->n);
+        wh->array = (l_int32 *)reallocNew((void **)&wh->array,
+                                          3 * wh->n * sizeof(l_int32),
+                                          3 * wh->nalloc * sizeof(l_int32));
+    }
+    array = wh->array;
+
+        /* Swap up: move parents down to the hole at ic until the
+         * new entry can go there */
+    ic = wh->n++;
+    while (ic > 0) {
+        ip = (ic - 1) / 2;
+        if (array[3 * ip] <= val)
+            break;
+        array[3 * ic] = array[3 * ip];
+        array[3 * ic + 1] = array[3 * ip + 1];
+        array[3 * ic + 2] = array[3 * ip + 2];
+        ic = ip;
+    }
+    array[3 * ic] = val;
+    array[3 * ic + 1] = pos;
+    array[3 * ic + 2] = index;
 }
 
 
 /*
- * \brief  popWSPixel()
+ * \brief   wsheapRemove()
  *
- * \param[in]     lh        priority queue
- * \param[in]     stack     of reusable WSPixels
+ * \param[in]     wh        heap
  * \param[out]    pval      pixel value
- * \param[out]    px, py    pixel coordinates
+ * \param[out]    ppos      pixel location, x + w * y
  * \param[out]    pindex    label for set to which pixel belongs
- * \return   void
+ * \return   0 if a pixel was removed, 1 if the heap is empty
+ */
+static l_int32
+wsheapRemove(L_WSHEAP  *wh,
+             l_int32   *pval,
+             l_int32   *ppos,
+             l_int32   *pindex)
+{
+l_int32   n, ip, ic, icr, val;
+l_int32  *array;
+
+    if (wh->n == 0)
+        return 1;
+    array = wh->array;
+    *pval = array[0];
+    *ppos = array[1];
+    *pindex = array[2];
+    n = --wh->n;
+    val = array[3 * n];  /* the last entry moves down from the head */
+
+        /* Swap down: move the smaller child up to the hole at ip
+         * until the last entry can go there */
+    ip = 0;
+    while ((ic = 2 * ip + 1) < n) {
+        icr = ic + 1;
+        if (icr < n && array[3 * icr] < array[3 * ic])
+            ic = icr;
+        if (val <= array[3 * ic])
+            break;
+        array[3 * ip] = array[3 * ic];
+        array[3 * ip + 1] = array[3 * ic + 1];
+        array[3 * ip + 2] = array[3 * ic + 2];
+        ip = ic;
+    }
+    array[3 * ip] = val;
+    array[3 * ip + 1] = array[3 * n + 1];
+    array[3 * ip + 2] = array[3 * n + 2];
+    return 0;
+}
+
+
+/*
+ * \brief   wsqueueCreate()
+ *
+ * \return  bucket queue for 8 bpp pixel values
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for removing a WSPixel from a heap,
- *          which returns the WSPixel data and saves the WSPixel
- *          on the storage stack.
+ *      (1) This is used by pixWatershedMarkers().
+ *      (2) There is a FIFO for each of the 256 values.  Pixels are
+ *          removed in increasing order of value, and in the order
+ *          they were added for pixels with the same value.  Both
+ *          operations are O(1), except for the scan to the next
+ *          non-empty level, which is at most 256 steps over the
+ *          whole fill.
  * </pre>
  */
+static L_WSQUEUE *
+wsqueueCreate(void)
+{
+    return (L_WSQUEUE *)LEPT_CALLOC(1, sizeof(L_WSQUEUE));
+}
+
+
+/*
+ * \brief   wsqueueDestroy()
+ *
+ * \param[in,out]   pwq   will be set to null before returning
+ * \return  void
+ */
 static void
-popWSPixel(L_HEAP   *lh,
-           L_STACK  *stack,
-           l_int32  *pval,
-           l_int32  *px,
-           l_int32  *py,
-           l_int32  *pindex)
+wsqueueDestroy(L_WSQUEUE  **pwq)
 {
-L_WSPIXEL  *wsp;
+l_int32     i;
+L_WSQUEUE  *wq;
 
-    if (!lh) {
-        L_ERROR("lheap not defined\n", __func__);
-        return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", __func__);
-        return;
-    }
-    if (!pval || !px || !py || !pindex) {
-        L_ERROR("data can't be returned\n", __func__);
+    if ((wq = *pwq) == NULL)
         return;
+    for (i = 0; i < 256; i++)
+        LEPT_FREE(wq->array[i]);
+    LEPT_FREE(wq);
+    *pwq = NULL;
+}
+
+
+/*
+ * \brief   pushWSPixel()
+ *
+ * \param[in]    wq       bucket queue
+ * \param[in]    val      pixel value: used for ordering the queue
+ * \param[in]    pos      pixel location, x + w * y
+ * \param[in]    index    label for set to which pixel belongs
+ * \return    void
+ *
+ * <pre>
+ * Notes:
+ *      (1) A pixel can be added at a level below the lowest one that
+ *          is queued; it is then the next one to be removed.
+ * </pre>
+ */
+static void
+pushWSPixel(L_WSQUEUE  *wq,
+            l_int32     val,
+            l_int32     pos,
+            l_int32     index)
+{
+l_int32   n;
+l_int32  *array;
+
+    if (wq->head[val] == wq->n[val])  /* empty; reuse the array */
+        wq->head[val] = wq->n[val] = 0;
+    n = wq->n[val];
+    if (n == wq->nalloc[val]) {
+        wq->nalloc[val] = L_MAX(64, 2 * n);
+        wq->array[val] = (l_int32 *)reallocNew((void **)&wq->array[val],
+                                  2 * n * sizeof(l_int32),
+                                  2 * wq->nalloc[val] * sizeof(l_int32));
     }
+    array = wq->array[val];
+    array[2 * n] = pos;
+    array[2 * n + 1] = index;
+    wq->n[val]++;
+    if (wq->count == 0 || val < wq->minlevel)
+        wq->minlevel = val;
+    wq->count++;
+}
 
-    if ((wsp = (L_WSPIXEL *)lheapRemove(lh)) == NULL)
-        return;
-    *pval = (l_int32)wsp->val;
-    *px = wsp->x;
-    *py = wsp->y;
-    *pindex = wsp->index;
-    lstackAdd(stack, wsp);  /* save for re-use */
+
+/*
+ * \brief  popWSPixel()
+ *
+ * \param[in]     wq        bucket queue
+ * \param[out]    pval      pixel value
+ * \param[out]    ppos      pixel location, x + w * y
+ * \param[out]    pindex    label for set to which pixel belongs
+ * \return   0 if a pixel was removed, 1 if the queue is empty
+ */
+static l_int32
+popWSPixel(L_WSQUEUE  *wq,
+           l_int32    *pval,
+           l_int32    *ppos,
+           l_int32    *pindex)
+{
+l_int32   val, head;
+
+    if (wq->count == 0)
+        return 1;
+    val = wq->minlevel;
+    while (wq->head[val] == wq->n[val])
+        val++;
+    wq->minlevel = val;
+    head = wq->head[val]++;
+    *pval = val;
+    *ppos = wq->array[val][2 * head];
+    *pindex = wq->array[val][2 * head + 1];
+    wq->count--;
+    return 0;
 }
 
 
@@ -1096,3 +1293,174 @@ PIXA    *pixa;
     pixaDestroy(&pixa);
     return pixd;
 }
+
+
+/*-----------------------------------------------------------------------*
+ *                      Marker-controlled watershed                      *
+ *-----------------------------------------------------------------------*/
+/*!
+ * \brief   pixWatershedMarkers()
+ *
+ * \param[in]    pixs           8 bpp; no colormap
+ * \param[in]    pixm           1 bpp markers, or 8, 16 or 32 bpp labels
+ *                              of markers, with 0 for unmarked pixels
+ * \param[in]    connectivity   4 or 8
+ * \param[in]    outformat      L_WSHED_LABELS or L_WSHED_BORDERS
+ * \return  pixd    32 bpp labels or 1 bpp borders, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This floods pixs from the markers in increasing order of
+ *          pixel value.  Each pixel reached by the flood takes the label
+ *          of an adjacent labelled pixel.  There is one basin for each
+ *          marker label, and the minima of pixs that have no marker are
+ *          absorbed by the basin that reaches them first.  Use the
+ *          labels to segment touching objects: make one marker for
+ *          each object, and flood an image that is high between
+ *          the objects, such as a gradient or an inverted distance
+ *          function.
+ *      (2) If pixm is 1 bpp, each connected component is a marker,
+ *          and the labels are 1, 2, ... in raster order of the
+ *          components.  Otherwise, the nonzero values in pixm are the
+ *          labels, and a label can be used for more than one marker.
+ *      (3) With L_WSHED_LABELS, pixd has the basin label of every pixel
+ *          that is reached from a marker.  The pixels that are not
+ *          reached, because there are no markers, are 0.
+ *      (4) With L_WSHED_BORDERS, the pixels where basins with different
+ *          labels meet are not labelled, and are not used to continue
+ *          the flood.  pixd is 1 for these watershed lines, and 0
+ *          elsewhere.
+ *      (5) Pixels are taken from a bucket queue with a FIFO for each
+ *          level.  A pixel that is added below the current flood
+ *          level is queued at that level, so the flood level never
+ *          decreases.
+ * </pre>
+ */
+PIX *
+pixWatershedMarkers(PIX     *pixs,
+                    PIX     *pixm,
+                    l_int32  connectivity,
+                    l_int32  outformat)
+{
+l_int32     i, j, k, w, h, d, wplm, wpld, n, pos, x, y, xn, yn, q;
+l_int32     val, level, index, label, qlabel;
+l_int32    *lab;
+l_uint32   *datam, *datad, *line;
+void      **lines8;
+L_WSQUEUE  *wq;
+PIX        *pixt, *pixd;
+
+    if (!pixs || pixGetDepth(pixs) != 8 || pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs undefined or not 8 bpp gray",
+                                __func__, NULL);
+    if (!pixm)
+        return (PIX *)ERROR_PTR("pixm not defined", __func__, NULL);
+    d = pixGetDepth(pixm);
+    if (d != 1 && d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixm not 1, 8, 16 or 32 bpp",
+                                __func__, NULL);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if (pixGetWidth(pixm) != w || pixGetHeight(pixm) != h)
+        return (PIX *)ERROR_PTR("pixs and pixm sizes differ", __func__, NULL);
+    if (connectivity != 4 && connectivity != 8)
+        return (PIX *)ERROR_PTR("connectivity not 4 or 8", __func__, NULL);
+    if (outformat != L_WSHED_LABELS && outformat != L_WSHED_BORDERS)
+        return (PIX *)ERROR_PTR("invalid outformat", __func__, NULL);
+
+        /* Get the marker labels */
+    if (d == 1) {
+        if ((pixt = pixConnCompTransform(pixm, connectivity, 32)) == NULL)
+            return (PIX *)ERROR_PTR("pixt not made", __func__, NULL);
+    } else {
+        pixt = pixClone(pixm);
+    }
+    n = w * h;
+    lab = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    datam = pixGetData(pixt);
+    wplm = pixGetWpl(pixt);
+    d = pixGetDepth(pixt);
+    for (i = 0, k = 0; i < h; i++) {
+        line = datam + i * wplm;
+        for (j = 0; j < w; j++, k++) {
+            if (d == 8)
+                lab[k] = GET_DATA_BYTE(line, j);
+            else if (d == 16)
+                lab[k] = GET_DATA_TWO_BYTES(line, j);
+            else  /* d == 32 */
+                lab[k] = line[j] & 0x7fffffff;
+        }
+    }
+    pixDestroy(&pixt);
+
+        /* Queue the unmarked neighbors of the markers */
+    wq = wsqueueCreate();
+    lines8 = pixGetLinePtrs(pixs, NULL);
+    for (k = 0; k < n; k++) {
+        if (lab[k] <= 0) continue;
+        y = k / w;
+        x = k - y * w;
+        for (i = 0; i < connectivity; i++) {
+            xn = x + Dx[i];
+            yn = y + Dy[i];
+            if (xn < 0 || xn >= w || yn < 0 || yn >= h) continue;
+            q = yn * w + xn;
+            if (lab[q] != 0) continue;
+            lab[q] = WshedInQueue;
+            pushWSPixel(wq, GET_DATA_BYTE(lines8[yn], xn), q, 0);
+        }
+    }
+
+        /* Flood */
+    while (popWSPixel(wq, &level, &pos, &index) == 0) {
+        y = pos / w;
+        x = pos - y * w;
+        label = 0;
+        for (i = 0; i < connectivity; i++) {
+            xn = x + Dx[i];
+            yn = y + Dy[i];
+            if (xn < 0 || xn >= w || yn < 0 || yn >= h) continue;
+            qlabel = lab[yn * w + xn];
+            if (qlabel <= 0) continue;
+            if (label == 0) {
+                label = qlabel;
+                if (outformat == L_WSHED_LABELS) break;
+            } else if (qlabel != label) {
+                label = WshedLine;
+                break;
+            }
+        }
+        lab[pos] = label;
+        if (label == WshedLine) continue;
+        for (i = 0; i < connectivity; i++) {
+            xn = x + Dx[i];
+            yn = y + Dy[i];
+            if (xn < 0 || xn >= w || yn < 0 || yn >= h) continue;
+            q = yn * w + xn;
+            if (lab[q] != 0) continue;
+            lab[q] = WshedInQueue;
+            val = GET_DATA_BYTE(lines8[yn], xn);
+            pushWSPixel(wq, L_MAX(val, level), q, 0);
+        }
+    }
+    wsqueueDestroy(&wq);
+    LEPT_FREE(lines8);
+
+        /* Render the labels or the lines */
+    if (outformat == L_WSHED_LABELS)
+        pixd = pixCreate(w, h, 32);
+    else
+        pixd = pixCreate(w, h, 1);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0, k = 0; i < h; i++) {
+        line = datad + i * wpld;
+        for (j = 0; j < w; j++, k++) {
+            if (outformat == L_WSHED_LABELS)
+                line[j] = lab[k];
+            else if (lab[k] == WshedLine)
+                SET_DATA_BIT(line, j);
+        }
+    }
+    LEPT_FREE(lab);
+    return pixd;
+}
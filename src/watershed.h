@@ -32,6 +32,8 @@
  *
  *     Simple data structure to hold watershed data.
  *     All data here is owned by the L_WShed and must be freed.
+ *
+ *     Output flags for pixWatershedMarkers().
  */
 
 /*! Simple data structure to hold watershed data. */
@@ -61,4 +63,10 @@ struct L_WShed
 };
 typedef struct L_WShed L_WSHED;
 
+/*! Output of marker-controlled watershed */
+enum {
+    L_WSHED_LABELS   = 1,    /*!< 32 bpp label of the basin of each pixel */
+    L_WSHED_BORDERS  = 2     /*!< 1 bpp lines where basins meet           */
+};
+
 #endif  /* LEPTONICA_WATERSHED_H */
@@ -40,6 +40,10 @@
  *          l_int32          pixWriteWebP()  [ special top level ]
  *          l_int32          pixWriteStreamWebP()
  *          l_int32          pixWriteMemWebP()
+ *
+ *    Push decoding of webp
+ *          l_int32          webpPushDecode()
+ *          void             webpPushCleanup()
  * </pre>
  */
 
@@ -401,6 +405,122 @@ PIX       *pix1, *pix2;
     return 0;
 }
 
+
+/*---------------------------------------------------------------------*
+ *                        Push decoding of webp                        *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   webpPushDecode()
+ *
+ * \param[in]    pd    push decoder
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is called by the push decoder (pushdecode.c) whenever
+ *          data arrives.  When the header is available, the image is
+ *          made and a libwebp incremental decoder is set up to decode
+ *          directly into its raster.  The data not yet seen is then
+ *          appended to the incremental decoder.
+ *      (2) The rows are decoded in RGBA byte order, so as each row is
+ *          completed, it is converted in place to pix byte order.
+ *      (3) The result is the same as with pixReadMemWebP().
+ * </pre>
+ */
+l_ok
+webpPushDecode(L_PUSHDEC  *pd)
+{
+l_int32        i, j, w, h, wpl, last_y;
+l_uint32       word;
+l_uint32      *data, *line;
+PIX           *pix;
+VP8StatusCode  status;
+WebPIDecoder  *idec;
+WebPBitstreamFeatures  features;
+
+    if (!pd)
+        return ERROR_INT("pd not defined", __func__, 1);
+
+        /* Make the image and decoder as soon as the header is here */
+    if (!pd->codec) {
+        status = WebPGetFeatures(pd->data, pd->nbytes, &features);
+        if (status == VP8_STATUS_NOT_ENOUGH_DATA)
+            return 0;
+        if (status != VP8_STATUS_OK)
+            return ERROR_INT("Invalid WebP file", __func__, 1);
+        w = features.width;
+        h = features.height;
+        if ((pix = pixCreate(w, h, 32)) == NULL)
+            return ERROR_INT("pix not made", __func__, 1);
+        pixSetInputFormat(pix, IFF_WEBP);
+        if (features.has_alpha) pixSetSpp(pix, 4);
+        wpl = pixGetWpl(pix);
+        idec = WebPINewRGB(MODE_RGBA, (uint8_t *)pixGetData(pix),
+                           (size_t)4 * wpl * h, 4 * wpl);
+        if (!idec) {
+            pixDestroy(&pix);
+            return ERROR_INT("incremental decoder not made", __func__, 1);
+        }
+        pd->pix = pix;
+        pd->codec = idec;
+        pd->offset = 0;
+        pd->status = L_PUSHDEC_DECODING;
+    }
+    idec = (WebPIDecoder *)pd->codec;
+
+    if (pd->nbytes == pd->offset)
+        return 0;
+    status = WebPIAppend(idec, pd->data + pd->offset,
+                         pd->nbytes - pd->offset);
+    pd->offset = pd->nbytes;
+    if (status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED)
+        return ERROR_INT("WebP decode failed", __func__, 1);
+
+        /* Convert the newly completed rows from RGBA byte order
+         * to pix byte order; no swapping is required on big-endians. */
+    last_y = 0;
+    if (WebPIDecGetRGB(idec, &last_y, NULL, NULL, NULL) == NULL)
+        last_y = 0;
+    pix = pd->pix;
+    w = pixGetWidth(pix);
+    h = pixGetHeight(pix);
+    wpl = pixGetWpl(pix);
+    data = pixGetData(pix);
+    last_y = L_MIN(last_y, h);
+    for (i = pd->nrows; i < last_y; i++) {
+        line = data + i * wpl;
+        for (j = 0; j < w; j++) {
+            word = line[j];
+#ifdef L_LITTLE_ENDIAN
+            line[j] = (word >> 24) | ((word >> 8) & 0x0000ff00) |
+                      ((word << 8) & 0x00ff0000) | (word << 24);
+#else
+            line[j] = word;
+#endif  /* L_LITTLE_ENDIAN */
+        }
+    }
+    pd->nrows = L_MAX(pd->nrows, last_y);
+
+    if (status == VP8_STATUS_OK && pd->nrows == h)
+        pd->status = L_PUSHDEC_DONE;
+    return 0;
+}
+
+
+/*!
+ * \brief   webpPushCleanup()
+ *
+ * \param[in]    pd    push decoder
+ * \return  void
+ */
+void
+webpPushCleanup(L_PUSHDEC  *pd)
+{
+    if (!pd || !pd->codec) return;
+    WebPIDelete((WebPIDecoder *)pd->codec);
+    pd->codec = NULL;
+}
+
 /* --------------------------------------------*/
 #endif  /* HAVE_LIBWEBP */
 /* --------------------------------------------*/
@@ -94,6 +94,21 @@ l_ok pixWriteMemWebP(l_uint8 **pencdata, size_t *pencsize, PIX *pixs,
     return ERROR_INT("function not present", __func__, 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+l_ok webpPushDecode(L_PUSHDEC *pd)
+{
+    return ERROR_INT("function not present", __func__, 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void webpPushCleanup(L_PUSHDEC *pd)
+{
+    L_ERROR("function not present\n", __func__);
+    return;
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBWEBP */
 /* --------------------------------------------*/
@@ -29,21 +29,39 @@
  * \file  zlibmem.c
  * <pre>
  *
- *      zlib operations in memory, using bbuffer
+ *      zlib operations in memory
  *          l_uint8   *zlibCompress()
  *          l_uint8   *zlibUncompress()
+ *          size_t     zlibCompressBound()
  *
+ *    We use zlib to compress and decompress a byte array from one
+ *    memory buffer to another.  Compression is done on the whole
+ *    buffer in a single call, writing into an output array that is
+ *    preallocated to the worst-case compressed size, as given by
+ *    zlibCompressBound(), and then shrunk to the compressed size.
+ *    Decompression writes directly into an output array that is
+ *    doubled in size whenever it fills up.  No intermediate copies
+ *    of the data are made.
  *
- *    This provides an example use of the byte buffer utility
- *    (see bbuffer.c for details of how the bbuffer works internally).
- *    We use zlib to compress and decompress a byte array from
- *    one memory buffer to another.  The standard method uses streams,
- *    but here we use the bbuffer as an expandable queue of pixels
- *    for both the reading and writing sides of each operation.
+ *    The zlib interface uses 32-bit sizes on some platforms (e.g.,
+ *    where long is 32 bits).  On decompression, the input is given
+ *    to zlib in chunks, so there is no limit on its size.  With
+ *    zlib (but not libdeflate), compression of an input that is too
+ *    large for a uLong is refused.
  *
- *    With memory mapping, one should be able to compress between
- *    memory buffers by using the file system to buffer everything in
- *    the background, but the bbuffer implementation is more portable.
+ *    If leptonica is built with libdeflate (HAVE_LIBDEFLATE, enabled
+ *    with -DENABLE_LIBDEFLATE=ON in cmake or --with-libdeflate in
+ *    autoconf), it is used instead of zlib for both operations.
+ *    libdeflate only works on whole buffers, which is what we need
+ *    here, and it is typically 2 to 3 times faster than zlib at the
+ *    same compression level.  The output is a standard zlib stream
+ *    in either case, so data compressed with one backend can be
+ *    decompressed with the other.  Use getImagelibVersions() to
+ *    find which backend is in use.
+ *
+ *    These functions are used for the flate encoding of images in
+ *    pdf and PostScript, for compression of serialized data, and
+ *    for the data strings embedded in generated code.
  * </pre>
  */
 
@@ -51,6 +69,7 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
 /* --------------------------------------------*/
@@ -59,9 +78,17 @@
 
 #include "zlib.h"
 
-static const l_int32  L_BUF_SIZE = 32768;
+#if  HAVE_LIBDEFLATE
+#include "libdeflate.h"
+#endif  /* HAVE_LIBDEFLATE */
+
+static const size_t   L_BUF_SIZE = 32768;
 static const l_int32  ZLIB_COMPRESSION_LEVEL = 6;
 
+    /* Largest number of bytes given to inflate() in a single call,
+     * for either input or output */
+static const size_t   MaxInflateChunk = 0x40000000;
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG     0
 #endif  /* ~NO_CONSOLE_IO */
@@ -77,15 +104,13 @@ static const l_int32  ZLIB_COMPRESSION_LEVEL = 6;
  *
  * <pre>
  * Notes:
- *      (1) We repeatedly read in and fill up an input buffer,
- *          compress the data, and read it back out.  zlib
- *          uses two byte buffers internally in the z_stream
- *          data structure.  We use the bbuffers to feed data
- *          into the fixed bufferin, and feed it out of bufferout,
- *          in the same way that a pair of streams would normally
- *          be used if the data were being read from one file
- *          and written to another.  This is done iteratively,
- *          compressing L_BUF_SIZE bytes of input data at a time.
+ *      (1) The output array is allocated with the size given by
+ *          zlibCompressBound(), and the entire input is compressed
+ *          into it with a single call.  It is then reallocated to
+ *          the compressed size, *%pnout, because compressed data is
+ *          often held for a long time.
+ *      (2) With zlib, the input size must fit in a uLong, which is
+ *          32 bits on some platforms.  Larger inputs are rejected.
  * </pre>
  */
 l_uint8 *
@@ -93,85 +118,60 @@ zlibCompress(const l_uint8  *datain,
              size_t          nin,
              size_t         *pnout)
 {
-l_uint8    *dataout;
-l_int32     status, success;
-l_int32     flush;
-size_t      nbytes;
-l_uint8    *bufferin, *bufferout;
-L_BBUFFER  *bbin, *bbout;
-z_stream    z;
+l_uint8  *dataout, *datanew;
+size_t    nbound;
+#if  HAVE_LIBDEFLATE
+struct libdeflate_compressor  *compressor;
+#else
+l_int32   status;
+uLongf    nout;
+#endif  /* HAVE_LIBDEFLATE */
 
+    if (!pnout)
+        return (l_uint8 *)ERROR_PTR("&nout not defined", __func__, NULL);
+    *pnout = 0;
     if (!datain)
         return (l_uint8 *)ERROR_PTR("datain not defined", __func__, NULL);
 
-        /* Set up fixed size buffers used in z_stream */
-    bufferin = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-    bufferout = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-
-        /* Set up bbuffers and load bbin with the data */
-    bbin = bbufferCreate(datain, nin);
-    bbout = bbufferCreate(NULL, 0);
-
-    success = TRUE;
-    if (!bufferin || !bufferout || !bbin || !bbout) {
-        L_ERROR("calloc fail for buffer\n", __func__);
-        success = FALSE;
-        goto cleanup_arrays;
+#if  HAVE_LIBDEFLATE
+    if ((compressor = libdeflate_alloc_compressor(ZLIB_COMPRESSION_LEVEL))
+         == NULL)
+        return (l_uint8 *)ERROR_PTR("compressor not made", __func__, NULL);
+    nbound = libdeflate_zlib_compress_bound(compressor, nin);
+    if ((dataout = (l_uint8 *)LEPT_MALLOC(nbound)) == NULL) {
+        libdeflate_free_compressor(compressor);
+        return (l_uint8 *)ERROR_PTR("dataout not made", __func__, NULL);
     }
-
-    z.zalloc = (alloc_func)0;
-    z.zfree = (free_func)0;
-    z.opaque = (voidpf)0;
-    z.next_in = bufferin;
-    z.avail_in = 0;
-    z.next_out = bufferout;
-    z.avail_out = L_BUF_SIZE;
-
-    status = deflateInit(&z, ZLIB_COMPRESSION_LEVEL);
+    *pnout = libdeflate_zlib_compress(compressor, datain, nin,
+                                      dataout, nbound);
+    libdeflate_free_compressor(compressor);
+    if (*pnout == 0) {
+        LEPT_FREE(dataout);
+        return (l_uint8 *)ERROR_PTR("compression failed", __func__, NULL);
+    }
+#else
+    if ((size_t)(uLong)nin != nin)
+        return (l_uint8 *)ERROR_PTR("nin too large for zlib", __func__, NULL);
+    nbound = zlibCompressBound(nin);
+    if ((dataout = (l_uint8 *)LEPT_MALLOC(nbound)) == NULL)
+        return (l_uint8 *)ERROR_PTR("dataout not made", __func__, NULL);
+    nout = nbound;
+    status = compress2(dataout, &nout, datain, nin, ZLIB_COMPRESSION_LEVEL);
     if (status != Z_OK) {
-        L_ERROR("deflateInit failed\n", __func__);
-        success = FALSE;
-        goto cleanup_arrays;
+        LEPT_FREE(dataout);
+        L_ERROR("compress2 failed with status %d\n", __func__, status);
+        return NULL;
     }
+    *pnout = nout;
+#endif  /* HAVE_LIBDEFLATE */
 
-    do {
-        if (z.avail_in == 0) {
-            z.next_in = bufferin;
-            bbufferWrite(bbin, bufferin, L_BUF_SIZE, &nbytes);
-#if DEBUG
-            lept_stderr(" wrote %zu bytes to bufferin\n", nbytes);
-#endif  /* DEBUG */
-            z.avail_in = nbytes;
-        }
-        flush = (bbin->n) ? Z_SYNC_FLUSH : Z_FINISH;
-        status = deflate(&z, flush);
-#if DEBUG
-        lept_stderr(" status is %d, bytesleft = %u, totalout = %zu\n",
-                  status, z.avail_out, z.total_out);
-#endif  /* DEBUG */
-        nbytes = L_BUF_SIZE - z.avail_out;
-        if (nbytes) {
-            bbufferRead(bbout, bufferout, nbytes);
 #if DEBUG
-            lept_stderr(" read %zu bytes from bufferout\n", nbytes);
+    lept_stderr(" nin = %zu, bound = %zu, nout = %zu\n", nin, nbound, *pnout);
 #endif  /* DEBUG */
-        }
-        z.next_out = bufferout;
-        z.avail_out = L_BUF_SIZE;
-    } while (flush != Z_FINISH);
 
-    deflateEnd(&z);
-
-cleanup_arrays:
-    if (success) {
-        dataout = bbufferDestroyAndSaveData(&bbout, pnout);
-    } else {
-        dataout = NULL;
-        bbufferDestroy(&bbout);
-    }
-    bbufferDestroy(&bbin);
-    LEPT_FREE(bufferin);
-    LEPT_FREE(bufferout);
+        /* Give back the unused part of the array */
+    if ((datanew = (l_uint8 *)LEPT_REALLOC(dataout, *pnout)) != NULL)
+        dataout = datanew;
     return dataout;
 }
 
@@ -186,7 +186,15 @@ cleanup_arrays:
  *
  * <pre>
  * Notes:
- *      (1) See zlibCompress().
+ *      (1) The size of the uncompressed data is not stored in the
+ *          zlib stream.  We start with an output array that is 4 times
+ *          the size of the input, and double it as required.
+ *      (2) As with other byte arrays in leptonica, the output has an
+ *          extra byte, set to 0, after the data.  This allows
+ *          uncompressed text to be used as a string.
+ *      (3) With zlib, the input is given to inflate() in chunks, and
+ *          the output size is counted here, because the sizes in
+ *          the z_stream may be only 32 bits.
  * </pre>
  */
 l_uint8 *
@@ -194,87 +202,137 @@ zlibUncompress(const l_uint8  *datain,
                size_t          nin,
                size_t         *pnout)
 {
-l_uint8    *dataout;
-l_uint8    *bufferin, *bufferout;
-l_int32     status, success;
-size_t      nbytes;
-L_BBUFFER  *bbin, *bbout;
-z_stream    z;
+l_uint8  *dataout, *datanew;
+size_t    nalloc;
+#if  HAVE_LIBDEFLATE
+size_t    nout;
+enum libdeflate_result         result;
+struct libdeflate_decompressor  *decompressor;
+#else
+l_int32   status;
+size_t    navail, nchunk, inpos, outpos;
+z_stream  z;
+#endif  /* HAVE_LIBDEFLATE */
 
+    if (!pnout)
+        return (l_uint8 *)ERROR_PTR("&nout not defined", __func__, NULL);
+    *pnout = 0;
     if (!datain)
         return (l_uint8 *)ERROR_PTR("datain not defined", __func__, NULL);
 
-        /* Set up fixed size buffers used in z_stream */
-    bufferin = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-    bufferout = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-
-        /* Set up bbuffers and load bbin with the data */
-    bbin = bbufferCreate(datain, nin);
-    bbout = bbufferCreate(NULL, 0);
+    nalloc = L_MAX(4 * nin, L_BUF_SIZE);
+    if ((dataout = (l_uint8 *)LEPT_MALLOC(nalloc + 1)) == NULL)
+        return (l_uint8 *)ERROR_PTR("dataout not made", __func__, NULL);
 
-    success = TRUE;
-    if (!bufferin || !bufferout || !bbin || !bbout) {
-        L_ERROR("calloc fail for buffer\n", __func__);
-        success = FALSE;
-        goto cleanup_arrays;
+#if  HAVE_LIBDEFLATE
+    if ((decompressor = libdeflate_alloc_decompressor()) == NULL) {
+        LEPT_FREE(dataout);
+        return (l_uint8 *)ERROR_PTR("decompressor not made", __func__, NULL);
     }
-
-    z.zalloc = (alloc_func)0;
-    z.zfree = (free_func)0;
-    z.next_in = bufferin;
-    z.avail_in = 0;
-    z.next_out = bufferout;
-    z.avail_out = L_BUF_SIZE;
-
-    status = inflateInit(&z);
-    if (status != Z_OK) {
-        L_ERROR("inflateInit fail for buffer\n", __func__);
-        success = FALSE;
-        goto cleanup_arrays;
+    while (1) {
+        result = libdeflate_zlib_decompress(decompressor, datain, nin,
+                                            dataout, nalloc, &nout);
+        if (result != LIBDEFLATE_INSUFFICIENT_SPACE)
+            break;
+        nalloc *= 2;
+        if ((datanew = (l_uint8 *)LEPT_REALLOC(dataout, nalloc + 1))
+             == NULL) {
+            LEPT_FREE(dataout);
+            libdeflate_free_decompressor(decompressor);
+            return (l_uint8 *)ERROR_PTR("realloc fail", __func__, NULL);
+        }
+        dataout = datanew;
+    }
+    libdeflate_free_decompressor(decompressor);
+    if (result != LIBDEFLATE_SUCCESS) {
+        LEPT_FREE(dataout);
+        L_ERROR("decompression failed with result %d\n", __func__, result);
+        return NULL;
+    }
+    *pnout = nout;
+#else
+    memset(&z, 0, sizeof(z_stream));
+    inpos = L_MIN(nin, MaxInflateChunk);
+    z.next_in = (Bytef *)datain;
+    z.avail_in = inpos;
+    if (inflateInit(&z) != Z_OK) {
+        LEPT_FREE(dataout);
+        return (l_uint8 *)ERROR_PTR("inflateInit failed", __func__, NULL);
     }
 
-    for ( ; ; ) {
-        if (z.avail_in == 0) {
-            z.next_in = bufferin;
-            bbufferWrite(bbin, bufferin, L_BUF_SIZE, &nbytes);
-#if DEBUG
-            lept_stderr(" wrote %d bytes to bufferin\n", nbytes);
-#endif  /* DEBUG */
-            z.avail_in = nbytes;
+    outpos = 0;
+    while (1) {
+        if (outpos == nalloc) {  /* out of space; double the size */
+            nalloc *= 2;
+            if ((datanew = (l_uint8 *)LEPT_REALLOC(dataout, nalloc + 1))
+                 == NULL) {
+                inflateEnd(&z);
+                LEPT_FREE(dataout);
+                return (l_uint8 *)ERROR_PTR("realloc fail", __func__, NULL);
+            }
+            dataout = datanew;
         }
-        if (z.avail_in == 0)
-            break;
-        status = inflate(&z, Z_SYNC_FLUSH);
-#if DEBUG
-        lept_stderr(" status is %d, bytesleft = %d, totalout = %d\n",
-                status, z.avail_out, z.total_out);
-#endif  /* DEBUG */
-        nbytes = L_BUF_SIZE - z.avail_out;
-        if (nbytes) {
-            bbufferRead(bbout, bufferout, nbytes);
+        if (z.avail_in == 0 && inpos < nin) {  /* next chunk of input */
+            nchunk = L_MIN(nin - inpos, MaxInflateChunk);
+            z.next_in = (Bytef *)datain + inpos;
+            z.avail_in = nchunk;
+            inpos += nchunk;
+        }
+        navail = L_MIN(nalloc - outpos, MaxInflateChunk);
+        z.next_out = dataout + outpos;
+        z.avail_out = navail;
+        status = inflate(&z, Z_NO_FLUSH);
+        outpos += navail - z.avail_out;
 #if DEBUG
-            lept_stderr(" read %d bytes from bufferout\n", nbytes);
+        lept_stderr(" status is %d, bytesleft = %u, totalout = %zu\n",
+                    status, z.avail_in, outpos);
 #endif  /* DEBUG */
+        if (status == Z_STREAM_END)
+            break;
+        if (status != Z_OK ||
+            (z.avail_in == 0 && inpos == nin && z.avail_out > 0)) {
+            inflateEnd(&z);
+            LEPT_FREE(dataout);
+            L_ERROR("inflate failed with status %d\n", __func__, status);
+            return NULL;
         }
-        z.next_out = bufferout;
-        z.avail_out = L_BUF_SIZE;
     }
-
+    *pnout = outpos;
     inflateEnd(&z);
+#endif  /* HAVE_LIBDEFLATE */
 
-cleanup_arrays:
-    if (success) {
-        dataout = bbufferDestroyAndSaveData(&bbout, pnout);
-    } else {
-        dataout = NULL;
-        bbufferDestroy(&bbout);
-    }
-    bbufferDestroy(&bbin);
-    LEPT_FREE(bufferin);
-    LEPT_FREE(bufferout);
+    dataout[*pnout] = 0;
     return dataout;
 }
 
+
+/*!
+ * \brief   zlibCompressBound()
+ *
+ * \param[in]    nin     number of bytes of input data
+ * \return  upper bound on the number of bytes of zlib compressed data
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is the size of the output array allocated by
+ *          zlibCompress() for the backend in use.
+ *      (2) With zlib, this returns 0 if %nin is too large for a uLong.
+ * </pre>
+ */
+size_t
+zlibCompressBound(size_t  nin)
+{
+#if  HAVE_LIBDEFLATE
+    return libdeflate_zlib_compress_bound(NULL, nin);
+#else
+    if ((size_t)(uLong)nin != nin) {
+        L_ERROR("nin too large for zlib\n", __func__);
+        return 0;
+    }
+    return compressBound(nin);
+#endif  /* HAVE_LIBDEFLATE */
+}
+
 /* --------------------------------------------*/
 #endif  /* HAVE_LIBZ */
 /* --------------------------------------------*/
@@ -54,6 +54,14 @@ l_uint8 * zlibUncompress(const l_uint8 *datain, size_t nin, size_t *pnout)
     return (l_uint8 *)ERROR_PTR("function not present", __func__, NULL);
 }
 
+/* ----------------------------------------------------------------------*/
+
+size_t zlibCompressBound(size_t nin)
+{
+    L_ERROR("function not present\n", __func__);
+    return 0;
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBZ */
 /* --------------------------------------------*/